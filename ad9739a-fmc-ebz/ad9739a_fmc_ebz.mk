@@ -17,6 +17,9 @@ M_INC_DIRS += $(NOOS-DIR)/drivers/dac/ad9739a
 M_INC_DIRS += $(NOOS-DIR)/drivers/frequency/adf4350
 
 M_HDR_FILES := $(NOOS-DIR)/ad9739a-fmc-ebz/config.h
+M_HDR_FILES += $(NOOS-DIR)/include/error.h
+M_HDR_FILES += $(NOOS-DIR)/include/frac_pll.h
 
 M_SRC_FILES := $(NOOS-DIR)/ad9739a-fmc-ebz/ad9739a_fmc_ebz.c
+M_SRC_FILES += $(NOOS-DIR)/util/frac_pll.c
 
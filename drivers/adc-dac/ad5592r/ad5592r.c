@@ -131,6 +131,27 @@ int32_t ad5592r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 	return 0;
 }
 
+/**
+ * Single conversion callback of a sample source (sample_read_t).
+ *
+ * @param dev - The device structure.
+ * @param ch - The channel number.
+ * @param code - ADC value, without the channel address.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t ad5592r_sample_read(void *dev, uint8_t ch, uint16_t *code)
+{
+	int32_t ret;
+
+	ret = ad5592r_read_adc(dev, ch, code);
+	if (ret < 0)
+		return ret;
+
+	*code &= 0xFFF;
+
+	return 0;
+}
+
 /**
  * Write register.
  *
@@ -53,6 +53,7 @@ int32_t ad5592r_write_dac(struct ad5592r_dev *dev, uint8_t chan,
 			  uint16_t value);
 int32_t ad5592r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 			 uint16_t *value);
+int32_t ad5592r_sample_read(void *dev, uint8_t ch, uint16_t *code);
 int32_t ad5592r_reg_write(struct ad5592r_dev *dev, uint8_t reg,
 			  uint16_t value);
 int32_t ad5592r_reg_read(struct ad5592r_dev *dev, uint8_t reg,
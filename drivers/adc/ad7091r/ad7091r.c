@@ -147,6 +147,22 @@ uint16_t ad7091r_read_sample(struct ad7091r_dev *dev)
 	return conversion_result;
 }
 
+/***************************************************************************//**
+ * @brief Single conversion callback of a sample source (sample_read_t).
+ *
+ * @param dev     - The device structure.
+ * @param ch      - Unused, the device has one channel.
+ * @param code    - 12bit conversion result.
+ *
+ * @return 0.
+*******************************************************************************/
+int32_t ad7091r_sample_read(void *dev, uint8_t ch, uint16_t *code)
+{
+	*code = ad7091r_read_sample(dev);
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Puts the device in power-down mode.
  *
@@ -77,6 +77,9 @@ void ad7091r_software_reset(struct ad7091r_dev *dev);
 /*! Initiates one conversion and reads back the result. */
 uint16_t ad7091r_read_sample(struct ad7091r_dev *dev);
 
+/*! Single conversion callback of a sample source. */
+int32_t ad7091r_sample_read(void *dev, uint8_t ch, uint16_t *code);
+
 /*! Puts the device in power-down mode. */
 void ad7091r_power_down(struct ad7091r_dev *dev);
 
@@ -41,7 +41,16 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include "ad7193.h"    // AD7193 definitions.
+#include "wait.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Longest RDY period: slowest output rate with chop enabled, plus margin */
+#define AD7193_RDY_TIMEOUT_US	2000000
+#define AD7193_RDY_POLL_MAX_US	100
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -66,7 +75,7 @@ int8_t ad7193_init(struct ad7193_dev **device,
 {
 	struct ad7193_dev *dev;
 	int8_t status = 0;
-	uint8_t reg_val = 0;
+	uint32_t reg_val = 0;
 
 	dev = (struct ad7193_dev *)malloc(sizeof(*dev));
 	if (!dev)
@@ -74,6 +83,7 @@ int8_t ad7193_init(struct ad7193_dev **device,
 
 	dev->current_polarity = init_param.current_polarity;
 	dev->current_gain = init_param.current_gain;
+	dev->streaming = false;
 
 	/* SPI */
 	status = spi_init(&dev->spi_desc, &init_param.spi_init);
@@ -88,11 +98,8 @@ int8_t ad7193_init(struct ad7193_dev **device,
 	if (dev->gpio_miso)
 		status |= gpio_direction_input(dev->gpio_miso);
 
-	reg_val = ad7193_get_register_value(dev,
-					    AD7193_REG_ID,
-					    1,
-					    1);
-	if((reg_val & AD7193_ID_MASK) != ID_AD7193) {
+	if (ad7193_get_register_value(dev, AD7193_REG_ID, &reg_val, 1, 1) ||
+	    (reg_val & AD7193_ID_MASK) != ID_AD7193) {
 		status = -1;
 	}
 
@@ -131,17 +138,21 @@ int32_t ad7193_remove(struct ad7193_dev *dev)
  * @param bytes_number     - Number of bytes to be written.
  * @param modify_cs        - Allows Chip Select to be modified.
  *
- * @return none.
+ * @return 0 in case of success, -1 while streaming or on SPI error.
 *******************************************************************************/
-void ad7193_set_register_value(struct ad7193_dev *dev,
-			       uint8_t register_address,
-			       uint32_t register_value,
-			       uint8_t bytes_number,
-			       uint8_t modify_cs)
+int32_t ad7193_set_register_value(struct ad7193_dev *dev,
+				  uint8_t register_address,
+				  uint32_t register_value,
+				  uint8_t bytes_number,
+				  uint8_t modify_cs)
 {
 	uint8_t write_command[5] = {0, 0, 0, 0, 0};
 	uint8_t* data_pointer    = (uint8_t*)&register_value;
 	uint8_t bytes_nr         = bytes_number;
+	int32_t ret;
+
+	if (dev->streaming)
+		return -1;
 
 	write_command[0] = AD7193_COMM_WRITE |
 			   AD7193_COMM_ADDR(register_address);
@@ -152,9 +163,11 @@ void ad7193_set_register_value(struct ad7193_dev *dev,
 	}
 	if (modify_cs)
 		AD7193_CS_LOW;
-	spi_write_and_read(dev->spi_desc, write_command, bytes_number + 1);
+	ret = spi_write_and_read(dev->spi_desc, write_command, bytes_number + 1);
 	if (modify_cs)
 		AD7193_CS_HIGH;
+
+	return ret < 0 ? -1 : 0;
 }
 
 /***************************************************************************//**
@@ -162,32 +175,41 @@ void ad7193_set_register_value(struct ad7193_dev *dev,
  *
  * @param dev              - The device structure.
  * @param register_address - Address of the register.
+ * @param register_value   - Value of the register.
  * @param bytes_number     - Number of bytes that will be read.
  * @param modify_cs        - Allows Chip Select to be modified.
  *
- * @return buffer          - Value of the register.
+ * @return 0 in case of success, -1 while streaming or on SPI error.
 *******************************************************************************/
-uint32_t ad7193_get_register_value(struct ad7193_dev *dev,
-				   uint8_t register_address,
-				   uint8_t bytes_number,
-				   uint8_t modify_cs)
+int32_t ad7193_get_register_value(struct ad7193_dev *dev,
+				  uint8_t register_address,
+				  uint32_t *register_value,
+				  uint8_t bytes_number,
+				  uint8_t modify_cs)
 {
 	uint8_t register_word[5] = {0, 0, 0, 0, 0};
 	uint32_t buffer = 0x0;
 	uint8_t i = 0;
+	int32_t ret;
+
+	if (dev->streaming)
+		return -1;
 
 	register_word[0] = AD7193_COMM_READ |
 			   AD7193_COMM_ADDR(register_address);
 	if (modify_cs)
 		AD7193_CS_LOW;
-	spi_write_and_read(dev->spi_desc, register_word, bytes_number + 1);
+	ret = spi_write_and_read(dev->spi_desc, register_word, bytes_number + 1);
 	if (modify_cs)
 		AD7193_CS_HIGH;
+	if (ret < 0)
+		return -1;
 	for(i = 1; i < bytes_number + 1; i++) {
 		buffer = (buffer << 8) + register_word[i];
 	}
+	*register_value = buffer;
 
-	return buffer;
+	return 0;
 }
 
 /***************************************************************************//**
@@ -226,10 +248,8 @@ void ad7193_set_power(struct ad7193_dev *dev,
 	uint32_t old_pwr_mode = 0x0;
 	uint32_t new_pwr_mode = 0x0;
 
-	old_pwr_mode  = ad7193_get_register_value(dev,
-			AD7193_REG_MODE,
-			3,
-			1);
+	if (ad7193_get_register_value(dev, AD7193_REG_MODE, &old_pwr_mode, 3, 1))
+		return;
 	old_pwr_mode &= ~(AD7193_MODE_SEL(0x7));
 	new_pwr_mode  = old_pwr_mode |
 			AD7193_MODE_SEL((pwr_mode * (AD7193_MODE_IDLE)) |
@@ -272,10 +292,8 @@ void ad7193_channel_select(struct ad7193_dev *dev,
 	uint32_t old_reg_value = 0x0;
 	uint32_t new_reg_value = 0x0;
 
-	old_reg_value  = ad7193_get_register_value(dev,
-			 AD7193_REG_CONF,
-			 3,
-			 1);
+	if (ad7193_get_register_value(dev, AD7193_REG_CONF, &old_reg_value, 3, 1))
+		return;
 	old_reg_value &= ~(AD7193_CONF_CHAN(0x3FF));
 	new_reg_value  = old_reg_value | AD7193_CONF_CHAN(1 << channel);
 	ad7193_set_register_value(dev,
@@ -303,10 +321,8 @@ void ad7193_calibrate(struct ad7193_dev *dev,
 
 	ad7193_channel_select(dev,
 			      channel);
-	old_reg_value  = ad7193_get_register_value(dev,
-			 AD7193_REG_MODE,
-			 3,
-			 1);
+	if (ad7193_get_register_value(dev, AD7193_REG_MODE, &old_reg_value, 3, 1))
+		return;
 	old_reg_value &= ~AD7193_MODE_SEL(0x7);
 	new_reg_value  = old_reg_value | AD7193_MODE_SEL(mode);
 	AD7193_CS_LOW;
@@ -338,10 +354,8 @@ void ad7193_range_setup(struct ad7193_dev *dev,
 	uint32_t old_reg_value = 0x0;
 	uint32_t new_reg_value = 0x0;
 
-	old_reg_value  = ad7193_get_register_value(dev,
-			 AD7193_REG_CONF,
-			 3,
-			 1);
+	if (ad7193_get_register_value(dev, AD7193_REG_CONF, &old_reg_value, 3, 1))
+		return;
 	old_reg_value &= ~(AD7193_CONF_UNIPOLAR |
 			   AD7193_CONF_GAIN(0x7));
 	new_reg_value  = old_reg_value |
@@ -362,13 +376,17 @@ void ad7193_range_setup(struct ad7193_dev *dev,
  *
  * @param dev - The device structure.
  *
- * @return regData - Result of a single analog-to-digital conversion.
+ * @return regData - Result of a single analog-to-digital conversion, 0 while
+ *                   streaming.
 *******************************************************************************/
 uint32_t ad7193_single_conversion(struct ad7193_dev *dev)
 {
 	uint32_t command = 0x0;
 	uint32_t reg_data = 0x0;
 
+	if (dev->streaming)
+		return 0;
+
 	command = AD7193_MODE_SEL(AD7193_MODE_SINGLE) |
 		  AD7193_MODE_CLKSRC(AD7193_CLK_INT) |
 		  AD7193_MODE_RATE(0x060);
@@ -379,10 +397,11 @@ uint32_t ad7193_single_conversion(struct ad7193_dev *dev)
 				  3,
 				  0); // CS is not modified.
 	ad7193_wait_rdy_go_low(dev);
-	reg_data = ad7193_get_register_value(dev,
-					     AD7193_REG_DATA,
-					     3,
-					     0); // CS is not modified.
+	ad7193_get_register_value(dev,
+				  AD7193_REG_DATA,
+				  &reg_data,
+				  3,
+				  0); // CS is not modified.
 	AD7193_CS_HIGH;
 
 	return reg_data;
@@ -394,14 +413,19 @@ uint32_t ad7193_single_conversion(struct ad7193_dev *dev)
  * @param dev - The device structure.
  * @param sample_number - the number of samples
  *
- * @return samplesAverage - The average of the conversion results.
+ * @return samplesAverage - The average of the conversion results, 0 without
+ *                          samples or while streaming.
 *******************************************************************************/
 uint32_t ad7193_continuous_read_avg(struct ad7193_dev *dev,
-				    uint8_t sample_number)
+				    uint32_t sample_number)
 {
-	uint32_t samples_average = 0;
+	uint64_t samples_average = 0;
 	uint32_t command = 0;
-	uint8_t count = 0;
+	uint32_t count = 0;
+	uint32_t sample;
+
+	if (!sample_number || dev->streaming)
+		return 0;
 
 	command = AD7193_MODE_SEL(AD7193_MODE_CONT) |
 		  AD7193_MODE_CLKSRC(AD7193_CLK_INT) |
@@ -414,10 +438,13 @@ uint32_t ad7193_continuous_read_avg(struct ad7193_dev *dev,
 				  0); // CS is not modified.
 	for(count = 0; count < sample_number; count++) {
 		ad7193_wait_rdy_go_low(dev);
-		samples_average += ad7193_get_register_value(dev,
-				   AD7193_REG_DATA,
-				   3,
-				   0); // CS is not modified.
+		sample = 0;
+		ad7193_get_register_value(dev,
+					  AD7193_REG_DATA,
+					  &sample,
+					  3,
+					  0); // CS is not modified.
+		samples_average += sample;
 	}
 	AD7193_CS_HIGH;
 	samples_average = samples_average / sample_number;
@@ -474,3 +501,326 @@ float ad7193_convert_to_volts(struct ad7193_dev *dev,
 
 	return voltage;
 }
+
+/***************************************************************************//**
+ * @brief RDY interrupt handler: reads one result in continuous read mode.
+ *
+ * @param data - The stream.
+ *
+ * @return none.
+*******************************************************************************/
+static void ad7193_stream_rdy_handler(void *data)
+{
+	struct ad7193_stream *stream = data;
+	struct ad7193_dev *dev = stream->dev;
+	struct ad7193_sample sample;
+	uint8_t buf[4] = {0, 0, 0, 0};
+	uint8_t rdy = 0;
+
+	/* DOUT/RDY also toggles while the data is clocked out */
+	AD7193_RDY_STATE(rdy);
+	if (rdy)
+		return;
+
+	spi_write_and_read(dev->spi_desc, buf, stream->status_en ? 4 : 3);
+
+	sample.timestamp = 0;
+	if (stream->timer)
+		timer_counter_get(stream->timer, &sample.timestamp);
+	sample.data = ((uint32_t)buf[0] << 16) | (buf[1] << 8) | buf[2];
+	sample.status = buf[3];
+
+	if (cb_free_space(stream->ring) < sizeof(sample)) {
+		stream->overruns++;
+		return;
+	}
+
+	cb_write(stream->ring, &sample, sizeof(sample));
+}
+
+/***************************************************************************//**
+ * @brief Allocates the ring buffer and registers the RDY interrupt handler.
+ *        The interrupt must be a falling edge interrupt on the DOUT/RDY pin.
+ *
+ * @param stream     - The stream.
+ * @param dev        - The device structure.
+ * @param init_param - The structure that contains the stream parameters.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad7193_stream_init(struct ad7193_stream **stream,
+			   struct ad7193_dev *dev,
+			   struct ad7193_stream_init_param *init_param)
+{
+	struct ad7193_stream *desc;
+	int32_t ret;
+
+	if (!dev || !init_param->irq_ctrl || !init_param->ring_samples)
+		return -1;
+
+	desc = (struct ad7193_stream *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -1;
+
+	desc->dev = dev;
+	desc->irq_ctrl = init_param->irq_ctrl;
+	desc->rdy_irq_id = init_param->rdy_irq_id;
+	desc->timer = init_param->timer;
+	desc->filter_rate = init_param->filter_rate ? init_param->filter_rate :
+			    0x060;
+	desc->status_en = init_param->status_en;
+	ad7193_stream_stats_reset(desc);
+
+	ret = cb_init(&desc->ring, init_param->ring_samples *
+		      sizeof(struct ad7193_sample));
+	if (ret < 0) {
+		free(desc);
+		return ret;
+	}
+
+	ret = irq_register(desc->irq_ctrl, desc->rdy_irq_id,
+			   ad7193_stream_rdy_handler, desc);
+	if (ret < 0) {
+		cb_remove(desc->ring);
+		free(desc);
+		return ret;
+	}
+
+	*stream = desc;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Frees the resources allocated by ad7193_stream_init().
+ *
+ * @param stream - The stream.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad7193_stream_remove(struct ad7193_stream *stream)
+{
+	int32_t ret;
+
+	ret = ad7193_stream_stop(stream);
+	irq_unregister(stream->irq_ctrl, stream->rdy_irq_id);
+	cb_remove(stream->ring);
+	free(stream);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief RDY condition for wait_for_condition(): the status pin is the
+ *        condition, so it is met as soon as it is checked.
+ *
+ * @param ctx  - Unused.
+ * @param done - Set to true.
+ *
+ * @return 0.
+*******************************************************************************/
+static int32_t ad7193_rdy_cond(void *ctx, bool *done)
+{
+	*done = true;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Leaves continuous read mode with the exit command, which is only
+ *        taken while RDY is low. The wait for RDY is bounded.
+ *
+ * @param stream - The stream.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t ad7193_stream_exit(struct ad7193_stream *stream)
+{
+	struct ad7193_dev *dev = stream->dev;
+	struct wait_param param = {
+		.start_us = 1,
+		.max_step_us = AD7193_RDY_POLL_MAX_US,
+		.timeout_us = AD7193_RDY_TIMEOUT_US,
+		.status_gpio = dev->gpio_miso,
+		.status_level = GPIO_LOW,
+	};
+	uint8_t buf[5] = {0, 0, 0, 0, 0};
+	int32_t ret;
+
+	ret = wait_for_condition(&param, ad7193_rdy_cond, NULL);
+	if (ret < 0)
+		return ret;
+
+	buf[0] = AD7193_COMM_READ | AD7193_COMM_ADDR(AD7193_REG_DATA);
+
+	return spi_write_and_read(dev->spi_desc, buf, stream->status_en ? 5 : 4);
+}
+
+/***************************************************************************//**
+ * @brief Starts continuous conversion on the selected channels and enters
+ *        continuous read mode. CS stays low until ad7193_stream_stop().
+ *
+ * @param stream - The stream.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad7193_stream_start(struct ad7193_stream *stream)
+{
+	struct ad7193_dev *dev = stream->dev;
+	uint32_t command;
+	uint8_t cread;
+	int32_t ret;
+
+	if (stream->running)
+		return 0;
+
+	command = AD7193_MODE_SEL(AD7193_MODE_CONT) |
+		  AD7193_MODE_CLKSRC(AD7193_CLK_INT) |
+		  AD7193_MODE_RATE(stream->filter_rate);
+	if (stream->status_en)
+		command |= AD7193_MODE_DAT_STA;
+
+	AD7193_CS_LOW;
+	ret = ad7193_set_register_value(dev,
+					AD7193_REG_MODE,
+					command,
+					3,
+					0); // CS is not modified.
+	if (ret < 0)
+		goto error;
+	/* Enter continuous read: no command byte before the results. */
+	cread = AD7193_COMM_READ | AD7193_COMM_ADDR(AD7193_REG_DATA) |
+		AD7193_COMM_CREAD;
+	ret = spi_write_and_read(dev->spi_desc, &cread, 1);
+	if (ret < 0)
+		goto error;
+	dev->streaming = true;
+	stream->running = true;
+
+	ret = irq_source_enable(stream->irq_ctrl, stream->rdy_irq_id);
+	if (ret < 0)
+		goto error_cread;
+
+	return 0;
+error_cread:
+	/* Best effort, the bus is released either way */
+	ad7193_stream_exit(stream);
+	dev->streaming = false;
+	stream->running = false;
+error:
+	AD7193_CS_HIGH;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Leaves continuous read mode. The ADC keeps converting. Samples left
+ *        in the ring buffer can still be read.
+ *
+ * @param stream - The stream.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad7193_stream_stop(struct ad7193_stream *stream)
+{
+	struct ad7193_dev *dev = stream->dev;
+	int32_t ret;
+
+	if (!stream->running)
+		return 0;
+
+	ret = irq_source_disable(stream->irq_ctrl, stream->rdy_irq_id);
+	if (ret < 0)
+		return ret;
+
+	ret = ad7193_stream_exit(stream);
+	if (ret < 0) {
+		/* Still in continuous read, let the handler run again */
+		irq_source_enable(stream->irq_ctrl, stream->rdy_irq_id);
+		return ret;
+	}
+	AD7193_CS_HIGH;
+	dev->streaming = false;
+	stream->running = false;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Number of samples waiting in the ring buffer.
+ *
+ * @param stream - The stream.
+ *
+ * @return Number of samples.
+*******************************************************************************/
+uint32_t ad7193_stream_available(struct ad7193_stream *stream)
+{
+	return cb_size(stream->ring) / sizeof(struct ad7193_sample);
+}
+
+/***************************************************************************//**
+ * @brief Takes samples from the ring buffer and updates the running
+ *        statistics.
+ *
+ * @param stream     - The stream.
+ * @param samples    - The samples.
+ * @param nb_samples - Size of the samples array.
+ *
+ * @return Number of samples read.
+*******************************************************************************/
+uint32_t ad7193_stream_read(struct ad7193_stream *stream,
+			    struct ad7193_sample *samples,
+			    uint32_t nb_samples)
+{
+	struct ad7193_stream_stats *stats = &stream->stats;
+	uint32_t count;
+	uint32_t i;
+	double delta;
+
+	count = ad7193_stream_available(stream);
+	if (count > nb_samples)
+		count = nb_samples;
+
+	cb_read(stream->ring, samples, count * sizeof(*samples));
+
+	for (i = 0; i < count; i++) {
+		if (samples[i].data < stats->min)
+			stats->min = samples[i].data;
+		if (samples[i].data > stats->max)
+			stats->max = samples[i].data;
+		stats->count++;
+		delta = samples[i].data - stats->mean;
+		stats->mean += delta / stats->count;
+		stats->m2 += delta * (samples[i].data - stats->mean);
+	}
+
+	return count;
+}
+
+/***************************************************************************//**
+ * @brief Clears the running statistics.
+ *
+ * @param stream - The stream.
+ *
+ * @return none.
+*******************************************************************************/
+void ad7193_stream_stats_reset(struct ad7193_stream *stream)
+{
+	memset(&stream->stats, 0, sizeof(stream->stats));
+	stream->stats.min = UINT32_MAX;
+}
+
+/***************************************************************************//**
+ * @brief Variance of the samples read since the last statistics reset.
+ *
+ * @param stream - The stream.
+ *
+ * @return Sample variance, in LSB squared.
+*******************************************************************************/
+double ad7193_stream_variance(struct ad7193_stream *stream)
+{
+	if (stream->stats.count < 2)
+		return 0;
+
+	return stream->stats.m2 / (stream->stats.count - 1);
+}
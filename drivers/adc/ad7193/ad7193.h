@@ -44,8 +44,12 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "gpio.h"
 #include "spi.h"
+#include "irq.h"
+#include "timer.h"
+#include "circular_buffer.h"
 
 /******************************************************************************/
 /******************************** AD7193 **************************************/
@@ -188,6 +192,8 @@ struct ad7193_dev {
 	/* Device Settings */
 	uint8_t		current_polarity;
 	uint8_t		current_gain;
+	/* Continuous read running: the bus belongs to the stream */
+	bool		streaming;
 };
 
 struct ad7193_init_param {
@@ -201,6 +207,58 @@ struct ad7193_init_param {
 	uint8_t		current_gain;
 };
 
+/* One sample of a stream */
+struct ad7193_sample {
+	/* Timer count when the sample was read, 0 without timer */
+	uint32_t	timestamp;
+	/* 24-bit conversion result */
+	uint32_t	data;
+	/* Status byte (channel in the low bits), 0 without status */
+	uint8_t		status;
+};
+
+/* Running statistics of the samples read from a stream */
+struct ad7193_stream_stats {
+	uint32_t	count;
+	uint32_t	min;
+	uint32_t	max;
+	double		mean;
+	/* Sum of the squared differences from the mean */
+	double		m2;
+};
+
+struct ad7193_stream_init_param {
+	/* Interrupt controller and line of the DOUT/RDY falling edge */
+	struct irq_ctrl_desc	*irq_ctrl;
+	uint32_t		rdy_irq_id;
+	/* Timestamp source, may be NULL */
+	struct timer_desc	*timer;
+	/* Samples the ring buffer holds (rounded up) */
+	uint32_t		ring_samples;
+	/* Filter word FS, 1 gives the highest output data rate */
+	uint16_t		filter_rate;
+	/* Append the status byte to each sample */
+	bool			status_en;
+};
+
+/*
+ * Continuous read streaming: CS stays low and every RDY falling edge clocks
+ * out the result only, without a command byte.
+ */
+struct ad7193_stream {
+	struct ad7193_dev		*dev;
+	struct irq_ctrl_desc		*irq_ctrl;
+	uint32_t			rdy_irq_id;
+	struct timer_desc		*timer;
+	struct circular_buffer		*ring;
+	uint16_t			filter_rate;
+	bool				status_en;
+	bool				running;
+	/* Samples dropped because the ring was full */
+	volatile uint32_t		overruns;
+	struct ad7193_stream_stats	stats;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -213,17 +271,18 @@ int8_t ad7193_init(struct ad7193_dev **device,
 int32_t ad7193_remove(struct ad7193_dev *dev);
 
 /*! Writes data into a register. */
-void ad7193_set_register_value(struct ad7193_dev *dev,
-			       uint8_t register_address,
-			       uint32_t register_value,
-			       uint8_t bytes_number,
-			       uint8_t modify_cs);
+int32_t ad7193_set_register_value(struct ad7193_dev *dev,
+				  uint8_t register_address,
+				  uint32_t register_value,
+				  uint8_t bytes_number,
+				  uint8_t modify_cs);
 
 /*! Reads the value of a register. */
-uint32_t ad7193_get_register_value(struct ad7193_dev *dev,
-				   uint8_t register_address,
-				   uint8_t bytes_number,
-				   uint8_t modify_cs);
+int32_t ad7193_get_register_value(struct ad7193_dev *dev,
+				  uint8_t register_address,
+				  uint32_t *register_value,
+				  uint8_t bytes_number,
+				  uint8_t modify_cs);
 
 /*! Resets the device. */
 void ad7193_reset(struct ad7193_dev *dev);
@@ -254,7 +313,7 @@ uint32_t ad7193_single_conversion(struct ad7193_dev *dev);
 
 /*! Returns the average of several conversion results. */
 uint32_t ad7193_continuous_read_avg(struct ad7193_dev *dev,
-				    uint8_t sample_number);
+				    uint32_t sample_number);
 
 /*! Read data from temperature sensor and converts it to Celsius degrees. */
 float ad7193_temperature_read(struct ad7193_dev *dev);
@@ -264,4 +323,32 @@ float ad7193_convert_to_volts(struct ad7193_dev *dev,
 			      uint32_t raw_data,
 			      float v_ref);
 
+/*! Allocates the ring buffer and registers the RDY interrupt handler. */
+int32_t ad7193_stream_init(struct ad7193_stream **stream,
+			   struct ad7193_dev *dev,
+			   struct ad7193_stream_init_param *init_param);
+
+/*! Frees the resources allocated by ad7193_stream_init(). */
+int32_t ad7193_stream_remove(struct ad7193_stream *stream);
+
+/*! Starts continuous conversion and continuous read. */
+int32_t ad7193_stream_start(struct ad7193_stream *stream);
+
+/*! Leaves continuous read. */
+int32_t ad7193_stream_stop(struct ad7193_stream *stream);
+
+/*! Number of samples waiting in the ring buffer. */
+uint32_t ad7193_stream_available(struct ad7193_stream *stream);
+
+/*! Takes samples from the ring buffer and updates the statistics. */
+uint32_t ad7193_stream_read(struct ad7193_stream *stream,
+			    struct ad7193_sample *samples,
+			    uint32_t nb_samples);
+
+/*! Clears the running statistics. */
+void ad7193_stream_stats_reset(struct ad7193_stream *stream);
+
+/*! Variance of the samples read since the last statistics reset. */
+double ad7193_stream_variance(struct ad7193_stream *stream);
+
 #endif /* __AD7193_H__ */
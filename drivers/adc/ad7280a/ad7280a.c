@@ -45,10 +45,70 @@
 #include <stdlib.h>
 #include "ad7280a.h"
 
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+/* CRC-8 of each byte value, polynomial AD7280A_CRC_POLYNOMIAL */
+static const uint8_t ad7280a_crc8_table[256] = {
+	0x00, 0x2F, 0x5E, 0x71, 0xBC, 0x93, 0xE2, 0xCD,
+	0x57, 0x78, 0x09, 0x26, 0xEB, 0xC4, 0xB5, 0x9A,
+	0xAE, 0x81, 0xF0, 0xDF, 0x12, 0x3D, 0x4C, 0x63,
+	0xF9, 0xD6, 0xA7, 0x88, 0x45, 0x6A, 0x1B, 0x34,
+	0x73, 0x5C, 0x2D, 0x02, 0xCF, 0xE0, 0x91, 0xBE,
+	0x24, 0x0B, 0x7A, 0x55, 0x98, 0xB7, 0xC6, 0xE9,
+	0xDD, 0xF2, 0x83, 0xAC, 0x61, 0x4E, 0x3F, 0x10,
+	0x8A, 0xA5, 0xD4, 0xFB, 0x36, 0x19, 0x68, 0x47,
+	0xE6, 0xC9, 0xB8, 0x97, 0x5A, 0x75, 0x04, 0x2B,
+	0xB1, 0x9E, 0xEF, 0xC0, 0x0D, 0x22, 0x53, 0x7C,
+	0x48, 0x67, 0x16, 0x39, 0xF4, 0xDB, 0xAA, 0x85,
+	0x1F, 0x30, 0x41, 0x6E, 0xA3, 0x8C, 0xFD, 0xD2,
+	0x95, 0xBA, 0xCB, 0xE4, 0x29, 0x06, 0x77, 0x58,
+	0xC2, 0xED, 0x9C, 0xB3, 0x7E, 0x51, 0x20, 0x0F,
+	0x3B, 0x14, 0x65, 0x4A, 0x87, 0xA8, 0xD9, 0xF6,
+	0x6C, 0x43, 0x32, 0x1D, 0xD0, 0xFF, 0x8E, 0xA1,
+	0xE3, 0xCC, 0xBD, 0x92, 0x5F, 0x70, 0x01, 0x2E,
+	0xB4, 0x9B, 0xEA, 0xC5, 0x08, 0x27, 0x56, 0x79,
+	0x4D, 0x62, 0x13, 0x3C, 0xF1, 0xDE, 0xAF, 0x80,
+	0x1A, 0x35, 0x44, 0x6B, 0xA6, 0x89, 0xF8, 0xD7,
+	0x90, 0xBF, 0xCE, 0xE1, 0x2C, 0x03, 0x72, 0x5D,
+	0xC7, 0xE8, 0x99, 0xB6, 0x7B, 0x54, 0x25, 0x0A,
+	0x3E, 0x11, 0x60, 0x4F, 0x82, 0xAD, 0xDC, 0xF3,
+	0x69, 0x46, 0x37, 0x18, 0xD5, 0xFA, 0x8B, 0xA4,
+	0x05, 0x2A, 0x5B, 0x74, 0xB9, 0x96, 0xE7, 0xC8,
+	0x52, 0x7D, 0x0C, 0x23, 0xEE, 0xC1, 0xB0, 0x9F,
+	0xAB, 0x84, 0xF5, 0xDA, 0x17, 0x38, 0x49, 0x66,
+	0xFC, 0xD3, 0xA2, 0x8D, 0x40, 0x6F, 0x1E, 0x31,
+	0x76, 0x59, 0x28, 0x07, 0xCA, 0xE5, 0x94, 0xBB,
+	0x21, 0x0E, 0x7F, 0x50, 0x9D, 0xB2, 0xC3, 0xEC,
+	0xD8, 0xF7, 0x86, 0xA9, 0x64, 0x4B, 0x3A, 0x15,
+	0x8F, 0xA0, 0xD1, 0xFE, 0x33, 0x1C, 0x6D, 0x42,
+};
+
+/* Acquisition time of each AD7280A_ACQ_TIME_x setting, in ns */
+static const uint16_t ad7280a_t_acq_ns[4] = {465, 1010, 1460, 1890};
+
 /*****************************************************************************/
 /************************ Functions Definitions ******************************/
 /*****************************************************************************/
 
+/******************************************************************************
+ * @brief Computes the CRC of the 24 least significant bits of a value.
+ *
+ * @param data - The bits covered by the CRC, right aligned.
+ *
+ * @return The CRC.
+******************************************************************************/
+static uint8_t ad7280a_crc8(uint32_t data)
+{
+	uint8_t crc;
+
+	crc = (data >> 16) & 0xFF;
+	crc = ad7280a_crc8_table[crc] ^ ((data >> 8) & 0xFF);
+	crc = ad7280a_crc8_table[crc] ^ (data & 0xFF);
+
+	return crc;
+}
+
 /******************************************************************************
  * @brief Initializes the communication with the device.
  *
@@ -181,45 +241,9 @@ uint32_t ad7280a_transfer_32bits(struct ad7280a_dev *dev,
 ******************************************************************************/
 uint32_t ad7280a_crc_write(uint32_t message)
 {
-	int32_t i;
-	int32_t crc;
-	int32_t xor1 = 0;
-	int32_t xor2 = 0;
-	int32_t xor3 = 0;
-	int32_t xor4 = 0;
-	int32_t xor5 = 0;
-	uint32_t data_out = 0;
-	int32_t crc0 = 0;
-	int32_t crc1 = 0;
-	int32_t crc2 = 0;
-	int32_t crc3 = 0;
-	int32_t crc4 = 0;
-	int32_t crc5 = 0;
-	int32_t crc6 = 0;
-	int32_t crc7 = 0;
-
 	message = message >> 11;
-	for (i = NUMBITS_WRITE; i >= 0; i--) {
-		xor5 = (crc4 ^ crc7) ? 1 : 0;
-		xor4 = (crc2 ^ crc7) ? 1 : 0;
-		xor3 = (crc1 ^ crc7) ? 1 : 0;
-		xor2 = (crc0 ^ crc7) ? 1 : 0;
-		xor1 = ((message & (1 << i)) ? 1 : 0) ^ (crc7 ? 1 : 0);
-		crc7 = crc6;
-		crc6 = crc5;
-		crc5 = xor5;
-		crc4 = crc3;
-		crc3 = xor4;
-		crc2 = xor3;
-		crc1 = xor2;
-		crc0 = xor1;
-	}
-	crc = (crc0 ? (1 << 0) : 0) | (crc1 ? (1 << 1) : 0) | (crc2 ? (1 << 2) : 0) |
-	      (crc3 ? (1 << 3) : 0) | (crc4 ? (1 << 4) : 0) | (crc5 ? (1 << 5) : 0) |
-	      (crc6 ? (1 << 6) : 0) | (crc7 ? (1 << 7) : 0);
-	data_out = (message << 11) | (crc << 3) | 2;
 
-	return data_out;
+	return (message << 11) | (ad7280a_crc8(message) << 3) | 2;
 }
 
 /******************************************************************************
@@ -233,50 +257,7 @@ uint32_t ad7280a_crc_write(uint32_t message)
 ******************************************************************************/
 int32_t ad7280a_crc_read(uint32_t message)
 {
-	int32_t i;
-	uint32_t data_in = 0;
-	int32_t crc_rec;
-	int32_t crc_computed;
-	int32_t xor1 = 0;
-	int32_t xor2 = 0;
-	int32_t xor3 = 0;
-	int32_t xor4 = 0;
-	int32_t xor5 = 0;
-	int32_t crc0 = 0;
-	int32_t crc1 = 0;
-	int32_t crc2 = 0;
-	int32_t crc3 = 0;
-	int32_t crc4 = 0;
-	int32_t crc5 = 0;
-	int32_t crc6 = 0;
-	int32_t crc7 = 0;
-
-	crc_rec= (message >> 2) & 0xFF;
-	data_in = message >> 10;
-	for (i = NUMBITS_READ; i >= 0; i--) {
-		xor5 = (crc4 ^ crc7) ? 1 : 0;
-		xor4 = (crc2 ^ crc7) ? 1 : 0;
-		xor3 = (crc1 ^ crc7) ? 1 : 0;
-		xor2 = (crc0 ^ crc7) ? 1 : 0;
-		xor1 = ((data_in & (1 << i)) ? 1 : 0) ^ (crc7 ? 1 : 0);
-		crc7 = crc6;
-		crc6 = crc5;
-		crc5 = xor5;
-		crc4 = crc3;
-		crc3 = xor4;
-		crc2 = xor3;
-		crc1 = xor2;
-		crc0 = xor1;
-	}
-	crc_computed = (crc0 ? (1 << 0) : 0) | (crc1 ? (1 << 1) : 0) |
-		       (crc2 ? (1 << 2) : 0) | (crc3 ? (1 << 3) : 0) |
-		       (crc4 ? (1 << 4) : 0) | (crc5 ? (1 << 5) : 0) |
-		       (crc6 ? (1 << 6) : 0) | (crc7 ? (1 << 7) : 0);
-	if (crc_rec == crc_computed) {
-		return 1;
-	} else {
-		return 0;
-	}
+	return ((message >> 2) & 0xFF) == ad7280a_crc8(message >> 10);
 }
 
 /******************************************************************************
@@ -314,14 +295,14 @@ int8_t ad7280a_convert_read_all(struct ad7280a_dev *dev)
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	/* Toggle CNVST pin */
 	AD7280A_CNVST_LOW;
 	/* Wait 50us */
-	mdelay(50);
+	udelay(50);
 	AD7280A_CNVST_HIGH;
 	/* Wait 300us */
-	mdelay(300);
+	udelay(300);
 	/* Read data from both devices */
 	for(i = 0; i < 24; i++) {
 		dev->read_data[i] = ad7280a_transfer_32bits(dev,
@@ -407,7 +388,7 @@ int16_t ad7280a_read_register(struct ad7280a_dev *dev,
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	/* Configure the Read register */
 	value = ad7280a_crc_write((uint32_t) (dev_addr << 31) |
 				  (AD7280A_READ << 21) |
@@ -465,7 +446,7 @@ int16_t ad7280a_read_conversion(struct ad7280a_dev *dev,
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	/*  */
 	value = ad7280a_crc_write((uint32_t)(dev_addr << 31) |
 				  (AD7280A_CONTROL_HB << 21) |
@@ -474,7 +455,7 @@ int16_t ad7280a_read_conversion(struct ad7280a_dev *dev,
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	/* Allow conversions to be initiated using CNVST pin on selected part */
 	value=ad7280a_crc_write((uint32_t)(dev_addr << 31) |
 				(AD7280A_CNVST_N_CONTROL << 21) |
@@ -486,10 +467,10 @@ int16_t ad7280a_read_conversion(struct ad7280a_dev *dev,
 	AD7280A_CNVST_LOW;
 	/* Allow sufficient time for all conversions to be completed */
 	/* Wait 50us */
-	mdelay(50);
+	udelay(50);
 	AD7280A_CNVST_HIGH;
 	/* Wait 300us */
-	mdelay(300);
+	udelay(300);
 	/* Perform the read */
 	value = ad7280a_transfer_32bits(dev,
 					AD7280A_READ_TXVAL);
@@ -701,7 +682,7 @@ void ad7280a_selftest_all(struct ad7280a_dev *dev,
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	value = ad7280a_crc_write((uint32_t) (AD7280A_READ << 21) |
 				  (AD7280A_SELF_TEST << 15)            |
 				  (1 << 12));
@@ -716,10 +697,10 @@ void ad7280a_selftest_all(struct ad7280a_dev *dev,
 				value);
 	AD7280A_CNVST_LOW;
 	/* wait 100us */
-	mdelay(100);
+	udelay(100);
 	AD7280A_CNVST_HIGH;
 	/* wait 300us */
-	mdelay(300);
+	udelay(300);
 	value = ad7280a_crc_write((uint32_t) (AD7280A_CNVST_N_CONTROL << 21) |
 				  (1 << 13)                       |
 				  (1 << 12));
@@ -760,3 +741,176 @@ uint8_t ad7280a_alert_pin(struct ad7280a_dev *dev)
 
 	return alert_ad7280a;
 }
+
+/******************************************************************************
+ * @brief Configures the daisy chain for stack scans: every scan starts one
+ *        broadcast conversion and reads the results of all the devices.
+ *
+ * @param scan       - The scan structure.
+ * @param dev        - The device structure.
+ * @param init_param - The scan parameters.
+ *
+ * @return 0 in case of success, -1 otherwise.
+******************************************************************************/
+int32_t ad7280a_scan_init(struct ad7280a_scan **scan,
+			  struct ad7280a_dev *dev,
+			  struct ad7280a_scan_init_param *init_param)
+{
+	struct ad7280a_scan *s;
+	uint32_t frames;
+	uint32_t t_acq;
+	uint32_t value;
+	uint8_t hb;
+
+	if (!scan || !dev || !init_param || !init_param->num_devices ||
+	    init_param->num_devices > AD7280A_MAX_DEVICES ||
+	    init_param->conv_avg > AD7280A_CONV_AVG_8 ||
+	    init_param->acq_time > AD7280A_ACQ_TIME_1600ns)
+		return -1;
+
+	s = (struct ad7280a_scan *)calloc(1, sizeof(*s));
+	if (!s)
+		return -1;
+
+	s->dev = dev;
+	s->num_devices = init_param->num_devices;
+	s->channels = init_param->aux_en ? AD7280A_NUM_CH : AD7280A_NUM_CELLS;
+	s->timer = init_param->timer;
+
+	frames = s->num_devices * s->channels;
+	s->frames = (uint8_t *)calloc(frames, 4);
+	s->voltage = (float *)calloc(frames, sizeof(*s->voltage));
+	if (!s->frames || !s->voltage) {
+		ad7280a_scan_remove(s);
+		return -1;
+	}
+
+	/* Total conversion time = (tACQ + tCONV) * conversions - tACQ +
+	 * (devices - 1) * tDELAY, followed by tWAIT before the readout. */
+	t_acq = ad7280a_t_acq_ns[init_param->acq_time];
+	s->conv_delay_us = (t_acq + 695) * s->channels *
+			   (1 << init_param->conv_avg) - t_acq +
+			   (s->num_devices - 1) * 250;
+	s->conv_delay_us = (s->conv_delay_us + 999) / 1000 + 5;
+
+	/* Convert and read the selected inputs on all the devices */
+	hb = init_param->aux_en ? (AD7280A_CTRL_HB_CONV_RES_READ_ALL |
+				   AD7280A_CTRL_HB_CONV_INPUT_ALL) :
+	     (AD7280A_CTRL_HB_CONV_RES_READ_6CELL |
+	      AD7280A_CTRL_HB_CONV_INPUT_6CELL);
+	hb |= AD7280A_CTRL_HB_CONV_AVG(init_param->conv_avg);
+	value = ad7280a_crc_write((uint32_t) (AD7280A_CONTROL_HB << 21) |
+				  (hb << 13) |
+				  (1 << 12));
+	ad7280a_transfer_32bits(dev,
+				value);
+	value = ad7280a_crc_write((uint32_t) (AD7280A_CONTROL_LB << 21) |
+				  ((AD7280A_CTRL_LB_ACQ_TIME(init_param->acq_time) |
+				    AD7280A_CTRL_LB_MUST_SET |
+				    AD7280A_CTRL_LB_LOCK_DEV_ADDR |
+				    AD7280A_CTRL_LB_DAISY_CHAIN_RB_EN) << 13) |
+				  (1 << 12));
+	ad7280a_transfer_32bits(dev,
+				value);
+
+	*scan = s;
+
+	return 0;
+}
+
+/******************************************************************************
+ * @brief Free the resources allocated by ad7280a_scan_init().
+ *
+ * @param scan - The scan structure.
+ *
+ * @return 0 in case of success, -1 otherwise.
+******************************************************************************/
+int32_t ad7280a_scan_remove(struct ad7280a_scan *scan)
+{
+	if (!scan)
+		return -1;
+
+	free(scan->frames);
+	free(scan->voltage);
+	free(scan);
+
+	return 0;
+}
+
+/******************************************************************************
+ * @brief Starts one conversion on all the devices of the chain and reads the
+ *        results back to back. Frames failing the CRC check or arriving out
+ *        of order leave their previous voltage in place.
+ *
+ * @param scan - The scan structure.
+ *
+ * @return 0 in case of success, -1 if any frame was rejected.
+******************************************************************************/
+int32_t ad7280a_scan_run(struct ad7280a_scan *scan)
+{
+	struct ad7280a_dev *dev = scan->dev;
+	uint32_t frames = scan->num_devices * scan->channels;
+	uint32_t value;
+	uint32_t i;
+	uint16_t code;
+	uint8_t *buf;
+	uint8_t reg;
+	int32_t ret = 0;
+
+	/* Rewind the read pointer and allow one CNVST pulse on all devices */
+	value = ad7280a_crc_write((uint32_t) (AD7280A_READ << 21) |
+				  (AD7280A_CELL_VOLTAGE_1 << 15) |
+				  (1 << 12));
+	ad7280a_transfer_32bits(dev,
+				value);
+	value = ad7280a_crc_write((uint32_t) (AD7280A_CNVST_N_CONTROL << 21) |
+				  (2 << 13) |
+				  (1 << 12));
+	ad7280a_transfer_32bits(dev,
+				value);
+
+	/* The falling edge of CNVST starts the conversion on all devices */
+	AD7280A_CNVST_LOW;
+	udelay(1);
+	AD7280A_CNVST_HIGH;
+	udelay(scan->conv_delay_us);
+
+	for (i = 0; i < frames; i++) {
+		buf = &scan->frames[i * 4];
+		buf[0] = (AD7280A_READ_TXVAL >> 24) & 0xFF;
+		buf[1] = (AD7280A_READ_TXVAL >> 16) & 0xFF;
+		buf[2] = (AD7280A_READ_TXVAL >> 8) & 0xFF;
+		buf[3] = AD7280A_READ_TXVAL & 0xFF;
+	}
+
+	/* Each 32 bit frame is framed by CS, the results come out device by
+	 * device starting with the master. */
+	for (i = 0; i < frames; i++) {
+		if (scan->timer && !(i % scan->channels))
+			timer_counter_get(scan->timer,
+					  &scan->timestamp[i / scan->channels]);
+		ret |= spi_write_and_read(dev->spi_desc, &scan->frames[i * 4], 4);
+	}
+	if (ret)
+		return -1;
+
+	scan->crc_errors = 0;
+	for (i = 0; i < frames; i++) {
+		buf = &scan->frames[i * 4];
+		value = ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+			((uint32_t)buf[2] << 8) | buf[3];
+		reg = (value >> 23) & 0xF;
+		if (!ad7280a_crc_read(value) || reg != i % scan->channels) {
+			scan->crc_errors++;
+			continue;
+		}
+		code = (value >> 11) & 0xFFF;
+		if (reg < AD7280A_NUM_CELLS)
+			scan->voltage[i] = 1 + code * 0.0009765625f;
+		else
+			scan->voltage[i] = code * 0.001220703125f;
+	}
+	scan->total_crc_errors += scan->crc_errors;
+
+	return scan->crc_errors ? -1 : 0;
+}
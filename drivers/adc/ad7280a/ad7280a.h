@@ -47,9 +47,11 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "delay.h"
 #include "gpio.h"
 #include "spi.h"
+#include "timer.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -165,6 +167,14 @@
 #define NUMBITS_READ        22   // Number of bits for CRC when reading
 #define NUMBITS_WRITE       21   // Number of bits for CRC when writing
 
+/* CRC-8 polynomial: x^8 + x^5 + x^3 + x^2 + x + 1 */
+#define AD7280A_CRC_POLYNOMIAL      0x2F
+
+/* Channels of one device: 6 cells and 6 auxiliary inputs */
+#define AD7280A_NUM_CELLS           6
+#define AD7280A_NUM_CH              12
+#define AD7280A_MAX_DEVICES         8
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -190,6 +200,40 @@ struct ad7280a_init_param {
 	struct gpio_init_param	gpio_alert;
 };
 
+/* Stack scan: one broadcast conversion, then all the results of the chain */
+struct ad7280a_scan_init_param {
+	/* Devices in the daisy chain, master included */
+	uint8_t			num_devices;
+	/* Convert and read the auxiliary inputs as well as the cells */
+	bool			aux_en;
+	/* AD7280A_CONV_AVG_x */
+	uint8_t			conv_avg;
+	/* AD7280A_ACQ_TIME_x */
+	uint8_t			acq_time;
+	/* Timestamp source, may be NULL */
+	struct timer_desc	*timer;
+};
+
+struct ad7280a_scan {
+	struct ad7280a_dev	*dev;
+	uint8_t			num_devices;
+	/* Channels read per device, 6 or 12 */
+	uint8_t			channels;
+	/* Wait between the conversion start and the readout */
+	uint32_t		conv_delay_us;
+	struct timer_desc	*timer;
+	/* Read frames of the whole chain */
+	uint8_t			*frames;
+	/* Per device timer count at the start of its readout */
+	uint32_t		timestamp[AD7280A_MAX_DEVICES];
+	/* Results in volts, channels entries per device: cells then
+	 * auxiliary inputs */
+	float			*voltage;
+	/* Frames rejected by the CRC check in the last scan and in total */
+	uint32_t		crc_errors;
+	uint32_t		total_crc_errors;
+};
+
 /*****************************************************************************/
 /************************ Functions Declarations *****************************/
 /*****************************************************************************/
@@ -246,4 +290,15 @@ void ad7280a_selftest_all(struct ad7280a_dev *dev,
 /* Reads the value of Alert Pin from the device. */
 uint8_t ad7280a_alert_pin(struct ad7280a_dev *dev);
 
+/* Configures the chain for stack scans. */
+int32_t ad7280a_scan_init(struct ad7280a_scan **scan,
+			  struct ad7280a_dev *dev,
+			  struct ad7280a_scan_init_param *init_param);
+
+/* Free the resources allocated by ad7280a_scan_init(). */
+int32_t ad7280a_scan_remove(struct ad7280a_scan *scan);
+
+/* Converts and reads all the channels of all the devices. */
+int32_t ad7280a_scan_run(struct ad7280a_scan *scan);
+
 #endif /*_AD7280A_H_*/
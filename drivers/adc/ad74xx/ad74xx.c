@@ -183,6 +183,22 @@ uint16_t ad74xx_get_register_value(struct ad74xx_dev *dev)
 	return conv_result;
 }
 
+/***************************************************************************//**
+ * @brief Single conversion callback of a sample source (sample_read_t).
+ *
+ * @param dev  - The device structure.
+ * @param ch   - Unused, the device has one channel.
+ * @param code - Conversion data.
+ *
+ * @return 0.
+*******************************************************************************/
+int32_t ad74xx_sample_read(void *dev, uint8_t ch, uint16_t *code)
+{
+	*code = ad74xx_get_register_value(dev);
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Converts a raw sample to volts.
  *
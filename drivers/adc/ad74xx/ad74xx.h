@@ -116,6 +116,9 @@ void ad74xx_power_up(struct ad74xx_dev *dev);
 /*! Reads the conversion value. */
 uint16_t ad74xx_get_register_value(struct ad74xx_dev *dev);
 
+/*! Single conversion callback of a sample source. */
+int32_t ad74xx_sample_read(void *dev, uint8_t ch, uint16_t *code);
+
 /*! Converts a raw sample to volts. */
 float ad74xx_convert_to_volts(struct ad74xx_dev *dev,
 			      uint16_t raw_value,
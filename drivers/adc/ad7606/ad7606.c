@@ -43,29 +43,36 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "stdbool.h"
+#include "string.h"
 #include "ad7606.h"
+#include "wait.h"
 
 static const struct ad7606_chip_info ad7606_chip_info_tbl[] = {
 	[ID_AD7605_4] = {
 		.num_channels = 4,
 		.has_oversampling = false,
+		.max_rate_hz = 300000,
 	},
 	[ID_AD7606_4] = {
 		.num_channels = 4,
 		.has_oversampling = true,
+		.max_rate_hz = 200000,
 	},
 	[ID_AD7606_6] = {
 		.num_channels = 6,
 		.has_oversampling = true,
+		.max_rate_hz = 200000,
 	},
 	[ID_AD7606_8] = {
 		.num_channels = 8,
 		.has_oversampling = true,
+		.max_rate_hz = 200000,
 	},
 	[ID_AD7606B] = {
 		.num_channels = 8,
 		.has_oversampling = true,
 		.has_registers = true,
+		.max_rate_hz = 800000,
 	},
 };
 
@@ -123,8 +130,28 @@ static int ad7606_spi_write_mask(struct ad7606_dev *dev,
 	return ad7606_spi_reg_write(dev, addr, reg_data);
 }
 
+static int32_t ad7606_busy_low(void *ctx, bool *done)
+{
+	struct ad7606_dev *dev = ctx;
+	uint8_t busy;
+	int32_t ret;
+
+	ret = gpio_get_value(dev->gpio_busy, &busy);
+	if (ret < 0)
+		return ret;
+
+	*done = (busy == GPIO_LOW);
+
+	return 0;
+}
+
 int32_t ad7606_spi_read_bulk(struct ad7606_dev *dev)
 {
+	struct wait_param param = {
+		.start_us = 1,
+		.max_step_us = 16,
+		.timeout_us = AD7606_BUSY_TIMEOUT_US,
+	};
 	uint8_t size;
 	int32_t ret;
 
@@ -137,6 +164,13 @@ int32_t ad7606_spi_read_bulk(struct ad7606_dev *dev)
 	if (ret < 0)
 		return ret;
 
+	/* The result is only valid once the conversion is over */
+	ret = wait_for_condition(&param, ad7606_busy_low, dev);
+	if (ret < 0)
+		return ret;
+
+	memset(dev->data, 0, size);
+
 	return spi_write_and_read(dev->spi_desc, dev->data, size);
 }
 
@@ -192,15 +226,15 @@ int32_t ad7606_request_gpios(struct ad7606_dev *dev,
 	if (!ad7606_chip_info_tbl[dev->device_id].has_oversampling)
 		return 0;
 
-	ret = gpio_get(&dev->gpio_range, &init_param->gpio_os0);
+	ret = gpio_get(&dev->gpio_os0, &init_param->gpio_os0);
 	if (ret < 0)
 		return ret;
 
-	ret = gpio_get(&dev->gpio_range, &init_param->gpio_os1);
+	ret = gpio_get(&dev->gpio_os1, &init_param->gpio_os1);
 	if (ret < 0)
 		return ret;
 
-	return gpio_get(&dev->gpio_range, &init_param->gpio_os2);
+	return gpio_get(&dev->gpio_os2, &init_param->gpio_os2);
 }
 
 int32_t ad7606_set_os_ratio(struct ad7606_dev *dev,
@@ -230,6 +264,8 @@ int32_t ad7606_set_os_ratio(struct ad7606_dev *dev,
 			return ret;
 	}
 
+	dev->oversampling = osr;
+
 	return 0;
 }
 
@@ -323,3 +359,195 @@ int32_t ad7606_remove(struct ad7606_dev *dev)
 
 	return ret;
 }
+
+/*
+ * Highest sampling rate: every doubling of the oversampling ratio doubles
+ * the conversion time.
+ */
+uint32_t ad7606_get_max_rate(struct ad7606_dev *dev)
+{
+	return ad7606_chip_info_tbl[dev->device_id].max_rate_hz >>
+	       dev->oversampling;
+}
+
+/* BUSY falling edge: read the frame of the conversion that just ended. */
+static void ad7606_burst_busy_handler(void *data)
+{
+	struct ad7606_burst *burst = data;
+	uint8_t frame[AD7606_MAX_CHANNELS * 2];
+	int32_t ret;
+
+	memset(frame, 0, burst->frame_size);
+	ret = spi_write_and_read(burst->dev->spi_desc, frame, burst->frame_size);
+	if (ret < 0) {
+		burst->error = ret;
+		return;
+	}
+
+	/* Only store whole frames so the reader never loses the alignment */
+	if (cb_free_space(burst->ring) < burst->frame_size) {
+		burst->overruns++;
+		return;
+	}
+
+	cb_write(burst->ring, frame, burst->frame_size);
+	burst->frames++;
+}
+
+int32_t ad7606_burst_init(struct ad7606_burst **burst,
+			  struct ad7606_dev *dev,
+			  struct ad7606_burst_init_param *init_param)
+{
+	struct ad7606_burst *desc;
+	int32_t ret;
+
+	if (!dev || !init_param->irq_ctrl || !init_param->ring_frames ||
+	    !init_param->trigger_start != !init_param->trigger_stop)
+		return -1;
+
+	desc = (struct ad7606_burst *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -1;
+
+	desc->dev = dev;
+	desc->irq_ctrl = init_param->irq_ctrl;
+	desc->busy_irq_id = init_param->busy_irq_id;
+	desc->frame_size = ad7606_chip_info_tbl[dev->device_id].num_channels * 2;
+	desc->trigger_start = init_param->trigger_start;
+	desc->trigger_stop = init_param->trigger_stop;
+	desc->trigger_ctx = init_param->trigger_ctx;
+
+	ret = cb_init(&desc->ring, init_param->ring_frames * desc->frame_size);
+	if (ret < 0) {
+		free(desc);
+		return ret;
+	}
+
+	ret = irq_register(desc->irq_ctrl, desc->busy_irq_id,
+			   ad7606_burst_busy_handler, desc);
+	if (ret < 0) {
+		cb_remove(desc->ring);
+		free(desc);
+		return ret;
+	}
+
+	*burst = desc;
+
+	return 0;
+}
+
+/*
+ * Start sampling all the channels. The rate is limited to what the current
+ * oversampling ratio allows, 0 selects the highest rate.
+ */
+int32_t ad7606_burst_start(struct ad7606_burst *burst, uint32_t rate_hz)
+{
+	uint32_t max_rate;
+	int32_t ret;
+
+	if (burst->running)
+		return -1;
+
+	max_rate = ad7606_get_max_rate(burst->dev);
+	if (!rate_hz || rate_hz > max_rate)
+		rate_hz = max_rate;
+	burst->rate_hz = rate_hz;
+	burst->error = 0;
+
+	ret = irq_source_enable(burst->irq_ctrl, burst->busy_irq_id);
+	if (ret < 0)
+		return ret;
+
+	if (burst->trigger_start) {
+		ret = burst->trigger_start(burst->trigger_ctx, rate_hz);
+		if (ret < 0) {
+			irq_source_disable(burst->irq_ctrl, burst->busy_irq_id);
+			return ret;
+		}
+	}
+
+	burst->running = true;
+
+	return 0;
+}
+
+int32_t ad7606_burst_stop(struct ad7606_burst *burst)
+{
+	int32_t ret = 0;
+
+	if (!burst->running)
+		return 0;
+
+	if (burst->trigger_stop)
+		ret = burst->trigger_stop(burst->trigger_ctx);
+
+	irq_source_disable(burst->irq_ctrl, burst->busy_irq_id);
+	burst->running = false;
+
+	return ret;
+}
+
+/*
+ * Start one conversion by pulsing CONVST, when no timer/PWM drives it. The
+ * frame is read by the BUSY interrupt.
+ */
+int32_t ad7606_burst_trigger(struct ad7606_burst *burst)
+{
+	int32_t ret;
+
+	ret = gpio_set_value(burst->dev->gpio_convst, 0);
+	if (ret < 0)
+		return ret;
+
+	return gpio_set_value(burst->dev->gpio_convst, 1);
+}
+
+/* Number of frames waiting in the ring buffer. */
+uint32_t ad7606_burst_available(struct ad7606_burst *burst)
+{
+	return cb_size(burst->ring) / burst->frame_size;
+}
+
+/*
+ * Fetch up to nb_frames frames as struct of arrays: the samples of channel
+ * ch are stored at data[ch * nb_frames + n], whatever the number of frames
+ * available. Returns the number of frames copied or a negative error code if
+ * the interrupt handler failed.
+ */
+int32_t ad7606_burst_read(struct ad7606_burst *burst, uint16_t *data,
+			  uint32_t nb_frames)
+{
+	uint8_t frame[AD7606_MAX_CHANNELS * 2];
+	uint8_t nr_ch = burst->frame_size / 2;
+	uint32_t count;
+	uint32_t n;
+	uint8_t ch;
+
+	if (burst->error < 0)
+		return burst->error;
+
+	count = ad7606_burst_available(burst);
+	if (count > nb_frames)
+		count = nb_frames;
+
+	for (n = 0; n < count; n++) {
+		cb_read(burst->ring, frame, burst->frame_size);
+		for (ch = 0; ch < nr_ch; ch++)
+			data[ch * nb_frames + n] = frame[ch * 2] << 8 |
+						   frame[ch * 2 + 1];
+	}
+
+	return count;
+}
+
+int32_t ad7606_burst_remove(struct ad7606_burst *burst)
+{
+	int32_t ret;
+
+	ret = ad7606_burst_stop(burst);
+	irq_unregister(burst->irq_ctrl, burst->busy_irq_id);
+	cb_remove(burst->ring);
+	free(burst);
+
+	return ret;
+}
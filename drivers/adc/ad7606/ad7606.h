@@ -43,9 +43,12 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "delay.h"
 #include "gpio.h"
 #include "spi.h"
+#include "irq.h"
+#include "circular_buffer.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -67,6 +70,11 @@
 #define AD7606_RANGE_CH_MODE(ch, mode)	\
 	((GENMASK(3, 0) & mode) << (4 * ((ch) % 2)))
 
+/* Longest conversion, OSR 256 included, in us */
+#define AD7606_BUSY_TIMEOUT_US		2000
+
+#define AD7606_MAX_CHANNELS		8
+
 #define AD7606_RD_FLAG_MSK(x)		(BIT(6) | ((x) & 0x3F))
 #define AD7606_WR_FLAG_MSK(x)		((x) & 0x3F)
 
@@ -101,6 +109,8 @@ struct ad7606_chip_info {
 	uint8_t num_channels;
 	bool has_oversampling;
 	bool has_registers;
+	/* Throughput without oversampling */
+	uint32_t max_rate_hz;
 };
 
 struct ad7606_dev {
@@ -119,6 +129,7 @@ struct ad7606_dev {
 	/* Buffer to store the conv result */
 	uint8_t	data[16];
 	bool sw_mode_en;
+	enum ad7606_osr oversampling;
 };
 
 struct ad7606_init_param {
@@ -139,6 +150,47 @@ struct ad7606_init_param {
 	bool sw_mode_en;
 };
 
+/*
+ * Sampling engine: CONVST is driven at the sampling rate by a timer/PWM set up
+ * by the application, every BUSY falling edge reads all the channels in
+ * interrupt context and stores them as one frame in a ring buffer.
+ */
+struct ad7606_burst_init_param {
+	/* Interrupt controller and line of the BUSY falling edge */
+	struct irq_ctrl_desc *irq_ctrl;
+	uint32_t busy_irq_id;
+	/* Frames the ring buffer holds (rounded up) */
+	uint32_t ring_frames;
+	/*
+	 * Start/stop the CONVST timer/PWM at the given rate. If NULL,
+	 * conversions are started by calling ad7606_burst_trigger(), e.g.
+	 * from a periodic timer interrupt.
+	 */
+	int32_t (*trigger_start)(void *ctx, uint32_t rate_hz);
+	int32_t (*trigger_stop)(void *ctx);
+	void *trigger_ctx;
+};
+
+struct ad7606_burst {
+	struct ad7606_dev *dev;
+	struct irq_ctrl_desc *irq_ctrl;
+	uint32_t busy_irq_id;
+	struct circular_buffer *ring;
+	/* Bytes per frame, 2 per channel */
+	uint8_t frame_size;
+	int32_t (*trigger_start)(void *ctx, uint32_t rate_hz);
+	int32_t (*trigger_stop)(void *ctx);
+	void *trigger_ctx;
+	/* Sampling rate in use */
+	uint32_t rate_hz;
+	bool running;
+	/* Frames stored and frames dropped because the ring was full */
+	volatile uint32_t frames;
+	volatile uint32_t overruns;
+	/* Last SPI error seen by the interrupt handler */
+	volatile int32_t error;
+};
+
 int32_t ad7606_spi_reg_read(struct ad7606_dev *dev,
 			    uint8_t reg_addr,
 			    uint8_t *reg_data);
@@ -159,4 +211,15 @@ int32_t ad7606_set_ch_range(struct ad7606_dev *dev, uint8_t ch,
 int32_t ad7606_init(struct ad7606_dev **device,
 		    struct ad7606_init_param *init_param);
 int32_t ad7606_remove(struct ad7606_dev *dev);
+uint32_t ad7606_get_max_rate(struct ad7606_dev *dev);
+int32_t ad7606_burst_init(struct ad7606_burst **burst,
+			  struct ad7606_dev *dev,
+			  struct ad7606_burst_init_param *init_param);
+int32_t ad7606_burst_start(struct ad7606_burst *burst, uint32_t rate_hz);
+int32_t ad7606_burst_stop(struct ad7606_burst *burst);
+int32_t ad7606_burst_trigger(struct ad7606_burst *burst);
+uint32_t ad7606_burst_available(struct ad7606_burst *burst);
+int32_t ad7606_burst_read(struct ad7606_burst *burst, uint16_t *data,
+			  uint32_t nb_frames);
+int32_t ad7606_burst_remove(struct ad7606_burst *burst);
 #endif /* AD7606_H_ */
@@ -143,6 +143,32 @@ void ad799x_get_conversion_result(struct ad799x_dev *dev,
 	*conv_value = (conv_word & 0x0FFF) >> (12 - dev->bits_number);
 }
 
+/***************************************************************************//**
+ * @brief Single conversion callback of a sample source (sample_read_t). The
+ *        converted channels are the ones selected in the Configuration
+ *        Register, in ascending order, matching the enabled channels of the
+ *        sample source.
+ *
+ * @param dev  - The device structure.
+ * @param ch   - The expected channel.
+ * @param code - Stores the conversion value.
+ *
+ * @return 0 in case of success, -1 if the device converted another channel.
+*******************************************************************************/
+int32_t ad799x_sample_read(void *dev, uint8_t ch, uint16_t *code)
+{
+	int16_t conv_value;
+	int8_t channel;
+
+	ad799x_get_conversion_result(dev, &conv_value, &channel);
+	if (channel != ch)
+		return -1;
+
+	*code = conv_value;
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Converts a raw sample to volts.
  *
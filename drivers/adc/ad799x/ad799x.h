@@ -102,6 +102,9 @@ void ad799x_get_conversion_result(struct ad799x_dev *dev,
 				  int16_t* conv_value,
 				  int8_t* channel);
 
+/*! Single conversion callback of a sample source. */
+int32_t ad799x_sample_read(void *dev, uint8_t ch, uint16_t *code);
+
 /*! Converts a raw sample to volts.*/
 float ad799x_convert_to_volts(struct ad799x_dev *dev,
 			      int16_t raw_sample,
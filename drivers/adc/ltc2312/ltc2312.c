@@ -191,6 +191,34 @@ int32_t ltc2312_read(struct ltc2312_dev *dev, uint16_t *ptr_adc_code)
 	return ret;
 }
 
+/**
+ * Single conversion callback of a sample source (sample_read_t). Unlike
+ * ltc2312_read(), there is no dummy read and no averaging: each transfer
+ * returns the previous conversion and starts the next one, so a paced
+ * acquisition sees one sample of latency.
+ *
+ * @param [in]  dev  - The device structure.
+ * @param [in]  ch   - Unused, the device has one channel.
+ * @param [out] code - Read data.
+ *
+ * @return 0 for success, or negative error code otherwise.
+ */
+int32_t ltc2312_sample_read(void *dev, uint8_t ch, uint16_t *code)
+{
+	uint8_t adc_array[] = {0x00, 0x00};
+	int32_t ret;
+
+	ret = spi_write_and_read(((struct ltc2312_dev *)dev)->spi_desc,
+				 adc_array, LTC2312_READ_BYTES_NUMBER);
+	if (ret != 0)
+		return ret;
+
+	*code = (((uint16_t)adc_array[0] << 8) | adc_array[1]) >>
+		ltc2312_get_shift(dev);
+
+	return 0;
+}
+
 /**
  * Calculates the LTC2312 input voltage given the binary data and LSB weight.
  *
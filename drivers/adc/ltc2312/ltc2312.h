@@ -101,6 +101,9 @@ int32_t ltc2312_remove(struct ltc2312_dev *dev);
 /* Reads the LTC2315 and returns 32-bit data in offset binary format. */
 int32_t ltc2312_read(struct ltc2312_dev *dev, uint16_t *ptr_adc_code);
 
+/* Single conversion callback of a sample source. */
+int32_t ltc2312_sample_read(void *dev, uint8_t ch, uint16_t *code);
+
 /* Calculates the LTC2315 input voltage given the binary data and LSB weight. */
 void ltc2312_code_to_voltage(struct ltc2312_dev *dev, uint16_t adc_code,
 			     float vref, float *voltage);
@@ -42,6 +42,7 @@
 /******************************************************************************/
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 #include "error.h"
 #include "delay.h"
@@ -106,6 +107,9 @@
 #define AXI_DAC_IQCOR_COEFF_2(x)		(((x) & 0xFFFF) << 0)
 #define AXI_DAC_TO_IQCOR_COEFF_2(x)		(((x) >> 0) & 0xFFFF)
 
+/* Words generated at once when writing a buffer to memory */
+#define AXI_DAC_STAGE_WORDS				512
+
 const uint16_t sine_lut[128] = {
 	0x000, 0x064, 0x0C8, 0x12C, 0x18F, 0x1F1, 0x252, 0x2B1,
 	0x30F, 0x36B, 0x3C5, 0x41C, 0x471, 0x4C3, 0x512, 0x55F,
@@ -380,6 +384,54 @@ int32_t axi_dac_set_datasel(struct axi_dac *dac,
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief axi_dac_dds_incr
+ * DDS phase increment word for a frequency in Hz.
+ *******************************************************************************/
+static inline uint32_t axi_dac_dds_incr(struct axi_dac *dac, uint32_t freq_hz)
+{
+	uint64_t val64;
+
+	val64 = (uint64_t) freq_hz * 0xFFFFULL;
+	val64 = val64 / dac->clock_hz;
+
+	return AXI_DAC_DDS_INCR(val64) | 1;
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_dds_init
+ * DDS initial phase word for a phase in milli degrees.
+ *******************************************************************************/
+static inline uint32_t axi_dac_dds_init(uint32_t phase)
+{
+	uint64_t val64;
+
+	val64 = (uint64_t) phase * 0x10000ULL + (360000 / 2);
+	val64 = val64 / 360000;
+
+	return AXI_DAC_DDS_INIT(val64);
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_dds_scale_reg
+ * DDS scale word, signed magnitude, for a scale in micro units.
+ *******************************************************************************/
+static inline uint32_t axi_dac_dds_scale_reg(int32_t scale_micro_units)
+{
+	uint32_t scale_reg;
+
+	scale_reg = scale_micro_units;
+	if (scale_micro_units < 0)
+		scale_reg = scale_micro_units * -1;
+	if (scale_reg >= 1999000)
+		scale_reg = 1999000;
+	scale_reg = (uint32_t)(((uint64_t)scale_reg * 0x4000) / 1000000);
+	if (scale_micro_units < 0)
+		scale_reg = scale_reg | 0x8000;
+
+	return AXI_DAC_DDS_SCALE(scale_reg);
+}
+
 /***************************************************************************//**
  * @brief dds_set_frequency
  *
@@ -388,14 +440,11 @@ int32_t axi_dac_set_datasel(struct axi_dac *dac,
 int32_t axi_dac_dds_set_frequency(struct axi_dac *dac,
 				  uint32_t chan, uint32_t freq_hz)
 {
-	uint64_t val64;
 	uint32_t reg;
 
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
 	axi_dac_read(dac, AXI_DAC_REG_DDS_INIT_INCR(chan), &reg);
-	val64 = (uint64_t) freq_hz * 0xFFFFULL;
-	val64 = val64 / dac->clock_hz;
-	reg = (reg & ~AXI_DAC_DDS_INCR(~0)) | AXI_DAC_DDS_INCR(val64) | 1;
+	reg = (reg & ~AXI_DAC_DDS_INCR(~0)) | axi_dac_dds_incr(dac, freq_hz);
 	axi_dac_write(dac, AXI_DAC_REG_DDS_INIT_INCR(chan), reg);
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
 
@@ -432,14 +481,11 @@ int32_t axi_dac_dds_get_frequency(struct axi_dac *dac,
 int32_t axi_dac_dds_set_phase(struct axi_dac *dac,
 			      uint32_t chan, uint32_t phase)
 {
-	uint64_t val64;
 	uint32_t reg;
 
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
 	axi_dac_read(dac, AXI_DAC_REG_DDS_INIT_INCR(chan), &reg);
-	val64 = (uint64_t) phase * 0x10000ULL + (360000 / 2);
-	val64 = val64 / 360000;
-	reg = (reg & ~AXI_DAC_DDS_INIT(~0)) | AXI_DAC_DDS_INIT(val64);
+	reg = (reg & ~AXI_DAC_DDS_INIT(~0)) | axi_dac_dds_init(phase);
 	axi_dac_write(dac, AXI_DAC_REG_DDS_INIT_INCR(chan), reg);
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
 
@@ -478,20 +524,9 @@ int32_t axi_dac_dds_set_scale(struct axi_dac *dac,
 			      uint32_t chan,
 			      int32_t scale_micro_units)
 {
-	uint32_t scale_reg;
-
-	scale_reg = scale_micro_units;
-	if (scale_micro_units < 0)
-		scale_reg = scale_micro_units * -1;
-	if (scale_reg >= 1999000)
-		scale_reg = 1999000;
-	scale_reg = (uint32_t)(((uint64_t)scale_reg * 0x4000) / 1000000);
-	if (scale_micro_units < 0)
-		scale_reg = scale_reg | 0x8000;
-
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
 	axi_dac_write(dac, AXI_DAC_REG_DDS_SCALE(chan),
-		      AXI_DAC_DDS_SCALE(scale_reg));
+		      axi_dac_dds_scale_reg(scale_micro_units));
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
 
 	return SUCCESS;
@@ -522,6 +557,72 @@ int32_t axi_dac_dds_get_scale(struct axi_dac *dac,
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief axi_dac_dds_prepare
+ * Compute the register words of a set of tones, to be written by
+ * axi_dac_dds_apply(). Can be done ahead of time, e.g. for a hopping table.
+ *******************************************************************************/
+void axi_dac_dds_prepare(struct axi_dac *dac,
+			 const struct axi_dac_dds_tone *tones,
+			 struct axi_dac_dds_words *words,
+			 uint32_t num_tones)
+{
+	uint32_t i;
+
+	for (i = 0; i < num_tones; i++) {
+		words[i].chan = (tones[i].chan * 2) + tones[i].tone;
+		words[i].init_incr = axi_dac_dds_init(tones[i].phase) |
+				     axi_dac_dds_incr(dac, tones[i].freq_hz);
+		words[i].scale = axi_dac_dds_scale_reg(tones[i].scale);
+	}
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_dds_apply
+ * Write the words of a set of tones with a single sync, so that all the tones
+ * start together, phase coherent.
+ *******************************************************************************/
+int32_t axi_dac_dds_apply(struct axi_dac *dac,
+			  const struct axi_dac_dds_words *words,
+			  uint32_t num_tones)
+{
+	uint32_t i;
+
+	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
+	for (i = 0; i < num_tones; i++) {
+		axi_dac_write(dac, AXI_DAC_REG_DDS_INIT_INCR(words[i].chan),
+			      words[i].init_incr);
+		axi_dac_write(dac, AXI_DAC_REG_DDS_SCALE(words[i].chan),
+			      words[i].scale);
+	}
+	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_dds_set_tones
+ * Configure a set of tones with a single sync: no register read back and
+ * two register writes per tone.
+ *******************************************************************************/
+int32_t axi_dac_dds_set_tones(struct axi_dac *dac,
+			      const struct axi_dac_dds_tone *tones,
+			      uint32_t num_tones)
+{
+	struct axi_dac_dds_words *words;
+	int32_t ret;
+
+	words = (struct axi_dac_dds_words *)calloc(num_tones, sizeof(*words));
+	if (!words)
+		return FAILURE;
+
+	axi_dac_dds_prepare(dac, tones, words, num_tones);
+	ret = axi_dac_dds_apply(dac, words, num_tones);
+	free(words);
+
+	return ret;
+}
+
 /***************************************************************************//**
  * @brief dds_to_signed_mag_fmt
 *******************************************************************************/
@@ -683,61 +784,94 @@ int32_t axi_dac_dds_get_calib_phase(struct axi_dac *dac,
 	return axi_dac_dds_get_calib_phase_scale(dac, 1, chan, val, val2);
 }
 
+/***************************************************************************//**
+ * @brief axi_dac_write_buf
+ * Generate the words of a DAC buffer in the descriptor staging buffer and
+ * copy them to memory in blocks, instead of one bus access per word. The
+ * buffer range stays mapped and the data cache is flushed once, for the
+ * whole buffer.
+ *******************************************************************************/
+static int32_t axi_dac_write_buf(struct axi_dac *dac,
+				 uint32_t address,
+				 uint32_t num_words,
+				 void (*fill)(const void *ctx, uint32_t *words,
+					      uint32_t first, uint32_t count),
+				 const void *ctx)
+{
+	uint32_t index;
+	uint32_t count;
+	int32_t ret = SUCCESS;
+
+	if (axi_io_map(address, num_words * sizeof(uint32_t)) != SUCCESS)
+		return FAILURE;
+
+	for (index = 0; index < num_words; index += count) {
+		count = min_t(uint32_t, num_words - index, AXI_DAC_STAGE_WORDS);
+		fill(ctx, dac->stage, index, count);
+		ret = axi_io_write_buf(address, index * sizeof(uint32_t),
+				       dac->stage, count);
+		if (ret != SUCCESS)
+			break;
+	}
+
+	axi_io_unmap(address);
+	if (ret != SUCCESS)
+		return FAILURE;
+
+	if (dac->dcache_flush_range)
+		dac->dcache_flush_range(address, num_words * sizeof(uint32_t));
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_fill_sine_lut
+ * Word i of the sine buffer: I from the table, Q a quarter period later. With
+ * four channels every sample is sent on both channel pairs.
+ *******************************************************************************/
+static void axi_dac_fill_sine_lut(const void *ctx,
+				  uint32_t *words,
+				  uint32_t first,
+				  uint32_t count)
+{
+	const struct axi_dac *dac = ctx;
+	uint32_t tx_count = ARRAY_SIZE(sine_lut);
+	uint32_t index;
+	uint32_t index_i;
+	uint32_t index_q;
+
+	for (index = first; index < first + count; index++) {
+		if (dac->num_channels == 4) {
+			index_i = index / 2;
+			index_q = (index_i + tx_count / 4) % tx_count;
+		} else {
+			index_i = index;
+			index_q = (index_i + tx_count / 4) % tx_count;
+		}
+		words[index - first] = (sine_lut[index_i] << 20) |
+				       (sine_lut[index_q] << 4);
+	}
+}
+
 /***************************************************************************//**
  * @brief axi_dac_set_sine_lut
+ * Returns the length of the buffer in bytes, 0 if it could not be written.
 *******************************************************************************/
 uint32_t axi_dac_set_sine_lut(struct axi_dac *dac,
 			      uint32_t address)
 {
 	uint32_t length;
 	uint32_t tx_count;
-	uint32_t index_mem;
-	uint32_t index;
-	uint32_t index_i1;
-	uint32_t index_q1;
-	uint32_t index_i2;
-	uint32_t index_q2;
-	uint32_t data_i1;
-	uint32_t data_q1;
-	uint32_t data_i2;
-	uint32_t data_q2;
+	uint32_t num_words;
+	int32_t ret;
+
 	tx_count = sizeof(sine_lut) / sizeof(uint16_t);
-	if(dac->num_channels == 4) {
-		for(index = 0, index_mem = 0; index < (tx_count * 2);
-		    index += 2, index_mem += 2) {
-			index_i1 = index;
-			index_q1 = index + (tx_count / 2);
-			if(index_q1 >= (tx_count * 2))
-				index_q1 -= (tx_count * 2);
-			data_i1 = (sine_lut[index_i1 / 2] << 20);
-			data_q1 = (sine_lut[index_q1 / 2] << 4);
-
-			axi_io_write(address, index_mem * 4, data_i1 | data_q1);
-
-			index_i2 = index_i1;
-			index_q2 = index_q1;
-			if(index_i2 >= (tx_count * 2))
-				index_i2 -= (tx_count * 2);
-			if(index_q2 >= (tx_count * 2))
-				index_q2 -= (tx_count * 2);
-			data_i2 = (sine_lut[index_i2 / 2] << 20);
-			data_q2 = (sine_lut[index_q2 / 2] << 4);
-
-			axi_io_write(address, (index_mem + 1) * 4, data_i2 | data_q2);
+	num_words = (dac->num_channels == 4) ? tx_count * 2 : tx_count;
 
-		}
-	} else {
-		for(index = 0; index < tx_count; index += 1) {
-			index_i1 = index;
-			index_q1 = index + (tx_count / 4);
-			if(index_q1 >= tx_count)
-				index_q1 -= tx_count;
-			data_i1 = (sine_lut[index_i1] << 20);
-			data_q1 = (sine_lut[index_q1] << 4);
-
-			axi_io_write(address, index * 4, data_i1 | data_q1);
-		}
-	}
+	ret = axi_dac_write_buf(dac, address, num_words, axi_dac_fill_sine_lut,
+				dac);
+	if (ret != SUCCESS)
+		return 0;
 
 	length = tx_count * dac->num_channels * 2;
 	return length;
@@ -752,19 +886,78 @@ int32_t axi_dac_set_buff(struct axi_dac *dac,
 			 uint32_t buff_size)
 {
 	uint32_t index;
-	uint32_t data_i;
-	uint32_t data_q;
+	uint32_t count;
+	int32_t ret = SUCCESS;
 
-	for(index = 0; index < buff_size; index += 2) {
-		data_i = (buff[index]);
-		data_q = (buff[index + 1] << 16);
+	if (axi_io_map(address, buff_size * sizeof(uint16_t)) != SUCCESS)
+		return FAILURE;
 
-		axi_io_write(address, index * 2, data_i | data_q);
+	/* buff_size 16-bit samples, packed two per word */
+	for (index = 0; index < buff_size; index += count * 2) {
+		count = min_t(uint32_t, (buff_size - index + 1) / 2,
+			      AXI_DAC_STAGE_WORDS);
+		dac->stage[count - 1] = 0;
+		memcpy(dac->stage, buff + index,
+		       min_t(uint32_t, count * 2, buff_size - index) *
+		       sizeof(uint16_t));
+		ret = axi_io_write_buf(address, index * 2, dac->stage, count);
+		if (ret != SUCCESS)
+			break;
 	}
 
+	axi_io_unmap(address);
+	if (ret != SUCCESS)
+		return FAILURE;
+
+	if (dac->dcache_flush_range)
+		dac->dcache_flush_range(address, buff_size * sizeof(uint16_t));
+
 	return SUCCESS;
 }
 
+/**
+ * @struct axi_dac_replicate
+ * @brief Source of axi_dac_fill_replicate(): the same sample on all the
+ * channel pairs.
+ */
+struct axi_dac_replicate {
+	/** I/Q words, one per sample */
+	const uint32_t *iq;
+	/** I samples, used when iq is NULL */
+	const int16_t *i;
+	/** Q samples, used when iq is NULL */
+	const int16_t *q;
+	/** Number of channel pairs */
+	uint8_t num_tx_channels;
+};
+
+/***************************************************************************//**
+ * @brief axi_dac_fill_replicate
+ *******************************************************************************/
+static void axi_dac_fill_replicate(const void *ctx,
+				   uint32_t *words,
+				   uint32_t first,
+				   uint32_t count)
+{
+	const struct axi_dac_replicate *src = ctx;
+	uint32_t index;
+	uint32_t sample;
+
+	if (src->num_tx_channels == 1 && !src->iq) {
+		axi_dac_pack_iq(words, src->i + first, src->q + first, count);
+		return;
+	}
+
+	for (index = first; index < first + count; index++) {
+		sample = index / src->num_tx_channels;
+		if (src->iq)
+			words[index - first] = src->iq[sample];
+		else
+			axi_dac_pack_iq(&words[index - first], &src->i[sample],
+					&src->q[sample], 1);
+	}
+}
+
 /***************************************************************************//**
  * @brief axi_dac_load_custom_data
  *******************************************************************************/
@@ -773,20 +966,17 @@ int32_t axi_dac_load_custom_data(struct axi_dac *dac,
 				 uint32_t custom_tx_count,
 				 uint32_t address)
 {
-	uint32_t index, index_mem = 0;
+	struct axi_dac_replicate src = {
+		.iq = custom_data_iq,
+		.num_tx_channels = dac->num_channels / 2,
+	};
 	uint8_t chan;
-	uint8_t num_tx_channels = dac->num_channels / 2;
 
-	for(index = 0; index < custom_tx_count; index++) {
-		/* Send the same data on all the channels */
-		for (chan = 0; chan < num_tx_channels; chan++) {
-
-			axi_io_write(address, index_mem * sizeof(uint32_t),
-				     custom_data_iq[index]);
-
-			index_mem++;
-		}
-	}
+	/* Send the same data on all the channels */
+	if (axi_dac_write_buf(dac, address,
+			      custom_tx_count * src.num_tx_channels,
+			      axi_dac_fill_replicate, &src) != SUCCESS)
+		return FAILURE;
 
 	for (chan = 0; chan < dac->num_channels; chan++) {
 		axi_dac_write(dac, AXI_DAC_REG_DATA_SELECT((chan*2)+0), 0x2);
@@ -797,6 +987,49 @@ int32_t axi_dac_load_custom_data(struct axi_dac *dac,
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief axi_dac_pack_iq
+ * Interleave I and Q samples into DAC words, I in the low half. A plain loop
+ * over independent elements, which the compiler vectorizes.
+ *******************************************************************************/
+void axi_dac_pack_iq(uint32_t *restrict words,
+		     const int16_t *restrict i,
+		     const int16_t *restrict q,
+		     uint32_t num_samples)
+{
+	uint32_t index;
+
+	for (index = 0; index < num_samples; index++)
+		words[index] = (uint16_t)i[index] |
+			       ((uint32_t)(uint16_t)q[index] << 16);
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_load_waveform
+ * Load an I/Q waveform in the DAC buffer, the same on all the channel pairs,
+ * then switch all the channels to DMA with a single sync.
+ *******************************************************************************/
+int32_t axi_dac_load_waveform(struct axi_dac *dac,
+			      uint32_t address,
+			      const int16_t *i,
+			      const int16_t *q,
+			      uint32_t num_samples)
+{
+	struct axi_dac_replicate src = {
+		.i = i,
+		.q = q,
+		.num_tx_channels = max_t(uint8_t, dac->num_channels / 2, 1),
+	};
+
+	if (!i || !q || !num_samples)
+		return FAILURE;
+
+	if (axi_dac_write_buf(dac, address, num_samples * src.num_tx_channels,
+			      axi_dac_fill_replicate, &src) != SUCCESS)
+		return FAILURE;
+
+	return axi_dac_set_datasel(dac, -1, AXI_DAC_DATA_SEL_DMA);
+}
 
 /***************************************************************************//**
  * @brief axi_dac_init
@@ -817,6 +1050,10 @@ int32_t axi_dac_init(struct axi_dac **dac_core,
 	dac->base = init->base;
 	dac->num_channels = init->num_channels;
 	dac->channels = init->channels;
+	dac->dcache_flush_range = init->dcache_flush_range;
+	dac->stage = (uint32_t *)calloc(AXI_DAC_STAGE_WORDS, sizeof(uint32_t));
+	if (!dac->stage)
+		goto error;
 
 	axi_dac_write(dac, AXI_DAC_REG_RSTN, 0);
 	axi_dac_write(dac, AXI_DAC_REG_RSTN,
@@ -848,6 +1085,7 @@ int32_t axi_dac_init(struct axi_dac **dac_core,
 
 	return SUCCESS;
 error:
+	free(dac->stage);
 	free(dac);
 
 	return FAILURE;
@@ -856,36 +1094,40 @@ error:
 int32_t axi_dac_data_setup(struct axi_dac *dac)
 {
 	struct axi_dac_channel *chan;
+	struct axi_dac_dds_tone tones[2];
 	uint32_t i;
 
 	if(dac->channels) {
 		for (i = 0; i < dac->num_channels; i++) {
 			chan = &dac->channels[i];
 			if (chan->sel == AXI_DAC_DATA_SEL_DDS) {
-				axi_dac_dds_set_frequency(dac, ((i*2)+0), chan->dds_frequency_0);
-				axi_dac_dds_set_phase(dac, ((i*2)+0), chan->dds_phase_0);
-				axi_dac_dds_set_scale(dac, ((i*2)+0), chan->dds_scale_0);
-				if (chan->dds_dual_tone == 0) {
-					axi_dac_dds_set_frequency(dac, ((i*2)+1), chan->dds_frequency_0);
-					axi_dac_dds_set_phase(dac, ((i*2)+1), chan->dds_phase_0);
-					axi_dac_dds_set_scale(dac, ((i*2)+1), chan->dds_scale_0);
-				} else {
-					axi_dac_dds_set_frequency(dac, ((i*2)+1), chan->dds_frequency_1);
-					axi_dac_dds_set_phase(dac, ((i*2)+1), chan->dds_phase_1);
-					axi_dac_dds_set_scale(dac, ((i*2)+1), chan->dds_scale_1);
+				tones[0].chan = i;
+				tones[0].tone = 0;
+				tones[0].freq_hz = chan->dds_frequency_0;
+				tones[0].phase = chan->dds_phase_0;
+				tones[0].scale = chan->dds_scale_0;
+				tones[1] = tones[0];
+				tones[1].tone = 1;
+				if (chan->dds_dual_tone) {
+					tones[1].freq_hz = chan->dds_frequency_1;
+					tones[1].phase = chan->dds_phase_1;
+					tones[1].scale = chan->dds_scale_1;
 				}
+				axi_dac_dds_set_tones(dac, tones, 2);
 			}
 			axi_dac_write(dac, DAC_REG_DATA_PATTERN(i), chan->pat_data);
 			axi_dac_set_datasel(dac, i, chan->sel);
 		}
 	} else {
 		for (i = 0; i < dac->num_channels; i++) {
-			axi_dac_dds_set_frequency(dac, ((i*2)+0), 3*1000*1000);
-			axi_dac_dds_set_frequency(dac, ((i*2)+1), 3*1000*1000);
-			axi_dac_dds_set_phase(dac, ((i*2)+0), (i % 2) ? 0 : 90000);
-			axi_dac_dds_set_phase(dac, ((i*2)+1), (i % 2) ? 0 : 90000);
-			axi_dac_dds_set_scale(dac, ((i*2)+0), 50*1000);
-			axi_dac_dds_set_scale(dac, ((i*2)+1), 50*1000);
+			tones[0].chan = i;
+			tones[0].tone = 0;
+			tones[0].freq_hz = 3*1000*1000;
+			tones[0].phase = (i % 2) ? 0 : 90000;
+			tones[0].scale = 50*1000;
+			tones[1] = tones[0];
+			tones[1].tone = 1;
+			axi_dac_dds_set_tones(dac, tones, 2);
 			axi_dac_write(dac, AXI_DAC_REG_DATA_SELECT((i*2)+0), 0);
 			axi_dac_write(dac, AXI_DAC_REG_DATA_SELECT((i*2)+1), 0);
 		}
@@ -898,6 +1140,7 @@ int32_t axi_dac_data_setup(struct axi_dac *dac)
  *******************************************************************************/
 int32_t axi_dac_remove(struct axi_dac *dac)
 {
+	free(dac->stage);
 	free(dac);
 
 	return SUCCESS;
@@ -53,6 +53,9 @@ struct axi_dac {
 	uint8_t	num_channels;
 	uint64_t clock_hz;
 	struct axi_dac_channel *channels; //dac channels manual configuration
+	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/* words generated before being copied to the buffer memory */
+	uint32_t *stage;
 };
 
 struct axi_dac_init {
@@ -60,6 +63,8 @@ struct axi_dac_init {
 	uint32_t base;
 	uint8_t	num_channels;
 	struct axi_dac_channel *channels; //dac channels manual configuration
+	/* flush the data cache after loading a buffer, NULL if not needed */
+	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
 };
 
 enum axi_dac_data_sel {
@@ -75,6 +80,22 @@ enum axi_dac_data_sel {
 	AXI_DAC_DATA_SEL_PNXX,
 };
 
+/* one DDS tone of a batch update */
+struct axi_dac_dds_tone {
+	uint32_t chan;                  // dac channel
+	uint32_t tone;                  // 0 or 1
+	uint32_t freq_hz;               // in hz
+	uint32_t phase;                 // in milli angles
+	int32_t scale;                  // in micro units
+};
+
+/* register words of a tone, computed by axi_dac_dds_prepare() */
+struct axi_dac_dds_words {
+	uint32_t chan;                  // dds channel (chan * 2 + tone)
+	uint32_t init_incr;
+	uint32_t scale;
+};
+
 struct axi_dac_channel {
 	uint32_t dds_frequency_0;       // in hz (1000*1000 for MHz)
 	uint32_t dds_phase_0;           // in milli(?) angles (90*1000 for 90 degrees = pi/2)
@@ -110,6 +131,16 @@ int32_t axi_dac_dds_set_scale(struct axi_dac *dac,
 int32_t axi_dac_dds_get_scale(struct axi_dac *dac,
 			      uint32_t chan,
 			      int32_t *scale_micro_units);
+void axi_dac_dds_prepare(struct axi_dac *dac,
+			 const struct axi_dac_dds_tone *tones,
+			 struct axi_dac_dds_words *words,
+			 uint32_t num_tones);
+int32_t axi_dac_dds_apply(struct axi_dac *dac,
+			  const struct axi_dac_dds_words *words,
+			  uint32_t num_tones);
+int32_t axi_dac_dds_set_tones(struct axi_dac *dac,
+			      const struct axi_dac_dds_tone *tones,
+			      uint32_t num_tones);
 int32_t axi_dac_set_buff(struct axi_dac *dac,
 			 uint32_t address,
 			 uint16_t *buff,
@@ -136,6 +167,15 @@ int32_t axi_dac_load_custom_data(struct axi_dac *dac,
 				 const uint32_t *custom_data_iq,
 				 uint32_t custom_tx_count,
 				 uint32_t address);
+void axi_dac_pack_iq(uint32_t *words,
+		     const int16_t *i,
+		     const int16_t *q,
+		     uint32_t num_samples);
+int32_t axi_dac_load_waveform(struct axi_dac *dac,
+			      uint32_t address,
+			      const int16_t *i,
+			      const int16_t *q,
+			      uint32_t num_samples);
 int32_t axi_dac_data_setup(struct axi_dac *dac);
 
 #endif
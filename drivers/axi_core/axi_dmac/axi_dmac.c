@@ -72,23 +72,11 @@ int32_t axi_dmac_write(struct axi_dmac *dmac,
 }
 
 /***************************************************************************//**
- * @brief axi_dmac_transfer
+ * @brief axi_dmac_submit
  *******************************************************************************/
-int32_t axi_dmac_transfer(struct axi_dmac *dmac,
-			  uint32_t address, uint32_t size)
+static int32_t axi_dmac_submit(struct axi_dmac *dmac,
+			       uint32_t address, uint32_t size)
 {
-	uint32_t transfer_id;
-	uint32_t reg_val;
-
-	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
-	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
-
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
-
-	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &transfer_id);
-	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
-	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
-
 	switch (dmac->direction) {
 	case DMA_DEV_TO_MEM:
 		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
@@ -108,6 +96,30 @@ int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 
 	axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
 
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer
+ *******************************************************************************/
+int32_t axi_dmac_transfer(struct axi_dmac *dmac,
+			  uint32_t address, uint32_t size)
+{
+	uint32_t transfer_id;
+	uint32_t reg_val;
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &transfer_id);
+	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+
+	if (axi_dmac_submit(dmac, address, size) != SUCCESS)
+		return FAILURE;
+
 	if (dmac->flags & DMA_CYCLIC)
 		return SUCCESS;
 
@@ -130,6 +142,56 @@ int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_start
+ * Queue a transfer without waiting for it to complete, so that the next
+ * transfer can be queued while the current one is running. Waits only while
+ * the queue of the core is full.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
+				uint32_t address, uint32_t size,
+				uint32_t *transfer_id)
+{
+	uint32_t reg_val;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
+	if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
+		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+	}
+
+	/* Wait until the previous transfer is queued. */
+	do {
+		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
+	} while(reg_val == 1);
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, transfer_id);
+
+	return axi_dmac_submit(dmac, address, size);
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_done
+ * Check if a transfer queued by axi_dmac_transfer_start() is completed.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_done(struct axi_dmac *dmac,
+			       uint32_t transfer_id, bool *done)
+{
+	uint32_t reg_val;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
+	if (reg_val == 1) {
+		/* Not queued yet, the done bit may belong to an older transfer */
+		*done = false;
+		return SUCCESS;
+	}
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &reg_val);
+	*done = !!(reg_val & (1u << transfer_id));
+
+	return SUCCESS;
+}
+
 /***************************************************************************//**
  * @brief axi_dmac_init
  *******************************************************************************/
@@ -43,6 +43,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "util.h"
 
 /******************************************************************************/
@@ -68,6 +69,9 @@
 #define AXI_DMAC_REG_SRC_STRIDE		0x424
 #define AXI_DMAC_REG_TRANSFER_DONE	0x428
 
+/* Number of transfer IDs, i.e. transfers queued or in flight at once */
+#define AXI_DMAC_MAX_TRANSFERS		4
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -104,6 +108,11 @@ int32_t axi_dmac_write(struct axi_dmac *dmac, uint32_t reg_addr,
 		       uint32_t reg_data);
 int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 			  uint32_t address, uint32_t size);
+int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
+				uint32_t address, uint32_t size,
+				uint32_t *transfer_id);
+int32_t axi_dmac_transfer_done(struct axi_dmac *dmac,
+			       uint32_t transfer_id, bool *done);
 int32_t axi_dmac_init(struct axi_dmac **adc_core,
 		      const struct axi_dmac_init *init);
 int32_t axi_dmac_remove(struct axi_dmac *dmac);
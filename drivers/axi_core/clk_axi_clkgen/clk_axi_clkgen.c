@@ -99,6 +99,40 @@
 #define MMCM_REG_FILTER1			0x4e
 #define MMCM_REG_FILTER2			0x4f
 
+/* Rate dependent MMCM registers and the bits the rate settings own */
+static const struct {
+	uint32_t reg;
+	uint32_t mask;
+} axi_clkgen_mmcm_regs[AXI_CLKGEN_MMCM_NUM_REGS] = {
+	{ MMCM_REG_CLKOUT0_1, 0xefff },
+	{ MMCM_REG_CLKOUT0_2, 0x03ff },
+	{ MMCM_REG_CLKOUT1_1, 0xefff },
+	{ MMCM_REG_CLKOUT1_2, 0x03ff },
+	{ MMCM_REG_CLK_DIV, 0x3fff },
+	{ MMCM_REG_CLK_FB1, 0xefff },
+	{ MMCM_REG_CLK_FB2, 0x03ff },
+	{ MMCM_REG_LOCK1, 0x03ff },
+	{ MMCM_REG_LOCK2, 0x7fff },
+	{ MMCM_REG_LOCK3, 0x7fff },
+	{ MMCM_REG_FILTER1, 0x9900 },
+	{ MMCM_REG_FILTER2, 0x9900 },
+};
+
+enum axi_clkgen_mmcm_reg_idx {
+	AXI_CLKGEN_IDX_CLKOUT0_1,
+	AXI_CLKGEN_IDX_CLKOUT0_2,
+	AXI_CLKGEN_IDX_CLKOUT1_1,
+	AXI_CLKGEN_IDX_CLKOUT1_2,
+	AXI_CLKGEN_IDX_CLK_DIV,
+	AXI_CLKGEN_IDX_CLK_FB1,
+	AXI_CLKGEN_IDX_CLK_FB2,
+	AXI_CLKGEN_IDX_LOCK1,
+	AXI_CLKGEN_IDX_LOCK2,
+	AXI_CLKGEN_IDX_LOCK3,
+	AXI_CLKGEN_IDX_FILTER1,
+	AXI_CLKGEN_IDX_FILTER2,
+};
+
 static const uint32_t axi_clkgen_filter_table[] = {
 	0x01001990, 0x01001190, 0x01009890, 0x01001890,
 	0x01008890, 0x01009090, 0x01009090, 0x01009090,
@@ -312,6 +346,30 @@ static void axi_clkgen_setup_ranges(struct axi_clkgen *axi_clkgen,
 	}
 }
 
+/**
+ * @brief axi_clkgen_get_ranges
+ */
+static void axi_clkgen_get_ranges(struct axi_clkgen *axi_clkgen)
+{
+	uint32_t pcore_version;
+
+	if (axi_clkgen->ranges_valid)
+		return;
+
+	axi_clkgen->fpfd_min = 10000;
+	axi_clkgen->fpfd_max = 300000;
+	axi_clkgen->fvco_min = 600000;
+	axi_clkgen->fvco_max = 1200000;
+
+	axi_clkgen_read(axi_clkgen, AXI_REG_VERSION, &pcore_version);
+	if (AXI_PCORE_VER_MAJOR(pcore_version) > 0x04)
+		axi_clkgen_setup_ranges(axi_clkgen,
+					&axi_clkgen->fpfd_min, &axi_clkgen->fpfd_max,
+					&axi_clkgen->fvco_min, &axi_clkgen->fvco_max);
+
+	axi_clkgen->ranges_valid = true;
+}
+
 /**
  * @brief axi_clkgen_calc_params
  */
@@ -322,10 +380,10 @@ void axi_clkgen_calc_params(struct axi_clkgen *axi_clkgen,
 			    uint32_t *best_m,
 			    uint32_t *best_dout)
 {
-	uint32_t fpfd_min	= 10000;
-	uint32_t fpfd_max	= 300000;
-	uint32_t fvco_min	= 600000;
-	uint32_t fvco_max	= 1200000;
+	uint32_t fpfd_min;
+	uint32_t fpfd_max;
+	uint32_t fvco_min;
+	uint32_t fvco_max;
 	uint32_t	   d		= 0;
 	uint32_t	   d_min	= 0;
 	uint32_t	   d_max	= 0;
@@ -338,12 +396,12 @@ void axi_clkgen_calc_params(struct axi_clkgen *axi_clkgen,
 	uint32_t	   fvco		= 0;
 	int32_t		   f		= 0;
 	int32_t		   best_f	= 0;
-	uint32_t pcore_version;
 
-	axi_clkgen_read(axi_clkgen, AXI_REG_VERSION, &pcore_version);
-	if (AXI_PCORE_VER_MAJOR(pcore_version) > 0x04)
-		axi_clkgen_setup_ranges(axi_clkgen, &fpfd_min, &fpfd_max,
-					&fvco_min, &fvco_max);
+	axi_clkgen_get_ranges(axi_clkgen);
+	fpfd_min = axi_clkgen->fpfd_min;
+	fpfd_max = axi_clkgen->fpfd_max;
+	fvco_min = axi_clkgen->fvco_min;
+	fvco_max = axi_clkgen->fvco_max;
 
 	fin /= 1000;
 	fout /= 1000;
@@ -413,10 +471,11 @@ static void axi_clkgen_mmcm_enable(struct axi_clkgen *clkgen,
 }
 
 /**
- * @brief axi_clkgen_set_rate
+ * @brief axi_clkgen_build_image
  */
-int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
-			    uint32_t rate)
+static int32_t axi_clkgen_build_image(struct axi_clkgen *clkgen,
+				      uint32_t rate,
+				      struct axi_clkgen_rate_image *image)
 {
 	uint32_t d		 = 0;
 	uint32_t m		 = 0;
@@ -427,48 +486,148 @@ int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
 	uint32_t low	 = 0;
 	uint32_t filter  = 0;
 	uint32_t lock	 = 0;
-	uint32_t reg_val;
-
-	if (clkgen->parent_rate == 0 || rate == 0)
-		return 0;
+	uint32_t vals[AXI_CLKGEN_MMCM_NUM_REGS];
+	uint32_t i;
 
 	axi_clkgen_calc_params(clkgen, clkgen->parent_rate, rate, &d, &m, &dout);
 
 	if (d == 0 || dout == 0 || m == 0)
-		return 0;
+		return FAILURE;
+
+	image->d = d;
+	image->m = m;
+	image->dout = dout;
 
 	filter = axi_clkgen_lookup_filter(m - 1);
 	lock = axi_clkgen_lookup_lock(m - 1);
 
-	axi_clkgen_mmcm_enable(clkgen, 0);
-
 	axi_clkgen_calc_clk_params(dout, &low, &high, &edge, &nocount);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLKOUT0_1, (high << 6) | low, 0xefff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLKOUT0_2, (edge << 7) | (nocount << 6),
-			      0x03ff);
+	vals[AXI_CLKGEN_IDX_CLKOUT0_1] = (high << 6) | low;
+	vals[AXI_CLKGEN_IDX_CLKOUT0_2] = (edge << 7) | (nocount << 6);
 
 	dout *= 4;
 	axi_clkgen_calc_clk_params(dout, &low, &high, &edge, &nocount);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLKOUT1_1, (high << 6) | low, 0xefff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLKOUT1_2, (edge << 7) | (nocount << 6),
-			      0x03ff);
+	vals[AXI_CLKGEN_IDX_CLKOUT1_1] = (high << 6) | low;
+	vals[AXI_CLKGEN_IDX_CLKOUT1_2] = (edge << 7) | (nocount << 6);
 
 	axi_clkgen_calc_clk_params(d, &low, &high, &edge, &nocount);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLK_DIV,
-			      (edge << 13) | (nocount << 12) | (high << 6) | low, 0x3fff);
+	vals[AXI_CLKGEN_IDX_CLK_DIV] = (edge << 13) | (nocount << 12) |
+				       (high << 6) | low;
 
 	axi_clkgen_calc_clk_params(m, &low, &high, &edge, &nocount);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLK_FB1, (high << 6) | low, 0xefff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_CLK_FB2, (edge << 7) | (nocount << 6),
-			      0x03ff);
-
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_LOCK1, lock & 0x3ff, 0x3ff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_LOCK2,
-			      (((lock >> 16) & 0x1f) << 10) | 0x1, 0x7fff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_LOCK3,
-			      (((lock >> 24) & 0x1f) << 10) | 0x3e9, 0x7fff);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_FILTER1, filter >> 16, 0x9900);
-	axi_clkgen_mmcm_write(clkgen, MMCM_REG_FILTER2, filter, 0x9900);
+	vals[AXI_CLKGEN_IDX_CLK_FB1] = (high << 6) | low;
+	vals[AXI_CLKGEN_IDX_CLK_FB2] = (edge << 7) | (nocount << 6);
+
+	vals[AXI_CLKGEN_IDX_LOCK1] = lock & 0x3ff;
+	vals[AXI_CLKGEN_IDX_LOCK2] = (((lock >> 16) & 0x1f) << 10) | 0x1;
+	vals[AXI_CLKGEN_IDX_LOCK3] = (((lock >> 24) & 0x1f) << 10) | 0x3e9;
+	vals[AXI_CLKGEN_IDX_FILTER1] = filter >> 16;
+	vals[AXI_CLKGEN_IDX_FILTER2] = filter;
+
+	for (i = 0; i < AXI_CLKGEN_MMCM_NUM_REGS; i++)
+		image->regs[i] = vals[i] & axi_clkgen_mmcm_regs[i].mask;
+
+	image->parent_rate = clkgen->parent_rate;
+	image->rate = rate;
+	image->valid = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief axi_clkgen_get_image
+ *
+ * Return the cached register image for the requested rate, solving the
+ * dividers only on a cache miss.
+ */
+static struct axi_clkgen_rate_image *axi_clkgen_get_image(
+	struct axi_clkgen *clkgen, uint32_t rate)
+{
+	struct axi_clkgen_rate_image *image;
+	uint32_t i;
+
+	for (i = 0; i < AXI_CLKGEN_RATE_CACHE_SIZE; i++) {
+		image = &clkgen->cache[i];
+		if (image->valid && image->rate == rate &&
+		    image->parent_rate == clkgen->parent_rate)
+			return image;
+	}
+
+	image = &clkgen->cache[clkgen->cache_next];
+	image->valid = false;
+	if (axi_clkgen_build_image(clkgen, rate, image) != SUCCESS)
+		return NULL;
+
+	clkgen->cache_next = (clkgen->cache_next + 1) %
+			     AXI_CLKGEN_RATE_CACHE_SIZE;
+
+	return image;
+}
+
+/**
+ * @brief axi_clkgen_write_image
+ *
+ * The bits outside the rate fields never change, so they are read back
+ * once and every later rate switch is a plain sequence of DRP writes.
+ */
+static void axi_clkgen_write_image(struct axi_clkgen *clkgen,
+				   const struct axi_clkgen_rate_image *image)
+{
+	uint32_t reg_val;
+	uint32_t i;
+
+	if (!clkgen->preserved_valid) {
+		for (i = 0; i < AXI_CLKGEN_MMCM_NUM_REGS; i++) {
+			axi_clkgen_mmcm_read(clkgen, axi_clkgen_mmcm_regs[i].reg,
+					     &reg_val);
+			clkgen->preserved[i] = reg_val & ~axi_clkgen_mmcm_regs[i].mask;
+		}
+		clkgen->preserved_valid = true;
+	}
+
+	for (i = 0; i < AXI_CLKGEN_MMCM_NUM_REGS; i++)
+		axi_clkgen_mmcm_write(clkgen, axi_clkgen_mmcm_regs[i].reg,
+				      clkgen->preserved[i] | image->regs[i],
+				      0xffff);
+}
+
+/**
+ * @brief axi_clkgen_prepare_rate
+ *
+ * Solve and cache the MMCM settings for a rate ahead of time so that a
+ * later axi_clkgen_set_rate() to it only has to write the registers.
+ */
+int32_t axi_clkgen_prepare_rate(struct axi_clkgen *clkgen,
+				uint32_t rate)
+{
+	if (clkgen->parent_rate == 0 || rate == 0)
+		return FAILURE;
+
+	if (!axi_clkgen_get_image(clkgen, rate))
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief axi_clkgen_set_rate
+ */
+int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
+			    uint32_t rate)
+{
+	struct axi_clkgen_rate_image *image;
+	uint32_t reg_val;
+
+	if (clkgen->parent_rate == 0 || rate == 0)
+		return 0;
+
+	image = axi_clkgen_get_image(clkgen, rate);
+	if (!image)
+		return 0;
+
+	axi_clkgen_mmcm_enable(clkgen, 0);
+
+	axi_clkgen_write_image(clkgen, image);
 
 	axi_clkgen_mmcm_enable(clkgen, 1);
 
@@ -526,7 +685,7 @@ int32_t axi_clkgen_init(struct axi_clkgen **clk,
 {
 	struct axi_clkgen *clkgen;
 
-	clkgen = (struct axi_clkgen *)malloc(sizeof(*clkgen));
+	clkgen = (struct axi_clkgen *)calloc(1, sizeof(*clkgen));
 	if (!clkgen)
 		return FAILURE;
 
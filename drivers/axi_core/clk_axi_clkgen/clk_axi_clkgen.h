@@ -43,14 +43,48 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define AXI_CLKGEN_MMCM_NUM_REGS	12
+#define AXI_CLKGEN_RATE_CACHE_SIZE	4
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
+/**
+ * @struct axi_clkgen_rate_image
+ * @brief Solved dividers and MMCM register image for one output rate.
+ */
+struct axi_clkgen_rate_image {
+	bool		valid;
+	uint32_t	parent_rate;
+	uint32_t	rate;
+	uint32_t	d;
+	uint32_t	m;
+	uint32_t	dout;
+	/** Field values of the rate dependent MMCM registers (already masked) */
+	uint16_t	regs[AXI_CLKGEN_MMCM_NUM_REGS];
+};
+
 struct axi_clkgen {
 	const char	*name;
 	uint32_t	base;
 	uint32_t	parent_rate;
+	/** PFD/VCO limits read from the core once */
+	bool		ranges_valid;
+	uint32_t	fpfd_min;
+	uint32_t	fpfd_max;
+	uint32_t	fvco_min;
+	uint32_t	fvco_max;
+	/** MMCM register bits not owned by the rate settings */
+	bool		preserved_valid;
+	uint16_t	preserved[AXI_CLKGEN_MMCM_NUM_REGS];
+	/** Recently solved rates, replaced round robin */
+	struct axi_clkgen_rate_image	cache[AXI_CLKGEN_RATE_CACHE_SIZE];
+	uint32_t	cache_next;
 };
 
 struct axi_clkgen_init {
@@ -64,6 +98,7 @@ struct axi_clkgen_init {
 /******************************************************************************/
 int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen, uint32_t rate);
 int32_t axi_clkgen_get_rate(struct axi_clkgen *clkgen, uint32_t *rate);
+int32_t axi_clkgen_prepare_rate(struct axi_clkgen *clkgen, uint32_t rate);
 int32_t axi_clkgen_init(struct axi_clkgen **clk,
 			const struct axi_clkgen_init *init);
 int32_t axi_clkgen_remove(struct axi_clkgen *clkgen);
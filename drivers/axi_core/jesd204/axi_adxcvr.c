@@ -81,10 +81,9 @@
 #define ADXCVR_DRP_PORT_ADDR_COMMON		0x00
 #define ADXCVR_DRP_PORT_ADDR_CHANNEL	0x20
 
-#define ADXCVR_DRP_PORT_COMMON(x)		(x)
-#define ADXCVR_DRP_PORT_CHANNEL(x)		(0x100 + (x))
-
-#define ADXCVR_BROADCAST				0xff
+/* Busy polls issued back to back before falling back to 1 ms sleeps */
+#define ADXCVR_DRP_SPIN_COUNT		256
+#define ADXCVR_DRP_TIMEOUT_MS		20
 
 /**
  * @brief adxcvr_write
@@ -117,15 +116,28 @@ int32_t adxcvr_drp_wait_idle(struct adxcvr *xcvr,
 			     uint32_t drp_addr)
 {
 	uint32_t val;
-	int32_t timeout = 20;
-
-	do {
+	uint32_t spin = ADXCVR_DRP_SPIN_COUNT;
+	int32_t timeout = ADXCVR_DRP_TIMEOUT_MS;
+
+	/*
+	 * A DRP access completes within a few DRP clock cycles, so poll
+	 * without sleeping first and only back off when the port is stuck.
+	 */
+	while (true) {
 		adxcvr_read(xcvr, ADXCVR_REG_DRP_STATUS(drp_addr), &val);
 		if (!(val & ADXCVR_DRP_STATUS_BUSY))
 			return ADXCVR_DRP_STATUS_RDATA(val);
 
+		if (spin) {
+			spin--;
+			continue;
+		}
+
+		if (!timeout--)
+			break;
+
 		mdelay(1);
-	} while (timeout--);
+	}
 
 	printf("%s: %s: Timeout!", xcvr->name, __func__);
 
@@ -200,6 +212,7 @@ int32_t adxcvr_clk_set_rate(struct adxcvr *xcvr,
 {
 	struct xilinx_xcvr_cpll_config cpll_conf;
 	struct xilinx_xcvr_qpll_config qpll_conf;
+	uint32_t drp_port = ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST);
 	uint32_t out_div, clk25_div;
 	uint32_t i;
 	int32_t ret;
@@ -215,47 +228,47 @@ int32_t adxcvr_clk_set_rate(struct adxcvr *xcvr,
 	if (ret < 0)
 		return ret;
 
-	for (i = 0; i < xcvr->num_lanes; i++) {
-
-		if (xcvr->cpll_enable)
-			ret = xilinx_xcvr_cpll_write_config(&xcvr->xlx_xcvr,
-							    ADXCVR_DRP_PORT_CHANNEL(i),
-							    &cpll_conf);
-		else if (i % 4 == 0)
+	if (xcvr->cpll_enable) {
+		ret = xilinx_xcvr_cpll_write_config(&xcvr->xlx_xcvr, drp_port,
+						    &cpll_conf);
+		if (ret < 0)
+			return ret;
+	} else {
+		for (i = 0; i < xcvr->num_lanes; i += 4) {
 			ret = xilinx_xcvr_qpll_write_config(&xcvr->xlx_xcvr,
 							    ADXCVR_DRP_PORT_COMMON(i),
 							    &qpll_conf);
-		if (ret < 0)
-			return ret;
-
-		ret = xilinx_xcvr_write_out_div(&xcvr->xlx_xcvr,
-						ADXCVR_DRP_PORT_CHANNEL(i),
-						xcvr->tx_enable ? -1 : (int32_t)out_div,
-						xcvr->tx_enable ? (int32_t)out_div : -1);
-		if (ret < 0)
-			return ret;
-
-		if (!xcvr->tx_enable) {
-			ret = xilinx_xcvr_configure_cdr(&xcvr->xlx_xcvr,
-							ADXCVR_DRP_PORT_CHANNEL(i),
-							rate, out_div,
-							xcvr->lpm_enable);
 			if (ret < 0)
 				return ret;
-
-			ret = xilinx_xcvr_write_rx_clk25_div(&xcvr->xlx_xcvr,
-							     ADXCVR_DRP_PORT_CHANNEL(i),
-							     clk25_div);
-		} else {
-			ret = xilinx_xcvr_write_tx_clk25_div(&xcvr->xlx_xcvr,
-							     ADXCVR_DRP_PORT_CHANNEL(i),
-							     clk25_div);
 		}
+	}
 
+	/*
+	 * All lanes run at the same rate, so the channel settings are issued
+	 * once on the broadcast port and verified on every lane.
+	 */
+	ret = xilinx_xcvr_write_out_div(&xcvr->xlx_xcvr, drp_port,
+					xcvr->tx_enable ? -1 : (int32_t)out_div,
+					xcvr->tx_enable ? (int32_t)out_div : -1);
+	if (ret < 0)
+		return ret;
+
+	if (!xcvr->tx_enable) {
+		ret = xilinx_xcvr_configure_cdr(&xcvr->xlx_xcvr, drp_port,
+						rate, out_div,
+						xcvr->lpm_enable);
 		if (ret < 0)
 			return ret;
+
+		ret = xilinx_xcvr_write_rx_clk25_div(&xcvr->xlx_xcvr, drp_port,
+						     clk25_div);
+	} else {
+		ret = xilinx_xcvr_write_tx_clk25_div(&xcvr->xlx_xcvr, drp_port,
+						     clk25_div);
 	}
 
+	if (ret < 0)
+		return ret;
 
 	xcvr->lane_rate_khz = rate;
 
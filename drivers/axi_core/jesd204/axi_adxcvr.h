@@ -46,6 +46,14 @@
 #include <stdbool.h>
 #include "xilinx_transceiver.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define ADXCVR_DRP_PORT_COMMON(x)		(x)
+#define ADXCVR_DRP_PORT_CHANNEL(x)		(0x100 + (x))
+
+#define ADXCVR_BROADCAST				0xff
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -217,6 +217,42 @@ int32_t axi_jesd204_rx_get_lane_errors(struct axi_jesd204_rx *jesd,
 	return axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_ERRORS(lane), errors);
 }
 
+/**
+ * @brief axi_jesd204_rx_get_link_state
+ */
+int32_t axi_jesd204_rx_get_link_state(struct axi_jesd204_rx *jesd,
+				      uint32_t *link_disabled,
+				      uint32_t *link_status)
+{
+	axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATE, link_disabled);
+
+	return axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATUS,
+				   link_status);
+}
+
+/**
+ * @brief axi_jesd204_rx_get_lane_status
+ */
+int32_t axi_jesd204_rx_get_lane_status(struct axi_jesd204_rx *jesd,
+				       uint32_t lane, uint32_t *status)
+{
+	return axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_STATUS(lane), status);
+}
+
+/**
+ * @brief axi_jesd204_rx_get_lane_ilas
+ */
+int32_t axi_jesd204_rx_get_lane_ilas(struct axi_jesd204_rx *jesd,
+				     uint32_t lane, uint32_t *ilas)
+{
+	uint32_t i;
+
+	for (i = 0; i < 4; i++)
+		axi_jesd204_rx_read(jesd, JESD204_RX_REG_ILAS(lane, i), &ilas[i]);
+
+	return SUCCESS;
+}
+
 /**
  * @brief axi_jesd204_rx_laneinfo_read
  */
@@ -81,6 +81,15 @@ struct jesd204_rx_init {
 int32_t axi_jesd204_rx_lane_clk_enable(struct axi_jesd204_rx *jesd);
 int32_t axi_jesd204_rx_lane_clk_disable(struct axi_jesd204_rx *jesd);
 uint32_t axi_jesd204_rx_status_read(struct axi_jesd204_rx *jesd);
+int32_t axi_jesd204_rx_get_link_state(struct axi_jesd204_rx *jesd,
+				      uint32_t *link_disabled,
+				      uint32_t *link_status);
+int32_t axi_jesd204_rx_get_lane_status(struct axi_jesd204_rx *jesd,
+				       uint32_t lane, uint32_t *status);
+int32_t axi_jesd204_rx_get_lane_errors(struct axi_jesd204_rx *jesd,
+				       uint32_t lane, uint32_t *errors);
+int32_t axi_jesd204_rx_get_lane_ilas(struct axi_jesd204_rx *jesd,
+				     uint32_t lane, uint32_t *ilas);
 int32_t axi_jesd204_rx_laneinfo_read(struct axi_jesd204_rx *jesd,
 				     uint32_t lane);
 int32_t axi_jesd204_rx_watchdog(struct axi_jesd204_rx *jesd);
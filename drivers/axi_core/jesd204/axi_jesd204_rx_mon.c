@@ -0,0 +1,306 @@
+/***************************************************************************//**
+ *   @file   axi_jesd204_rx_mon.c
+ *   @brief  Link health monitor for the AXI-JESD204-RX peripheral.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "axi_jesd204_rx_mon.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define JESD204_RX_LINK_STATUS_DATA	3
+#define JESD204_RX_LANE_STATUS_CGS(x)	((x) & 0x3)
+#define JESD204_RX_LANE_STATUS_ILAS	BIT(5)
+
+/* ILAS fields that must be identical on all lanes (LID and FCHK excluded) */
+#define JESD204_RX_ILAS1_MASK		0xFFFFFFE0
+#define JESD204_RX_ILAS3_MASK		0x00FFFFFF
+#define JESD204_RX_ILAS1_F(x)		((((x) >> 16) & 0xff) + 1)
+#define JESD204_RX_ILAS1_K(x)		((((x) >> 24) & 0x1f) + 1)
+
+#define PCORE_VERSION_MINOR(x)		(((x) >> 8) & 0xff)
+
+/* Keep the compiler from moving the ring accesses past the sequence updates */
+#if defined(__GNUC__)
+#define jesd204_rx_mon_barrier()	__asm__ __volatile__("" ::: "memory")
+#else
+#define jesd204_rx_mon_barrier()
+#endif
+
+/******************************************************************************/
+/************************** Functions Implementation **************************/
+/******************************************************************************/
+
+/**
+ * @brief Check the ILAS configuration of the lanes against the link
+ *        configuration and against the first lane that completed ILAS.
+ */
+static uint32_t jesd204_rx_mon_check_ilas(struct jesd204_rx_mon *mon,
+		const struct jesd204_rx_mon_snapshot *snap)
+{
+	struct jesd204_rx_config *config = &mon->jesd->config;
+	uint32_t ref[4], ilas[4];
+	uint32_t mismatch = 0;
+	bool have_ref = false;
+	uint32_t i;
+
+	for (i = 0; i < mon->num_lanes; i++) {
+		if (!(snap->lane_status[i] & JESD204_RX_LANE_STATUS_ILAS))
+			continue;
+
+		axi_jesd204_rx_get_lane_ilas(mon->jesd, i, ilas);
+
+		if ((JESD204_RX_ILAS1_F(ilas[1]) != config->octets_per_frame) ||
+		    (JESD204_RX_ILAS1_K(ilas[1]) != config->frames_per_multiframe))
+			mismatch |= BIT(i);
+
+		if (!have_ref) {
+			memcpy(ref, ilas, sizeof(ref));
+			have_ref = true;
+			continue;
+		}
+
+		if ((ilas[0] != ref[0]) ||
+		    ((ilas[1] & JESD204_RX_ILAS1_MASK) !=
+		     (ref[1] & JESD204_RX_ILAS1_MASK)) ||
+		    (ilas[2] != ref[2]) ||
+		    ((ilas[3] & JESD204_RX_ILAS3_MASK) !=
+		     (ref[3] & JESD204_RX_ILAS3_MASK)))
+			mismatch |= BIT(i);
+	}
+
+	return mismatch;
+}
+
+/**
+ * @brief Sample the link status into the next snapshot of the ring and
+ *        restart the link if needed. The restart does not block: the link is
+ *        disabled for restart_ticks samples, then enabled again. The link is
+ *        also restarted if it does not reach DATA within data_timeout samples
+ *        of being enabled.
+ *        Meant to be called periodically, e.g. from a timer interrupt.
+ */
+int32_t jesd204_rx_mon_sample(struct jesd204_rx_mon *mon)
+{
+	struct jesd204_rx_mon_snapshot *snap;
+	uint32_t new_errors = 0;
+	bool has_errors;
+	uint32_t i;
+
+	if (!mon)
+		return FAILURE;
+
+	mon->update_seq++;
+	jesd204_rx_mon_barrier();
+
+	snap = &mon->ring[mon->head];
+	snap->seq = mon->seq++;
+	snap->flags = 0;
+	snap->ilas_mismatch = 0;
+
+	if (mon->restart_countdown) {
+		if (--mon->restart_countdown == 0)
+			axi_jesd204_rx_lane_clk_enable(mon->jesd);
+		snap->flags |= JESD204_RX_MON_RESTART;
+	}
+
+	axi_jesd204_rx_get_link_state(mon->jesd, &snap->link_disabled,
+				      &snap->link_status);
+
+	has_errors = PCORE_VERSION_MINOR(mon->jesd->version) >= 2;
+	for (i = 0; i < mon->num_lanes; i++) {
+		axi_jesd204_rx_get_lane_status(mon->jesd, i,
+					       &snap->lane_status[i]);
+		snap->lane_errors[i] = 0;
+		if (!has_errors)
+			continue;
+
+		axi_jesd204_rx_get_lane_errors(mon->jesd, i,
+					       &snap->lane_errors[i]);
+		/* The counters are cleared when the link is restarted */
+		if (snap->lane_errors[i] >= mon->last_errors[i])
+			new_errors += snap->lane_errors[i] - mon->last_errors[i];
+		else
+			new_errors += snap->lane_errors[i];
+		mon->last_errors[i] = snap->lane_errors[i];
+	}
+
+	if (!snap->link_disabled &&
+	    (snap->link_status == JESD204_RX_LINK_STATUS_DATA)) {
+		mon->link_up = true;
+		mon->data_wait = 0;
+
+		for (i = 0; i < mon->num_lanes; i++)
+			if (JESD204_RX_LANE_STATUS_CGS(snap->lane_status[i]) == 0)
+				snap->flags |= JESD204_RX_MON_LANE_DESYNC;
+
+		if (mon->error_threshold && (new_errors >= mon->error_threshold))
+			snap->flags |= JESD204_RX_MON_ERR_THRESHOLD;
+
+		snap->ilas_mismatch = jesd204_rx_mon_check_ilas(mon, snap);
+		if (snap->ilas_mismatch)
+			snap->flags |= JESD204_RX_MON_ILAS_MISMATCH;
+	} else if (!mon->restart_countdown) {
+		if (mon->link_up)
+			mon->link_drops++;
+		mon->link_up = false;
+		snap->flags |= JESD204_RX_MON_LINK_DOWN;
+
+		/* Only count while the link is enabled and trying to sync */
+		if (!snap->link_disabled && mon->data_timeout &&
+		    (++mon->data_wait >= mon->data_timeout))
+			snap->flags |= JESD204_RX_MON_DATA_TIMEOUT;
+	}
+
+	if (!mon->restart_countdown &&
+	    (snap->flags & (JESD204_RX_MON_LANE_DESYNC |
+			    JESD204_RX_MON_ERR_THRESHOLD |
+			    JESD204_RX_MON_DATA_TIMEOUT))) {
+		axi_jesd204_rx_lane_clk_disable(mon->jesd);
+		mon->restart_countdown = max_t(uint32_t, mon->restart_ticks, 1);
+		mon->restarts++;
+		mon->link_up = false;
+		mon->data_wait = 0;
+		snap->flags |= JESD204_RX_MON_RESTART;
+	}
+
+	mon->head = (mon->head + 1) % mon->nb_snapshots;
+	if (mon->count < mon->nb_snapshots)
+		mon->count++;
+
+	jesd204_rx_mon_barrier();
+	mon->update_seq++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief IRQ handler wrapper of jesd204_rx_mon_sample(), to be registered on
+ *        a periodic timer interrupt.
+ */
+void jesd204_rx_mon_irq_handler(void *mon)
+{
+	jesd204_rx_mon_sample(mon);
+}
+
+/**
+ * @brief Get a snapshot from the ring. Index 0 is the most recent one.
+ *        The copy is retried if the sampler ran while it was taken, so the
+ *        snapshot is never a mix of two samples.
+ */
+int32_t jesd204_rx_mon_get_snapshot(struct jesd204_rx_mon *mon, uint32_t idx,
+				    struct jesd204_rx_mon_snapshot *snapshot)
+{
+	uint32_t pos, seq;
+
+	if (!mon || !snapshot)
+		return FAILURE;
+
+	do {
+		seq = mon->update_seq;
+		jesd204_rx_mon_barrier();
+		if (seq & 1)
+			continue;
+
+		if (idx >= mon->count)
+			return FAILURE;
+
+		pos = (mon->head + mon->nb_snapshots - 1 - idx) %
+		      mon->nb_snapshots;
+		*snapshot = mon->ring[pos];
+
+		jesd204_rx_mon_barrier();
+	} while ((seq & 1) || (seq != mon->update_seq));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief jesd204_rx_mon_init
+ */
+int32_t jesd204_rx_mon_init(struct jesd204_rx_mon **mon,
+			    const struct jesd204_rx_mon_init *init)
+{
+	struct jesd204_rx_mon *m;
+
+	if (!init || !init->jesd || !init->nb_snapshots)
+		return FAILURE;
+
+	m = (struct jesd204_rx_mon *)calloc(1, sizeof(*m));
+	if (!m)
+		return FAILURE;
+
+	m->ring = (struct jesd204_rx_mon_snapshot *)calloc(init->nb_snapshots,
+			sizeof(*m->ring));
+	if (!m->ring) {
+		free(m);
+		return FAILURE;
+	}
+
+	m->jesd = init->jesd;
+	m->num_lanes = min_t(uint32_t, init->jesd->num_lanes,
+			     JESD204_RX_MON_MAX_LANES);
+	m->nb_snapshots = init->nb_snapshots;
+	m->error_threshold = init->error_threshold;
+	m->restart_ticks = init->restart_ticks;
+	m->data_timeout = init->data_timeout;
+
+	*mon = m;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief jesd204_rx_mon_remove
+ */
+int32_t jesd204_rx_mon_remove(struct jesd204_rx_mon *mon)
+{
+	if (!mon)
+		return FAILURE;
+
+	free(mon->ring);
+	free(mon);
+
+	return SUCCESS;
+}
@@ -0,0 +1,126 @@
+/***************************************************************************//**
+ *   @file   axi_jesd204_rx_mon.h
+ *   @brief  Link health monitor for the AXI-JESD204-RX peripheral.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef AXI_JESD204_RX_MON_H_
+#define AXI_JESD204_RX_MON_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "util.h"
+#include "axi_jesd204_rx.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define JESD204_RX_MON_MAX_LANES	8
+
+/* Snapshot flags */
+#define JESD204_RX_MON_LINK_DOWN	BIT(0)
+#define JESD204_RX_MON_LANE_DESYNC	BIT(1)
+#define JESD204_RX_MON_ERR_THRESHOLD	BIT(2)
+#define JESD204_RX_MON_ILAS_MISMATCH	BIT(3)
+#define JESD204_RX_MON_RESTART		BIT(4)
+#define JESD204_RX_MON_DATA_TIMEOUT	BIT(5)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+struct jesd204_rx_mon_snapshot {
+	/* Sample number */
+	uint32_t seq;
+	/* JESD204_RX_MON_* flags */
+	uint32_t flags;
+	uint32_t link_disabled;
+	uint32_t link_status;
+	uint32_t lane_status[JESD204_RX_MON_MAX_LANES];
+	/* Lane error counters, as read from the core */
+	uint32_t lane_errors[JESD204_RX_MON_MAX_LANES];
+	/* Lanes whose ILAS configuration differs from the expected one */
+	uint32_t ilas_mismatch;
+};
+
+struct jesd204_rx_mon {
+	struct axi_jesd204_rx *jesd;
+	uint32_t num_lanes;
+	/* Snapshot ring */
+	struct jesd204_rx_mon_snapshot *ring;
+	uint32_t nb_snapshots;
+	uint32_t head;
+	uint32_t count;
+	uint32_t seq;
+	/* Odd while the sampler updates the ring */
+	volatile uint32_t update_seq;
+	/* Restart policy */
+	uint32_t error_threshold;
+	uint32_t restart_ticks;
+	uint32_t restart_countdown;
+	uint32_t data_timeout;
+	uint32_t data_wait;
+	/* Statistics */
+	uint32_t restarts;
+	uint32_t link_drops;
+	uint32_t last_errors[JESD204_RX_MON_MAX_LANES];
+	bool link_up;
+};
+
+struct jesd204_rx_mon_init {
+	struct axi_jesd204_rx *jesd;
+	/* Number of snapshots kept in the ring */
+	uint32_t nb_snapshots;
+	/* New lane errors per sample that trigger a restart (0 to disable) */
+	uint32_t error_threshold;
+	/* Samples during which the link is kept disabled on restart */
+	uint32_t restart_ticks;
+	/* Samples from link enable to DATA that trigger a restart (0 to disable) */
+	uint32_t data_timeout;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+int32_t jesd204_rx_mon_init(struct jesd204_rx_mon **mon,
+			    const struct jesd204_rx_mon_init *init);
+int32_t jesd204_rx_mon_remove(struct jesd204_rx_mon *mon);
+int32_t jesd204_rx_mon_sample(struct jesd204_rx_mon *mon);
+void jesd204_rx_mon_irq_handler(void *mon);
+int32_t jesd204_rx_mon_get_snapshot(struct jesd204_rx_mon *mon, uint32_t idx,
+				    struct jesd204_rx_mon_snapshot *snapshot);
+#endif
@@ -125,6 +125,14 @@ int32_t xilinx_xcvr_read(struct xilinx_xcvr *xcvr, uint32_t drp_port,
 	return adxcvr_drp_read(xcvr->ad_xcvr, drp_port, reg_addr, reg_val);
 }
 
+/**
+ * @brief xilinx_xcvr_drp_is_broadcast
+ */
+static bool xilinx_xcvr_drp_is_broadcast(uint32_t drp_port)
+{
+	return drp_port == ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST);
+}
+
 /**
  * @brief xilinx_xcvr_drp_read
  */
@@ -133,6 +141,10 @@ int32_t xilinx_xcvr_drp_read(struct xilinx_xcvr *xcvr,
 {
 	int32_t ret;
 
+	/* Lanes are kept in sync, so a broadcast read returns the first one */
+	if (xilinx_xcvr_drp_is_broadcast(drp_port))
+		drp_port = ADXCVR_DRP_PORT_CHANNEL(0);
+
 	ret = xilinx_xcvr_read(xcvr, drp_port, reg, val);
 
 	if (ret < 0) {
@@ -145,13 +157,46 @@ int32_t xilinx_xcvr_drp_read(struct xilinx_xcvr *xcvr,
 	return ret;
 }
 
+/**
+ * @brief xilinx_xcvr_drp_verify
+ *
+ * Read back a register from every channel a write went to. A broadcast
+ * write is checked on each lane in a single pass after the write.
+ */
+static int32_t xilinx_xcvr_drp_verify(struct xilinx_xcvr *xcvr,
+				      uint32_t drp_port, uint32_t reg, uint32_t val)
+{
+	uint32_t read_val;
+	uint32_t i, first, last;
+	int32_t ret;
+
+	if (xilinx_xcvr_drp_is_broadcast(drp_port)) {
+		first = ADXCVR_DRP_PORT_CHANNEL(0);
+		last = ADXCVR_DRP_PORT_CHANNEL(xcvr->ad_xcvr->num_lanes);
+	} else {
+		first = drp_port;
+		last = drp_port + 1;
+	}
+
+	for (i = first; i < last; i++) {
+		ret = xilinx_xcvr_drp_read(xcvr, i, reg, &read_val);
+		if (ret < 0)
+			return ret;
+		if (read_val != val)
+			printf("%s: read-write mismatch: port %"PRIu32", reg 0x%"PRIX32","
+			       "val 0x%4"PRIX32", expected val 0x%4"PRIX32"\n",
+			       __func__, i, reg, read_val, val);
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief xilinx_xcvr_drp_write
  */
 int32_t xilinx_xcvr_drp_write(struct xilinx_xcvr *xcvr,
 			      uint32_t drp_port, uint32_t reg, uint32_t val)
 {
-	uint32_t read_val;
 	int32_t ret;
 
 	ret = xilinx_xcvr_write(xcvr, drp_port, reg, val);
@@ -161,15 +206,63 @@ int32_t xilinx_xcvr_drp_write(struct xilinx_xcvr *xcvr,
 		return ret;
 	}
 
-	xilinx_xcvr_drp_read(xcvr, drp_port, reg, &read_val);
-	if (read_val != val)
-		printf("%s: read-write mismatch: reg 0x%"PRIX32","
-		       "val 0x%4"PRIX32", expected val 0x%4"PRIX32"\n",
-		       __func__, reg, val, read_val);
+	xilinx_xcvr_drp_verify(xcvr, drp_port, reg, val);
 
 	return SUCCESS;
 }
 
+/**
+ * @brief xilinx_xcvr_drp_update_broadcast
+ *
+ * Read-modify-write the same register on all channels. When every lane
+ * holds the same value (the usual case) the merged value goes out as a
+ * single broadcast write, or not at all if nothing changes. Lanes that
+ * diverge fall back to individual read-modify-write accesses.
+ */
+static int32_t xilinx_xcvr_drp_update_broadcast(struct xilinx_xcvr *xcvr,
+		uint32_t reg, uint32_t mask, uint32_t val)
+{
+	uint32_t num_lanes = xcvr->ad_xcvr->num_lanes;
+	uint32_t read_val, lane0_val = 0;
+	bool uniform = true;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < num_lanes; i++) {
+		ret = xilinx_xcvr_drp_read(xcvr, ADXCVR_DRP_PORT_CHANNEL(i),
+					   reg, &read_val);
+		if (ret < 0)
+			return ret;
+		if (i == 0)
+			lane0_val = read_val;
+		else if (read_val != lane0_val)
+			uniform = false;
+	}
+
+	if (!uniform) {
+		for (i = 0; i < num_lanes; i++) {
+			ret = xilinx_xcvr_drp_read(xcvr, ADXCVR_DRP_PORT_CHANNEL(i),
+						   reg, &read_val);
+			if (ret < 0)
+				return ret;
+			ret = xilinx_xcvr_drp_write(xcvr, ADXCVR_DRP_PORT_CHANNEL(i),
+						    reg, val | (read_val & ~mask));
+			if (ret < 0)
+				return ret;
+		}
+
+		return SUCCESS;
+	}
+
+	val |= lane0_val & ~mask;
+	if (val == lane0_val)
+		return SUCCESS;
+
+	return xilinx_xcvr_drp_write(xcvr,
+				     ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+				     reg, val);
+}
+
 /**
  * @brief xilinx_xcvr_drp_update
  */
@@ -179,6 +272,9 @@ int32_t xilinx_xcvr_drp_update(struct xilinx_xcvr *xcvr, uint32_t drp_port,
 	uint32_t read_val;
 	int32_t ret;
 
+	if (xilinx_xcvr_drp_is_broadcast(drp_port))
+		return xilinx_xcvr_drp_update_broadcast(xcvr, reg, mask, val);
+
 	ret = xilinx_xcvr_drp_read(xcvr, drp_port, reg, &read_val);
 	if (ret < 0)
 		return ret;
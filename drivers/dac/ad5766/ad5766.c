@@ -281,6 +281,73 @@ int32_t ad5766_set_dac_reg_all(struct ad5766_dev *dev,
 				    data);
 }
 
+/**
+ * Update the selected channels together. The codes are loaded in the input
+ * registers and, if requested, transferred to the outputs by a single
+ * software LDAC. The commands are packed in one buffer and sent back to
+ * back, one SYNC frame each.
+ * @param dev - The device structure.
+ * @param ch_mask - The selected channels.
+ *		    Accepted values: AD5766_LDAC(x) | AD5766_LDAC(y) | ...
+ * @param data - One code per selected channel, lowest channel first.
+ * @param ldac - Update the outputs once all the input registers are loaded.
+ *		 When false, the outputs are updated later by a software or
+ *		 hardware LDAC.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad5766_set_dac_batch(struct ad5766_dev *dev,
+			     uint16_t ch_mask,
+			     const uint16_t *data,
+			     bool ldac)
+{
+	uint8_t buf[(AD5766_NUM_CHANNELS + 1) * 3];
+	uint8_t nb_frames = 0;
+	uint8_t cmd_reg;
+	uint8_t i;
+	int32_t ret = 0;
+
+	if (!dev || !data || !ch_mask)
+		return FAILURE;
+
+	/* Same code on all the channels: one write to all DAC registers */
+	if (ch_mask == 0xFFFF && ldac) {
+		for (i = 1; i < AD5766_NUM_CHANNELS; i++)
+			if (data[i] != data[0])
+				break;
+		if (i == AD5766_NUM_CHANNELS)
+			return ad5766_set_dac_reg_all(dev, data[0]);
+	}
+
+	/* A single channel is written directly to its DAC register */
+	cmd_reg = ldac && !(ch_mask & (ch_mask - 1)) ?
+		  AD5766_CMD_WR_DAC_REG(0) : AD5766_CMD_WR_IN_REG(0);
+
+	for (i = 0; i < AD5766_NUM_CHANNELS; i++) {
+		if (!(ch_mask & AD5766_LDAC(i)))
+			continue;
+		buf[nb_frames * 3] = cmd_reg | i;
+		buf[nb_frames * 3 + 1] = (*data & 0xFF00) >> 8;
+		buf[nb_frames * 3 + 2] = (*data & 0x00FF) >> 0;
+		data++;
+		nb_frames++;
+	}
+
+	if (ldac && cmd_reg == AD5766_CMD_WR_IN_REG(0)) {
+		buf[nb_frames * 3] = AD5766_CMD_SW_LDAC;
+		buf[nb_frames * 3 + 1] = (ch_mask & 0xFF00) >> 8;
+		buf[nb_frames * 3 + 2] = (ch_mask & 0x00FF) >> 0;
+		nb_frames++;
+	}
+
+	for (i = 0; i < nb_frames; i++) {
+		ret = spi_write_and_read(dev->spi_desc, &buf[i * 3], 3);
+		if (ret)
+			return ret;
+	}
+
+	return ret;
+}
+
 /**
  * Initialize the device.
  * @param device - The device structure.
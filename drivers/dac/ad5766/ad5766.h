@@ -43,6 +43,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "delay.h"
 #include "gpio.h"
 #include "spi.h"
@@ -67,6 +68,8 @@
 #define AD5766_CMD_DITHER_SCALE_1	0xC0
 #define AD5766_CMD_DITHER_SCALE_2	0xD0
 
+#define AD5766_NUM_CHANNELS		16
+
 /* AD5766_CMD_SDO_CNTRL */
 #define AD5766_SDO_EN			(1 << 0)
 
@@ -209,6 +212,11 @@ int32_t ad5766_set_dac_reg(struct ad5766_dev *dev,
 /* Set the DAC register for all channels. */
 int32_t ad5766_set_dac_reg_all(struct ad5766_dev *dev,
 			       uint16_t data);
+/* Update the selected channels together. */
+int32_t ad5766_set_dac_batch(struct ad5766_dev *dev,
+			     uint16_t ch_mask,
+			     const uint16_t *data,
+			     bool ldac);
 /* Initialize the device. */
 int32_t ad5766_init(struct ad5766_dev **device,
 		    struct ad5766_init_param init_param);
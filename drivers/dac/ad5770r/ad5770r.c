@@ -420,6 +420,7 @@ int32_t ad5770r_set_dac_value(struct ad5770r_dev *dev,
 			      uint16_t dac_value, enum ad5770r_channels channel)
 {
 	uint8_t data[2];
+	int32_t ret;
 
 	if (!dev)
 		return FAILURE;
@@ -427,9 +428,15 @@ int32_t ad5770r_set_dac_value(struct ad5770r_dev *dev,
 	data[1] = (uint8_t)AD5770R_CH_DAC_DATA_LSB(dac_value);
 	data[0] = (uint8_t)((dac_value & 0x3FC0) >> 6);
 
-	return ad5770r_spi_reg_write_multiple(dev,
-					      AD5770R_CH0_DAC_MSB + 2 * channel,
-					      data, sizeof(data));
+	ret = ad5770r_spi_reg_write_multiple(dev,
+					     AD5770R_CH0_DAC_MSB + 2 * channel,
+					     data, sizeof(data));
+	if (ret)
+		return ret;
+
+	dev->dac_value[channel] = dac_value;
+
+	return ret;
 };
 
 /**
@@ -443,6 +450,7 @@ int32_t ad5770r_set_dac_input(struct ad5770r_dev *dev,
 			      uint16_t dac_input, enum ad5770r_channels channel)
 {
 	uint8_t data[2];
+	int32_t ret;
 
 	if (!dev)
 		return FAILURE;
@@ -450,12 +458,97 @@ int32_t ad5770r_set_dac_input(struct ad5770r_dev *dev,
 	data[1] = (uint8_t)AD5770R_CH_DAC_DATA_LSB(dac_input);
 	data[0] = (uint8_t)((dac_input & 0x3FC0) >> 6);
 
-	return ad5770r_spi_reg_write_multiple(dev,
-					      AD5770R_CH0_INPUT_MSB + 2 * channel,
-					      data, sizeof(data));
+	ret = ad5770r_spi_reg_write_multiple(dev,
+					     AD5770R_CH0_INPUT_MSB + 2 * channel,
+					     data, sizeof(data));
+	if (ret)
+		return ret;
+
+	dev->input_value[channel] = dac_input;
 
+	return ret;
 };
 
+/**
+ * Set the input value of several channels and optionally update their
+ * outputs together. With descending addresses and streaming enabled, the
+ * input registers from the highest selected channel down to CH0 and the
+ * SW_LDAC register, which follows them, are written in a single transfer.
+ * Channels inside that range which are not selected are rewritten with
+ * their last input value. Otherwise every channel is written separately.
+ * @param dev - The device structure.
+ * @param ch_mask - The selected channels, bit x for channel x.
+ * @param dac_input - One value per selected channel, lowest channel first.
+ * @param ldac - Update the selected outputs once the inputs are loaded.
+ *		 When false, the outputs are updated later by a software or
+ *		 hardware LDAC.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad5770r_set_dac_input_batch(struct ad5770r_dev *dev,
+				    uint8_t ch_mask,
+				    const uint16_t *dac_input,
+				    bool ldac)
+{
+	uint8_t buf[1 + 2 * AD5770R_NUM_CHANNELS + 1];
+	uint16_t value[AD5770R_NUM_CHANNELS];
+	uint8_t len = 1;
+	int8_t first = -1;
+	int8_t last = -1;
+	int8_t i;
+	int32_t ret;
+
+	if (!dev || !dac_input || !ch_mask ||
+	    ch_mask >= (1 << AD5770R_NUM_CHANNELS))
+		return FAILURE;
+
+	for (i = 0; i < AD5770R_NUM_CHANNELS; i++) {
+		if (ch_mask & BIT(i)) {
+			value[i] = *dac_input++;
+			if (first < 0)
+				first = i;
+			last = i;
+		} else {
+			value[i] = dev->input_value[i];
+		}
+	}
+
+	if (dev->dev_spi_settings.addr_ascension ||
+	    dev->dev_spi_settings.single_instruction ||
+	    dev->dev_spi_settings.stream_mode_length) {
+		for (i = first; i <= last; i++) {
+			if (!(ch_mask & BIT(i)))
+				continue;
+			ret = ad5770r_set_dac_input(dev, value[i], i);
+			if (ret)
+				return ret;
+		}
+
+		return ldac ? ad5770r_spi_reg_write(dev, AD5770R_SW_LDAC,
+						    ch_mask) : SUCCESS;
+	}
+
+	/* SW_LDAC is the next address after the CH0 input LSB */
+	if (ldac)
+		first = AD5770R_CH0;
+
+	buf[0] = AD5770R_REG_WRITE(AD5770R_CH0_INPUT_MSB + 2 * last);
+	for (i = last; i >= first; i--) {
+		buf[len++] = (uint8_t)((value[i] & 0x3FC0) >> 6);
+		buf[len++] = (uint8_t)AD5770R_CH_DAC_INPUT_DATA_LSB(value[i]);
+	}
+	if (ldac)
+		buf[len++] = ch_mask;
+
+	ret = spi_write_and_read(dev->spi_desc, buf, len);
+	if (ret)
+		return ret;
+
+	for (i = first; i <= last; i++)
+		dev->input_value[i] = value[i];
+
+	return ret;
+}
+
 /**
  * Set page mask for dac value and input.
  * @param dev - The device structure.
@@ -223,6 +223,8 @@
 /* AD5770R_CH_ENABLE */
 #define AD5770R_CH_ENABLE_SET(x, channel)			(((x) & 0x1) << (channel))
 
+#define AD5770R_NUM_CHANNELS				6
+
 #define AD5770R_REG_READ(x)					(((x) & 0x7F) | 0x80)
 #define AD5770R_REG_WRITE(x)					((x) & 0x7F)
 
@@ -384,6 +386,10 @@ int32_t ad5770r_set_dac_value(struct ad5770r_dev *dev,
 			      uint16_t dac_value, enum ad5770r_channels channel);
 int32_t ad5770r_set_dac_input(struct ad5770r_dev *dev,
 			      uint16_t dac_input, enum ad5770r_channels channel);
+int32_t ad5770r_set_dac_input_batch(struct ad5770r_dev *dev,
+				    uint8_t ch_mask,
+				    const uint16_t *dac_input,
+				    bool ldac);
 int32_t ad5770r_set_page_mask(struct ad5770r_dev *dev,
 			      const struct ad5770r_dac_page_mask *page_mask);
 int32_t ad5770r_set_mask_channel(struct ad5770r_dev *dev,
@@ -202,6 +202,71 @@ int32_t ad9523_vco_out_map(struct ad9523_dev *dev,
 	return ret;
 }
 
+/**
+ * @struct ad9523_readback_ctx
+ * @brief Readback condition checked by ad9523_wait_readback().
+ */
+struct ad9523_readback_ctx {
+	struct ad9523_dev *dev;
+	uint32_t reg_addr;
+	uint32_t mask;
+	uint32_t data;
+};
+
+/***************************************************************************//**
+ * @brief Check the readback condition of ad9523_wait_readback().
+ *
+ * @param ctx - The readback context.
+ * @param done - Set to true if the masked register value matches.
+ *
+ * @return Returns 0 in case of success or negative error code.
+ *******************************************************************************/
+static int32_t ad9523_readback_cond(void *ctx, bool *done)
+{
+	struct ad9523_readback_ctx *rb = ctx;
+	uint32_t reg_data;
+	int32_t ret;
+
+	ret = ad9523_spi_read(rb->dev, rb->reg_addr, &reg_data);
+	if (ret < 0)
+		return ret;
+
+	*done = ((reg_data & rb->mask) == rb->data);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Wait for a readback register to match the expected value.
+ *
+ * @param dev - The device structure.
+ * @param reg_addr - The address of the readback register.
+ * @param mask - The mask that is applied.
+ * @param data - The expected data.
+ *
+ * @return Returns 0 in case of success or negative error code.
+ *******************************************************************************/
+static int32_t ad9523_wait_readback(struct ad9523_dev *dev,
+				    uint32_t reg_addr,
+				    uint32_t mask,
+				    uint32_t data)
+{
+	struct ad9523_readback_ctx ctx = {
+		.dev = dev,
+		.reg_addr = reg_addr,
+		.mask = mask,
+		.data = data
+	};
+	struct wait_param param = {
+		.start_us = AD9523_POLL_START_US,
+		.max_step_us = AD9523_POLL_MAX_STEP_US,
+		.timeout_us = AD9523_POLL_TIMEOUT_US,
+		.stats = &dev->lock_stats
+	};
+
+	return wait_for_condition(&param, ad9523_readback_cond, &ctx);
+}
+
 /***************************************************************************//**
  * @brief Updates the AD9523 configuration.
  *
@@ -214,23 +279,13 @@ int32_t ad9523_vco_out_map(struct ad9523_dev *dev,
 int32_t ad9523_calibrate(struct ad9523_dev *dev)
 {
 	uint32_t reg_data;
-	uint32_t timeout;
 
 	ad9523_spi_write(dev,
 			 AD9523_PLL2_VCO_CTRL,
 			 AD9523_PLL2_VCO_CALIBRATE);
 	ad9523_io_update(dev);
 
-	timeout = 0;
-	while (timeout < 100) {
-		mdelay(1);
-		timeout = timeout + 1;
-		ad9523_spi_read(dev,
-				AD9523_READBACK_1,
-				&reg_data);
-		if ((reg_data & 0x1) == 0x0)
-			break;
-	}
+	ad9523_wait_readback(dev, AD9523_READBACK_1, 0x1, 0x0);
 	ad9523_spi_read(dev,
 			AD9523_READBACK_1,
 			&reg_data);
@@ -258,7 +313,6 @@ int32_t ad9523_status(struct ad9523_dev *dev)
 	int32_t ret;
 	uint32_t reg_data;
 	uint32_t status;
-	uint32_t timeout;
 
 	status = 0;
 
@@ -276,16 +330,10 @@ int32_t ad9523_status(struct ad9523_dev *dev)
 		status = status | AD9523_READBACK_0_STAT_PLL1_LD;
 	}
 
-	timeout = 0;
-	while (timeout < 100) {
-		mdelay(1);
-		timeout = timeout + 1;
-		ad9523_spi_read(dev,
-				AD9523_READBACK_0,
-				&reg_data);
-		if ((reg_data & status) == status)
-			break;
-	}
+	ad9523_wait_readback(dev, AD9523_READBACK_0, status, status);
+	ad9523_spi_read(dev,
+			AD9523_READBACK_0,
+			&reg_data);
 
 	ret = 0;
 	if ((reg_data & AD9523_READBACK_0_STAT_VCXO) != AD9523_READBACK_0_STAT_VCXO) {
@@ -443,6 +491,7 @@ int32_t ad9523_setup(struct ad9523_dev **device,
 		return ret;
 
 	dev->pdata = init_param->pdata;
+	wait_stats_reset(&dev->lock_stats);
 
 	ret = ad9523_spi_write(dev,
 			       AD9523_SERIAL_PORT_CONFIG,
@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include "delay.h"
 #include "spi.h"
+#include "wait.h"
 
 /******************************************************************************/
 /****************************** AD9523 ****************************************/
@@ -271,6 +272,11 @@
 #define AD9523_NUM_CHAN						14
 #define AD9523_NUM_CHAN_ALT_CLK_SRC				10
 
+/* Readback poll timing (us) */
+#define AD9523_POLL_START_US					10
+#define AD9523_POLL_MAX_STEP_US					1000
+#define AD9523_POLL_TIMEOUT_US					100000
+
 #define ARRAY_SIZE(ar) (sizeof(ar)/sizeof(ar[0]))
 
 /******************************************************************************/
@@ -482,6 +488,8 @@ struct ad9523_dev {
 	/* Device Settings */
 	struct ad9523_state		ad9523_st;
 	struct ad9523_platform_data	*pdata;
+	/* Statistics of the calibration and status polls */
+	struct wait_stats		lock_stats;
 };
 
 struct ad9523_init_param {
@@ -189,9 +189,48 @@ int32_t ad9528_spi_write_n(struct ad9528_dev *dev,
 	return ret;
 }
 
+/**
+ * @struct ad9528_poll_ctx
+ * @brief Register condition checked by ad9528_poll().
+ */
+struct ad9528_poll_ctx {
+	struct ad9528_dev *dev;
+	uint32_t reg_addr;
+	uint32_t mask;
+	uint32_t data;
+};
+
+/***************************************************************************//**
+ * @brief Check the register condition of ad9528_poll().
+ *
+ * @param ctx - The poll context.
+ * @param done - Set to true if the masked register value matches.
+ *
+ * @return Returns 0 in case of success or negative error code.
+*******************************************************************************/
+static int32_t ad9528_poll_cond(void *ctx, bool *done)
+{
+	struct ad9528_poll_ctx *poll = ctx;
+	uint32_t reg_data;
+	int32_t ret;
+
+	ret = ad9528_spi_read_n(poll->dev, poll->reg_addr, &reg_data);
+	if (ret < 0)
+		return ret;
+
+	*done = ((reg_data & poll->mask) == poll->data);
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Poll register.
  *
+ * The register is polled with an interval growing from
+ * AD9528_POLL_START_US to AD9528_POLL_MAX_STEP_US, for at most
+ * AD9528_POLL_TIMEOUT_US. The duration of each poll is recorded in the
+ * device lock statistics.
+ *
  * @param dev - The device structure.
  * @param reg_addr - The address of the register.
  * @param mask - The mask that is applied.
@@ -204,22 +243,20 @@ int32_t ad9528_poll(struct ad9528_dev *dev,
 		    uint32_t mask,
 		    uint32_t data)
 {
-	uint32_t reg_data;
-	uint8_t timeout = 100;
-	int32_t ret;
-
-	do {
-		ret = ad9528_spi_read_n(dev,
-					reg_addr,
-					&reg_data);
-		if (ret < 0)
-			return ret;
-		mdelay(1);
-	} while (((reg_data & mask) != data) && --timeout);
-
-	return timeout ? 0 : -1;
-
-	return 0;
+	struct ad9528_poll_ctx ctx = {
+		.dev = dev,
+		.reg_addr = reg_addr,
+		.mask = mask,
+		.data = data
+	};
+	struct wait_param param = {
+		.start_us = AD9528_POLL_START_US,
+		.max_step_us = AD9528_POLL_MAX_STEP_US,
+		.timeout_us = AD9528_POLL_TIMEOUT_US,
+		.stats = &dev->lock_stats
+	};
+
+	return wait_for_condition(&param, ad9528_poll_cond, &ctx);
 }
 
 /***************************************************************************//**
@@ -373,6 +410,7 @@ int32_t ad9528_setup(struct ad9528_dev **device,
 		return -1;
 
 	dev->pdata = init_param.pdata;
+	wait_stats_reset(&dev->lock_stats);
 
 	/* GPIO */
 	ret = gpio_get(&dev->gpio_resetb, &init_param.gpio_resetb);
@@ -47,6 +47,7 @@
 #include "delay.h"
 #include "spi.h"
 #include "gpio.h"
+#include "wait.h"
 
 /******************************************************************************/
 /****************************** AD9528 ****************************************/
@@ -253,6 +254,11 @@
 
 #define AD9528_SPI_MAGIC		0x00FF05
 
+/* Register poll timing (us) */
+#define AD9528_POLL_START_US		10
+#define AD9528_POLL_MAX_STEP_US		1000
+#define AD9528_POLL_TIMEOUT_US		100000
+
 /* Output Driver Mode */
 #define DRIVER_MODE_LVDS	0
 #define DRIVER_MODE_LVDS_BOOST	1
@@ -485,6 +491,8 @@ struct ad9528_dev {
 	/* Device Settings */
 	struct ad9528_state ad9528_st;
 	struct ad9528_platform_data *pdata;
+	/* Statistics of the register polls (lock, calibration) */
+	struct wait_stats lock_stats;
 };
 
 struct ad9528_init_param {
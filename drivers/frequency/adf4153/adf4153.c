@@ -81,6 +81,7 @@ int8_t adf4153_init(struct adf4153_dev **device,
 		return -1;
 
 	dev->adf4153_st = init_param.adf4153_st;
+	frac_pll_solver_reset(&dev->solver);
 
 	dev->adf4153_rfin_min_frq = 10000000;   // 10 Mhz
 	dev->adf4153_rfin_max_frq = 250000000;  // 250 Mhz
@@ -302,19 +303,17 @@ uint32_t adf4153_tune_rcounter(struct adf4153_dev *dev,
  * @param dev       - The device structure.
  * @param frequency - The desired frequency value.
  *
- * @return calculatedFrequency - The actual frequency value that was set.
+ * @return calculatedFrequency - The actual frequency value that was set, 0 if
+ *                               no divider setting was found.
 *******************************************************************************/
 uint64_t adf4153_set_frequency(struct adf4153_dev *dev,
 			       uint64_t frequency)
 {
+	struct frac_pll_cfg cfg;
+	struct frac_pll_result res;
 	uint64_t vco_frequency = 0;     // VCO frequency
-	uint32_t pfd_frequency = 0;     // PFD frequency
 	uint64_t calculated_frequency = 0;     // Actual VCO frequency
-	uint32_t int_value = 0;     // INT value
-	uint32_t frac_value = 0;     // FRAC value
 	uint32_t mod_value = 0;     // MOD value
-	uint16_t r_counter = 0;     // R Counter
-	float buffer = 0;
 	uint8_t device_prescaler = 0;
 	uint8_t int_min = 0;
 	/* validate the given frequency parameter */
@@ -332,35 +331,34 @@ uint64_t adf4153_set_frequency(struct adf4153_dev *dev,
 	mod_value = CEIL(dev->adf4153_st.ref_in,
 			 dev->adf4153_st.channel_spacing);
 	/* if the mod_value is too high, increase the channel spacing */
-	if(mod_value > dev->adf4153_mod_max) {
-		do {
-			dev->adf4153_st.channel_spacing++;
-			mod_value = CEIL(dev->adf4153_st.ref_in,
-					 dev->adf4153_st.channel_spacing);
-		} while(mod_value <= dev->adf4153_mod_max);
+	while(mod_value > dev->adf4153_mod_max) {
+		dev->adf4153_st.channel_spacing++;
+		mod_value = CEIL(dev->adf4153_st.ref_in,
+				 dev->adf4153_st.channel_spacing);
 	}
 	/* define prescaler */
 	device_prescaler = (vco_frequency <= FREQ_2_GHZ) ? ADF4153_PRESCALER_4_5 : \
 			   ADF4153_PRESCALER_8_9;
 	int_min = (device_prescaler == ADF4153_PRESCALER_4_5) ? 31 : 91;
-	/* define the PFD frequency, R counter ant INT value */
-	do {
-		/* define the PFD frequency and R Counter, using the TuneRCounter() */
-		pfd_frequency = adf4153_tune_rcounter(dev,
-						      &r_counter);
-		int_value = vco_frequency / pfd_frequency;
-	} while(int_value < int_min);
-	/*define FRAC value */
-	do {
-		frac_value++;
-		buffer = int_value + ((float)frac_value/mod_value);
-		calculated_frequency = (uint64_t)(buffer * pfd_frequency);
-	} while(calculated_frequency <= vco_frequency);
-	frac_value--;
+	/* define the PFD frequency, R counter, INT and FRAC values */
+	cfg.clkin = dev->adf4153_st.ref_in;
+	cfg.ref_doubler_en = (dev->r2 &
+			      ADF4153_R2_REF_DOUBLER(ADF4153_R2_RESYNC_MASK)) >>
+			     ADF4153_R2_REF_DOUBLER_OFFSET;
+	cfg.ref_div2_en = false;
+	cfg.r_cnt_init = 0;
+	cfg.max_r_cnt = ADF4153_R1_RCOUNTER_MASK;
+	cfg.max_fpfd = dev->adf4153_pfd_max_frq;
+	cfg.max_mod = dev->adf4153_mod_max;
+	cfg.fixed_mod = mod_value;
+	cfg.chspc_retry = false;
+	cfg.round_closest = false;
+	if (frac_pll_solve(&dev->solver, &cfg, 0, vco_frequency, int_min,
+			   &res) < 0)
+		return 0;
 
 	/* Find the actual VCO frequency. */
-	buffer = int_value + ((float)frac_value/mod_value);
-	calculated_frequency = (uint64_t)(buffer * pfd_frequency);
+	calculated_frequency = frac_pll_vco_freq(&res);
 
 	/* Enable the Counter Reset */
 	adf4153_update_latch(dev,
@@ -376,7 +374,7 @@ uint64_t adf4153_set_frequency(struct adf4153_dev *dev,
 			     ADF4153_CTRL_R_DIVIDER |
 			     dev->r1 |
 			     ADF4153_R1_MOD(mod_value) |
-			     ADF4153_R1_RCOUNTER(r_counter) |
+			     ADF4153_R1_RCOUNTER(res.r_cnt) |
 			     ADF4153_R1_PRESCALE(device_prescaler));
 
 	/* Load the N divider with the new values */
@@ -385,8 +383,8 @@ uint64_t adf4153_set_frequency(struct adf4153_dev *dev,
 	adf4153_update_latch(dev,
 			     ADF4153_CTRL_N_DIVIDER |
 			     dev->r0 |
-			     ADF4153_R0_FRAC(frac_value) |
-			     ADF4153_R0_INT(int_value));
+			     ADF4153_R0_FRAC(res.fract) |
+			     ADF4153_R0_INT(res.int_val));
 	/* Disable the Counter Reset */
 	dev->r2 &= ~ADF4153_R2_COUNTER_RST(ADF4153_R2_COUNTER_RST_MASK);
 	adf4153_update_latch(dev,
@@ -47,6 +47,7 @@
 #include <stdint.h>
 #include "gpio.h"
 #include "spi.h"
+#include "frac_pll.h"
 
 /*****************************************************************************/
 /*  Device specific MACROs                                                   */
@@ -357,6 +358,9 @@ struct adf4153_dev {
 	uint32_t r1;               /* the actual value of R Divider Register */
 	uint32_t r2;               /* the actual value of Control Register */
 	uint32_t r3;               /* the actual value of Noise and Spur Reg*/
+
+	/* Memoized R counter search */
+	struct frac_pll_solver solver;
 };
 
 struct adf4153_init_param {
@@ -44,6 +44,7 @@
 #include <stdlib.h>
 #include "adf4156.h"
 #include "adf4156_cfg.h"
+#include "frac_pll.h"
 
 /***************************************************************************//**
  * @brief Initialize the SPI communication with the device.
@@ -67,6 +68,9 @@ int8_t adf4156_init(struct adf4156_dev **device,
 	if (!dev)
 		return -1;
 
+	dev->adf4156_st.pdata = &adf4156_pdata_lpc;
+	frac_pll_solver_reset(&dev->adf4156_st.solver);
+
 	/* Setup GPIO pads */
 	status = gpio_get(&dev->gpio_le, &init_param.gpio_le);
 	status |= gpio_get(&dev->gpio_ce, &init_param.gpio_ce);
@@ -224,6 +228,31 @@ uint32_t gcd(uint32_t x, uint32_t y)
 	return x;
 }
 
+/***************************************************************************//**
+ * @brief Fills the solver configuration from the platform data.
+ *
+ * @param dev - The device structure.
+ * @param cfg - The solver configuration.
+ *
+ * @return None.
+*******************************************************************************/
+static void adf4156_solver_cfg(struct adf4156_dev *dev,
+			       struct frac_pll_cfg *cfg)
+{
+	struct adf4156_platform_data *pdata = dev->adf4156_st.pdata;
+
+	cfg->clkin = pdata->clkin;
+	cfg->ref_doubler_en = pdata->ref_doubler_en;
+	cfg->ref_div2_en = pdata->ref_div2_en;
+	cfg->r_cnt_init = 0;
+	cfg->max_r_cnt = ADF4156_MAX_R_CNT;
+	cfg->max_fpfd = ADF4156_MAX_FREQ_PFD;
+	cfg->max_mod = ADF4156_MAX_MODULUS;
+	cfg->fixed_mod = 0;
+	cfg->chspc_retry = false;
+	cfg->round_closest = true;
+}
+
 /***************************************************************************//**
  * @brief Sets the ADF4156 output frequency.
  *
@@ -235,10 +264,11 @@ uint32_t gcd(uint32_t x, uint32_t y)
 double adf4156_set_freq(struct adf4156_dev *dev,
 			double freq)
 {
-	uint64_t tmp;
-	uint32_t       div_gcd, prescaler, chspc;
+	struct frac_pll_cfg cfg;
+	struct frac_pll_result res;
+	uint32_t       prescaler, chspc;
 	uint16_t mdiv;
-	uint16_t r_cnt = 0;
+	int32_t ret;
 	double result;
 
 
@@ -261,35 +291,21 @@ double adf4156_set_freq(struct adf4156_dev *dev,
 		return -1;
 	}
 
-	do {
-		do {
-			r_cnt = adf4156_tune_r_cnt(dev, r_cnt);
-			dev->adf4156_st.r2_mod = \
-						 dev->adf4156_st.fpfd / chspc;
-			if (r_cnt > ADF4156_MAX_R_CNT) {
-				printf("Error! R-counter has a too high \
+	adf4156_solver_cfg(dev, &cfg);
+	ret = frac_pll_solve(&dev->adf4156_st.solver, &cfg, chspc,
+			     (uint64_t)freq, mdiv, &res);
+	if (ret < 0) {
+		printf("Error! R-counter has a too high \
 value for the selected spacing. Try with a higher spacing value.\r\n");
-				return -1;
-			}
-		} while ((dev->adf4156_st.r2_mod > ADF4156_MAX_MODULUS) && r_cnt);
-		dev->adf4156_st.r_cnt = r_cnt;
-		tmp = freq * (uint64_t)dev->adf4156_st.r2_mod + (dev->adf4156_st.fpfd >> 1);
-		tmp = (uint64_t)(tmp / dev->adf4156_st.fpfd);
-		dev->adf4156_st.r0_fract = tmp % dev->adf4156_st.r2_mod;
-		tmp = tmp / dev->adf4156_st.r2_mod;
-		dev->adf4156_st.r0_int = (uint32_t)tmp;
-	} while (mdiv > dev->adf4156_st.r0_int);
-
-	if (dev->adf4156_st.r0_fract && dev->adf4156_st.r2_mod) {
-		div_gcd = gcd(dev->adf4156_st.r2_mod,
-			      dev->adf4156_st.r0_fract);
-		dev->adf4156_st.r2_mod /= div_gcd;
-		dev->adf4156_st.r0_fract /= div_gcd;
-	} else {
-		dev->adf4156_st.r0_fract = 0;
-		dev->adf4156_st.r2_mod = 1;
+		return -1;
 	}
 
+	dev->adf4156_st.fpfd = res.fpfd;
+	dev->adf4156_st.r_cnt = res.r_cnt;
+	dev->adf4156_st.r0_int = res.int_val;
+	dev->adf4156_st.r0_fract = res.fract;
+	dev->adf4156_st.r2_mod = res.mod;
+
 	/* register R3 */
 	dev->adf4156_st.reg_val[ADF4156_REG3] &= ~(ADF4156_CNT_RST(-1));
 	dev->adf4156_st.reg_val[ADF4156_REG3] |= (ADF4156_CNT_RST(1));
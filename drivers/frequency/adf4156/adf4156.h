@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include "gpio.h"
 #include "spi.h"
+#include "frac_pll.h"
 
 /******************************************************************************/
 /********************* Macros and Constants Definitions ***********************/
@@ -205,6 +206,7 @@ struct adf4156_state {
 	uint32_t	r0_int;         /* Integer value */
 	uint32_t	r2_mod;         /* Modulus value */
 	uint32_t	reg_val[5];     /* Actual register value */
+	struct frac_pll_solver solver; /* Memoized R counter search */
 };
 
 struct adf4156_dev {
@@ -43,6 +43,7 @@
 #include <stdlib.h>
 #include "adf4157.h"
 #include "adf4157_cfg.h"
+#include "frac_pll.h"
 
 /***************************************************************************//**
  * @brief Initialize the SPI communication with the device.
@@ -66,6 +67,9 @@ int8_t adf4157_init(struct adf4157_dev **device,
 	if (!dev)
 		return -1;
 
+	dev->adf4157_st.pdata = &adf4157_pdata_lpc;
+	frac_pll_solver_reset(&dev->adf4157_st.solver);
+
 	/* Setup GPIO pads */
 	status = gpio_get(&dev->gpio_le, &init_param.gpio_le);
 	status |= gpio_get(&dev->gpio_ce, &init_param.gpio_ce);
@@ -221,6 +225,31 @@ uint32_t gcd(uint32_t x, uint32_t y)
 	return x;
 }
 
+/***************************************************************************//**
+ * @brief Fills the solver configuration from the platform data.
+ *
+ * @param dev - The device structure.
+ * @param cfg - The solver configuration.
+ *
+ * @return None.
+*******************************************************************************/
+static void adf4157_solver_cfg(struct adf4157_dev *dev,
+			       struct frac_pll_cfg *cfg)
+{
+	struct adf4157_platform_data *pdata = dev->adf4157_st.pdata;
+
+	cfg->clkin = pdata->clkin;
+	cfg->ref_doubler_en = pdata->ref_doubler_en;
+	cfg->ref_div2_en = pdata->ref_div2_en;
+	cfg->r_cnt_init = 0;
+	cfg->max_r_cnt = ADF4157_MAX_R_CNT;
+	cfg->max_fpfd = ADF4157_MAX_FREQ_PFD;
+	cfg->max_mod = ADF4157_FIXED_MODULUS;
+	cfg->fixed_mod = ADF4157_FIXED_MODULUS;
+	cfg->chspc_retry = false;
+	cfg->round_closest = true;
+}
+
 /***************************************************************************//**
  * @brief Sets the ADF4157 output frequency.
  *
@@ -232,11 +261,11 @@ uint32_t gcd(uint32_t x, uint32_t y)
 double adf4157_set_freq(struct adf4157_dev *dev,
 			double freq)
 {
-	uint64_t tmp;
+	struct frac_pll_cfg cfg;
+	struct frac_pll_result res;
 	uint32_t prescaler;
-	float chspc;
 	uint16_t mdiv;
-	uint16_t r_cnt = 0;
+	int32_t ret;
 	double result;
 
 	if ((freq > ADF4157_MAX_OUT_FREQ) || (freq < ADF4157_MIN_OUT_FREQ))
@@ -251,26 +280,24 @@ double adf4157_set_freq(struct adf4157_dev *dev,
 	}
 
 	freq *= 1000000;
-	dev->adf4157_st.r2_mod = ADF4157_FIXED_MODULUS;
 	if ((dev->adf4157_st.pdata->clkin > ADF4157_MAX_FREQ_REFIN) ||
 	    (dev->adf4157_st.pdata->clkin < ADF4157_MIN_FREQ_REFIN)) {
 		return -1;
 	}
-	do {
-		do {
-			r_cnt = adf4157_tune_r_cnt(dev,
-						   r_cnt);
-			chspc = (float)(dev->adf4157_st.fpfd) / dev->adf4157_st.r2_mod;
-		} while (r_cnt == 0);
-		dev->adf4157_st.r_cnt = r_cnt;
-		dev->adf4157_st.channel_spacing = chspc;
-
-		tmp = freq * (uint64_t)dev->adf4157_st.r2_mod + (dev->adf4157_st.fpfd >> 1);
-		tmp = (uint64_t)(tmp / dev->adf4157_st.fpfd);
-		dev->adf4157_st.r0_fract = tmp % dev->adf4157_st.r2_mod;
-		tmp = tmp / dev->adf4157_st.r2_mod;
-		dev->adf4157_st.r0_int = (uint32_t)tmp;
-	} while (mdiv > dev->adf4157_st.r0_int);
+
+	/* The modulus is fixed, so the channel spacing is not used */
+	adf4157_solver_cfg(dev, &cfg);
+	ret = frac_pll_solve(&dev->adf4157_st.solver, &cfg, 0,
+			     (uint64_t)freq, mdiv, &res);
+	if (ret < 0)
+		return -1;
+
+	dev->adf4157_st.fpfd = res.fpfd;
+	dev->adf4157_st.r_cnt = res.r_cnt;
+	dev->adf4157_st.r0_int = res.int_val;
+	dev->adf4157_st.r0_fract = res.fract;
+	dev->adf4157_st.r2_mod = res.mod;
+	dev->adf4157_st.channel_spacing = (float)res.fpfd / res.mod;
 
 	/* register R3 */
 	dev->adf4157_st.reg_val[ADF4157_REG3] &= ~(ADF4157_CNT_RST(-1));
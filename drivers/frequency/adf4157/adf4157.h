@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include "gpio.h"
 #include "spi.h"
+#include "frac_pll.h"
 
 /******************************************************************************/
 /********************* Macros and Constants Definitions ***********************/
@@ -199,6 +200,7 @@ struct adf4157_state {
 	uint32_t			r2_mod;             /* Modulus value */
 	float				channel_spacing;    /* Channel spacing */
 	uint32_t			reg_val[5];         /* Actual register value */
+	struct frac_pll_solver		solver;             /* Memoized R counter search */
 };
 
 struct adf4157_dev {
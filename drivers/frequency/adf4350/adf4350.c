@@ -98,6 +98,21 @@ int32_t adf4350_sync_config(adf4350_dev *dev)
 	return 0;
 }
 
+/***************************************************************************//**
+ * @brief Computes the PFD frequency for a given R counter value.
+ *
+ * @param dev - The device structure.
+ * @param r_cnt - The R counter value.
+ *
+ * @return Returns the PFD frequency.
+*******************************************************************************/
+static uint32_t adf4350_calc_fpfd(adf4350_dev *dev,
+				  uint16_t r_cnt)
+{
+	return (dev->clkin * (dev->pdata->ref_doubler_en ? 2 : 1)) /
+	       (r_cnt * (dev->pdata->ref_div2_en ? 2 : 1));
+}
+
 /***************************************************************************//**
  * @brief Increases the R counter value until the ADF4350_MAX_FREQ_PFD is
  *        greater than PFD frequency.
@@ -112,51 +127,65 @@ int32_t adf4350_tune_r_cnt(adf4350_dev *dev,
 {
 	do {
 		r_cnt++;
-		dev->fpfd = (dev->clkin * (dev->pdata->ref_doubler_en ? 2 : 1)) /
-			    (r_cnt * (dev->pdata->ref_div2_en ? 2 : 1));
+		dev->fpfd = adf4350_calc_fpfd(dev, r_cnt);
 	} while (dev->fpfd > ADF4350_MAX_FREQ_PFD);
 
 	return r_cnt;
 }
 
 /***************************************************************************//**
- * @brief Computes the greatest common divider of two numbers
+ * @brief Fills the solver configuration from the reference settings.
  *
- * @return Returns the gcd.
+ * @param dev - The device structure.
+ * @param cfg - The solver configuration.
+ *
+ * @return None.
 *******************************************************************************/
-uint32_t gcd(uint32_t x, uint32_t y)
+static void adf4350_solver_cfg(adf4350_dev *dev,
+			       struct frac_pll_cfg *cfg)
 {
-	uint32_t tmp;
-
-	while (y != 0) {
-		tmp = x % y;
-		x = y;
-		y = tmp;
-	}
-
-	return x;
+	cfg->clkin = dev->clkin;
+	cfg->ref_doubler_en = dev->pdata->ref_doubler_en;
+	cfg->ref_div2_en = dev->pdata->ref_div2_en;
+	/*
+	 * Allow a predefined reference division factor
+	 * if not set, compute our own
+	 */
+	cfg->r_cnt_init = dev->pdata->ref_div_factor ?
+			  dev->pdata->ref_div_factor - 1 : 0;
+	cfg->max_r_cnt = ADF4350_MAX_R_CNT;
+	cfg->max_fpfd = ADF4350_MAX_FREQ_PFD;
+	cfg->max_mod = ADF4350_MAX_MODULUS;
+	cfg->fixed_mod = 0;
+	cfg->chspc_retry = true;
+	cfg->round_closest = false;
 }
 
 /***************************************************************************//**
- * @brief Sets the ADF4350 frequency.
+ * @brief Computes the register values for a frequency, without writing them.
  *
  * @param dev - The device structure.
  * @param freq - The desired frequency value.
+ * @param hop - The computed configuration.
  *
- * @return calculatedFrequency - The actual frequency value that was set.
+ * @return Returns 0 in case of success or negative error code.
 *******************************************************************************/
-int64_t adf4350_set_freq(adf4350_dev *dev,
-			 uint64_t freq)
+int32_t adf4350_calc_freq(adf4350_dev *dev,
+			  uint64_t freq,
+			  struct adf4350_hop *hop)
 {
-	uint64_t tmp;
-	uint32_t div_gcd, prescaler, chspc;
-	uint16_t mdiv, r_cnt = 0;
-	uint8_t band_sel_div;
+	struct frac_pll_cfg cfg;
+	struct frac_pll_result res;
+	uint32_t prescaler;
+	uint16_t mdiv;
+	uint8_t band_sel_div, rf_div_sel = 0;
 	int32_t ret;
 
 	if ((freq > ADF4350_MAX_OUT_FREQ) || (freq < ADF4350_MIN_OUT_FREQ))
 		return -1;
 
+	hop->freq = freq;
+
 	if (freq > ADF4350_MAX_FREQ_45_PRESC) {
 		prescaler = ADF4350_REG1_PRESCALER;
 		mdiv = 75;
@@ -165,69 +194,36 @@ int64_t adf4350_set_freq(adf4350_dev *dev,
 		mdiv = 23;
 	}
 
-	dev->r4_rf_div_sel = 0;
-
 	while (freq < ADF4350_MIN_VCO_FREQ) {
 		freq <<= 1;
-		dev->r4_rf_div_sel++;
+		rf_div_sel++;
 	}
 
-	/*
-	 * Allow a predefined reference division factor
-	 * if not set, compute our own
-	 */
-	if (dev->pdata->ref_div_factor)
-		r_cnt = dev->pdata->ref_div_factor - 1;
-
-	chspc = dev->chspc;
-
-	do {
-		do {
-			do {
-				r_cnt = adf4350_tune_r_cnt(dev, r_cnt);
-				dev->r1_mod = dev->fpfd / chspc;
-				if (r_cnt > ADF4350_MAX_R_CNT) {
-					/* try higher spacing values */
-					chspc++;
-					r_cnt = 0;
-				}
-			} while ((dev->r1_mod > ADF4350_MAX_MODULUS) && r_cnt);
-		} while (r_cnt == 0);
-
-
-		tmp = freq * (uint64_t)dev->r1_mod + (dev->fpfd > 1);
-
-		tmp = (tmp / dev->fpfd);	/* Div round closest (n + d/2)/d */
-
-		dev->r0_fract = tmp % dev->r1_mod;
-		tmp = tmp / dev->r1_mod;
-
-		dev->r0_int = tmp;
-	} while (mdiv > dev->r0_int);
+	adf4350_solver_cfg(dev, &cfg);
+	ret = frac_pll_solve(&dev->solver, &cfg, dev->chspc, freq, mdiv, &res);
+	if (ret < 0)
+		return ret;
 
-	band_sel_div = dev->fpfd % ADF4350_MAX_BANDSEL_CLK >
+	band_sel_div = res.fpfd % ADF4350_MAX_BANDSEL_CLK >
 		       ADF4350_MAX_BANDSEL_CLK / 2 ?
-		       dev->fpfd / ADF4350_MAX_BANDSEL_CLK + 1 :
-		       dev->fpfd / ADF4350_MAX_BANDSEL_CLK;
+		       res.fpfd / ADF4350_MAX_BANDSEL_CLK + 1 :
+		       res.fpfd / ADF4350_MAX_BANDSEL_CLK;
 
-	if (dev->r0_fract && dev->r1_mod) {
-		div_gcd = gcd(dev->r1_mod, dev->r0_fract);
-		dev->r1_mod /= div_gcd;
-		dev->r0_fract /= div_gcd;
-	} else {
-		dev->r0_fract = 0;
-		dev->r1_mod = 1;
-	}
+	hop->fpfd = res.fpfd;
+	hop->r0_int = res.int_val;
+	hop->r0_fract = res.fract;
+	hop->r1_mod = res.mod;
+	hop->r4_rf_div_sel = rf_div_sel;
 
-	dev->regs[ADF4350_REG0] = ADF4350_REG0_INT(dev->r0_int) |
-				  ADF4350_REG0_FRACT(dev->r0_fract);
+	hop->regs[ADF4350_REG0] = ADF4350_REG0_INT(res.int_val) |
+				  ADF4350_REG0_FRACT(res.fract);
 
-	dev->regs[ADF4350_REG1] = ADF4350_REG1_PHASE(1) |
-				  ADF4350_REG1_MOD(dev->r1_mod) |
+	hop->regs[ADF4350_REG1] = ADF4350_REG1_PHASE(1) |
+				  ADF4350_REG1_MOD(res.mod) |
 				  prescaler;
 
-	dev->regs[ADF4350_REG2] =
-		ADF4350_REG2_10BIT_R_CNT(r_cnt) |
+	hop->regs[ADF4350_REG2] =
+		ADF4350_REG2_10BIT_R_CNT(res.r_cnt) |
 		ADF4350_REG2_DOUBLE_BUFF_EN |
 		(dev->pdata->ref_doubler_en ? ADF4350_REG2_RMULT2_EN : 0) |
 		(dev->pdata->ref_div2_en ? ADF4350_REG2_RDIV2_EN : 0) |
@@ -236,14 +232,14 @@ int64_t adf4350_set_freq(adf4350_dev *dev,
 				ADF4350_REG2_CHARGE_PUMP_CURR_uA(5000) |
 				ADF4350_REG2_MUXOUT(0x7) | ADF4350_REG2_NOISE_MODE(0x3)));
 
-	dev->regs[ADF4350_REG3] = dev->pdata->r3_user_settings &
+	hop->regs[ADF4350_REG3] = dev->pdata->r3_user_settings &
 				  (ADF4350_REG3_12BIT_CLKDIV(0xFFF) |
 				   ADF4350_REG3_12BIT_CLKDIV_MODE(0x3) |
 				   ADF4350_REG3_12BIT_CSR_EN);
 
-	dev->regs[ADF4350_REG4] =
+	hop->regs[ADF4350_REG4] =
 		ADF4350_REG4_FEEDBACK_FUND |
-		ADF4350_REG4_RF_DIV_SEL(dev->r4_rf_div_sel) |
+		ADF4350_REG4_RF_DIV_SEL(rf_div_sel) |
 		ADF4350_REG4_8BIT_BAND_SEL_CLKDIV(band_sel_div) |
 		ADF4350_REG4_RF_OUT_EN |
 		(dev->pdata->r4_user_settings &
@@ -253,18 +249,91 @@ int64_t adf4350_set_freq(adf4350_dev *dev,
 		  ADF4350_REG4_AUX_OUTPUT_FUND |
 		  ADF4350_REG4_MUTE_TILL_LOCK_EN));
 
-	dev->regs[ADF4350_REG5] = ADF4350_REG5_LD_PIN_MODE_DIGITAL | 0x00180000;
+	hop->regs[ADF4350_REG5] = ADF4350_REG5_LD_PIN_MODE_DIGITAL | 0x00180000;
+
+	hop->actual_freq = frac_pll_vco_freq(&res) >> rf_div_sel;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Applies a configuration computed by adf4350_calc_freq(). Only the
+ *        registers that differ from the ones already in the device are
+ *        written.
+ *
+ * @param dev - The device structure.
+ * @param hop - The configuration to apply.
+ *
+ * @return calculatedFrequency - The actual frequency value that was set.
+*******************************************************************************/
+int64_t adf4350_hop_apply(adf4350_dev *dev,
+			  const struct adf4350_hop *hop)
+{
+	int32_t ret, i;
+
+	for (i = ADF4350_REG0; i <= ADF4350_REG5; i++)
+		dev->regs[i] = hop->regs[i];
+
+	dev->fpfd = hop->fpfd;
+	dev->r0_int = hop->r0_int;
+	dev->r0_fract = hop->r0_fract;
+	dev->r1_mod = hop->r1_mod;
+	dev->r4_rf_div_sel = hop->r4_rf_div_sel;
 
 	ret = adf4350_sync_config(dev);
-	if(ret < 0) {
+	if (ret < 0)
 		return ret;
+
+	return hop->actual_freq;
+}
+
+/***************************************************************************//**
+ * @brief Computes the configurations of a list of frequencies, so that they
+ *        can be applied later by adf4350_hop_apply() without any computation.
+ *
+ * @param dev - The device structure.
+ * @param freqs - The list of frequencies.
+ * @param hops - The computed configurations (one for each frequency).
+ * @param nb_hops - The number of frequencies.
+ *
+ * @return Returns 0 in case of success or negative error code.
+*******************************************************************************/
+int32_t adf4350_hop_list_prepare(adf4350_dev *dev,
+				 const uint64_t *freqs,
+				 struct adf4350_hop *hops,
+				 uint32_t nb_hops)
+{
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < nb_hops; i++) {
+		ret = adf4350_calc_freq(dev, freqs[i], &hops[i]);
+		if (ret < 0)
+			return ret;
 	}
 
-	tmp = (uint64_t)((dev->r0_int * dev->r1_mod) +
-			 dev->r0_fract) * (uint64_t)dev->fpfd;
-	tmp = tmp / ((uint64_t)dev->r1_mod * ((uint64_t)1 << dev->r4_rf_div_sel));
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Sets the ADF4350 frequency.
+ *
+ * @param dev - The device structure.
+ * @param freq - The desired frequency value.
+ *
+ * @return calculatedFrequency - The actual frequency value that was set.
+*******************************************************************************/
+int64_t adf4350_set_freq(adf4350_dev *dev,
+			 uint64_t freq)
+{
+	struct adf4350_hop hop;
+	int32_t ret;
+
+	ret = adf4350_calc_freq(dev, freq, &hop);
+	if (ret < 0)
+		return ret;
 
-	return tmp;
+	return adf4350_hop_apply(dev, &hop);
 }
 
 /***************************************************************************//**
@@ -286,6 +355,8 @@ int32_t adf4350_setup(adf4350_dev **device,
 		return -1;
 	}
 
+	frac_pll_solver_reset(&dev->solver);
+
 	/* SPI */
 	ret = spi_init(&dev->spi_desc, &init_param.spi_init);
 
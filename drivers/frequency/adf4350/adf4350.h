@@ -45,6 +45,7 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "spi.h"
+#include "frac_pll.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -180,6 +181,18 @@ typedef struct {
 	uint32_t	aux_output_power;
 } adf4350_init_param;
 
+/* Precomputed configuration of one frequency */
+struct adf4350_hop {
+	uint64_t	freq;
+	uint64_t	actual_freq;
+	uint32_t	fpfd;
+	uint32_t	r0_int;
+	uint32_t	r0_fract;
+	uint32_t	r1_mod;
+	uint32_t	r4_rf_div_sel;
+	uint32_t	regs[6];
+};
+
 typedef struct {
 	spi_desc	*spi_desc;
 	struct adf4350_platform_data *pdata;
@@ -194,6 +207,7 @@ typedef struct {
 	uint32_t	regs[6];
 	uint32_t	regs_hw[6];
 	uint32_t 	val;
+	struct frac_pll_solver solver;
 } adf4350_dev;
 
 /******************************************************************************/
@@ -205,6 +219,21 @@ int32_t adf4350_setup(adf4350_dev **device,
 /*! Writes 4 bytes of data to ADF4350. */
 int32_t adf4350_write(adf4350_dev *dev,
 		      uint32_t data);
+/*! Sets the ADF4350 frequency. */
+int64_t adf4350_set_freq(adf4350_dev *dev,
+			 uint64_t freq);
+/*! Computes the register values for a frequency, without writing them. */
+int32_t adf4350_calc_freq(adf4350_dev *dev,
+			  uint64_t freq,
+			  struct adf4350_hop *hop);
+/*! Computes the configurations of a list of frequencies. */
+int32_t adf4350_hop_list_prepare(adf4350_dev *dev,
+				 const uint64_t *freqs,
+				 struct adf4350_hop *hops,
+				 uint32_t nb_hops);
+/*! Applies a precomputed configuration. */
+int64_t adf4350_hop_apply(adf4350_dev *dev,
+			  const struct adf4350_hop *hop);
 /*! Stores PLL 0 frequency in Hz. */
 int64_t adf4350_out_altvoltage0_frequency(adf4350_dev *dev,
 		int64_t Hz);
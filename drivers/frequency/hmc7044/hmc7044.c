@@ -289,6 +289,44 @@ int32_t hmc7044_read(struct hmc7044_dev *dev, uint16_t reg, uint8_t *val)
 	return SUCCESS;
 }
 
+/**
+ * Check the PLL2 lock detect bit of the alarm readback register.
+ * @param ctx - The device structure.
+ * @param done - Set to true if PLL2 is locked.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t hmc7044_pll2_lock_cond(void *ctx, bool *done)
+{
+	struct hmc7044_dev *dev = ctx;
+	uint8_t alarm;
+	int32_t ret;
+
+	ret = hmc7044_read(dev, HMC7044_REG_ALARM_READBACK, &alarm);
+	if (ret < 0)
+		return ret;
+
+	*done = HMC7044_PLL2_LOCK_DETECT(alarm);
+
+	return SUCCESS;
+}
+
+/**
+ * Wait for PLL2 to lock.
+ * @param dev - The device structure.
+ * @return SUCCESS in case of success, FAILURE if PLL2 did not lock in time.
+ */
+static int32_t hmc7044_wait_pll2_lock(struct hmc7044_dev *dev)
+{
+	struct wait_param param = {
+		.start_us = HMC7044_POLL_START_US,
+		.max_step_us = HMC7044_POLL_MAX_STEP_US,
+		.timeout_us = HMC7044_POLL_TIMEOUT_US,
+		.stats = &dev->lock_stats
+	};
+
+	return wait_for_condition(&param, hmc7044_pll2_lock_cond, dev);
+}
+
 /**
  * Calculate the output channel divider.
  * @param rate - The desired rate.
@@ -633,9 +671,8 @@ static int32_t hmc7044_setup(struct hmc7044_dev *dev)
 		       HMC7044_HIGH_PERF_DISTRIB_PATH : 0) |
 		      (dev->high_performance_mode_pll_vco_en ?
 		       HMC7044_HIGH_PERF_PLL_VCO : 0));
-	mdelay(1);
 
-	return SUCCESS;
+	return hmc7044_wait_pll2_lock(dev);
 }
 
 /**
@@ -660,6 +697,8 @@ int32_t hmc7044_init(struct hmc7044_dev **device,
 	if (ret < 0)
 		return ret;
 
+	wait_stats_reset(&dev->lock_stats);
+
 	dev->clkin_freq[0] = init_param->clkin_freq[0];
 	dev->clkin_freq[1] = init_param->clkin_freq[1];
 	dev->clkin_freq[2] = init_param->clkin_freq[2];
@@ -46,6 +46,15 @@
 #include <stdint.h>
 #include "delay.h"
 #include "spi.h"
+#include "wait.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* PLL2 lock poll timing (us) */
+#define HMC7044_POLL_START_US		10
+#define HMC7044_POLL_MAX_STEP_US	1000
+#define HMC7044_POLL_TIMEOUT_US		10000
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -87,6 +96,7 @@ struct hmc7044_dev {
 	uint32_t	gpo_ctrl[4];
 	uint32_t	num_channels;
 	struct hmc7044_chan_spec	*channels;
+	struct wait_stats	lock_stats;
 };
 
 struct hmc7044_init_param {
@@ -41,18 +41,123 @@
 /***************************** Include Files *********************************/
 /*****************************************************************************/
 #include <stdlib.h>
+#include <stdbool.h>
 #include "ad5933.h"
+#include "wait.h"
 #include <math.h>
 
 /******************************************************************************/
 /************************** Constants Definitions *****************************/
 /******************************************************************************/
 const int32_t pow_2_27 = 134217728ul;      // 2 to the power of 27
+#define AD5933_PI	3.14159265f
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+struct ad5933_wait_ctx {
+	struct ad5933_dev *dev;
+	uint8_t mask;
+	uint8_t status;
+};
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/***************************************************************************//**
+ * @brief Status condition for wait_for_condition(). Reads the status register
+ *        directly, since ad5933_get_register_value() cannot report a bus
+ *        error.
+ *
+ * @param ctx  - The wait context.
+ * @param done - Set when the status bits are set.
+ *
+ * @return 0 in case of success, negative error code if the I2C access failed.
+*******************************************************************************/
+static int32_t ad5933_status_cond(void *ctx, bool *done)
+{
+	struct ad5933_wait_ctx *wait = ctx;
+	uint8_t data[2] = {AD5933_ADDR_POINTER, AD5933_REG_STATUS};
+	int32_t ret;
+
+	ret = i2c_write(wait->dev->i2c_desc, data, 2, 1);
+	if (ret < 0)
+		return ret;
+	ret = i2c_read(wait->dev->i2c_desc, &wait->status, 1, 1);
+	if (ret < 0)
+		return ret;
+	*done = (wait->status & wait->mask) != 0;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Waits for a status bit, polling at growing intervals.
+ *
+ * @param dev    - The device structure.
+ * @param mask   - Status bits to wait for.
+ * @param status - Last status read, may be NULL.
+ *
+ * @return 0 in case of success, -1 on timeout, negative error code if the
+ *         I2C access failed.
+*******************************************************************************/
+static int32_t ad5933_wait_status(struct ad5933_dev *dev,
+				  uint8_t mask,
+				  uint8_t *status)
+{
+	struct wait_param param = {
+		.start_us = AD5933_POLL_START_US,
+		.max_step_us = AD5933_POLL_MAX_US,
+		.timeout_us = AD5933_DATA_TIMEOUT_US,
+	};
+	struct ad5933_wait_ctx ctx = {
+		.dev = dev,
+		.mask = mask,
+	};
+	int32_t ret;
+
+	ret = wait_for_condition(&param, ad5933_status_cond, &ctx);
+	if (status)
+		*status = ctx.status;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Reads the real and the imaginary data with one block read.
+ *
+ * @param dev  - The device structure.
+ * @param real - Real data.
+ * @param imag - Imaginary data.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+static int32_t ad5933_get_data(struct ad5933_dev *dev,
+			       int16_t *real,
+			       int16_t *imag)
+{
+	uint8_t data[4] = {AD5933_ADDR_POINTER, AD5933_REG_REAL_DATA, 0, 0};
+	int32_t ret;
+
+	ret = i2c_write(dev->i2c_desc, data, 2, 1);
+	if (ret < 0)
+		return ret;
+	data[0] = AD5933_BLOCK_READ;
+	data[1] = 4;
+	ret = i2c_write(dev->i2c_desc, data, 2, 0);
+	if (ret < 0)
+		return ret;
+	ret = i2c_read(dev->i2c_desc, data, 4, 1);
+	if (ret < 0)
+		return ret;
+
+	*real = (int16_t)((data[0] << 8) | data[1]);
+	*imag = (int16_t)((data[2] << 8) | data[3]);
+
+	return 0;
+}
+
 /***************************************************************************//**
  * @brief Initializes the communication peripheral and the initial Values for
  *        AD5933 Board.
@@ -81,6 +186,7 @@ int32_t ad5933_init(struct ad5933_dev **device,
 	dev->current_clock_source = init_param.current_clock_source;
 	dev->current_gain = init_param.current_gain;
 	dev->current_range = init_param.current_range;
+	dev->current_inc_num = 0;
 
 	status = i2c_init(&dev->i2c_desc, &init_param.i2c_init);
 
@@ -312,6 +418,8 @@ void ad5933_config_sweep(struct ad5933_dev *dev,
 	inc_freq_reg = (uint32_t)((double)inc_freq * 4 / dev->current_sys_clk *
 				  pow_2_27);
 
+	dev->current_inc_num = inc_num_reg;
+
 	/* Configure the device with the sweep parameters. */
 	ad5933_set_register_value(dev,
 				  AD5933_REG_FREQ_START,
@@ -332,12 +440,10 @@ void ad5933_config_sweep(struct ad5933_dev *dev,
  *
  * @param dev             - The device structure.
  *
- * @return None.
+ * @return 0 in case of success, -1 if no data is ready in time.
 *******************************************************************************/
-void ad5933_start_sweep(struct ad5933_dev *dev)
+int32_t ad5933_start_sweep(struct ad5933_dev *dev)
 {
-	uint8_t status = 0;
-
 	ad5933_set_register_value(dev,
 				  AD5933_REG_CONTROL_HB,
 				  AD5933_CONTROL_FUNCTION(AD5933_FUNCTION_STANDBY) |
@@ -357,12 +463,8 @@ void ad5933_start_sweep(struct ad5933_dev *dev)
 				  AD5933_CONTROL_RANGE(dev->current_range) |
 				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
 				  1);
-	status = 0;
-	while((status & AD5933_STAT_DATA_VALID) == 0) {
-		status = ad5933_get_register_value(dev,
-						   AD5933_REG_STATUS,
-						   1);
-	};
+
+	return ad5933_wait_status(dev, AD5933_STAT_DATA_VALID, NULL);
 }
 
 /***************************************************************************//**
@@ -376,7 +478,8 @@ void ad5933_start_sweep(struct ad5933_dev *dev)
  *                                        AD5933_FUNCTION_REPEAT_FREQ - Repeat
                                           freq..
  *
- * @return gainFactor          - Calculated gain factor.
+ * @return gainFactor          - Calculated gain factor, or -1 if the data
+ *                               could not be read.
 *******************************************************************************/
 double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
 				    uint32_t calibration_impedance,
@@ -384,9 +487,8 @@ double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
 {
 	double gain_factor = 0;
 	double magnitude = 0;
-	signed short real_data = 0;
-	signed short imag_data = 0;
-	uint8_t status = 0;
+	int16_t real_data = 0;
+	int16_t imag_data = 0;
 
 	ad5933_set_register_value(dev,
 				  AD5933_REG_CONTROL_HB,
@@ -394,18 +496,10 @@ double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
 				  AD5933_CONTROL_RANGE(dev->current_range) |
 				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
 				  1);
-	status = 0;
-	while((status & AD5933_STAT_DATA_VALID) == 0) {
-		status = ad5933_get_register_value(dev,
-						   AD5933_REG_STATUS,
-						   1);
-	}
-	real_data = ad5933_get_register_value(dev,
-					      AD5933_REG_REAL_DATA,
-					      2);
-	imag_data = ad5933_get_register_value(dev,
-					      AD5933_REG_IMAG_DATA,
-					      2);
+	if (ad5933_wait_status(dev, AD5933_STAT_DATA_VALID, NULL) < 0)
+		return -1;
+	if (ad5933_get_data(dev, &real_data, &imag_data) < 0)
+		return -1;
 	magnitude = sqrt((real_data * real_data) + (imag_data * imag_data));
 	gain_factor = 1 / (magnitude * calibration_impedance);
 
@@ -421,17 +515,17 @@ double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
  *                       Example: AD5933_FUNCTION_INC_FREQ - Increment freq.;
  *                                AD5933_FUNCTION_REPEAT_FREQ - Repeat freq..
  *
- * @return impedance   - Calculated impedance.
+ * @return impedance   - Calculated impedance, or -1 if the data could not
+ *                       be read.
 *******************************************************************************/
 double ad5933_calculate_impedance(struct ad5933_dev *dev,
 				  double gain_factor,
 				  uint8_t freq_function)
 {
-	signed short real_data = 0;
-	signed short imag_data = 0;
+	int16_t real_data = 0;
+	int16_t imag_data = 0;
 	double magnitude = 0;
 	double impedance = 0;
-	uint8_t status = 0;
 
 	ad5933_set_register_value(dev,
 				  AD5933_REG_CONTROL_HB,
@@ -439,21 +533,226 @@ double ad5933_calculate_impedance(struct ad5933_dev *dev,
 				  AD5933_CONTROL_RANGE(dev->current_range) |
 				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
 				  1);
-	status = 0;
-	while((status & AD5933_STAT_DATA_VALID) == 0) {
-		status = ad5933_get_register_value(dev,
-						   AD5933_REG_STATUS,
-						   1);
-	}
-	real_data = ad5933_get_register_value(dev,
-					      AD5933_REG_REAL_DATA,
-					      2);
-	imag_data = ad5933_get_register_value(dev,
-					      AD5933_REG_IMAG_DATA,
-					      2);
+	if (ad5933_wait_status(dev, AD5933_STAT_DATA_VALID, NULL) < 0)
+		return -1;
+	if (ad5933_get_data(dev, &real_data, &imag_data) < 0)
+		return -1;
 	magnitude = sqrt((real_data * real_data) + (imag_data * imag_data));
 
 	impedance =  1 / (magnitude * gain_factor);
 
 	return impedance;
 }
+
+/***************************************************************************//**
+ * @brief Runs the sweep configured by ad5933_config_sweep() from the start
+ *        frequency to the end and collects the raw real and imaginary data.
+ *
+ * @param dev        - The device structure.
+ * @param real       - Real data of each point.
+ * @param imag       - Imaginary data of each point.
+ * @param max_points - Size of the arrays.
+ * @param points     - Number of points measured.
+ *
+ * @return 0 in case of success, -1 on timeout or bus error.
+*******************************************************************************/
+int32_t ad5933_sweep_run(struct ad5933_dev *dev,
+			 int16_t *real,
+			 int16_t *imag,
+			 uint16_t max_points,
+			 uint16_t *points)
+{
+	uint16_t total = dev->current_inc_num + 1;
+	uint8_t status;
+	uint16_t n = 0;
+	int32_t ret;
+
+	if (total > max_points)
+		total = max_points;
+
+	ret = ad5933_start_sweep(dev);
+	while (ret == 0 && n < total) {
+		ret = ad5933_wait_status(dev, AD5933_STAT_DATA_VALID, &status);
+		if (ret < 0)
+			break;
+
+		ret = ad5933_get_data(dev, &real[n], &imag[n]);
+		if (ret < 0)
+			break;
+		n++;
+
+		if ((status & AD5933_STAT_SWEEP_DONE) || n == total)
+			break;
+
+		ad5933_set_register_value(dev,
+					  AD5933_REG_CONTROL_HB,
+					  AD5933_CONTROL_FUNCTION(AD5933_FUNCTION_INC_FREQ) |
+					  AD5933_CONTROL_RANGE(dev->current_range) |
+					  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
+					  1);
+	}
+	*points = n;
+
+	ad5933_set_register_value(dev,
+				  AD5933_REG_CONTROL_HB,
+				  AD5933_CONTROL_FUNCTION(AD5933_FUNCTION_STANDBY) |
+				  AD5933_CONTROL_RANGE(dev->current_range) |
+				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
+				  1);
+
+	return (n == total) ? 0 : -1;
+}
+
+/***************************************************************************//**
+ * @brief Integer square root.
+ *
+ * @param x - Value.
+ *
+ * @return floor(sqrt(x)).
+*******************************************************************************/
+static uint32_t ad5933_isqrt(uint32_t x)
+{
+	uint32_t res = 0;
+	uint32_t bit = 1ul << 30;
+
+	while (bit > x)
+		bit >>= 2;
+
+	while (bit) {
+		if (x >= res + bit) {
+			x -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return res;
+}
+
+/***************************************************************************//**
+ * @brief Computes the calibration of a sweep done on a known impedance. The
+ *        gain factor and the system phase are interpolated between the first
+ *        and the last points.
+ *
+ * @param real                  - Real data of each point.
+ * @param imag                  - Imaginary data of each point.
+ * @param points                - Number of points.
+ * @param calibration_impedance - The calibration impedance value.
+ * @param cal                   - The calibration.
+ *
+ * @return 0 in case of success, -1 if the data is not usable.
+*******************************************************************************/
+int32_t ad5933_sweep_calibrate(const int16_t *real,
+			       const int16_t *imag,
+			       uint16_t points,
+			       uint32_t calibration_impedance,
+			       struct ad5933_sweep_cal *cal)
+{
+	uint16_t last = points - 1;
+	float mag_first;
+	float mag_last;
+	float phase_span;
+
+	if (!points || !calibration_impedance)
+		return -1;
+
+	mag_first = sqrtf((float)real[0] * real[0] + (float)imag[0] * imag[0]);
+	mag_last = sqrtf((float)real[last] * real[last] +
+			 (float)imag[last] * imag[last]);
+	if (mag_first == 0 || mag_last == 0)
+		return -1;
+
+	cal->gain_factor = 1 / (mag_first * calibration_impedance);
+	cal->system_phase = atan2f(imag[0], real[0]);
+	cal->gain_factor_step = 0;
+	cal->system_phase_step = 0;
+	if (last) {
+		cal->gain_factor_step = (1 / (mag_last * calibration_impedance) -
+					 cal->gain_factor) / last;
+		/* Take the short way around between the two phases */
+		phase_span = atan2f(imag[last], real[last]) - cal->system_phase;
+		if (phase_span > AD5933_PI)
+			phase_span -= 2 * AD5933_PI;
+		else if (phase_span <= -AD5933_PI)
+			phase_span += 2 * AD5933_PI;
+		cal->system_phase_step = phase_span / last;
+	}
+	cal->inv_gain_factor = (uint64_t)ad5933_isqrt((uint32_t)(real[0] * real[0]) +
+				(uint32_t)(imag[0] * imag[0])) * calibration_impedance;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Computes the impedance and the phase of all the points of a sweep in
+ *        single precision, in one pass over the raw data.
+ *
+ * @param real      - Real data of each point.
+ * @param imag      - Imaginary data of each point.
+ * @param points    - Number of points.
+ * @param cal       - The calibration.
+ * @param impedance - Impedance of each point, in ohms.
+ * @param phase     - Phase of each point in radians, NULL if not needed.
+ *
+ * @return None.
+*******************************************************************************/
+void ad5933_sweep_impedance(const int16_t *real,
+			    const int16_t *imag,
+			    uint16_t points,
+			    const struct ad5933_sweep_cal *cal,
+			    float *impedance,
+			    float *phase)
+{
+	float mag;
+	uint16_t i;
+
+	for (i = 0; i < points; i++) {
+		mag = sqrtf((float)real[i] * real[i] + (float)imag[i] * imag[i]);
+		impedance[i] = 1 / (mag * (cal->gain_factor +
+					   cal->gain_factor_step * i));
+	}
+
+	if (!phase)
+		return;
+
+	for (i = 0; i < points; i++)
+		phase[i] = atan2f(imag[i], real[i]) -
+			   (cal->system_phase + cal->system_phase_step * i);
+}
+
+/***************************************************************************//**
+ * @brief Computes the impedance of all the points of a sweep with integer
+ *        math only, using the gain factor of the first point.
+ *
+ * @param real      - Real data of each point.
+ * @param imag      - Imaginary data of each point.
+ * @param points    - Number of points.
+ * @param cal       - The calibration.
+ * @param impedance - Impedance of each point, in ohms, UINT32_MAX if the
+ *                    magnitude is 0.
+ *
+ * @return None.
+*******************************************************************************/
+void ad5933_sweep_impedance_fixed(const int16_t *real,
+				  const int16_t *imag,
+				  uint16_t points,
+				  const struct ad5933_sweep_cal *cal,
+				  uint32_t *impedance)
+{
+	uint64_t z;
+	uint32_t mag;
+	uint16_t i;
+
+	for (i = 0; i < points; i++) {
+		mag = ad5933_isqrt((uint32_t)(real[i] * real[i]) +
+				   (uint32_t)(imag[i] * imag[i]));
+		if (!mag) {
+			impedance[i] = UINT32_MAX;
+			continue;
+		}
+		z = (cal->inv_gain_factor + mag / 2) / mag;
+		impedance[i] = (z > UINT32_MAX) ? UINT32_MAX : z;
+	}
+}
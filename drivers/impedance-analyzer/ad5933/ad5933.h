@@ -108,6 +108,11 @@
 #define AD5933_INTERNAL_SYS_CLK     16000000ul      // 16MHz
 #define AD5933_MAX_INC_NUM          511             // Maximum increment number
 
+/* DATA_VALID polling: first interval, longest interval and default timeout */
+#define AD5933_POLL_START_US        100
+#define AD5933_POLL_MAX_US          2000
+#define AD5933_DATA_TIMEOUT_US      5000000
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -120,6 +125,19 @@ struct ad5933_dev {
 	uint8_t current_clock_source;
 	uint8_t current_gain;
 	uint8_t current_range;
+	uint16_t current_inc_num;
+};
+
+/* Calibration of a sweep, linear in the point index (two-point calibration) */
+struct ad5933_sweep_cal {
+	/* Gain factor at the first point and change per point */
+	float gain_factor;
+	float gain_factor_step;
+	/* System phase at the first point and change per point, in radians */
+	float system_phase;
+	float system_phase_step;
+	/* Magnitude times impedance at the first point, for fixed point */
+	uint64_t inv_gain_factor;
 };
 
 struct ad5933_init_param {
@@ -177,7 +195,7 @@ void ad5933_config_sweep(struct ad5933_dev *dev,
 			 uint16_t inc_num);
 
 /*! Starts the sweep operation. */
-void ad5933_start_sweep(struct ad5933_dev *dev);
+int32_t ad5933_start_sweep(struct ad5933_dev *dev);
 
 /*! Reads the real and the imaginary data and calculates the Gain Factor. */
 double ad5933_calculate_gain_factor(struct ad5933_dev *dev,
@@ -189,4 +207,33 @@ double ad5933_calculate_impedance(struct ad5933_dev *dev,
 				  double gain_factor,
 				  uint8_t freq_function);
 
+/*! Runs the configured sweep and collects the raw real and imaginary data. */
+int32_t ad5933_sweep_run(struct ad5933_dev *dev,
+			 int16_t *real,
+			 int16_t *imag,
+			 uint16_t max_points,
+			 uint16_t *points);
+
+/*! Computes the calibration of a sweep done on a known impedance. */
+int32_t ad5933_sweep_calibrate(const int16_t *real,
+			       const int16_t *imag,
+			       uint16_t points,
+			       uint32_t calibration_impedance,
+			       struct ad5933_sweep_cal *cal);
+
+/*! Computes the impedance and the phase of all the points of a sweep. */
+void ad5933_sweep_impedance(const int16_t *real,
+			    const int16_t *imag,
+			    uint16_t points,
+			    const struct ad5933_sweep_cal *cal,
+			    float *impedance,
+			    float *phase);
+
+/*! Fixed point impedance of all the points, single-point calibration. */
+void ad5933_sweep_impedance_fixed(const int16_t *real,
+				  const int16_t *imag,
+				  uint16_t points,
+				  const struct ad5933_sweep_cal *cal,
+				  uint32_t *impedance);
+
 #endif /* __AD5933_H__ */
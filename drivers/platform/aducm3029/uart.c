@@ -49,6 +49,21 @@
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @struct dma_ccd
+ * @brief uDMA channel control data, as stored in the primary and alternate
+ * control tables.
+ */
+struct dma_ccd {
+	/** Source end pointer */
+	volatile uint32_t	src_end;
+	/** Destination end pointer */
+	volatile uint32_t	dst_end;
+	/** Channel control word */
+	volatile uint32_t	ctrl;
+	uint32_t		reserved;
+};
+
 /**
  * @struct baud_desc
  * @brief Structure of an element from \ref baud_rates_26MHz.
@@ -97,6 +112,13 @@ const struct baud_desc baud_rates_26MHz[BAUDS_NB] = {
 	{1500000, 171, 1, 1, 2}
 };
 
+/** Entries in each uDMA channel control table */
+#define DMA_NUM_CHANNELS		32u
+/** Channel control word: transfer mode, 0 when the channel is stopped */
+#define DMA_CTRL_CYCLE_MASK		0x7u
+/** Channel control word: remaining transfers minus one */
+#define DMA_CTRL_N_MINUS_1(ctrl)	(((ctrl) >> 4) & 0x3FFu)
+
 /**
  * Used to check if device already initialized
  */
@@ -184,6 +206,123 @@ static void uart_callback(void *desc, uint32_t event, void *buff)
 	}
 }
 
+/**
+ * @brief Ring buffer mode callback. Moves each received chunk to the ring
+ * buffer and gives the chunk back to the ADI driver right away.
+ * @param desc:		Descriptor of the UART device
+ * @param event:	Event ID from ADI_UART_EVENT
+ * @param buff:		Pointer to the handled buffer or to an error code
+ */
+static void uart_ring_callback(void *desc, uint32_t event, void *buff)
+{
+	struct aducm_uart_desc *extra = ((struct uart_desc *)desc)->extra;
+
+	switch(event) {
+	case ADI_UART_EVENT_RX_BUFFER_PROCESSED:
+		/* Chunks complete in order, skip what the reader already took */
+		cb_write(extra->rx_cb, (uint8_t *)buff + extra->rx_taken,
+			 ADUCM_UART_RX_CHUNK - extra->rx_taken);
+		extra->rx_taken = 0;
+		extra->rx_head ^= 1;
+		adi_uart_SubmitRxBuffer(
+			(ADI_UART_HANDLE const)extra->uart_handler,
+			buff, ADUCM_UART_RX_CHUNK, true);
+		break;
+	case ADI_UART_EVENT_TX_BUFFER_PROCESSED:
+		extra->waiting_write_callback--;
+		break;
+	default:
+		extra->errors |= (uint32_t)buff;
+		break;
+	}
+}
+
+/**
+ * @brief Number of bytes the DMA already stored in the chunk being filled.
+ * The ADI driver only reports full chunks, so the count is taken from the
+ * running uDMA descriptor that targets the chunk. A descriptor is only
+ * trusted while its channel is active, so 0 is returned when the chunk is
+ * not started yet or already complete, and the callback delivers it.
+ * @param extra:	Platform descriptor of the UART device
+ * @return Number of bytes received in the chunk.
+ */
+static uint32_t uart_rx_chunk_filled(struct aducm_uart_desc *extra)
+{
+	struct dma_ccd	*tables[2];
+	struct dma_ccd	*ccd;
+	uint32_t	dst_end, t, ch;
+
+	tables[0] = (struct dma_ccd *)pADI_DMA0->PDBPTR;
+	tables[1] = (struct dma_ccd *)pADI_DMA0->ADBPTR;
+	dst_end = (uint32_t)&extra->rx_chunk[extra->rx_head]
+		  [ADUCM_UART_RX_CHUNK - 1];
+
+	for (t = 0; t < 2; t++)
+		for (ch = 0; ch < DMA_NUM_CHANNELS; ch++) {
+			ccd = &tables[t][ch];
+			if (ccd->dst_end != dst_end ||
+			    !(ccd->ctrl & DMA_CTRL_CYCLE_MASK))
+				continue;
+
+			return ADUCM_UART_RX_CHUNK - 1 -
+			       DMA_CTRL_N_MINUS_1(ccd->ctrl);
+		}
+
+	return 0;
+}
+
+/**
+ * @brief Idle flush of the ring buffer mode. Moves the bytes of the partially
+ * filled chunk to the ring buffer, so a short message does not wait for the
+ * chunk to fill up. Called by the reader when the ring buffer runs empty.
+ * @param extra:	Platform descriptor of the UART device
+ */
+static void uart_rx_flush(struct aducm_uart_desc *extra)
+{
+	uint32_t primask;
+	uint32_t filled;
+
+	/* Keep the callback from completing the chunk meanwhile */
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	filled = uart_rx_chunk_filled(extra);
+	if (filled > extra->rx_taken) {
+		cb_write(extra->rx_cb,
+			 extra->rx_chunk[extra->rx_head] + extra->rx_taken,
+			 filled - extra->rx_taken);
+		extra->rx_taken = filled;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Read the data already received, without waiting. Only available in
+ * ring buffer mode (\ref aducm_uart_init_param.rx_ring_size set).
+ * @param desc:	Descriptor of the UART device
+ * @param data:	Buffer where data will be read
+ * @param bytes_number:	Maximum number of bytes to be read
+ * @return Number of bytes read (possibly 0), \ref FAILURE otherwise.
+ */
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number)
+{
+	struct aducm_uart_desc *extra;
+
+	if (!desc || !data)
+		return FAILURE;
+
+	extra = desc->extra;
+	if (!extra->rx_cb)
+		return FAILURE;
+
+	if (cb_size(extra->rx_cb) < bytes_number)
+		uart_rx_flush(extra);
+
+	return cb_read(extra->rx_cb, data, bytes_number);
+}
+
 /**
  * @brief Calls the low level read functions depending on the mode
  * @param desc:	Descriptor of the UART device
@@ -201,6 +340,21 @@ int32_t uart_read(struct uart_desc *desc, uint8_t *data,
 		return FAILURE;
 
 	extra = desc->extra;
+	if (extra->rx_cb) { //Ring buffer mode
+		uint32_t offset = 0;
+		uint32_t n;
+
+		while (offset < bytes_number) {
+			n = cb_read(extra->rx_cb, data + offset,
+				    bytes_number - offset);
+			if (!n)
+				uart_rx_flush(extra);
+			offset += n;
+		}
+
+		return SUCCESS;
+	}
+
 	if (bytes_number == 0 || bytes_number > MAX_BYTES) {
 		errors = BAD_INPUT_PARAMETERS;
 		goto failure;
@@ -255,7 +409,20 @@ int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
 		goto failure;
 	}
 
-	if (!extra->callback) { //Blocking mode
+	if (extra->rx_cb) { //Ring buffer mode, the callback owns both directions
+		extra->waiting_write_callback++;
+		if (ADI_UART_SUCCESS != adi_uart_SubmitTxBuffer(
+			    (ADI_UART_HANDLE const)extra->uart_handler,
+			    (void *const)data,
+			    (uint32_t const)bytes_number,
+			    bytes_number > 4 ? true : false)) {
+			extra->waiting_write_callback--;
+			errors = NO_ERR;
+			goto failure;
+		}
+		while (*(volatile uint32_t *)&extra->waiting_write_callback)
+			;
+	} else if (!extra->callback) { //Blocking mode
 		if (ADI_UART_SUCCESS != adi_uart_Write(
 			    (ADI_UART_HANDLE const)extra->uart_handler,
 			    (void *const)data,
@@ -365,8 +532,26 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 		adi_uart_RegisterCallback(aducm_desc->uart_handler,
 					  uart_callback,
 					  (*desc));
+
+	if (aducm_init_param->rx_ring_size) {
+		if (aducm_desc->callback)
+			goto failure;
+		if (cb_init(&aducm_desc->rx_cb,
+			    aducm_init_param->rx_ring_size) != SUCCESS)
+			goto failure;
+		adi_uart_RegisterCallback(aducm_desc->uart_handler,
+					  uart_ring_callback,
+					  (*desc));
+		/* Two buffers in flight so no byte is missed while one is copied */
+		for (i = 0; i < 2; i++)
+			adi_uart_SubmitRxBuffer(aducm_desc->uart_handler,
+						aducm_desc->rx_chunk[i],
+						ADUCM_UART_RX_CHUNK, true);
+	}
+
 	return SUCCESS;
 failure:
+	cb_remove(aducm_desc->rx_cb);
 	free_desc_mem(*desc);
 	*desc = NULL;
 	return FAILURE;
@@ -386,6 +571,7 @@ int32_t uart_remove(struct uart_desc *desc)
 	aducm_desc = desc->extra;
 
 	adi_uart_Close(aducm_desc->uart_handler);
+	cb_remove(aducm_desc->rx_cb);
 	free_desc_mem(desc);
 	initialized[desc->device_id] = 0;
 
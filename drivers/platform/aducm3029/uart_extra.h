@@ -48,6 +48,17 @@
 #include <drivers/pwr/adi_pwr.h>
 #include <stdint.h>
 #include "error.h"
+#include "circular_buffer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/**
+ * Size of the DMA buffers kept submitted to the ADI driver in ring buffer mode.
+ * Partially filled buffers are flushed when the reader runs out of data.
+ */
+#define ADUCM_UART_RX_CHUNK	32u
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -207,6 +218,12 @@ struct aducm_uart_init_param {
 	UART_CALLBACK		callback;
 	/** Set a parameter to be passed to the callback as app_param */
 	void			*param;
+	/**
+	 * Size of the receive ring buffer (optional). When set, the driver
+	 * receives in the background and \ref uart_read copies from the ring
+	 * buffer. Can not be used together with callback.
+	 */
+	uint32_t		rx_ring_size;
 };
 
 /**
@@ -243,6 +260,14 @@ struct aducm_uart_desc {
 	 * is called and reset when the buffer is processed
 	 */
 	uint32_t	waiting_write_callback;
+	/** Receive ring buffer, NULL when not in ring buffer mode */
+	struct circular_buffer	*rx_cb;
+	/** Buffers submitted to the ADI driver in ring buffer mode */
+	uint8_t		rx_chunk[2][ADUCM_UART_RX_CHUNK];
+	/** Index of the buffer being filled */
+	uint32_t	rx_head;
+	/** Bytes of the buffer being filled already moved to the ring */
+	uint32_t	rx_taken;
 };
 
 #endif /* UART_H_ */
@@ -77,3 +77,43 @@ int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return SUCCESS;
 }
 
+/**
+ * @brief AXI IO Altera specific block write function, for memory (e.g. DMA
+ * buffers in DDR).
+ * @param base - Base address
+ * @param offset - Address offset
+ * @param data - words to be written.
+ * @param count - number of words.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_buf(uint32_t base, uint32_t offset, const uint32_t *data,
+			 uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+		IOWR_32DIRECT(base, offset + i * sizeof(*data), data[i]);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO Altera specific map function. The address space is always mapped.
+ * @param base - Base address
+ * @param size - Size of the range, in bytes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_map(uint32_t base, uint32_t size)
+{
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO Altera specific unmap function. The address space is always mapped.
+ * @param base - Base address
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_unmap(uint32_t base)
+{
+	return SUCCESS;
+}
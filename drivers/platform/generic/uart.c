@@ -72,6 +72,31 @@ int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number)
 	return SUCCESS;
 }
 
+/**
+ * @brief Read the data already received, without waiting.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Maximum number of bytes to read.
+ * @return Number of bytes read, negative error code otherwise.
+ */
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number)
+{
+	if (desc) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (data) {
+		// Unused variable - fix compiler warning
+	}
+
+	if (bytes_number) {
+		// Unused variable - fix compiler warning
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief Write data to UART device.
  * @param desc - Instance of UART.
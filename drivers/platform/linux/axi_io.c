@@ -42,74 +42,140 @@
 /******************************************************************************/
 #include <fcntl.h>
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/mman.h>
 #include "error.h"
 #include "axi_io.h"
 
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct axi_io_mapping
+ * @brief Range kept mapped by axi_io_map().
+ */
+struct axi_io_mapping {
+	/** UIO index, valid if addr is not NULL */
+	uint32_t base;
+	/** UIO file descriptor */
+	int fd;
+	/** Mapped address */
+	void *addr;
+	/** Mapped length, in bytes */
+	size_t len;
+};
+
+static struct axi_io_mapping axi_io_kept;
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
 /**
- * @brief AXI IO through UIO read/write function.
+ * @brief Open and map a UIO device.
  * @param base - UIO index (/dev/uioX).
- * @param offset - Address offset.
- * @param read - Location where read data will be stored.
- * @param write - Data to be written.
+ * @param len - Length to be mapped, in bytes.
+ * @param map - The mapping.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t axi_io_read_write(uint32_t base, uint32_t offset, uint32_t *read,
-				 uint32_t *write)
+static int32_t axi_io_open(uint32_t base, size_t len,
+			   struct axi_io_mapping *map)
 {
 	char buf[32];
-	int ret;
-	int uio_fd;
-	int32_t status = SUCCESS;
-	void *uio_addr;
 
 	sprintf(buf, "/dev/uio%"PRIu32"", base);
 
-	uio_fd = open(buf, O_RDWR);
-	if (uio_fd < 0) {
+	map->fd = open(buf, O_RDWR);
+	if (map->fd < 0) {
 		printf("%s: Can't open %s\n\r", __func__, buf);
 		return FAILURE;
 	}
 
-	uio_addr = mmap(NULL,
-			offset + sizeof(*read),
-			PROT_READ|PROT_WRITE,
-			MAP_SHARED,
-			uio_fd,
-			0);
-	if (uio_addr == MAP_FAILED) {
+	map->addr = mmap(NULL,
+			 len,
+			 PROT_READ|PROT_WRITE,
+			 MAP_SHARED,
+			 map->fd,
+			 0);
+	if (map->addr == MAP_FAILED) {
 		printf("%s: mmap() failed\n\r", __func__);
-		status = FAILURE;
-		goto close;
+		map->addr = NULL;
+		close(map->fd);
+		return FAILURE;
 	}
 
-	if (read)
-		*read = *(uint32_t *)((uintptr_t)uio_addr + offset);
-	if (write)
-		*(uint32_t *)((uintptr_t)uio_addr + offset) = *write;
+	map->base = base;
+	map->len = len;
 
-	ret = munmap(uio_addr, offset + sizeof(*read));
+	return SUCCESS;
+}
+
+/**
+ * @brief Unmap and close a UIO device.
+ * @param map - The mapping.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t axi_io_close(struct axi_io_mapping *map)
+{
+	int32_t status = SUCCESS;
+	int ret;
+
+	ret = munmap(map->addr, map->len);
 	if (ret < 0) {
 		printf("%s: munmap() failed\n\r", __func__);
 		status = FAILURE;
 	}
+	map->addr = NULL;
 
-close:
-	ret = close(uio_fd);
+	ret = close(map->fd);
 	if (ret < 0) {
-		printf("%s: Can't close %s\n\r", __func__, buf);
+		printf("%s: Can't close /dev/uio%"PRIu32"\n\r", __func__,
+		       map->base);
 		status = FAILURE;
 	}
 
 	return status;
 }
 
+/**
+ * @brief AXI IO through UIO read/write function.
+ * @param base - UIO index (/dev/uioX).
+ * @param offset - Address offset.
+ * @param read - Location where read data will be stored.
+ * @param write - Data to be written.
+ * @param count - Number of words to read or write.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t axi_io_read_write(uint32_t base, uint32_t offset, uint32_t *read,
+				 const uint32_t *write, uint32_t count)
+{
+	struct axi_io_mapping map;
+	size_t len = offset + count * sizeof(uint32_t);
+	bool kept;
+
+	kept = axi_io_kept.addr && axi_io_kept.base == base &&
+	       len <= axi_io_kept.len;
+	if (kept)
+		map = axi_io_kept;
+	else if (axi_io_open(base, len, &map) != SUCCESS)
+		return FAILURE;
+
+	if (read)
+		*read = *(uint32_t *)((uintptr_t)map.addr + offset);
+	if (write)
+		memcpy((void *)((uintptr_t)map.addr + offset), write,
+		       count * sizeof(uint32_t));
+
+	if (kept)
+		return SUCCESS;
+
+	return axi_io_close(&map);
+}
+
 /**
  * @brief AXI IO through UIO read function.
  * @param base - UIO index (/dev/uioX).
@@ -119,7 +185,7 @@ close:
  */
 int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
 {
-	return axi_io_read_write(base, offset, data, NULL);
+	return axi_io_read_write(base, offset, data, NULL, 1);
 }
 
 /**
@@ -131,5 +197,52 @@ int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
  */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 {
-	return axi_io_read_write(base, offset, NULL, &data);
+	return axi_io_read_write(base, offset, NULL, &data, 1);
+}
+
+/**
+ * @brief AXI IO through UIO block write function, with a single mapping of
+ * the whole block, or none inside an axi_io_map() range.
+ * @param base - UIO index (/dev/uioX).
+ * @param offset - Address offset.
+ * @param data - Words to be written.
+ * @param count - Number of words.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_buf(uint32_t base, uint32_t offset, const uint32_t *data,
+			 uint32_t count)
+{
+	return axi_io_read_write(base, offset, NULL, data, count);
+}
+
+/**
+ * @brief AXI IO through UIO map function. The range stays mapped, and is
+ * accessed without opening the device again, until axi_io_unmap(). A single
+ * range is kept at a time.
+ * @param base - UIO index (/dev/uioX).
+ * @param size - Size of the range, in bytes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_map(uint32_t base, uint32_t size)
+{
+	if (axi_io_kept.addr) {
+		if (axi_io_kept.base == base && size <= axi_io_kept.len)
+			return SUCCESS;
+		axi_io_close(&axi_io_kept);
+	}
+
+	return axi_io_open(base, size, &axi_io_kept);
+}
+
+/**
+ * @brief AXI IO through UIO unmap function.
+ * @param base - UIO index (/dev/uioX).
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_unmap(uint32_t base)
+{
+	if (!axi_io_kept.addr || axi_io_kept.base != base)
+		return FAILURE;
+
+	return axi_io_close(&axi_io_kept);
 }
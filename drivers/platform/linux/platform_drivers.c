@@ -40,13 +40,18 @@
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
+#include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include "platform_drivers.h"
+#include <linux/gpio.h>
 #include <linux/i2c-dev.h>
 #include <linux/spi/spidev.h>
 
@@ -267,6 +272,329 @@ int32_t spi_write_and_read(spi_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Release the line handle or line event fd of a chardev GPIO.
+ * @param desc - The GPIO descriptor.
+ * @return None.
+ */
+static void gpio_chardev_release(gpio_desc *desc)
+{
+	if (desc->fd >= 0)
+		close(desc->fd);
+	desc->fd = -1;
+	desc->edges = 0;
+}
+
+/**
+ * @brief Request a chardev GPIO line with the given direction.
+ *
+ * The line handle stays open until the direction changes or the
+ * descriptor is removed, so value accesses cost a single ioctl.
+ * @param desc - The GPIO descriptor.
+ * @param direction - GPIO_OUT or GPIO_IN.
+ * @param value - Initial value for an output.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t gpio_chardev_request(gpio_desc *desc,
+				    uint8_t direction,
+				    uint8_t value)
+{
+	struct gpiohandle_request req;
+	int ret;
+
+	gpio_chardev_release(desc);
+
+	memset(&req, 0, sizeof(req));
+	req.lineoffsets[0] = desc->line;
+	req.lines = 1;
+	req.flags = (direction == GPIO_OUT) ? GPIOHANDLE_REQUEST_OUTPUT :
+		    GPIOHANDLE_REQUEST_INPUT;
+	req.default_values[0] = !!value;
+	snprintf(req.consumer_label, sizeof(req.consumer_label), "no-OS");
+
+	ret = ioctl(desc->chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &req);
+	if (ret < 0) {
+		printf("%s: Can't request line %"PRIu32"\n\r", __func__,
+		       desc->line);
+		return FAILURE;
+	}
+
+	desc->fd = req.fd;
+	desc->direction = direction;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Obtain a GPIO descriptor for a line of a GPIO character device.
+ * @param desc - The GPIO descriptor.
+ * @param chip_path - The GPIO chip device, e.g. "/dev/gpiochip0".
+ * @param line - The line offset within the chip.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_get_chardev(gpio_desc **desc,
+			 const char *chip_path,
+			 uint32_t line)
+{
+	gpio_desc *descriptor;
+
+	descriptor = (gpio_desc *)calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	descriptor->type = CHARDEV_GPIO;
+	descriptor->number = line;
+	descriptor->line = line;
+	descriptor->fd = -1;
+	descriptor->direction = GPIO_IN;
+
+	descriptor->chip_fd = open(chip_path, O_RDWR | O_CLOEXEC);
+	if (descriptor->chip_fd < 0) {
+		printf("%s: Can't open device\n\r", __func__);
+		free(descriptor);
+		return FAILURE;
+	}
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Report edges of an input line through gpio_wait_event().
+ *
+ * The line is requested as an input for as long as events are enabled.
+ * Calling gpio_direction_input() or gpio_direction_output() disables them.
+ * @param desc - The GPIO descriptor (CHARDEV_GPIO only).
+ * @param edges - Combination of GPIO_EDGE_RISING and GPIO_EDGE_FALLING.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_enable_events(gpio_desc *desc,
+			   uint8_t edges)
+{
+	struct gpioevent_request req;
+	int ret;
+
+	if (desc->type != CHARDEV_GPIO || !edges)
+		return FAILURE;
+
+	gpio_chardev_release(desc);
+
+	memset(&req, 0, sizeof(req));
+	req.lineoffset = desc->line;
+	req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+	if (edges & GPIO_EDGE_RISING)
+		req.eventflags |= GPIOEVENT_REQUEST_RISING_EDGE;
+	if (edges & GPIO_EDGE_FALLING)
+		req.eventflags |= GPIOEVENT_REQUEST_FALLING_EDGE;
+	snprintf(req.consumer_label, sizeof(req.consumer_label), "no-OS");
+
+	ret = ioctl(desc->chip_fd, GPIO_GET_LINEEVENT_IOCTL, &req);
+	if (ret < 0) {
+		printf("%s: Can't request events on line %"PRIu32"\n\r",
+		       __func__, desc->line);
+		return FAILURE;
+	}
+
+	desc->fd = req.fd;
+	desc->direction = GPIO_IN;
+	desc->edges = edges;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for an edge on a line set up by gpio_enable_events().
+ * @param desc - The GPIO descriptor.
+ * @param timeout_ms - Time to wait in milliseconds, negative to wait forever.
+ * @param edge - The edge that occurred (GPIO_EDGE_RISING or
+ *               GPIO_EDGE_FALLING). May be NULL.
+ * @param timestamp_ns - Kernel timestamp of the edge. May be NULL.
+ * @return SUCCESS when an event was read, -ETIMEDOUT when none arrived in
+ *         time, FAILURE otherwise.
+ */
+int32_t gpio_wait_event(gpio_desc *desc,
+			int32_t timeout_ms,
+			uint8_t *edge,
+			uint64_t *timestamp_ns)
+{
+	struct gpioevent_data event;
+	struct pollfd pfd;
+	ssize_t len;
+	int ret;
+
+	if (desc->type != CHARDEV_GPIO || !desc->edges)
+		return FAILURE;
+
+	pfd.fd = desc->fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	ret = poll(&pfd, 1, timeout_ms);
+	if (ret < 0) {
+		printf("%s: Can't poll line %"PRIu32"\n\r", __func__, desc->line);
+		return FAILURE;
+	}
+	if (ret == 0)
+		return -ETIMEDOUT;
+
+	len = read(desc->fd, &event, sizeof(event));
+	if (len != sizeof(event)) {
+		printf("%s: Can't read event\n\r", __func__);
+		return FAILURE;
+	}
+
+	if (edge)
+		*edge = (event.id == GPIOEVENT_EVENT_RISING_EDGE) ?
+			GPIO_EDGE_RISING : GPIO_EDGE_FALLING;
+	if (timestamp_ns)
+		*timestamp_ns = event.timestamp;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Request several lines of one GPIO chip as a single handle.
+ *
+ * All the lines of a group are read or written with one ioctl.
+ * @param desc - The GPIO group descriptor.
+ * @param chip_path - The GPIO chip device, e.g. "/dev/gpiochip0".
+ * @param lines - Line offsets within the chip.
+ * @param num_lines - Number of lines (at most GPIO_GROUP_MAX_LINES).
+ * @param direction - GPIO_OUT or GPIO_IN, shared by all the lines.
+ * @param values - Initial output values, one per line. May be NULL.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_group_get(gpio_group_desc **desc,
+		       const char *chip_path,
+		       const uint32_t *lines,
+		       uint32_t num_lines,
+		       uint8_t direction,
+		       const uint8_t *values)
+{
+	struct gpiohandle_request req;
+	gpio_group_desc *descriptor;
+	uint32_t i;
+	int ret;
+
+	if (!num_lines || num_lines > GPIO_GROUP_MAX_LINES)
+		return FAILURE;
+
+	descriptor = (gpio_group_desc *)calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	descriptor->chip_fd = open(chip_path, O_RDWR | O_CLOEXEC);
+	if (descriptor->chip_fd < 0) {
+		printf("%s: Can't open device\n\r", __func__);
+		free(descriptor);
+		return FAILURE;
+	}
+
+	memset(&req, 0, sizeof(req));
+	for (i = 0; i < num_lines; i++) {
+		req.lineoffsets[i] = lines[i];
+		descriptor->lines[i] = lines[i];
+		if (values)
+			req.default_values[i] = !!values[i];
+	}
+	req.lines = num_lines;
+	req.flags = (direction == GPIO_OUT) ? GPIOHANDLE_REQUEST_OUTPUT :
+		    GPIOHANDLE_REQUEST_INPUT;
+	snprintf(req.consumer_label, sizeof(req.consumer_label), "no-OS");
+
+	ret = ioctl(descriptor->chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &req);
+	if (ret < 0) {
+		printf("%s: Can't request lines\n\r", __func__);
+		close(descriptor->chip_fd);
+		free(descriptor);
+		return FAILURE;
+	}
+
+	descriptor->fd = req.fd;
+	descriptor->num_lines = num_lines;
+	descriptor->direction = direction;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by gpio_group_get().
+ * @param desc - The GPIO group descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_group_remove(gpio_group_desc *desc)
+{
+	int ret;
+
+	close(desc->fd);
+	ret = close(desc->chip_fd);
+	if (ret < 0) {
+		printf("%s: Can't close device\n\r", __func__);
+		return FAILURE;
+	}
+
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the values of all the lines in a group.
+ * @param desc - The GPIO group descriptor.
+ * @param values - One value per line, in the order given to gpio_group_get().
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_group_set_values(gpio_group_desc *desc,
+			      const uint8_t *values)
+{
+	struct gpiohandle_data data;
+	uint32_t i;
+	int ret;
+
+	if (desc->direction != GPIO_OUT)
+		return FAILURE;
+
+	memset(&data, 0, sizeof(data));
+	for (i = 0; i < desc->num_lines; i++)
+		data.values[i] = !!values[i];
+
+	ret = ioctl(desc->fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+	if (ret < 0) {
+		printf("%s: Can't set values\n\r", __func__);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the values of all the lines in a group.
+ * @param desc - The GPIO group descriptor.
+ * @param values - One value per line, in the order given to gpio_group_get().
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_group_get_values(gpio_group_desc *desc,
+			      uint8_t *values)
+{
+	struct gpiohandle_data data;
+	uint32_t i;
+	int ret;
+
+	ret = ioctl(desc->fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data);
+	if (ret < 0) {
+		printf("%s: Can't get values\n\r", __func__);
+		return FAILURE;
+	}
+
+	for (i = 0; i < desc->num_lines; i++)
+		values[i] = data.values[i] ? GPIO_HIGH : GPIO_LOW;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Obtain the GPIO decriptor.
  * @param desc - The GPIO descriptor.
@@ -286,7 +614,9 @@ int32_t gpio_get(gpio_desc **desc,
 	if (!descriptor)
 		return FAILURE;
 
+	descriptor->type = GENERIC_GPIO;
 	descriptor->number = gpio_number;
+	descriptor->fd = -1;
 
 	fd = open("/sys/class/gpio/export", O_WRONLY);
 	if (fd < 0) {
@@ -328,6 +658,17 @@ int32_t gpio_remove(gpio_desc *desc)
 	int len;
 	int ret;
 
+	if (desc->type == CHARDEV_GPIO) {
+		gpio_chardev_release(desc);
+		ret = close(desc->chip_fd);
+		if (ret < 0) {
+			printf("%s: Can't close device\n\r", __func__);
+			return FAILURE;
+		}
+		free(desc);
+		return SUCCESS;
+	}
+
 	fd = open("/sys/class/gpio/unexport", O_WRONLY);
 	if (fd < 0) {
 		printf("%s: Can't open device\n\r", __func__);
@@ -363,6 +704,9 @@ int32_t gpio_direction_input(gpio_desc *desc)
 	int fd;
 	int ret;
 
+	if (desc->type == CHARDEV_GPIO)
+		return gpio_chardev_request(desc, GPIO_IN, 0);
+
 	sprintf(buf, "/sys/class/gpio/gpio%d/direction", desc->number);
 	fd = open(buf, O_WRONLY);
 	if (fd < 0) {
@@ -400,6 +744,9 @@ int32_t gpio_direction_output(gpio_desc *desc,
 	int fd;
 	int ret;
 
+	if (desc->type == CHARDEV_GPIO)
+		return gpio_chardev_request(desc, GPIO_OUT, value);
+
 	sprintf(buf, "/sys/class/gpio/gpio%d/direction", desc->number);
 	fd = open(buf, O_WRONLY);
 	if (fd < 0) {
@@ -444,6 +791,11 @@ int32_t gpio_get_direction(gpio_desc *desc,
 	int fd;
 	int ret;
 
+	if (desc->type == CHARDEV_GPIO) {
+		*direction = desc->direction;
+		return SUCCESS;
+	}
+
 	sprintf(buf, "/sys/class/gpio/gpio%d/direction", desc->number);
 	fd = open(buf, O_RDONLY);
 	if (fd < 0) {
@@ -486,6 +838,25 @@ int32_t gpio_set_value(gpio_desc *desc,
 	int fd;
 	int ret;
 
+	if (desc->type == CHARDEV_GPIO) {
+		struct gpiohandle_data data;
+
+		if (desc->fd < 0 || desc->direction != GPIO_OUT) {
+			printf("%s: Line is not an output\n\r", __func__);
+			return FAILURE;
+		}
+
+		memset(&data, 0, sizeof(data));
+		data.values[0] = !!value;
+		ret = ioctl(desc->fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+		if (ret < 0) {
+			printf("%s: Can't set value\n\r", __func__);
+			return FAILURE;
+		}
+
+		return SUCCESS;
+	}
+
 	sprintf(buf, "/sys/class/gpio/gpio%d/value", desc->number);
 	fd = open(buf, O_WRONLY);
 	if (fd < 0) {
@@ -527,6 +898,25 @@ int32_t gpio_get_value(gpio_desc *desc,
 	int fd;
 	int ret;
 
+	if (desc->type == CHARDEV_GPIO) {
+		struct gpiohandle_data data;
+
+		if (desc->fd < 0) {
+			ret = gpio_chardev_request(desc, GPIO_IN, 0);
+			if (ret != SUCCESS)
+				return ret;
+		}
+
+		ret = ioctl(desc->fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data);
+		if (ret < 0) {
+			printf("%s: Can't read value\n\r", __func__);
+			return FAILURE;
+		}
+		*value = data.values[0] ? GPIO_HIGH : GPIO_LOW;
+
+		return SUCCESS;
+	}
+
 	sprintf(buf, "/sys/class/gpio/gpio%d/value", desc->number);
 	fd = open(buf, O_RDONLY);
 	if (fd < 0) {
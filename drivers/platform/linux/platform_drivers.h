@@ -56,6 +56,11 @@
 #define GPIO_HIGH	0x01
 #define GPIO_LOW	0x00
 
+#define GPIO_EDGE_RISING	0x01
+#define GPIO_EDGE_FALLING	0x02
+
+#define GPIO_GROUP_MAX_LINES	64
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -110,15 +115,33 @@ typedef struct {
 } spi_desc;
 
 typedef enum {
-	GENERIC_GPIO
+	/* sysfs GPIO, identified by its global number */
+	GENERIC_GPIO,
+	/* GPIO character device line, identified by chip and offset */
+	CHARDEV_GPIO
 } gpio_type;
 
 typedef struct {
 	gpio_type	type;
 	uint32_t	id;
 	uint8_t		number;
+	/* CHARDEV_GPIO only */
+	int		chip_fd;
+	/* Line handle or line event fd, -1 while the line is not requested */
+	int		fd;
+	uint32_t	line;
+	uint8_t		direction;
+	uint8_t		edges;
 } gpio_desc;
 
+typedef struct {
+	int		chip_fd;
+	int		fd;
+	uint32_t	num_lines;
+	uint32_t	lines[GPIO_GROUP_MAX_LINES];
+	uint8_t		direction;
+} gpio_group_desc;
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -180,6 +203,40 @@ int32_t gpio_set_value(gpio_desc *desc,
 int32_t gpio_get_value(gpio_desc *desc,
 		       uint8_t *value);
 
+/* Obtain a GPIO descriptor for a line of a GPIO character device. */
+int32_t gpio_get_chardev(gpio_desc **desc,
+			 const char *chip_path,
+			 uint32_t line);
+
+/* Report edges of an input line through gpio_wait_event(). */
+int32_t gpio_enable_events(gpio_desc *desc,
+			   uint8_t edges);
+
+/* Wait for an edge on a line set up by gpio_enable_events(). */
+int32_t gpio_wait_event(gpio_desc *desc,
+			int32_t timeout_ms,
+			uint8_t *edge,
+			uint64_t *timestamp_ns);
+
+/* Request several lines of one GPIO chip as a single handle. */
+int32_t gpio_group_get(gpio_group_desc **desc,
+		       const char *chip_path,
+		       const uint32_t *lines,
+		       uint32_t num_lines,
+		       uint8_t direction,
+		       const uint8_t *values);
+
+/* Free the resources allocated by gpio_group_get(). */
+int32_t gpio_group_remove(gpio_group_desc *desc);
+
+/* Set the values of all the lines in a group. */
+int32_t gpio_group_set_values(gpio_group_desc *desc,
+			      const uint8_t *values);
+
+/* Get the values of all the lines in a group. */
+int32_t gpio_group_get_values(gpio_group_desc *desc,
+			      uint8_t *values);
+
 /* Generate microseconds delay. */
 void udelay(uint32_t usecs);
 
@@ -0,0 +1,133 @@
+/***************************************************************************//**
+ *   @file   axi_io.c
+ *   @brief  Implementation of the simulated platform AXI IO, routed to device models.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "axi_io.h"
+#include "sim.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief AXI IO read, served by the model mapped at the address.
+ * @param base - Base address
+ * @param offset - Address offset
+ * @param data - variable where returned data is stored
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
+{
+	struct sim_model *model = sim_mmio_find(base + offset);
+
+	sim_get_stats()->mmio_reads++;
+
+	if (!model) {
+		*data = 0;
+		return FAILURE;
+	}
+
+	return model->mmio_read(model, base + offset - model->base, data);
+}
+
+/**
+ * @brief AXI IO write, served by the model mapped at the address.
+ * @param base - Base address
+ * @param offset - Address offset
+ * @param data - data to be written.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
+{
+	struct sim_model *model = sim_mmio_find(base + offset);
+
+	sim_get_stats()->mmio_writes++;
+
+	if (!model)
+		return FAILURE;
+
+	return model->mmio_write(model, base + offset - model->base, data);
+}
+
+/**
+ * @brief AXI IO block write, served word by word by the model mapped at the
+ * address.
+ * @param base - Base address
+ * @param offset - Address offset
+ * @param data - words to be written.
+ * @param count - number of words.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_buf(uint32_t base, uint32_t offset, const uint32_t *data,
+			 uint32_t count)
+{
+	int32_t ret = SUCCESS;
+	uint32_t i;
+
+	for (i = 0; i < count; i++)
+		if (axi_io_write(base, offset + i * sizeof(*data), data[i]))
+			ret = FAILURE;
+
+	return ret;
+}
+
+/**
+ * @brief AXI IO map function. The address space is always mapped.
+ * @param base - Base address
+ * @param size - Size of the range, in bytes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_map(uint32_t base, uint32_t size)
+{
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO unmap function. The address space is always mapped.
+ * @param base - Base address
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_unmap(uint32_t base)
+{
+	return SUCCESS;
+}
@@ -0,0 +1,210 @@
+/***************************************************************************//**
+ *   @file   gpio.c
+ *   @brief  Implementation of the simulated platform GPIO driver.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "error.h"
+#include "gpio.h"
+#include "sim.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/** Level driven by the drivers on outputs */
+static uint8_t sim_gpio_out[SIM_GPIO_NUM];
+/** Level driven by the test bench on inputs */
+static uint8_t sim_gpio_in[SIM_GPIO_NUM];
+/** Current direction */
+static uint8_t sim_gpio_dir[SIM_GPIO_NUM];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Drive the level seen by gpio_get_value() on an input.
+ * @param number - The GPIO number.
+ * @param value - GPIO_HIGH or GPIO_LOW.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_gpio_set_input(uint8_t number, uint8_t value)
+{
+	sim_gpio_in[number] = !!value;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read back the level driven by gpio_set_value().
+ * @param number - The GPIO number.
+ * @param value - The level.
+ * @return SUCCESS in case of success, FAILURE if the GPIO is an input.
+ */
+int32_t sim_gpio_get_output(uint8_t number, uint8_t *value)
+{
+	if (sim_gpio_dir[number] != GPIO_OUT)
+		return FAILURE;
+
+	*value = sim_gpio_out[number];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Obtain the GPIO decriptor.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO initialization parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_get(struct gpio_desc **desc,
+		 const struct gpio_init_param *param)
+{
+	struct gpio_desc *descriptor;
+
+	if (!desc || !param)
+		return FAILURE;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	descriptor->number = param->number;
+	descriptor->extra = param->extra;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by gpio_get().
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_remove(struct gpio_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the input direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_direction_input(struct gpio_desc *desc)
+{
+	sim_get_stats()->gpio_ops++;
+	sim_gpio_dir[desc->number] = GPIO_IN;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the output direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_direction_output(struct gpio_desc *desc,
+			      uint8_t value)
+{
+	sim_get_stats()->gpio_ops++;
+	sim_gpio_dir[desc->number] = GPIO_OUT;
+	sim_gpio_out[desc->number] = !!value;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param direction - The direction.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_get_direction(struct gpio_desc *desc,
+			   uint8_t *direction)
+{
+	*direction = sim_gpio_dir[desc->number];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_set_value(struct gpio_desc *desc,
+		       uint8_t value)
+{
+	sim_get_stats()->gpio_ops++;
+	sim_gpio_out[desc->number] = !!value;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the value of the specified GPIO. Outputs read back the driven
+ * level, inputs the level set with sim_gpio_set_input().
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t gpio_get_value(struct gpio_desc *desc,
+		       uint8_t *value)
+{
+	sim_get_stats()->gpio_ops++;
+
+	if (sim_gpio_dir[desc->number] == GPIO_OUT)
+		*value = sim_gpio_out[desc->number];
+	else
+		*value = sim_gpio_in[desc->number];
+
+	return SUCCESS;
+}
@@ -0,0 +1,224 @@
+/***************************************************************************//**
+ *   @file   irq.c
+ *   @brief  Implementation of the simulated platform IRQ controller.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "error.h"
+#include "irq.h"
+#include "irq_extra.h"
+#include "sim.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the interrupt controller.
+ * @param desc - The IRQ controller descriptor.
+ * @param param - The structure that contains the IRQ parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_ctrl_init(struct irq_ctrl_desc **desc,
+		      const struct irq_init_param *param)
+{
+	struct irq_ctrl_desc *descriptor;
+
+	if (!desc || !param)
+		return FAILURE;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	descriptor->extra = calloc(1, sizeof(struct sim_irq_desc));
+	if (!descriptor->extra) {
+		free(descriptor);
+		return FAILURE;
+	}
+	descriptor->irq_ctrl_id = param->irq_ctrl_id;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by irq_ctrl_init().
+ * @param desc - The IRQ controller descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_ctrl_remove(struct irq_ctrl_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Register an IRQ handler.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @param irq_handler - The IRQ handler.
+ * @param dev_instance - Passed to the handler.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_register(struct irq_ctrl_desc *desc, uint32_t irq_id,
+		     void (*irq_handler)(void *data), void *dev_instance)
+{
+	struct sim_irq_desc *sim_desc = desc->extra;
+
+	if (irq_id >= SIM_IRQ_NUM)
+		return FAILURE;
+
+	sim_desc->lines[irq_id].handler = irq_handler;
+	sim_desc->lines[irq_id].data = dev_instance;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unregister an IRQ handler.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_unregister(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_desc *sim_desc = desc->extra;
+
+	if (irq_id >= SIM_IRQ_NUM)
+		return FAILURE;
+
+	sim_desc->lines[irq_id].handler = NULL;
+	sim_desc->lines[irq_id].enabled = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Global interrupt enable.
+ * @param desc - The IRQ controller descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_global_enable(struct irq_ctrl_desc *desc)
+{
+	struct sim_irq_desc *sim_desc = desc->extra;
+
+	sim_desc->enabled = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Global interrupt disable.
+ * @param desc - The IRQ controller descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_global_disable(struct irq_ctrl_desc *desc)
+{
+	struct sim_irq_desc *sim_desc = desc->extra;
+
+	sim_desc->enabled = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable a specific interrupt.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_source_enable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_desc *sim_desc = desc->extra;
+
+	if (irq_id >= SIM_IRQ_NUM)
+		return FAILURE;
+
+	sim_desc->lines[irq_id].enabled = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Disable a specific interrupt.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_source_disable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_desc *sim_desc = desc->extra;
+
+	if (irq_id >= SIM_IRQ_NUM)
+		return FAILURE;
+
+	sim_desc->lines[irq_id].enabled = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Raise an interrupt. The handler runs synchronously when both the
+ * line and the controller are enabled.
+ * @param desc - The IRQ controller descriptor.
+ * @param irq_id - Interrupt identifier.
+ * @return SUCCESS if the handler ran, FAILURE otherwise.
+ */
+int32_t sim_irq_trigger(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_desc *sim_desc = desc->extra;
+
+	if (irq_id >= SIM_IRQ_NUM || !sim_desc->enabled ||
+	    !sim_desc->lines[irq_id].enabled || !sim_desc->lines[irq_id].handler)
+		return FAILURE;
+
+	sim_get_stats()->irqs++;
+	sim_desc->lines[irq_id].handler(sim_desc->lines[irq_id].data);
+
+	return SUCCESS;
+}
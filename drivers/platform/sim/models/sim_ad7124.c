@@ -0,0 +1,191 @@
+/***************************************************************************//**
+ *   @file   sim_ad7124.c
+ *   @brief  AD7124 register map model for the simulated platform.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "sim_models.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_AD7124_NUM_REGS		0x39
+
+#define SIM_AD7124_COMM_READ		(1 << 6)
+#define SIM_AD7124_COMM_ADDR(x)		((x) & 0x3F)
+
+#define SIM_AD7124_STATUS		0x00
+#define SIM_AD7124_ADC_CTRL		0x01
+#define SIM_AD7124_DATA			0x02
+#define SIM_AD7124_ID			0x05
+#define SIM_AD7124_CH0			0x09
+#define SIM_AD7124_CFG0			0x19
+#define SIM_AD7124_FILTER0		0x21
+#define SIM_AD7124_OFFSET0		0x29
+#define SIM_AD7124_GAIN0		0x31
+
+#define SIM_AD7124_RAMP_STEP		0x1000
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the size in bytes of a register.
+ * @param reg - Register address.
+ * @return The register size.
+ */
+static uint8_t sim_ad7124_reg_size(uint32_t reg)
+{
+	switch (reg) {
+	case SIM_AD7124_STATUS:
+	case SIM_AD7124_ID:
+	case 0x08:
+		return 1;
+	case SIM_AD7124_ADC_CTRL:
+	case 0x04:
+		return 2;
+	default:
+		if (reg >= SIM_AD7124_CH0 && reg < SIM_AD7124_FILTER0)
+			return 2;
+		return 3;
+	}
+}
+
+/**
+ * @brief Restore the power-on register values.
+ * @param model - The model.
+ * @return None.
+ */
+static void sim_ad7124_reset(struct sim_model *model)
+{
+	uint32_t i;
+
+	for (i = 0; i < model->num_regs; i++)
+		model->regs[i] = 0;
+
+	model->regs[SIM_AD7124_ID] = 0x14;
+	model->regs[SIM_AD7124_CH0] = 0x8001;
+	for (i = 0; i < 8; i++) {
+		model->regs[SIM_AD7124_CFG0 + i] = 0x0860;
+		model->regs[SIM_AD7124_FILTER0 + i] = 0x060180;
+		model->regs[SIM_AD7124_OFFSET0 + i] = 0x800000;
+		model->regs[SIM_AD7124_GAIN0 + i] = 0x500000;
+	}
+}
+
+/**
+ * @brief Decode an AD7124 SPI transfer: a communications byte followed by the
+ * register value, most significant byte first. 64 bits of ones reset the
+ * register map. Conversion data is a ramp, the status register always reports
+ * a ready result.
+ * @param model - The model.
+ * @param data - Transfer buffer, MISO bytes are written in place.
+ * @param bytes_number - Transfer length.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_ad7124_spi_xfer(struct sim_model *model, uint8_t *data,
+				   uint16_t bytes_number)
+{
+	uint32_t reg, val, i;
+	uint8_t size;
+	uint16_t ones = 0;
+
+	for (i = 0; i < bytes_number; i++)
+		if (data[i] == 0xFF)
+			ones++;
+	if (ones == bytes_number && bytes_number >= 8) {
+		sim_ad7124_reset(model);
+		return SUCCESS;
+	}
+
+	if (bytes_number < 2)
+		return FAILURE;
+
+	reg = SIM_AD7124_COMM_ADDR(data[0]);
+	if (reg >= SIM_AD7124_NUM_REGS)
+		return FAILURE;
+	size = sim_ad7124_reg_size(reg);
+	if (size > bytes_number - 1)
+		size = bytes_number - 1;
+
+	if (data[0] & SIM_AD7124_COMM_READ) {
+		if (reg == SIM_AD7124_DATA)
+			model->regs[reg] = (model->regs[reg] +
+					    SIM_AD7124_RAMP_STEP) & 0xFFFFFF;
+		val = sim_reg_read(model, reg);
+		for (i = 0; i < size; i++)
+			data[1 + i] = val >> (8 * (size - 1 - i));
+	} else {
+		val = 0;
+		for (i = 0; i < size; i++)
+			val = (val << 8) | data[1 + i];
+		sim_reg_write(model, reg, val);
+	}
+	data[0] = 0;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Create an AD7124 model. CRC checking is not modelled.
+ * @param model - The model.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_ad7124_init(struct sim_model **model)
+{
+	struct sim_model *m;
+	int32_t ret;
+
+	ret = sim_model_alloc(&m, "ad7124", SIM_AD7124_NUM_REGS);
+	if (ret != SUCCESS)
+		return ret;
+
+	m->spi_xfer = sim_ad7124_spi_xfer;
+	sim_ad7124_reset(m);
+	/* RDY is active low */
+	sim_reg_force(m, SIM_AD7124_STATUS, 0x80, 0x00);
+
+	*model = m;
+
+	return SUCCESS;
+}
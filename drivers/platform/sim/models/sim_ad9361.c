@@ -0,0 +1,179 @@
+/***************************************************************************//**
+ *   @file   sim_ad9361.c
+ *   @brief  AD9361 register map model for the simulated platform.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "sim_models.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_AD9361_NUM_REGS		0x400
+
+#define SIM_AD9361_WRITE		(1 << 15)
+#define SIM_AD9361_CNT(cmd)		((((cmd) >> 12) & 0x7) + 1)
+#define SIM_AD9361_ADDR(cmd)		((cmd) & 0x3FF)
+
+#define SIM_AD9361_ENSM_CONFIG_1	0x014
+#define SIM_AD9361_CALIBRATION_CTRL	0x016
+#define SIM_AD9361_STATE		0x017
+#define SIM_AD9361_PRODUCT_ID		0x037
+#define SIM_AD9361_CH_1_OVERFLOW	0x05E
+#define SIM_AD9361_RX_VCO_LOCK		0x247
+#define SIM_AD9361_TX_VCO_LOCK		0x287
+
+#define SIM_AD9361_FORCE_RX_ON		(1 << 6)
+#define SIM_AD9361_FORCE_TX_ON		(1 << 5)
+#define SIM_AD9361_FORCE_ALERT		(1 << 2)
+#define SIM_AD9361_TO_ALERT		(1 << 0)
+
+#define SIM_AD9361_STATE_ALERT		0x5
+#define SIM_AD9361_STATE_TX		0x6
+#define SIM_AD9361_STATE_RX		0x8
+#define SIM_AD9361_STATE_FDD		0xA
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Emulate the side effects of a register write.
+ * @param model - The model.
+ * @param reg - Register address.
+ * @param val - Written value.
+ * @return None.
+ */
+static void sim_ad9361_side_effects(struct sim_model *model, uint32_t reg,
+				    uint32_t val)
+{
+	uint32_t state;
+
+	switch (reg) {
+	case SIM_AD9361_CALIBRATION_CTRL:
+		/* Calibrations complete instantly and their bits self clear */
+		model->regs[reg] = 0;
+		break;
+	case SIM_AD9361_ENSM_CONFIG_1:
+		if ((val & SIM_AD9361_FORCE_RX_ON) && (val & SIM_AD9361_FORCE_TX_ON))
+			state = SIM_AD9361_STATE_FDD;
+		else if (val & SIM_AD9361_FORCE_RX_ON)
+			state = SIM_AD9361_STATE_RX;
+		else if (val & SIM_AD9361_FORCE_TX_ON)
+			state = SIM_AD9361_STATE_TX;
+		else if (val & (SIM_AD9361_FORCE_ALERT | SIM_AD9361_TO_ALERT))
+			state = SIM_AD9361_STATE_ALERT;
+		else
+			break;
+		model->regs[SIM_AD9361_STATE] =
+			(model->regs[SIM_AD9361_STATE] & ~0xF) | state;
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Decode an AD9361 SPI transfer: a 16 bit command followed by up to
+ * eight data bytes at descending addresses.
+ * @param model - The model.
+ * @param data - Transfer buffer, MISO bytes are written in place.
+ * @param bytes_number - Transfer length.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_ad9361_spi_xfer(struct sim_model *model, uint8_t *data,
+				   uint16_t bytes_number)
+{
+	uint16_t cmd;
+	uint32_t addr, cnt, i;
+
+	if (bytes_number < 3)
+		return FAILURE;
+
+	cmd = (data[0] << 8) | data[1];
+	addr = SIM_AD9361_ADDR(cmd);
+	cnt = SIM_AD9361_CNT(cmd);
+	if (cnt > bytes_number - 2u)
+		cnt = bytes_number - 2u;
+
+	data[0] = 0;
+	data[1] = 0;
+	for (i = 0; i < cnt; i++, addr--) {
+		addr &= SIM_AD9361_NUM_REGS - 1;
+		if (cmd & SIM_AD9361_WRITE) {
+			sim_reg_write(model, addr, data[2 + i]);
+			sim_ad9361_side_effects(model, addr, data[2 + i]);
+		} else {
+			data[2 + i] = sim_reg_read(model, addr);
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Create an AD9361 model. The product ID, the BBPLL and VCO lock bits
+ * read back as expected by the driver; a test script can override them with
+ * sim_reg_force().
+ * @param model - The model.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_ad9361_init(struct sim_model **model)
+{
+	struct sim_model *m;
+	int32_t ret;
+
+	ret = sim_model_alloc(&m, "ad9361", SIM_AD9361_NUM_REGS);
+	if (ret != SUCCESS)
+		return ret;
+
+	m->spi_xfer = sim_ad9361_spi_xfer;
+
+	m->regs[SIM_AD9361_PRODUCT_ID] = 0x0A;
+	sim_reg_force(m, SIM_AD9361_CH_1_OVERFLOW, 0x80, 0x80);
+	sim_reg_force(m, SIM_AD9361_RX_VCO_LOCK, 0x02, 0x02);
+	sim_reg_force(m, SIM_AD9361_TX_VCO_LOCK, 0x02, 0x02);
+
+	*model = m;
+
+	return SUCCESS;
+}
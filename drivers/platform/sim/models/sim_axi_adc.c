@@ -0,0 +1,134 @@
+/***************************************************************************//**
+ *   @file   sim_axi_adc.c
+ *   @brief  AXI ADC core register map model for the simulated platform.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "sim_models.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_AXI_ADC_SIZE		0x10000
+#define SIM_AXI_ADC_NUM_REGS		(SIM_AXI_ADC_SIZE / 4)
+
+#define SIM_AXI_ADC_VERSION		0x0000
+#define SIM_AXI_ADC_CLK_FREQ		0x0054
+#define SIM_AXI_ADC_CLK_RATIO		0x0058
+#define SIM_AXI_ADC_STATUS		0x005C
+#define SIM_AXI_ADC_CHAN_STATUS(c)	(0x0404 + (c) * 0x40)
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Memory mapped read.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Read value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_axi_adc_read(struct sim_model *model, uint32_t offset,
+				uint32_t *data)
+{
+	*data = sim_reg_read(model, offset / 4);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Memory mapped write.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Written value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_axi_adc_write(struct sim_model *model, uint32_t offset,
+				 uint32_t data)
+{
+	sim_reg_write(model, offset / 4, data);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Create an AXI ADC model and map it at the given address. The
+ * interface reports a locked status and PN error free channels; a test script
+ * can inject errors with sim_reg_force().
+ * @param model - The model.
+ * @param base - Base address.
+ * @param num_channels - Number of channels.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_axi_adc_init(struct sim_model **model, uint32_t base,
+			 uint32_t num_channels)
+{
+	struct sim_model *m;
+	uint32_t ch;
+	int32_t ret;
+
+	ret = sim_model_alloc(&m, "axi_adc", SIM_AXI_ADC_NUM_REGS);
+	if (ret != SUCCESS)
+		return ret;
+
+	m->mmio_read = sim_axi_adc_read;
+	m->mmio_write = sim_axi_adc_write;
+
+	m->regs[SIM_AXI_ADC_VERSION / 4] = 0x000A0062;
+	m->regs[SIM_AXI_ADC_CLK_FREQ / 4] = 0x00010000;
+	m->regs[SIM_AXI_ADC_CLK_RATIO / 4] = 0x1;
+	sim_reg_force(m, SIM_AXI_ADC_STATUS / 4, 0x1, 0x1);
+	for (ch = 0; ch < num_channels; ch++)
+		sim_reg_force(m, SIM_AXI_ADC_CHAN_STATUS(ch) / 4,
+			      0xFFFFFFFF, 0);
+
+	ret = sim_mmio_map(m, base, SIM_AXI_ADC_SIZE);
+	if (ret != SUCCESS) {
+		sim_model_free(m);
+		return ret;
+	}
+
+	*model = m;
+
+	return SUCCESS;
+}
@@ -0,0 +1,160 @@
+/***************************************************************************//**
+ *   @file   sim_axi_clkgen.c
+ *   @brief  AXI clock generator register map and MMCM DRP model.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "sim_models.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_AXI_CLKGEN_VERSION		0x0000
+#define SIM_AXI_CLKGEN_FPGA_INFO	0x001C
+#define SIM_AXI_CLKGEN_RESETN		0x0040
+#define SIM_AXI_CLKGEN_MMCM_RESETN	0x2
+#define SIM_AXI_CLKGEN_STATUS		0x005C
+#define SIM_AXI_CLKGEN_DRP_CNTRL	0x0070
+#define SIM_AXI_CLKGEN_DRP_SEL		0x20000000
+#define SIM_AXI_CLKGEN_DRP_READ		0x10000000
+#define SIM_AXI_CLKGEN_DRP_STATUS	0x0074
+#define SIM_AXI_CLKGEN_FPGA_VOLTAGE	0x0140
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Memory mapped read.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Read value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_axi_clkgen_read(struct sim_model *model, uint32_t offset,
+				   uint32_t *data)
+{
+	if (offset >= SIM_AXI_CLKGEN_SIZE)
+		return FAILURE;
+
+	*data = sim_reg_read(model, offset / 4);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Memory mapped write. DRP accesses complete immediately and the
+ * MMCM locks as soon as it is taken out of reset.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Written value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_axi_clkgen_write(struct sim_model *model, uint32_t offset,
+				    uint32_t data)
+{
+	uint32_t drp;
+
+	if (offset >= SIM_AXI_CLKGEN_SIZE)
+		return FAILURE;
+
+	sim_reg_write(model, offset / 4, data);
+
+	switch (offset) {
+	case SIM_AXI_CLKGEN_RESETN:
+		model->regs[SIM_AXI_CLKGEN_STATUS / 4] =
+			!!(data & SIM_AXI_CLKGEN_MMCM_RESETN);
+		break;
+	case SIM_AXI_CLKGEN_DRP_CNTRL:
+		if (!(data & SIM_AXI_CLKGEN_DRP_SEL))
+			break;
+		drp = SIM_AXI_CLKGEN_DRP((data >> 16) & 0x7F);
+		if (data & SIM_AXI_CLKGEN_DRP_READ)
+			model->regs[SIM_AXI_CLKGEN_DRP_STATUS / 4] =
+				sim_reg_read(model, drp) & 0xFFFF;
+		else
+			sim_reg_write(model, drp, data & 0xFFFF);
+		break;
+	default:
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Create an AXI clock generator model and map it at the given address.
+ * The MMCM DRP registers are kept after the AXI registers, at
+ * SIM_AXI_CLKGEN_DRP(reg), so a test script can preset and check them.
+ * @param model - The model.
+ * @param base - Base address.
+ * @param fpga_info - Value of the FPGA info register (technology, family,
+ * speed grade), which selects the PFD/VCO limits used by the driver.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_axi_clkgen_init(struct sim_model **model, uint32_t base,
+			    uint32_t fpga_info)
+{
+	struct sim_model *m;
+	int32_t ret;
+
+	ret = sim_model_alloc(&m, "axi_clkgen", SIM_AXI_CLKGEN_DRP(0x80));
+	if (ret != SUCCESS)
+		return ret;
+
+	m->mmio_read = sim_axi_clkgen_read;
+	m->mmio_write = sim_axi_clkgen_write;
+
+	m->regs[SIM_AXI_CLKGEN_VERSION / 4] = 0x00050063;
+	m->regs[SIM_AXI_CLKGEN_FPGA_INFO / 4] = fpga_info;
+	m->regs[SIM_AXI_CLKGEN_FPGA_VOLTAGE / 4] = 1000;
+
+	ret = sim_mmio_map(m, base, SIM_AXI_CLKGEN_SIZE);
+	if (ret != SUCCESS) {
+		sim_model_free(m);
+		return ret;
+	}
+
+	*model = m;
+
+	return SUCCESS;
+}
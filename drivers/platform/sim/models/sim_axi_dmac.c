@@ -0,0 +1,145 @@
+/***************************************************************************//**
+ *   @file   sim_axi_dmac.c
+ *   @brief  AXI DMAC register map model for the simulated platform.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "sim_models.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_AXI_DMAC_SIZE		0x1000
+#define SIM_AXI_DMAC_NUM_REGS		(SIM_AXI_DMAC_SIZE / 4)
+
+#define SIM_AXI_DMAC_IRQ_PENDING	0x084
+#define SIM_AXI_DMAC_TRANSFER_ID	0x404
+#define SIM_AXI_DMAC_START_TRANSFER	0x408
+#define SIM_AXI_DMAC_TRANSFER_DONE	0x428
+
+#define SIM_AXI_DMAC_IRQ_SOT		(1 << 0)
+#define SIM_AXI_DMAC_IRQ_EOT		(1 << 1)
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Memory mapped read.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Read value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_axi_dmac_read(struct sim_model *model, uint32_t offset,
+				 uint32_t *data)
+{
+	*data = sim_reg_read(model, offset / 4);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Memory mapped write. Starting a transfer completes it immediately and
+ * raises the start and end of transfer interrupts; no data is moved.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Written value.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_axi_dmac_write(struct sim_model *model, uint32_t offset,
+				  uint32_t data)
+{
+	uint32_t id;
+
+	switch (offset) {
+	case SIM_AXI_DMAC_IRQ_PENDING:
+		model->regs[offset / 4] &= ~data;
+		model->writes++;
+		break;
+	case SIM_AXI_DMAC_START_TRANSFER:
+		model->writes++;
+		if (!(data & 1))
+			break;
+		id = model->regs[SIM_AXI_DMAC_TRANSFER_ID / 4];
+		model->regs[SIM_AXI_DMAC_TRANSFER_DONE / 4] |= 1 << id;
+		model->regs[SIM_AXI_DMAC_TRANSFER_ID / 4] = (id + 1) & 0x3;
+		model->regs[SIM_AXI_DMAC_IRQ_PENDING / 4] |=
+			SIM_AXI_DMAC_IRQ_SOT | SIM_AXI_DMAC_IRQ_EOT;
+		model->regs[offset / 4] = 0;
+		break;
+	default:
+		sim_reg_write(model, offset / 4, data);
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Create an AXI DMAC model and map it at the given address.
+ * @param model - The model.
+ * @param base - Base address.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_axi_dmac_init(struct sim_model **model, uint32_t base)
+{
+	struct sim_model *m;
+	int32_t ret;
+
+	ret = sim_model_alloc(&m, "axi_dmac", SIM_AXI_DMAC_NUM_REGS);
+	if (ret != SUCCESS)
+		return ret;
+
+	m->mmio_read = sim_axi_dmac_read;
+	m->mmio_write = sim_axi_dmac_write;
+
+	ret = sim_mmio_map(m, base, SIM_AXI_DMAC_SIZE);
+	if (ret != SUCCESS) {
+		sim_model_free(m);
+		return ret;
+	}
+
+	*model = m;
+
+	return SUCCESS;
+}
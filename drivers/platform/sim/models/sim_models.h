@@ -0,0 +1,80 @@
+/***************************************************************************//**
+ *   @file   sim_models.h
+ *   @brief  Device models for the simulated platform.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef SIM_MODELS_H_
+#define SIM_MODELS_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "sim.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Size of the AXI clock generator register space */
+#define SIM_AXI_CLKGEN_SIZE		0x10000
+/** Model register index of an MMCM DRP register */
+#define SIM_AXI_CLKGEN_DRP(reg)		(SIM_AXI_CLKGEN_SIZE / 4 + (reg))
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* AD9361 SPI register map with lock, calibration and ENSM emulation. */
+int32_t sim_ad9361_init(struct sim_model **model);
+
+/* AD7124 SPI register map producing a ramp on the data register. */
+int32_t sim_ad7124_init(struct sim_model **model);
+
+/* AXI DMAC register map completing every transfer immediately. */
+int32_t sim_axi_dmac_init(struct sim_model **model, uint32_t base);
+
+/* AXI ADC register map reporting a locked, PN clean interface. */
+int32_t sim_axi_adc_init(struct sim_model **model, uint32_t base,
+			 uint32_t num_channels);
+
+/* AXI clock generator register map with an MMCM DRP that locks at once. */
+int32_t sim_axi_clkgen_init(struct sim_model **model, uint32_t base,
+			    uint32_t fpga_info);
+
+#endif /* SIM_MODELS_H_ */
@@ -0,0 +1,424 @@
+/***************************************************************************//**
+ *   @file   sim.c
+ *   @brief  Simulated platform core: device models, virtual time and bus statistics.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "error.h"
+#include "util.h"
+#include "sim.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static uint64_t sim_now_ns;
+static struct sim_stats sim_stats;
+static struct sim_model *sim_mmio_models;
+
+static struct sim_spi_record *sim_records;
+static uint32_t sim_records_max;
+static uint32_t sim_records_head;
+static uint32_t sim_records_count;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Allocate a model with a zeroed register map.
+ * @param model - The model.
+ * @param name - Model name.
+ * @param num_regs - Number of registers.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_model_alloc(struct sim_model **model, const char *name,
+			uint32_t num_regs)
+{
+	struct sim_model *m;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return FAILURE;
+
+	m->regs = calloc(num_regs, sizeof(*m->regs));
+	m->force_mask = calloc(num_regs, sizeof(*m->force_mask));
+	m->force_val = calloc(num_regs, sizeof(*m->force_val));
+	if (!m->regs || !m->force_mask || !m->force_val) {
+		sim_model_free(m);
+		return FAILURE;
+	}
+
+	m->name = name;
+	m->num_regs = num_regs;
+
+	*model = m;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free a model, unmapping it first.
+ * @param model - The model.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_model_free(struct sim_model *model)
+{
+	if (!model)
+		return FAILURE;
+
+	sim_mmio_unmap(model);
+	free(model->priv);
+	free(model->regs);
+	free(model->force_mask);
+	free(model->force_val);
+	free(model);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read a register through the forced bits.
+ * @param model - The model.
+ * @param reg - Register index.
+ * @return The register value, 0 for registers outside the map.
+ */
+uint32_t sim_reg_read(struct sim_model *model, uint32_t reg)
+{
+	if (reg >= model->num_regs)
+		return 0;
+
+	model->reads++;
+
+	return (model->regs[reg] & ~model->force_mask[reg]) |
+	       (model->force_val[reg] & model->force_mask[reg]);
+}
+
+/**
+ * @brief Write a register and run the script hook.
+ * @param model - The model.
+ * @param reg - Register index.
+ * @param val - Value.
+ * @return None.
+ */
+void sim_reg_write(struct sim_model *model, uint32_t reg, uint32_t val)
+{
+	if (reg >= model->num_regs)
+		return;
+
+	model->writes++;
+	model->regs[reg] = val;
+
+	if (model->write_hook)
+		model->write_hook(model, reg, val, model->write_hook_ctx);
+}
+
+/**
+ * @brief Make some bits of a register read back as a fixed value.
+ * @param model - The model.
+ * @param reg - Register index.
+ * @param mask - Bits to force, 0 releases the register.
+ * @param val - Forced value.
+ * @return None.
+ */
+void sim_reg_force(struct sim_model *model, uint32_t reg, uint32_t mask,
+		   uint32_t val)
+{
+	if (reg >= model->num_regs)
+		return;
+
+	model->force_mask[reg] = mask;
+	model->force_val[reg] = val & mask;
+}
+
+/**
+ * @brief Install the script hook of a model.
+ * @param model - The model.
+ * @param hook - Called after every register write, NULL to remove.
+ * @param ctx - Passed to the hook.
+ * @return None.
+ */
+void sim_model_set_hook(struct sim_model *model, sim_write_hook_t hook,
+			void *ctx)
+{
+	model->write_hook = hook;
+	model->write_hook_ctx = ctx;
+}
+
+/**
+ * @brief Map a model at a memory address.
+ * @param model - The model, must implement mmio_read and mmio_write.
+ * @param base - Base address.
+ * @param size - Region size in bytes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_mmio_map(struct sim_model *model, uint32_t base, uint32_t size)
+{
+	struct sim_model *m;
+	uint32_t end;
+
+	if (!model->mmio_read || !model->mmio_write || !size)
+		return FAILURE;
+
+	/* Inclusive end, so a region ending at the top of memory fits */
+	end = base + size - 1;
+	if (end < base)
+		return FAILURE;
+
+	for (m = sim_mmio_models; m; m = m->next)
+		if (base <= m->base + m->size - 1 && m->base <= end)
+			return FAILURE;
+
+	model->base = base;
+	model->size = size;
+	model->next = sim_mmio_models;
+	sim_mmio_models = model;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Remove a model from the memory map.
+ * @param model - The model.
+ * @return None.
+ */
+void sim_mmio_unmap(struct sim_model *model)
+{
+	struct sim_model **p;
+
+	for (p = &sim_mmio_models; *p; p = &(*p)->next) {
+		if (*p == model) {
+			*p = model->next;
+			break;
+		}
+	}
+
+	model->next = NULL;
+	model->size = 0;
+}
+
+/**
+ * @brief Find the model mapped at an address.
+ * @param addr - Address.
+ * @return The model, NULL if nothing is mapped there.
+ */
+struct sim_model *sim_mmio_find(uint32_t addr)
+{
+	struct sim_model *m;
+
+	for (m = sim_mmio_models; m; m = m->next)
+		if (addr >= m->base && addr - m->base < m->size)
+			return m;
+
+	return NULL;
+}
+
+/**
+ * @brief Current virtual time.
+ * @return Nanoseconds since the start of the program.
+ */
+uint64_t sim_time_ns(void)
+{
+	return sim_now_ns;
+}
+
+/**
+ * @brief Move the virtual time forward.
+ * @param ns - Nanoseconds.
+ * @return None.
+ */
+void sim_time_advance(uint64_t ns)
+{
+	sim_now_ns += ns;
+}
+
+/**
+ * @brief Platform wide counters.
+ * @return Pointer to the counters.
+ */
+struct sim_stats *sim_get_stats(void)
+{
+	return &sim_stats;
+}
+
+/**
+ * @brief Clear the platform wide counters.
+ * @return None.
+ */
+void sim_stats_reset(void)
+{
+	memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+/**
+ * @brief Print the platform wide counters.
+ * @return None.
+ */
+void sim_stats_print(void)
+{
+	printf("sim: spi %"PRIu32" xfers / %"PRIu32" bytes, "
+	       "i2c %"PRIu32" xfers / %"PRIu32" bytes\n",
+	       sim_stats.spi_xfers, sim_stats.spi_bytes,
+	       sim_stats.i2c_xfers, sim_stats.i2c_bytes);
+	printf("sim: mmio %"PRIu32" reads / %"PRIu32" writes, "
+	       "gpio %"PRIu32" ops, irq %"PRIu32"\n",
+	       sim_stats.mmio_reads, sim_stats.mmio_writes,
+	       sim_stats.gpio_ops, sim_stats.irqs);
+	printf("sim: virtual time %"PRIu64" us (delays %"PRIu64" us, "
+	       "bus %"PRIu64" us)\n", sim_now_ns / 1000,
+	       sim_stats.delay_ns / 1000, sim_stats.bus_ns / 1000);
+}
+
+/**
+ * @brief Start recording SPI transactions.
+ * @param max_records - Number of transactions kept, the oldest are dropped.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_record_start(uint32_t max_records)
+{
+	sim_record_stop();
+
+	if (!max_records)
+		return FAILURE;
+
+	sim_records = calloc(max_records, sizeof(*sim_records));
+	if (!sim_records)
+		return FAILURE;
+
+	sim_records_max = max_records;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop recording and free the records.
+ * @return None.
+ */
+void sim_record_stop(void)
+{
+	free(sim_records);
+	sim_records = NULL;
+	sim_records_max = 0;
+	sim_records_head = 0;
+	sim_records_count = 0;
+}
+
+/**
+ * @brief Record a transaction.
+ * @param chip_select - Chip select of the transfer.
+ * @param tx - MOSI bytes.
+ * @param rx - MISO bytes.
+ * @param bytes_number - Transfer length.
+ * @return None.
+ */
+void sim_record_spi(uint8_t chip_select, const uint8_t *tx, const uint8_t *rx,
+		    uint16_t bytes_number)
+{
+	struct sim_spi_record *rec;
+	uint16_t len = min_t(uint16_t, bytes_number, SIM_RECORD_BYTES);
+
+	if (!sim_records)
+		return;
+
+	rec = &sim_records[sim_records_head];
+	rec->time_ns = sim_now_ns;
+	rec->chip_select = chip_select;
+	rec->bytes_number = bytes_number;
+	memcpy(rec->tx, tx, len);
+	memcpy(rec->rx, rx, len);
+
+	sim_records_head = (sim_records_head + 1) % sim_records_max;
+	if (sim_records_count < sim_records_max)
+		sim_records_count++;
+}
+
+/**
+ * @brief Number of recorded transactions.
+ * @return Number of transactions.
+ */
+uint32_t sim_record_count(void)
+{
+	return sim_records_count;
+}
+
+/**
+ * @brief Get a recorded transaction.
+ * @param idx - Index, 0 is the oldest kept transaction.
+ * @return The record, NULL if idx is out of range.
+ */
+const struct sim_spi_record *sim_record_get(uint32_t idx)
+{
+	uint32_t first;
+
+	if (idx >= sim_records_count)
+		return NULL;
+
+	first = (sim_records_head + sim_records_max - sim_records_count) %
+		sim_records_max;
+
+	return &sim_records[(first + idx) % sim_records_max];
+}
+
+/**
+ * @brief Print the recorded transactions.
+ * @return None.
+ */
+void sim_record_dump(void)
+{
+	const struct sim_spi_record *rec;
+	uint32_t i, j, len;
+
+	for (i = 0; i < sim_records_count; i++) {
+		rec = sim_record_get(i);
+		len = min_t(uint32_t, rec->bytes_number, SIM_RECORD_BYTES);
+		printf("%10"PRIu64" ns cs%u %4u:", rec->time_ns,
+		       rec->chip_select, rec->bytes_number);
+		for (j = 0; j < len; j++)
+			printf(" %02x", rec->tx[j]);
+		printf(" |");
+		for (j = 0; j < len; j++)
+			printf(" %02x", rec->rx[j]);
+		printf("\n");
+	}
+}
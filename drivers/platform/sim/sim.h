@@ -0,0 +1,208 @@
+/***************************************************************************//**
+ *   @file   sim.h
+ *   @brief  Simulated platform: device models, virtual time and bus statistics.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef SIM_H_
+#define SIM_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Bytes of each direction kept per recorded SPI transaction */
+#define SIM_RECORD_BYTES	16
+
+/** Number of GPIOs handled by the simulated GPIO controller */
+#define SIM_GPIO_NUM		256
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct sim_model;
+
+/**
+ * @brief Called after every register write reaching a model. Lets a test
+ * script emulate device reactions (lock bits, self clearing resets, ...).
+ */
+typedef void (*sim_write_hook_t)(struct sim_model *model, uint32_t reg,
+				 uint32_t val, void *ctx);
+
+/**
+ * @struct sim_model
+ * @brief A simulated device: a register map plus the bus protocol decoding
+ * needed to reach it.
+ */
+struct sim_model {
+	/** Model name, used in dumps */
+	const char		*name;
+	/** Number of registers */
+	uint32_t		num_regs;
+	/** Register values */
+	uint32_t		*regs;
+	/** Bits that read back as force_val regardless of what was written */
+	uint32_t		*force_mask;
+	/** Forced bit values */
+	uint32_t		*force_val;
+	/** SPI transfer, data is replaced in place with the MISO bytes */
+	int32_t			(*spi_xfer)(struct sim_model *model, uint8_t *data,
+					    uint16_t bytes_number);
+	/** I2C write (read = false) or read (read = true) */
+	int32_t			(*i2c_xfer)(struct sim_model *model, uint8_t *data,
+					    uint8_t bytes_number, bool read);
+	/** Memory mapped read, offset from the mapped base */
+	int32_t			(*mmio_read)(struct sim_model *model,
+					     uint32_t offset, uint32_t *data);
+	/** Memory mapped write, offset from the mapped base */
+	int32_t			(*mmio_write)(struct sim_model *model,
+					      uint32_t offset, uint32_t data);
+	/** Script hook */
+	sim_write_hook_t	write_hook;
+	/** Script hook context */
+	void			*write_hook_ctx;
+	/** Memory mapped base address, 0 when not mapped */
+	uint32_t		base;
+	/** Memory mapped region size in bytes */
+	uint32_t		size;
+	/** Number of register reads */
+	uint32_t		reads;
+	/** Number of register writes */
+	uint32_t		writes;
+	/** Model private data */
+	void			*priv;
+	/** Next memory mapped model */
+	struct sim_model	*next;
+};
+
+/**
+ * @struct sim_stats
+ * @brief Platform wide counters, reset with sim_stats_reset().
+ */
+struct sim_stats {
+	uint32_t	spi_xfers;
+	uint32_t	spi_bytes;
+	uint32_t	i2c_xfers;
+	uint32_t	i2c_bytes;
+	uint32_t	mmio_reads;
+	uint32_t	mmio_writes;
+	uint32_t	gpio_ops;
+	uint32_t	irqs;
+	/** Virtual time spent in udelay()/mdelay() */
+	uint64_t	delay_ns;
+	/** Virtual time spent on the SPI and I2C buses */
+	uint64_t	bus_ns;
+};
+
+/**
+ * @struct sim_spi_record
+ * @brief One recorded SPI transaction.
+ */
+struct sim_spi_record {
+	uint64_t	time_ns;
+	uint8_t		chip_select;
+	uint16_t	bytes_number;
+	uint8_t		tx[SIM_RECORD_BYTES];
+	uint8_t		rx[SIM_RECORD_BYTES];
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a model with a zeroed register map. */
+int32_t sim_model_alloc(struct sim_model **model, const char *name,
+			uint32_t num_regs);
+/* Free a model, unmapping it first. */
+int32_t sim_model_free(struct sim_model *model);
+/* Read a register through the forced bits. */
+uint32_t sim_reg_read(struct sim_model *model, uint32_t reg);
+/* Write a register and run the script hook. */
+void sim_reg_write(struct sim_model *model, uint32_t reg, uint32_t val);
+/* Make some bits of a register read back as a fixed value. */
+void sim_reg_force(struct sim_model *model, uint32_t reg, uint32_t mask,
+		   uint32_t val);
+/* Install the script hook of a model. */
+void sim_model_set_hook(struct sim_model *model, sim_write_hook_t hook,
+			void *ctx);
+
+/* Map a model at a memory address, used by axi_io_read()/axi_io_write(). */
+int32_t sim_mmio_map(struct sim_model *model, uint32_t base, uint32_t size);
+/* Remove a model from the memory map. */
+void sim_mmio_unmap(struct sim_model *model);
+/* Find the model mapped at an address. */
+struct sim_model *sim_mmio_find(uint32_t addr);
+
+/* Current virtual time. */
+uint64_t sim_time_ns(void);
+/* Move the virtual time forward. */
+void sim_time_advance(uint64_t ns);
+
+/* Platform wide counters. */
+struct sim_stats *sim_get_stats(void);
+/* Clear the platform wide counters. */
+void sim_stats_reset(void);
+/* Print the platform wide counters. */
+void sim_stats_print(void);
+
+/* Start recording SPI transactions, keeping at most max_records. */
+int32_t sim_record_start(uint32_t max_records);
+/* Stop recording and free the records. */
+void sim_record_stop(void);
+/* Record a transaction, called by the SPI layer. */
+void sim_record_spi(uint8_t chip_select, const uint8_t *tx, const uint8_t *rx,
+		    uint16_t bytes_number);
+/* Number of recorded transactions. */
+uint32_t sim_record_count(void);
+/* Get a recorded transaction, 0 is the oldest. */
+const struct sim_spi_record *sim_record_get(uint32_t idx);
+/* Print the recorded transactions. */
+void sim_record_dump(void);
+
+/* Drive the level seen by gpio_get_value() on an input. */
+int32_t sim_gpio_set_input(uint8_t number, uint8_t value);
+/* Read back the level driven by gpio_set_value(). */
+int32_t sim_gpio_get_output(uint8_t number, uint8_t *value);
+
+#endif /* SIM_H_ */
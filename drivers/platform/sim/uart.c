@@ -0,0 +1,220 @@
+/***************************************************************************//**
+ *   @file   uart.c
+ *   @brief  Implementation of the simulated platform UART driver.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "error.h"
+#include "uart.h"
+#include "uart_extra.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Queue bytes for uart_read().
+ * @param desc - The UART descriptor.
+ * @param data - Bytes "received" on the line.
+ * @param bytes_number - Number of bytes.
+ * @return Number of bytes queued.
+ */
+int32_t sim_uart_inject(struct uart_desc *desc, const uint8_t *data,
+			uint32_t bytes_number)
+{
+	struct sim_uart_desc *sim_desc = desc->extra;
+
+	return cb_write(sim_desc->rx, data, bytes_number);
+}
+
+/**
+ * @brief Collect bytes written with uart_write().
+ * @param desc - The UART descriptor.
+ * @param data - Destination buffer.
+ * @param bytes_number - Maximum number of bytes.
+ * @return Number of bytes collected.
+ */
+int32_t sim_uart_collect(struct uart_desc *desc, uint8_t *data,
+			 uint32_t bytes_number)
+{
+	struct sim_uart_desc *sim_desc = desc->extra;
+
+	return cb_read(sim_desc->tx, data, bytes_number);
+}
+
+/**
+ * @brief Read the data already received, without waiting.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Maximum number of bytes to read.
+ * @return Number of bytes read.
+ */
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number)
+{
+	struct sim_uart_desc *sim_desc = desc->extra;
+
+	return cb_read(sim_desc->rx, data, bytes_number);
+}
+
+/**
+ * @brief Read data from UART device. Nothing can arrive while the caller
+ * waits, so a read of more than what was injected fails.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to read.
+ * @return Number of bytes read, FAILURE if not enough data was injected.
+ */
+int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number)
+{
+	struct sim_uart_desc *sim_desc = desc->extra;
+
+	if (cb_size(sim_desc->rx) < bytes_number)
+		return FAILURE;
+
+	return cb_read(sim_desc->rx, data, bytes_number);
+}
+
+/**
+ * @brief Write data to UART device.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to write.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
+		   uint32_t bytes_number)
+{
+	struct sim_uart_desc *sim_desc = desc->extra;
+
+	if (cb_write(sim_desc->tx, data, bytes_number) != bytes_number)
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the UART communication peripheral.
+ * @param desc - The UART descriptor.
+ * @param param - The structure that contains the UART parameters. The extra
+ *                field may point to a struct sim_uart_init_param.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
+{
+	struct sim_uart_init_param *sim_param;
+	struct sim_uart_desc *sim_desc;
+	struct uart_desc *descriptor;
+	uint32_t size = SIM_UART_BUFF_SIZE;
+
+	if (!desc || !param)
+		return FAILURE;
+
+	sim_param = param->extra;
+	if (sim_param && sim_param->buff_size)
+		size = sim_param->buff_size;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	sim_desc = calloc(1, sizeof(*sim_desc));
+	if (!sim_desc)
+		goto error_free_descriptor;
+
+	if (cb_init(&sim_desc->rx, size) != SUCCESS)
+		goto error_free_sim_desc;
+	if (cb_init(&sim_desc->tx, size) != SUCCESS)
+		goto error_free_rx;
+
+	descriptor->device_id = param->device_id;
+	descriptor->baud_rate = param->baud_rate;
+	descriptor->extra = sim_desc;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+
+error_free_rx:
+	cb_remove(sim_desc->rx);
+error_free_sim_desc:
+	free(sim_desc);
+error_free_descriptor:
+	free(descriptor);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Free the resources allocated by uart_init().
+ * @param desc - The UART descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t uart_remove(struct uart_desc *desc)
+{
+	struct sim_uart_desc *sim_desc;
+
+	if (!desc)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	cb_remove(sim_desc->rx);
+	cb_remove(sim_desc->tx);
+	free(sim_desc);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get number of UART errors.
+ * @param desc - The UART descriptor.
+ * @return number of errors.
+ */
+uint32_t uart_get_errors(struct uart_desc *desc)
+{
+	struct sim_uart_desc *sim_desc = desc->extra;
+	uint32_t errors = sim_desc->rx->overflows;
+
+	sim_desc->rx->overflows = 0;
+
+	return errors;
+}
@@ -41,6 +41,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <string.h>
 #include <xil_io.h>
 #include "error.h"
 #include "axi_io.h"
@@ -77,3 +78,41 @@ int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return SUCCESS;
 }
 
+/**
+ * @brief AXI IO Xilinx specific block write function, for memory (e.g. DMA
+ * buffers in DDR). The data cache is not flushed.
+ * @param base - Base address
+ * @param offset - Address offset
+ * @param data - words to be written.
+ * @param count - number of words.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_buf(uint32_t base, uint32_t offset, const uint32_t *data,
+			 uint32_t count)
+{
+	memcpy((void *)(uintptr_t)(base + offset), data,
+	       count * sizeof(*data));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO Xilinx specific map function. The address space is always mapped.
+ * @param base - Base address
+ * @param size - Size of the range, in bytes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_map(uint32_t base, uint32_t size)
+{
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO Xilinx specific unmap function. The address space is always mapped.
+ * @param base - Base address
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_unmap(uint32_t base)
+{
+	return SUCCESS;
+}
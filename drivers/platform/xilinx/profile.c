@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ *   @file   profile.c
+ *   @brief  Implementation of the Xilinx profiling clock.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <xparameters.h>
+#include "error.h"
+#include "profile.h"
+#ifdef _XPARAMETERS_PS_H_
+#include <xtime_l.h>
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start the profiling clock. On Zynq and ZynqMP the clock is the
+ * global timer, which the boot code already runs.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t profile_clock_init(void)
+{
+	return SUCCESS;
+}
+
+/**
+ * @brief Read the profiling clock.
+ * @return The lower 32 bits of the global timer, 0 on MicroBlaze.
+ */
+uint32_t profile_clock(void)
+{
+#ifdef _XPARAMETERS_PS_H_
+	XTime t;
+
+	XTime_GetTime(&t);
+
+	return (uint32_t)t;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Get the profiling clock frequency.
+ * @return The global timer frequency, 0 on MicroBlaze.
+ */
+uint32_t profile_clock_hz(void)
+{
+#ifdef _XPARAMETERS_PS_H_
+	return COUNTS_PER_SECOND;
+#else
+	return 0;
+#endif
+}
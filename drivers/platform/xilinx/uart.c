@@ -36,7 +36,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "error.h"
-#include "fifo.h"
+#include "circular_buffer.h"
 #include "irq.h"
 #include "uart.h"
 #include "uart_extra.h"
@@ -56,74 +56,21 @@
 /******************************************************************************/
 
 /**
- * @brief Save received data into fifo.
- * @param desc - Instance descriptor containing a fifo element.
- * @return SUCCESS in case of success, FAILURE otherwise.
- */
-static int32_t uart_fifo_insert(struct uart_desc *desc)
-{
-	int32_t ret;
-	struct xil_uart_desc *xil_uart_desc = desc->extra;
-	struct irq_ctrl_desc *irq_desc = xil_uart_desc->irq_desc;
-
-	if (xil_uart_desc->bytes_received > 0) {
-		ret = irq_source_disable(irq_desc, xil_uart_desc->irq_id);
-		if (ret < 0)
-			return ret;
-		ret = fifo_insert(&xil_uart_desc->fifo, xil_uart_desc->buff,
-				  xil_uart_desc->bytes_received);
-		if (ret < 0)
-			return ret;
-		xil_uart_desc->bytes_received = 0;
-		switch(xil_uart_desc->type) {
-		case UART_PS:
-#ifdef XUARTPS_H
-			XUartPs_Recv(xil_uart_desc->instance, (u8*)(xil_uart_desc->buff),
-				     UART_BUFF_LENGTH);
-			break;
-#endif // XUARTPS_H
-		case UART_PL:
-
-			break;
-		default:
-			return FAILURE;
-			break;
-		}
-		ret = irq_source_enable(irq_desc, xil_uart_desc->irq_id);
-		if (ret < 0)
-			return ret;
-	}
-
-	return SUCCESS;
-}
-
-/**
- * @brief Read byte from fifo.
- * @param desc - Instance descriptor containing a fifo element
- * @param data - read value.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @brief Read the data already received, without waiting.
+ *
+ * The interrupt handler moves each completed receive buffer into the ring
+ * buffer, so this only copies the contiguous spans available there.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Maximum number of bytes to read.
+ * @return Number of bytes read (possibly 0), negative error code otherwise.
  */
-static int32_t uart_read_byte(struct uart_desc *desc, uint8_t *data)
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number)
 {
 	struct xil_uart_desc *xil_uart_desc = desc->extra;
-	int32_t ret;
-
-	while (xil_uart_desc->fifo == NULL) {
-		/* nothing in fifo, wait until something is received */
-		ret = uart_fifo_insert(desc);
-		if (ret < 0)
-			return ret;
-	}
-
-	*data = xil_uart_desc->fifo->data[xil_uart_desc->fifo_read_offset];
-	xil_uart_desc->fifo_read_offset++;
-
-	if (xil_uart_desc->fifo->len - xil_uart_desc->fifo_read_offset <= 0) {
-		xil_uart_desc->fifo_read_offset = 0;
-		xil_uart_desc->fifo = fifo_remove(xil_uart_desc->fifo);
-	}
 
-	return SUCCESS;
+	return cb_read(xil_uart_desc->rx_cb, data, bytes_number);
 }
 
 /**
@@ -135,12 +82,13 @@ static int32_t uart_read_byte(struct uart_desc *desc, uint8_t *data)
  */
 int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number)
 {
-	ssize_t ret;
-	for (uint32_t i = 0; i < bytes_number; i++) {
-		ret = uart_read_byte(desc, &data[i]);
-		if (ret < 0)
-			return ret;
-	}
+	struct xil_uart_desc *xil_uart_desc = desc->extra;
+	uint32_t offset = 0;
+
+	/* nothing in the ring buffer yet, wait until something is received */
+	while (offset < bytes_number)
+		offset += cb_read(xil_uart_desc->rx_cb, data + offset,
+				  bytes_number - offset);
 
 	return bytes_number;
 }
@@ -204,7 +152,9 @@ static void uart_irq_handler(void *call_back_ref, uint32_t event,
 		 * timeout just indicates the data stopped for configured character time
 		 */
 		case XUARTPS_EVENT_RECV_TOUT:
-			xil_uart_desc->bytes_received = data_len;
+			cb_write(xil_uart_desc->rx_cb, xil_uart_desc->buff, data_len);
+			XUartPs_Recv(xil_uart_desc->instance, (u8*)xil_uart_desc->buff,
+				     UART_BUFF_LENGTH);
 			break;
 		/*
 		 * Data was received with an error, keep the data but determine
@@ -316,6 +266,12 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 	if (!(xil_uart_desc->instance))
 		goto error_free_xil_uart_desc;
 
+	status = cb_init(&xil_uart_desc->rx_cb,
+			 xil_uart_init_param->rx_ring_size ?
+			 xil_uart_init_param->rx_ring_size : UART_RX_RING_SIZE);
+	if (status < 0)
+		goto error_free_instance;
+
 	switch(xil_uart_desc->type) {
 	case UART_PS:
 #ifdef XUARTPS_H
@@ -371,6 +327,7 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 	return SUCCESS;
 
 error_free_instance:
+	cb_remove(xil_uart_desc->rx_cb);
 	free(xil_uart_desc->instance);
 error_free_xil_uart_desc:
 	free(xil_uart_desc);
@@ -388,6 +345,7 @@ error_free_descriptor:
 int32_t uart_remove(struct uart_desc *desc)
 {
 	struct xil_uart_desc *xil_uart_desc = desc->extra;
+	cb_remove(xil_uart_desc->rx_cb);
 	free(xil_uart_desc->instance);
 	free(xil_uart_desc);
 	free(desc);
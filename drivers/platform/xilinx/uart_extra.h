@@ -49,6 +49,8 @@
 /******************************************************************************/
 
 #define UART_BUFF_LENGTH 256
+/** Default size of the receive ring buffer */
+#define UART_RX_RING_SIZE 4096
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -77,6 +79,8 @@ struct xil_uart_init_param {
 	uint32_t			irq_id;
 	/** Interrupt Request Descriptor */
 	struct irq_ctrl_desc *irq_desc;
+	/** Receive ring buffer size, UART_RX_RING_SIZE if 0 */
+	uint32_t			rx_ring_size;
 };
 
 /**
@@ -90,14 +94,10 @@ struct xil_uart_desc {
 	uint32_t			irq_id;
 	/** Interrupt Request Descriptor */
 	struct irq_ctrl_desc *irq_desc;
-	/** FIFO */
-	struct fifo_element	*fifo;
-	/** FIFO read offset */
-	uint32_t 			fifo_read_offset;
+	/** Receive ring buffer, filled from the interrupt handler */
+	struct circular_buffer	*rx_cb;
 	/** UART Buffer */
 	char 				buff[UART_BUFF_LENGTH];
-	/** Number of bytes received */
-	uint32_t 			bytes_received;
 	/** Total number of errors */
 	uint32_t 			total_error_count;
 	/** UART Instance */
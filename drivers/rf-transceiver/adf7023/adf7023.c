@@ -41,8 +41,10 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include "adf7023_config.h"
 #include "adf7023.h"
+#include "util.h"
 
 /******************************************************************************/
 /*************************** Macros Definitions *******************************/
@@ -52,6 +54,12 @@
 #define ADF7023_CS_DEASSERT gpio_set_value(dev->gpio_cs,  \
 			    GPIO_HIGH)
 
+/* Status reads before giving up on CMD_READY */
+#define ADF7023_CMD_READY_TRIES	100
+
+#define ADF7023_PKT_EVENTS	(BBRAM_INTERRUPT_MASK_0_INTERRUPT_CRC_CORRECT | \
+				 BBRAM_INTERRUPT_MASK_0_INTERRUPT_TX_EOF)
+
 /******************************************************************************/
 /************************ Variables Definitions *******************************/
 /******************************************************************************/
@@ -238,13 +246,23 @@ void adf7023_get_ram(struct adf7023_dev *dev,
 		     uint32_t length,
 		     uint8_t* data)
 {
+	uint32_t hdr = 3;
+	uint32_t chunk;
+
+	dev->xfer[0] = SPI_MEM_RD | ((address & 0x700) >> 8);
+	dev->xfer[1] = address & 0xFF;
+	dev->xfer[2] = SPI_NOP;
+
 	ADF7023_CS_ASSERT;
-	adf7023_write_read_byte(dev, SPI_MEM_RD | ((address & 0x700) >> 8), 0);
-	adf7023_write_read_byte(dev, address & 0xFF, 0);
-	adf7023_write_read_byte(dev, SPI_NOP, 0);
-	while(length--) {
-		adf7023_write_read_byte(dev, SPI_NOP, data++);
-	}
+	do {
+		chunk = min(length, ADF7023_XFER_SIZE - hdr);
+		memset(dev->xfer + hdr, SPI_NOP, chunk);
+		spi_write_and_read(dev->spi_desc, dev->xfer, hdr + chunk);
+		memcpy(data, dev->xfer + hdr, chunk);
+		data += chunk;
+		length -= chunk;
+		hdr = 0;
+	} while (length);
 	ADF7023_CS_DEASSERT;
 }
 
@@ -263,12 +281,21 @@ void adf7023_set_ram(struct adf7023_dev *dev,
 		     uint32_t length,
 		     uint8_t* data)
 {
+	uint32_t hdr = 2;
+	uint32_t chunk;
+
+	dev->xfer[0] = SPI_MEM_WR | ((address & 0x700) >> 8);
+	dev->xfer[1] = address & 0xFF;
+
 	ADF7023_CS_ASSERT;
-	adf7023_write_read_byte(dev, SPI_MEM_WR | ((address & 0x700) >> 8), 0);
-	adf7023_write_read_byte(dev, address & 0xFF, 0);
-	while(length--) {
-		adf7023_write_read_byte(dev, *(data++), 0);
-	}
+	do {
+		chunk = min(length, ADF7023_XFER_SIZE - hdr);
+		memcpy(dev->xfer + hdr, data, chunk);
+		spi_write_and_read(dev->spi_desc, dev->xfer, hdr + chunk);
+		data += chunk;
+		length -= chunk;
+		hdr = 0;
+	} while (length);
 	ADF7023_CS_DEASSERT;
 }
 
@@ -392,3 +419,329 @@ void adf7023_set_frequency_deviation(struct adf7023_dev *dev,
 	adf7023_set_fw_state(dev, FW_STATE_PHY_OFF);
 	adf7023_set_command(dev, CMD_CONFIG_DEV);
 }
+
+/***************************************************************************//**
+ * @brief Waits until the radio controller accepts a new command.
+ *
+ * @param dev - The device structure.
+ *
+ * @return 0 when ready, -1 otherwise.
+*******************************************************************************/
+static int32_t adf7023_wait_cmd_ready(struct adf7023_dev *dev)
+{
+	uint32_t tries = ADF7023_CMD_READY_TRIES;
+	uint8_t status = 0;
+
+	while (tries--) {
+		adf7023_get_status(dev, &status);
+		if (status & STATUS_CMD_READY)
+			return 0;
+	}
+
+	return -1;
+}
+
+/***************************************************************************//**
+ * @brief Starts the next transmission if one is queued, receives otherwise.
+ *        The radio is expected in PHY_ON. If the radio controller does not
+ *        accept the command, the failure is counted and the rearm is retried
+ *        by the next service call.
+ *
+ * @param pkt - The packet engine.
+ *
+ * @return None.
+*******************************************************************************/
+static void adf7023_pkt_rearm(struct adf7023_pkt *pkt)
+{
+	struct adf7023_dev *dev = pkt->dev;
+	uint8_t *ram = pkt->ram;
+	uint8_t length;
+
+	if (adf7023_wait_cmd_ready(dev) < 0) {
+		pkt->rearm_errors++;
+		pkt->rearm_pending = true;
+		return;
+	}
+	pkt->rearm_pending = false;
+
+	if (!cb_size(pkt->tx_queue)) {
+		adf7023_set_command(dev, CMD_PHY_RX);
+		return;
+	}
+
+	/* Length, address and payload in a single burst */
+	cb_read(pkt->tx_queue, &length, 1);
+	cb_read(pkt->tx_queue, ram + 2, length);
+	ram[0] = 2 + length;
+	ram[1] = dev->adf7023_bbram_current.address_match_offset;
+	adf7023_set_ram(dev, ADF7023_TX_BASE_ADR, 2 + length, ram);
+
+	pkt->tx_busy = true;
+	adf7023_set_command(dev, CMD_PHY_TX);
+}
+
+/***************************************************************************//**
+ * @brief Moves the received packet to the RX queue.
+ *
+ * @param pkt - The packet engine.
+ *
+ * @return None.
+*******************************************************************************/
+static void adf7023_pkt_rx(struct adf7023_pkt *pkt)
+{
+	/* Queue record: payload length then payload */
+	uint8_t *record = pkt->ram;
+	uint8_t length;
+
+	adf7023_get_ram(pkt->dev, ADF7023_RX_BASE_ADR, 1, &length);
+	if (length < 2 || length - 2 > ADF7023_MAX_PAYLOAD) {
+		pkt->rx_dropped++;
+		return;
+	}
+	record[0] = length - 2;
+
+	/* Records are only stored whole */
+	if (cb_free_space(pkt->rx_queue) < 1U + record[0]) {
+		pkt->rx_dropped++;
+		return;
+	}
+
+	adf7023_get_ram(pkt->dev, ADF7023_RX_BASE_ADR + 2, record[0],
+			record + 1);
+	cb_write(pkt->rx_queue, record, 1 + record[0]);
+	pkt->rx_packets++;
+}
+
+/***************************************************************************//**
+ * @brief Handles the pending interrupt sources.
+ *
+ * @param pkt   - The packet engine.
+ * @param rearm - Restart the radio even if no packet event is pending.
+ *
+ * @return None.
+*******************************************************************************/
+static void adf7023_pkt_service(struct adf7023_pkt *pkt, bool rearm)
+{
+	struct adf7023_dev *dev = pkt->dev;
+	uint8_t source;
+
+	adf7023_get_ram(dev, MCR_REG_INTERRUPT_SOURCE_0, 1, &source);
+	adf7023_set_ram(dev, MCR_REG_INTERRUPT_SOURCE_0, 1, &source);
+
+	if (source & BBRAM_INTERRUPT_MASK_0_INTERRUPT_CRC_CORRECT)
+		adf7023_pkt_rx(pkt);
+
+	if (source & BBRAM_INTERRUPT_MASK_0_INTERRUPT_TX_EOF) {
+		pkt->tx_busy = false;
+		pkt->tx_packets++;
+	}
+
+	/* After either event the radio is back in PHY_ON */
+	if (rearm || pkt->rearm_pending || (source & ADF7023_PKT_EVENTS))
+		adf7023_pkt_rearm(pkt);
+}
+
+/***************************************************************************//**
+ * @brief IRQ_GP3 interrupt handler.
+ *
+ * @param data - The packet engine.
+ *
+ * @return None.
+*******************************************************************************/
+static void adf7023_pkt_irq_handler(void *data)
+{
+	adf7023_pkt_service(data, false);
+}
+
+/***************************************************************************//**
+ * @brief Allocates the packet queues and registers the interrupt handler.
+ *        While the engine runs, the device must only be accessed through the
+ *        adf7023_pkt_* functions.
+ *
+ * @param pkt        - The packet engine.
+ * @param dev        - The device structure.
+ * @param init_param - The structure that contains the engine parameters.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adf7023_pkt_init(struct adf7023_pkt **pkt,
+			 struct adf7023_dev *dev,
+			 struct adf7023_pkt_init_param *init_param)
+{
+	struct adf7023_pkt *desc;
+	int32_t ret;
+
+	if (!dev || !init_param->irq_ctrl)
+		return -1;
+
+	desc = (struct adf7023_pkt *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -1;
+
+	desc->dev = dev;
+	desc->irq_ctrl = init_param->irq_ctrl;
+	desc->irq_id = init_param->irq_id;
+
+	ret = cb_init(&desc->rx_queue, init_param->rx_queue_size);
+	if (ret < 0)
+		goto error;
+
+	ret = cb_init(&desc->tx_queue, init_param->tx_queue_size);
+	if (ret < 0)
+		goto error;
+
+	ret = irq_register(desc->irq_ctrl, desc->irq_id,
+			   adf7023_pkt_irq_handler, desc);
+	if (ret < 0)
+		goto error;
+
+	*pkt = desc;
+
+	return 0;
+error:
+	cb_remove(desc->tx_queue);
+	cb_remove(desc->rx_queue);
+	free(desc);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Free the resources allocated by adf7023_pkt_init().
+ *
+ * @param pkt - The packet engine.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adf7023_pkt_remove(struct adf7023_pkt *pkt)
+{
+	int32_t ret;
+
+	ret = adf7023_pkt_stop(pkt);
+	irq_unregister(pkt->irq_ctrl, pkt->irq_id);
+	cb_remove(pkt->tx_queue);
+	cb_remove(pkt->rx_queue);
+	free(pkt);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Enables the interrupt and starts receiving, or transmitting if
+ *        packets are already queued.
+ *
+ * @param pkt - The packet engine.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adf7023_pkt_start(struct adf7023_pkt *pkt)
+{
+	uint8_t clear = 0xFF;
+
+	if (pkt->running)
+		return 0;
+
+	adf7023_set_fw_state(pkt->dev, FW_STATE_PHY_ON);
+	adf7023_set_ram(pkt->dev, MCR_REG_INTERRUPT_SOURCE_0, 1, &clear);
+	pkt->tx_busy = false;
+	pkt->rearm_pending = false;
+	adf7023_pkt_rearm(pkt);
+	pkt->running = true;
+
+	return irq_source_enable(pkt->irq_ctrl, pkt->irq_id);
+}
+
+/***************************************************************************//**
+ * @brief Disables the interrupt and turns the receiver off. Packets left in
+ *        the queues are kept.
+ *
+ * @param pkt - The packet engine.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adf7023_pkt_stop(struct adf7023_pkt *pkt)
+{
+	int32_t ret;
+
+	if (!pkt->running)
+		return 0;
+
+	ret = irq_source_disable(pkt->irq_ctrl, pkt->irq_id);
+	adf7023_set_fw_state(pkt->dev, FW_STATE_PHY_ON);
+	pkt->running = false;
+	pkt->tx_busy = false;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Queues one packet for transmission. If the radio is receiving, the
+ *        transmission starts at once and takes precedence over a packet that
+ *        may be arriving.
+ *
+ * @param pkt    - The packet engine.
+ * @param packet - Payload.
+ * @param length - Payload length, up to ADF7023_MAX_PAYLOAD.
+ *
+ * @return 0 in case of success, -1 if the packet is invalid or the queue full.
+*******************************************************************************/
+int32_t adf7023_pkt_send(struct adf7023_pkt *pkt,
+			 const uint8_t *packet,
+			 uint8_t length)
+{
+	uint8_t record[1 + ADF7023_MAX_PAYLOAD];
+
+	if (!length || length > ADF7023_MAX_PAYLOAD)
+		return -1;
+
+	/* The handler only reads the TX queue: no masking needed to fill it */
+	if (cb_free_space(pkt->tx_queue) < 1U + length)
+		return -1;
+
+	record[0] = length;
+	memcpy(record + 1, packet, length);
+	cb_write(pkt->tx_queue, record, 1 + length);
+
+	if (!pkt->running)
+		return 0;
+
+	/* Starting a transmission shares the radio and tx_busy with the handler */
+	irq_source_disable(pkt->irq_ctrl, pkt->irq_id);
+	if (!pkt->tx_busy) {
+		adf7023_set_fw_state(pkt->dev, FW_STATE_PHY_ON);
+		/* Collect a packet received meanwhile before reusing RAM */
+		adf7023_pkt_service(pkt, true);
+	}
+	irq_source_enable(pkt->irq_ctrl, pkt->irq_id);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Takes one packet from the RX queue. A failed rearm of the radio is
+ *        retried first, since no interrupt comes while the radio is idle.
+ *
+ * @param pkt    - The packet engine.
+ * @param packet - Payload buffer, ADF7023_MAX_PAYLOAD bytes.
+ * @param length - Payload length.
+ *
+ * @return 1 if a packet was returned, 0 if the queue is empty.
+*******************************************************************************/
+int32_t adf7023_pkt_receive(struct adf7023_pkt *pkt,
+			    uint8_t *packet,
+			    uint8_t *length)
+{
+	if (pkt->running && pkt->rearm_pending) {
+		irq_source_disable(pkt->irq_ctrl, pkt->irq_id);
+		adf7023_pkt_service(pkt, false);
+		irq_source_enable(pkt->irq_ctrl, pkt->irq_id);
+	}
+
+	if (!cb_size(pkt->rx_queue))
+		return 0;
+
+	cb_read(pkt->rx_queue, length, 1);
+	cb_read(pkt->rx_queue, packet, *length);
+
+	return 1;
+}
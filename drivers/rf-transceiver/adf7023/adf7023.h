@@ -43,8 +43,11 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "spi.h"
 #include "gpio.h"
+#include "irq.h"
+#include "circular_buffer.h"
 
 /* Status Word */
 #define STATUS_SPI_READY  (0x1 << 7)
@@ -369,6 +372,13 @@ struct adf7023_bbram {
 #define ADF7023_TX_BASE_ADR 0x10
 #define ADF7023_RX_BASE_ADR 0x10
 
+/* Packet RAM past the base address: length, address and payload bytes */
+#define ADF7023_PACKET_RAM_SIZE	(0x100 - ADF7023_RX_BASE_ADR)
+#define ADF7023_MAX_PAYLOAD	(ADF7023_PACKET_RAM_SIZE - 2)
+
+/* Command and address bytes, plus a NOP for reads, then data */
+#define ADF7023_XFER_SIZE	(3 + ADF7023_PACKET_RAM_SIZE)
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -381,6 +391,8 @@ struct adf7023_dev {
 	struct gpio_desc	*gpio_miso;
 	/* Device Settings */
 	struct adf7023_bbram	adf7023_bbram_current;
+	/* Burst packet RAM transfers */
+	uint8_t			xfer[ADF7023_XFER_SIZE];
 };
 
 struct adf7023_init_param {
@@ -391,6 +403,40 @@ struct adf7023_init_param {
 	struct gpio_init_param	gpio_miso;
 };
 
+/*
+ * Packet engine: the IRQ_GP3 pin interrupt moves received packets to the RX
+ * queue and re-arms the receiver at once, and chains the packets of the TX
+ * queue. Packets are stored in the queues as a length byte and the payload.
+ */
+struct adf7023_pkt_init_param {
+	/* Interrupt controller and line of the IRQ_GP3 pin */
+	struct irq_ctrl_desc	*irq_ctrl;
+	uint32_t		irq_id;
+	/* Queue sizes in bytes, each packet takes its payload plus one */
+	uint32_t		rx_queue_size;
+	uint32_t		tx_queue_size;
+};
+
+struct adf7023_pkt {
+	struct adf7023_dev	*dev;
+	struct irq_ctrl_desc	*irq_ctrl;
+	uint32_t		irq_id;
+	struct circular_buffer	*rx_queue;
+	struct circular_buffer	*tx_queue;
+	bool			running;
+	/* A packet is being transmitted */
+	volatile bool		tx_busy;
+	/* The radio could not be restarted, retried on the next service */
+	volatile bool		rearm_pending;
+	/* Statistics */
+	volatile uint32_t	rx_packets;
+	volatile uint32_t	rx_dropped;
+	volatile uint32_t	tx_packets;
+	volatile uint32_t	rearm_errors;
+	/* Packet RAM image, only used from the interrupt handler */
+	uint8_t			ram[ADF7023_PACKET_RAM_SIZE];
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -448,4 +494,28 @@ void adf7023_set_data_rate(struct adf7023_dev *dev,
 void adf7023_set_frequency_deviation(struct adf7023_dev *dev,
 				     uint32_t freq_dev);
 
+/* Allocate the packet queues and register the interrupt handler. */
+int32_t adf7023_pkt_init(struct adf7023_pkt **pkt,
+			 struct adf7023_dev *dev,
+			 struct adf7023_pkt_init_param *init_param);
+
+/* Free the resources allocated by adf7023_pkt_init(). */
+int32_t adf7023_pkt_remove(struct adf7023_pkt *pkt);
+
+/* Enable the interrupt and start receiving. */
+int32_t adf7023_pkt_start(struct adf7023_pkt *pkt);
+
+/* Disable the interrupt and turn the receiver off. */
+int32_t adf7023_pkt_stop(struct adf7023_pkt *pkt);
+
+/* Queue one packet for transmission. */
+int32_t adf7023_pkt_send(struct adf7023_pkt *pkt,
+			 const uint8_t *packet,
+			 uint8_t length);
+
+/* Take one packet from the RX queue. */
+int32_t adf7023_pkt_receive(struct adf7023_pkt *pkt,
+			    uint8_t *packet,
+			    uint8_t *length);
+
 #endif // __ADF7023_H__
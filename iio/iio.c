@@ -49,6 +49,7 @@
 #include "util.h"
 #include "error.h"
 #include "errno.h"
+#include "xml.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -65,6 +66,42 @@ struct iio_interfaces {
 	uint8_t num_interfaces;
 };
 
+/**
+ * @struct iio_attr_cache_entry
+ * @brief Pre-rendered value of one attribute of one channel.
+ */
+struct iio_attr_cache_entry {
+	/** Attribute */
+	const struct iio_attribute *attr;
+	/** Channel number, -1 for device attributes */
+	int16_t ch_num;
+	/** Output channel */
+	bool ch_out;
+	/** The value can be served */
+	bool valid;
+	/** Time the value was read, for IIO_ATTR_CACHE_TTL */
+	uint32_t stamp_ms;
+	/** Value returned by show() */
+	ssize_t len;
+	/** Allocated size of value */
+	size_t size;
+	/** Rendered value */
+	char *value;
+};
+
+/**
+ * @struct iio_attr_cache
+ * @brief Attribute cache of an interface.
+ */
+struct iio_attr_cache {
+	/** Number of entries */
+	uint32_t num;
+	/** Allocated entries */
+	uint32_t size;
+	/** Entries */
+	struct iio_attr_cache_entry *entries;
+};
+
 /**
  * @struct element_info
  * @brief Structure informations about a specific parameter.
@@ -85,6 +122,32 @@ struct element_info {
  */
 static struct iio_interfaces *iio_interfaces = NULL;
 
+/**
+ * Ops registered by iio_init(), copied for every iio_instance_create() call
+ */
+static struct tinyiiod_ops *iio_ops = NULL;
+
+/**
+ * Read/write ops of the server, iio_server_read() is registered in their place
+ */
+static struct iio_server_ops iio_server_comm;
+
+/**
+ * First byte of a text command, already read by iio_read_command()
+ */
+static int16_t iio_pending_byte = -1;
+
+/**
+ * Instance executing the current command, owner of the devices it opens
+ */
+static struct tinyiiod *iio_session = NULL;
+
+/**
+ * Clock used to expire IIO_ATTR_CACHE_TTL values, TTL attributes are treated
+ * as volatile until one is set
+ */
+static uint32_t (*iio_attr_cache_clock)(void) = NULL;
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -179,17 +242,186 @@ static struct iio_interface *iio_get_interface(const char *device_name,
 	return NULL;
 }
 
+/**
+ * @brief Find the cache entry of an attribute, allocating it if needed.
+ * @param iface - Interface owning the cache.
+ * @param attr - Attribute.
+ * @param channel - Channel properties, NULL for device attributes.
+ * @return The entry, NULL if out of memory.
+ */
+static struct iio_attr_cache_entry *iio_attr_cache_get(
+	struct iio_interface *iface, const struct iio_attribute *attr,
+	const struct iio_ch_info *channel)
+{
+	struct iio_attr_cache *cache = iface->attr_cache;
+	struct iio_attr_cache_entry *e;
+	int16_t ch_num = channel ? channel->ch_num : -1;
+	bool ch_out = channel ? channel->ch_out : false;
+	uint32_t i;
+
+	if (!cache) {
+		cache = (struct iio_attr_cache *)calloc(1, sizeof(*cache));
+		if (!cache)
+			return NULL;
+		iface->attr_cache = cache;
+	}
+
+	for (i = 0; i < cache->num; i++) {
+		e = &cache->entries[i];
+		if (e->attr == attr && e->ch_num == ch_num && e->ch_out == ch_out)
+			return e;
+	}
+
+	if (cache->num == cache->size) {
+		e = (struct iio_attr_cache_entry *)realloc(cache->entries,
+				(cache->size + 16) * sizeof(*e));
+		if (!e)
+			return NULL;
+		cache->entries = e;
+		cache->size += 16;
+	}
+
+	e = &cache->entries[cache->num++];
+	memset(e, 0, sizeof(*e));
+	e->attr = attr;
+	e->ch_num = ch_num;
+	e->ch_out = ch_out;
+
+	return e;
+}
+
+/**
+ * @brief Invalidate the cached values that depend on the device state.
+ * @param iface - Interface owning the cache.
+ * @return None.
+ */
+static void iio_attr_cache_drop(struct iio_interface *iface)
+{
+	struct iio_attr_cache *cache = iface->attr_cache;
+	uint32_t i;
+
+	if (!cache)
+		return;
+
+	for (i = 0; i < cache->num; i++)
+		if (cache->entries[i].attr->cache != IIO_ATTR_STATIC)
+			cache->entries[i].valid = false;
+}
+
+/**
+ * @brief Free the attribute cache of an interface.
+ * @param iface - Interface owning the cache.
+ * @return None.
+ */
+static void iio_attr_cache_free(struct iio_interface *iface)
+{
+	struct iio_attr_cache *cache = iface->attr_cache;
+	uint32_t i;
+
+	if (!cache)
+		return;
+
+	for (i = 0; i < cache->num; i++)
+		free(cache->entries[i].value);
+	free(cache->entries);
+	free(cache);
+	iface->attr_cache = NULL;
+}
+
+/**
+ * @brief Read an attribute, from the cache when its policy allows it.
+ * @param iface - Interface of the device.
+ * @param attr - Attribute.
+ * @param buf - Buffer where value is read.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties, NULL for device attributes.
+ * @return Value returned by the show() function of the attribute.
+ */
+static ssize_t iio_attr_show(struct iio_interface *iface,
+			     const struct iio_attribute *attr, char *buf,
+			     size_t len, const struct iio_ch_info *channel)
+{
+	struct iio_attr_cache_entry *e;
+	uint32_t now = 0;
+	ssize_t ret;
+	char *value;
+
+	if (!attr->show)
+		return -ENOENT;
+
+	if (attr->cache == IIO_ATTR_VOLATILE ||
+	    (attr->cache == IIO_ATTR_CACHE_TTL && !iio_attr_cache_clock))
+		return attr->show(iface->dev_instance, buf, len, channel);
+
+	e = iio_attr_cache_get(iface, attr, channel);
+	if (!e)
+		return attr->show(iface->dev_instance, buf, len, channel);
+
+	if (attr->cache == IIO_ATTR_CACHE_TTL) {
+		now = iio_attr_cache_clock();
+		if (e->valid && now - e->stamp_ms >= attr->ttl_ms)
+			e->valid = false;
+	}
+
+	if (e->valid && (size_t)e->len < len) {
+		memcpy(buf, e->value, e->len + 1);
+		return e->len;
+	}
+
+	ret = attr->show(iface->dev_instance, buf, len, channel);
+	if (ret < 0 || (size_t)ret >= len)
+		return ret;
+
+	if (e->size < (size_t)ret + 1) {
+		value = (char *)realloc(e->value, ret + 1);
+		if (!value)
+			return ret;
+		e->value = value;
+		e->size = ret + 1;
+	}
+	memcpy(e->value, buf, ret);
+	e->value[ret] = '\0';
+	e->len = ret;
+	e->stamp_ms = now;
+	e->valid = true;
+
+	return ret;
+}
+
+/**
+ * @brief Write an attribute and invalidate the cached values of the device.
+ * @param iface - Interface of the device.
+ * @param attr - Attribute.
+ * @param buf - Value to be written.
+ * @param len - Length of data.
+ * @param channel - Channel properties, NULL for device attributes.
+ * @return Value returned by the store() function of the attribute.
+ */
+static ssize_t iio_attr_store(struct iio_interface *iface,
+			      const struct iio_attribute *attr, char *buf,
+			      size_t len, const struct iio_ch_info *channel)
+{
+	if (!attr->store)
+		return -ENOENT;
+
+	/* A write may change any attribute of the device, not only this one */
+	iio_attr_cache_drop(iface);
+
+	return attr->store(iface->dev_instance, buf, len, channel);
+}
+
 /**
  * @brief Read all attributes from an attribute list.
- * @param device - Physical instance of a device.
+ * @param iface - Interface of the device.
  * @param buf - Buffer where values are read.
  * @param len - Maximum length of value to be stored in buf.
  * @param channel - Channel properties.
  * @param attributes - List of attributes to be read.
  * @return Number of bytes read or negative value in case of error.
  */
-static ssize_t iio_read_all_attr(void *device, char *buf, size_t len,
-				 const struct iio_ch_info *channel, struct iio_attribute **attributes)
+static ssize_t iio_read_all_attr(struct iio_interface *iface, char *buf,
+				 size_t len, const struct iio_ch_info *channel,
+				 struct iio_attribute **attributes)
 {
 	int16_t i = 0, j = 0;
 	char local_buf[256];
@@ -203,7 +435,8 @@ static ssize_t iio_read_all_attr(void *device, char *buf, size_t len,
 		return FAILURE;
 
 	while (attributes[i]) {
-		attr_length = attributes[i]->show(device, local_buf, len, channel);
+		attr_length = iio_attr_show(iface, attributes[i], local_buf,
+					    min(len, sizeof(local_buf)), channel);
 		pattr_length = (uint32_t *)(buf + j);
 		*pattr_length = bswap_constant_32(attr_length);
 		j += 4;
@@ -221,15 +454,16 @@ static ssize_t iio_read_all_attr(void *device, char *buf, size_t len,
 
 /**
  * @brief Write all attributes from an attribute list.
- * @param device - Physical instance of a device.
+ * @param iface - Interface of the device.
  * @param buf - Values to be written.
  * @param len - Length of buf.
  * @param channel - Channel properties.
  * @param attributes - List of attributes to be written.
  * @return Number of written bytes or negative value in case of error.
  */
-static ssize_t iio_write_all_attr(void *device, char *buf, size_t len,
-				  const struct iio_ch_info *channel, struct iio_attribute **attributes)
+static ssize_t iio_write_all_attr(struct iio_interface *iface, char *buf,
+				  size_t len, const struct iio_ch_info *channel,
+				  struct iio_attribute **attributes)
 {
 	int16_t i = 0, j = 0;
 	int16_t attr_length;
@@ -243,7 +477,7 @@ static ssize_t iio_write_all_attr(void *device, char *buf, size_t len,
 	while (attributes[i]) {
 		attr_length = bswap_constant_32((uint32_t)(buf + j));
 		j += 4;
-		attributes[i]->store(device, (buf + j), attr_length, channel);
+		iio_attr_store(iface, attributes[i], (buf + j), attr_length, channel);
 		j += attr_length;
 		if (j & 0x3)
 			j = ((j >> 2) + 1) << 2;
@@ -278,10 +512,10 @@ static ssize_t iio_rd_wr_channel_attribute(struct element_info *el_info,
 	if (!strcmp(el_info->attribute_name, "")) {
 		/* read / write all channel attributes */
 		if (is_write)
-			return iio_write_all_attr(iface->dev_instance, buf, len, &channel_info,
+			return iio_write_all_attr(iface, buf, len, &channel_info,
 						  channel->attributes);
 		else
-			return iio_read_all_attr(iface->dev_instance, buf, len, &channel_info,
+			return iio_read_all_attr(iface, buf, len, &channel_info,
 						 channel->attributes);
 	} else {
 		/* read / write single channel attribute, if attribute found */
@@ -289,11 +523,11 @@ static ssize_t iio_rd_wr_channel_attribute(struct element_info *el_info,
 						    channel->attributes);
 		if (attribute_id >= 0) {
 			if (is_write)
-				return channel->attributes[attribute_id]->store(iface->dev_instance,
-						(char*)buf, len, &channel_info);
+				return iio_attr_store(iface, channel->attributes[attribute_id],
+						      (char*)buf, len, &channel_info);
 			else
-				return channel->attributes[attribute_id]->show(iface->dev_instance, (char*)buf,
-						len, &channel_info);
+				return iio_attr_show(iface, channel->attributes[attribute_id],
+						     (char*)buf, len, &channel_info);
 		}
 	}
 
@@ -328,10 +562,10 @@ static ssize_t iio_rd_wr_attribute(struct element_info *el_info, char *buf,
 		if (!strcmp(el_info->attribute_name, "")) {
 			/* read / write all device attributes */
 			if (is_write)
-				return iio_write_all_attr(iface->dev_instance, buf, len, NULL,
+				return iio_write_all_attr(iface, buf, len, NULL,
 							  iio_device->attributes);
 			else
-				return iio_read_all_attr(iface->dev_instance, buf, len, NULL,
+				return iio_read_all_attr(iface, buf, len, NULL,
 							 iio_device->attributes);
 		} else {
 			/* read / write single device attribute, if attribute found */
@@ -340,11 +574,11 @@ static ssize_t iio_rd_wr_attribute(struct element_info *el_info, char *buf,
 			if (attribute_id < 0)
 				return -ENOENT;
 			if (is_write)
-				return iio_device->attributes[attribute_id]->store(iface->dev_instance,
-						(char*)buf, len, NULL);
+				return iio_attr_store(iface, iio_device->attributes[attribute_id],
+						      (char*)buf, len, NULL);
 			else
-				return iio_device->attributes[attribute_id]->show(iface->dev_instance,
-						(char*)buf, len, NULL);
+				return iio_attr_show(iface, iio_device->attributes[attribute_id],
+						     (char*)buf, len, NULL);
 		}
 	} else {
 		/* it is attribute of a channel */
@@ -510,7 +744,12 @@ static int32_t iio_open_dev(const char *device, size_t sample_size,
 	if (mask & ~ch_mask)
 		return -ENOENT;
 
+	/* The buffer of a device can only serve one client */
+	if (iface->ch_mask && iface->owner != iio_session)
+		return -EBUSY;
+
 	iface->ch_mask = mask;
+	iface->owner = iio_session;
 
 	return SUCCESS;
 }
@@ -527,7 +766,11 @@ static int32_t iio_close_dev(const char *device)
 	if (!iio_supported_dev(device))
 		return FAILURE;
 	iface = iio_get_interface(device, iio_interfaces);
+	if (iface->ch_mask && iface->owner != iio_session)
+		return -EBUSY;
+
 	iface->ch_mask = 0;
+	iface->owner = NULL;
 
 	return SUCCESS;
 }
@@ -630,6 +873,289 @@ static ssize_t iio_write_dev(const char *device, const char *buf,
 	return -ENOENT;
 }
 
+/**
+ * @brief Check that a device buffer can be used by an instance: the device
+ * exists and is not opened by another instance.
+ * @param iiod - Instance moving the buffer.
+ * @param device - String containing device name.
+ * @return SUCCESS, negative value in case of failure.
+ */
+static ssize_t iio_buffer_check(struct tinyiiod *iiod, const char *device)
+{
+	struct iio_interface *iface;
+
+	if (!iio_supported_dev(device))
+		return -ENODEV;
+
+	iface = iio_get_interface(device, iio_interfaces);
+	if (iface->ch_mask && iface->owner != iiod)
+		return -EBUSY;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start a buffer read on behalf of an instance, for servers that send
+ * the data in chunks themselves instead of through "libtinyiiod".
+ * @param iiod - Instance issuing the READBUF command.
+ * @param device - String containing device name.
+ * @param bytes_count - Number of bytes to be read.
+ * @param mask - Opened channels mask.
+ * @return SUCCESS, negative value in case of failure.
+ */
+ssize_t iio_buffer_read_start(struct tinyiiod *iiod, const char *device,
+			      size_t bytes_count, uint32_t *mask)
+{
+	ssize_t ret;
+
+	ret = iio_buffer_check(iiod, device);
+	if (ret < 0)
+		return ret;
+
+	ret = iio_get_mask(device, mask);
+	if (ret < 0)
+		return ret;
+
+	ret = iio_transfer_dev_to_mem(device, bytes_count);
+
+	return ret < 0 ? ret : SUCCESS;
+}
+
+/**
+ * @brief Read the next chunk of a buffer started by iio_buffer_read_start().
+ * @param iiod - Instance issuing the READBUF command.
+ * @param device - String containing device name.
+ * @param buf - Destination.
+ * @param offset - Offset of the chunk in the buffer.
+ * @param bytes_count - Number of bytes to read.
+ * @return Number of bytes read or negative value in case of error.
+ */
+ssize_t iio_buffer_read(struct tinyiiod *iiod, const char *device, char *buf,
+			size_t offset, size_t bytes_count)
+{
+	ssize_t ret;
+
+	ret = iio_buffer_check(iiod, device);
+	if (ret < 0)
+		return ret;
+
+	return iio_read_dev(device, buf, offset, bytes_count);
+}
+
+/**
+ * @brief Write the next chunk of a buffer on behalf of an instance, for
+ * servers that receive the data in chunks themselves.
+ * @param iiod - Instance issuing the WRITEBUF command.
+ * @param device - String containing device name.
+ * @param buf - Source.
+ * @param offset - Offset of the chunk in the buffer.
+ * @param bytes_count - Number of bytes to write.
+ * @return Number of bytes written or negative value in case of error.
+ */
+ssize_t iio_buffer_write(struct tinyiiod *iiod, const char *device,
+			 const char *buf, size_t offset, size_t bytes_count)
+{
+	ssize_t ret;
+
+	ret = iio_buffer_check(iiod, device);
+	if (ret < 0)
+		return ret;
+
+	return iio_write_dev(device, buf, offset, bytes_count);
+}
+
+/**
+ * @brief Send a buffer written with iio_buffer_write() to the device.
+ * @param iiod - Instance issuing the WRITEBUF command.
+ * @param device - String containing device name.
+ * @param bytes_count - Size of the buffer.
+ * @return Number of bytes transferred or negative value in case of error.
+ */
+ssize_t iio_buffer_write_done(struct tinyiiod *iiod, const char *device,
+			      size_t bytes_count)
+{
+	ssize_t ret;
+
+	ret = iio_buffer_check(iiod, device);
+	if (ret < 0)
+		return ret;
+
+	return iio_transfer_mem_to_dev(device, bytes_count);
+}
+
+/**
+ * @brief Create an xml attribute and add it to a node.
+ * @param node - The node.
+ * @param name - Attribute name.
+ * @param value - Attribute value.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static ssize_t iio_xml_set(struct xml_node *node, char *name, char *value)
+{
+	struct xml_attribute *att;
+	ssize_t ret;
+
+	ret = xml_create_attribute(&att, name, value);
+	if (ret < 0)
+		return ret;
+
+	ret = xml_add_attribute(node, att);
+	if (ret < 0)
+		xml_delete_attribute(att);
+
+	return ret;
+}
+
+/**
+ * @brief Add an "attribute" element for each entry of an attribute list.
+ * @param parent - Device or channel node.
+ * @param attrs - NULL terminated list, may be NULL.
+ * @param prefix - File name prefix of channel attributes, NULL for device
+ *                 attributes.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static ssize_t iio_xml_add_attributes(struct xml_node *parent,
+				      struct iio_attribute **attrs,
+				      const char *prefix)
+{
+	struct xml_node *attribute;
+	char buff[256];
+	ssize_t ret;
+	uint16_t i;
+
+	for (i = 0; attrs && attrs[i]; i++) {
+		ret = xml_create_node(&attribute, "attribute");
+		if (ret < 0)
+			return ret;
+		ret = xml_add_node(parent, attribute);
+		if (ret < 0) {
+			xml_delete_node(attribute);
+			return ret;
+		}
+		ret = iio_xml_set(attribute, "name", (char *)attrs[i]->name);
+		if (ret < 0)
+			return ret;
+		if (!prefix)
+			continue;
+
+		snprintf(buff, sizeof(buff), "%s_%s", prefix, attrs[i]->name);
+		ret = iio_xml_set(attribute, "filename", buff);
+		if (ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Generate the xml of a device from its channel and attribute lists.
+ * Channel attributes get "in_<channel>_<attribute>" or
+ * "out_<channel>_<attribute>" file names.
+ * @param xml - Generated xml.
+ * @param iio_dev - Structure describing a device, channels and attributes.
+ * @param scan_format - Format of the channel scan elements, for example
+ *                      "le:S16/16&gt;&gt;0". NULL if the device has no buffer.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_device_get_scan_xml(char **xml, struct iio_device *iio_dev,
+				const char *scan_format)
+{
+	struct xml_document *document = NULL;
+	struct xml_node *device = NULL;
+	struct xml_node *channel;
+	struct xml_node *scan;
+	struct iio_channel *ch;
+	char buff[256];
+	ssize_t ret;
+	uint16_t i;
+
+	if (!xml || !iio_dev)
+		return FAILURE;
+
+	ret = xml_create_node(&device, "device");
+	if (ret < 0)
+		goto error;
+	ret = iio_xml_set(device, "id", (char *)iio_dev->name);
+	if (ret < 0)
+		goto error;
+	ret = iio_xml_set(device, "name", (char *)iio_dev->name);
+	if (ret < 0)
+		goto error;
+
+	for (i = 0; i < iio_dev->num_ch; i++) {
+		ch = iio_dev->channels[i];
+
+		ret = xml_create_node(&channel, "channel");
+		if (ret < 0)
+			goto error;
+		ret = xml_add_node(device, channel);
+		if (ret < 0) {
+			xml_delete_node(channel);
+			goto error;
+		}
+		ret = iio_xml_set(channel, "id", ch->name);
+		if (ret < 0)
+			goto error;
+		ret = iio_xml_set(channel, "type", ch->ch_out ? "output" : "input");
+		if (ret < 0)
+			goto error;
+
+		if (scan_format) {
+			ret = xml_create_node(&scan, "scan-element");
+			if (ret < 0)
+				goto error;
+			ret = xml_add_node(channel, scan);
+			if (ret < 0) {
+				xml_delete_node(scan);
+				goto error;
+			}
+			sprintf(buff, "%d", i);
+			ret = iio_xml_set(scan, "index", buff);
+			if (ret < 0)
+				goto error;
+			ret = iio_xml_set(scan, "format", (char *)scan_format);
+			if (ret < 0)
+				goto error;
+		}
+
+		snprintf(buff, sizeof(buff), "%s_%s", ch->ch_out ? "out" : "in",
+			 ch->name);
+		ret = iio_xml_add_attributes(channel, ch->attributes, buff);
+		if (ret < 0)
+			goto error;
+	}
+
+	ret = iio_xml_add_attributes(device, iio_dev->attributes, NULL);
+	if (ret < 0)
+		goto error;
+
+	ret = xml_create_document(&document, device);
+	if (ret < 0) {
+		if (document)
+			xml_delete_document(document);
+		goto error;
+	}
+	*xml = document->buff;
+
+error:
+	if (device)
+		xml_delete_node(device);
+
+	return ret;
+}
+
+/**
+ * @brief Generate the xml of a device without buffer. Can be used directly as
+ * the get_xml callback of an interface.
+ * @param xml - Generated xml.
+ * @param iio_dev - Structure describing a device, channels and attributes.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_device_get_xml(char **xml, struct iio_device *iio_dev)
+{
+	return iio_device_get_scan_xml(xml, iio_dev, NULL);
+}
+
 /**
  * @brief Get a merged xml containing all devices.
  * @param outxml - Generated xml.
@@ -767,18 +1293,356 @@ ssize_t iio_unregister(struct iio_interface *iio_interface)
 	}
 
 	for(i = 0; i < iio_interfaces->num_interfaces; i++) {
-		if (!strcmp(iio_interface->name, iio_interfaces->interfaces[i]->name)) {
-			iio_interface = iio_interfaces->interfaces[i];
+		if (!deleted &&
+		    !strcmp(iio_interface->name, iio_interfaces->interfaces[i]->name)) {
+			iio_attr_cache_free(iio_interfaces->interfaces[i]);
 			deleted = 1;
 			continue;
 		}
+		if (i - deleted == iio_interfaces->num_interfaces - 1)
+			break;
 		interfaces->interfaces[i - deleted] = iio_interfaces->interfaces[i];
 	}
 
+	if (!deleted) {
+		free(interfaces->interfaces);
+		free(interfaces);
+		return FAILURE;
+	}
+
 	interfaces->num_interfaces = iio_interfaces->num_interfaces - 1;
+	free(iio_interfaces->interfaces);
 	free(iio_interfaces);
+	iio_interfaces = interfaces;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Server read op registered in "libtinyiiod", returns first the byte
+ * taken by iio_read_command().
+ * @param buf - Destination.
+ * @param len - Number of bytes to read.
+ * @return Value returned by the read op of the server.
+ */
+static ssize_t iio_server_read(char *buf, size_t len)
+{
+	ssize_t ret;
+
+	if (!len || iio_pending_byte < 0)
+		return iio_server_comm.read(buf, len);
+
+	buf[0] = (char)iio_pending_byte;
+	iio_pending_byte = -1;
+	if (len == 1)
+		return 1;
+
+	ret = iio_server_comm.read(buf + 1, len - 1);
+	if (ret < 0)
+		return ret;
+
+	return ret + 1;
+}
+
+/**
+ * @brief Read len bytes from the server. The read op fills the whole buffer
+ * and returns a non negative value, which is SUCCESS on some transports and
+ * the number of bytes on others, so only its sign is checked.
+ * @param buf - Destination.
+ * @param len - Number of bytes to read.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static ssize_t iio_bin_read(uint8_t *buf, size_t len)
+{
+	ssize_t ret;
+
+	ret = iio_server_comm.read((char *)buf, len);
+	if (ret < 0)
+		return ret;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Answer a frame whose op is not supported: skip its items and reply
+ * -EOPNOTSUPP for each of them.
+ * @param hdr - Frame header, sent back as reply header.
+ * @param count - Number of items.
+ * @return SUCCESS in case of success or negative value if the link failed.
+ */
+static int32_t iio_bin_unsupported(uint8_t *hdr, uint16_t count)
+{
+	uint8_t item[IIO_BIN_ITEM_SIZE(0xFF)];
+	uint8_t status[4];
+	ssize_t ret;
+	uint16_t i;
+	uint8_t j;
+
+	for (j = 0; j < 4; j++)
+		status[j] = (uint32_t)-EOPNOTSUPP >> (8 * j);
 
-	return deleted ? SUCCESS : FAILURE;
+	ret = iio_server_comm.write((char *)hdr, IIO_BIN_HDR_SIZE);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < count; i++) {
+		ret = iio_bin_read(item, IIO_BIN_ITEM_SIZE(hdr[1]));
+		if (ret < 0)
+			return ret;
+		ret = iio_server_comm.write((char *)status, sizeof(status));
+		if (ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Find the attribute and the channel addressed by a binary id.
+ * @param id - Attribute id, see IIO_BIN_ID().
+ * @param iface - Interface of the device.
+ * @param attr - Attribute.
+ * @param ch_info - Channel properties, filled for channel attributes.
+ * @return Channel properties to be passed to the attribute, NULL for device
+ * attributes; "attr" is NULL if the id is not valid.
+ */
+static const struct iio_ch_info *iio_bin_resolve(uint32_t id,
+		struct iio_interface **iface, struct iio_attribute **attr,
+		struct iio_ch_info *ch_info)
+{
+	uint8_t dev = id >> 24, ch = id >> 16, idx = id >> 8;
+	struct iio_attribute **attributes;
+	struct iio_channel *channel;
+	uint8_t i;
+
+	*attr = NULL;
+	if (!iio_interfaces || dev >= iio_interfaces->num_interfaces)
+		return NULL;
+
+	*iface = iio_interfaces->interfaces[dev];
+	if (ch == IIO_BIN_DEV_ATTR) {
+		attributes = (*iface)->iio->attributes;
+		channel = NULL;
+	} else {
+		if (ch >= (*iface)->iio->num_ch)
+			return NULL;
+		channel = (*iface)->iio->channels[ch];
+		attributes = channel->attributes;
+	}
+
+	for (i = 0; attributes && attributes[i]; i++)
+		if (i == idx) {
+			*attr = attributes[i];
+			break;
+		}
+
+	if (!channel)
+		return NULL;
+
+	ch_info->ch_num = iio_get_channel_number(channel->name);
+	ch_info->ch_out = channel->ch_out;
+
+	return ch_info;
+}
+
+/**
+ * @brief Convert the text value of an attribute to a binary value.
+ * @param buf - Text value.
+ * @param fmt - Binary format.
+ * @param value - Binary value.
+ * @return SUCCESS in case of success or -EINVAL if the text is not a number.
+ */
+static ssize_t iio_bin_from_str(const char *buf, enum iio_bin_fmt fmt,
+				int64_t *value)
+{
+	bool neg = false, digits = false;
+	int64_t v = 0, frac = 0;
+	uint8_t n = 0;
+
+	while (*buf == ' ')
+		buf++;
+	if (*buf == '-' || *buf == '+')
+		neg = *buf++ == '-';
+
+	for (; isdigit((int)*buf); buf++, digits = true)
+		v = v * 10 + (*buf - '0');
+
+	if (fmt == IIO_BIN_MICRO) {
+		if (*buf == '.')
+			for (buf++; isdigit((int)*buf); buf++, digits = true)
+				if (n < 6) {
+					frac = frac * 10 + (*buf - '0');
+					n++;
+				}
+		for (; n < 6; n++)
+			frac *= 10;
+		v = v * 1000000 + frac;
+	}
+
+	if (!digits)
+		return -EINVAL;
+
+	*value = neg ? -v : v;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Convert a binary value to the text value of an attribute.
+ * @param value - Binary value.
+ * @param fmt - Binary format.
+ * @param buf - Text value, at least 24 bytes.
+ * @return Length of the text.
+ */
+static size_t iio_bin_to_str(int64_t value, enum iio_bin_fmt fmt, char *buf)
+{
+	uint64_t v = value < 0 ? -(uint64_t)value : value;
+	char tmp[24];
+	uint8_t n = 0;
+	size_t len = 0;
+
+	do {
+		tmp[n++] = '0' + v % 10;
+		v /= 10;
+		if (fmt == IIO_BIN_MICRO && n == 6)
+			tmp[n++] = '.';
+	} while (v || (fmt == IIO_BIN_MICRO && n < 8));
+
+	if (value < 0)
+		buf[len++] = '-';
+	while (n)
+		buf[len++] = tmp[--n];
+	buf[len] = '\0';
+
+	return len;
+}
+
+/**
+ * @brief Execute one item of a binary frame.
+ * @param op - IIO_BIN_READ or IIO_BIN_WRITE.
+ * @param id - Attribute id.
+ * @param value - Value to be written, or read value.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static ssize_t iio_bin_item(enum iio_bin_op op, uint32_t id, int64_t *value)
+{
+	enum iio_bin_fmt fmt = (enum iio_bin_fmt)(id & 0xFF);
+	const struct iio_ch_info *channel;
+	struct iio_interface *iface;
+	struct iio_attribute *attr;
+	struct iio_ch_info ch_info;
+	char buf[64];
+	ssize_t ret;
+	size_t len;
+
+	if (fmt != IIO_BIN_INT && fmt != IIO_BIN_MICRO)
+		return -EINVAL;
+
+	channel = iio_bin_resolve(id, &iface, &attr, &ch_info);
+	if (!attr)
+		return -ENOENT;
+
+	if (op == IIO_BIN_WRITE) {
+		len = iio_bin_to_str(*value, fmt, buf);
+		ret = iio_attr_store(iface, attr, buf, len, channel);
+
+		return ret < 0 ? ret : SUCCESS;
+	}
+
+	ret = iio_attr_show(iface, attr, buf, sizeof(buf), channel);
+	if (ret < 0)
+		return ret;
+	buf[min((size_t)ret, sizeof(buf) - 1)] = '\0';
+
+	return iio_bin_from_str(buf, fmt, value);
+}
+
+/**
+ * @brief Execute a binary batch attribute frame, whose magic byte was already
+ * read. Every item is answered, in order, as soon as it is executed.
+ * @return SUCCESS in case of success or negative value if the link failed.
+ */
+static int32_t iio_bin_command(void)
+{
+	uint8_t hdr[IIO_BIN_HDR_SIZE], item[12];
+	enum iio_bin_op op;
+	uint16_t count, i;
+	int64_t value;
+	uint64_t raw;
+	uint32_t id;
+	ssize_t ret;
+	uint8_t j;
+
+	ret = iio_bin_read(hdr + 1, IIO_BIN_HDR_SIZE - 1);
+	if (ret < 0)
+		return ret;
+
+	hdr[0] = IIO_BIN_MAGIC;
+	op = (enum iio_bin_op)hdr[1];
+	count = hdr[2] | (hdr[3] << 8);
+	if (op != IIO_BIN_READ && op != IIO_BIN_WRITE)
+		return iio_bin_unsupported(hdr, count);
+
+	ret = iio_server_comm.write((char *)hdr, IIO_BIN_HDR_SIZE);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < count; i++) {
+		ret = iio_bin_read(item, IIO_BIN_ITEM_SIZE(op));
+		if (ret < 0)
+			return ret;
+
+		id = item[0] | (item[1] << 8) | (item[2] << 16) |
+		     ((uint32_t)item[3] << 24);
+		raw = 0;
+		if (op == IIO_BIN_WRITE)
+			for (j = 0; j < 8; j++)
+				raw |= (uint64_t)item[4 + j] << (8 * j);
+		value = (int64_t)raw;
+
+		ret = iio_bin_item(op, id, &value);
+		if (ret < 0)
+			value = 0;
+
+		for (j = 0; j < 4; j++)
+			item[j] = (uint32_t)ret >> (8 * j);
+		for (j = 0; j < 8; j++)
+			item[4 + j] = (uint64_t)value >> (8 * j);
+
+		ret = iio_server_comm.write((char *)item,
+					    op == IIO_BIN_READ ? 12 : 4);
+		if (ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read and execute one command. Binary batch attribute frames are
+ * handled here, text commands are passed to "libtinyiiod". Can be called in
+ * place of tinyiiod_read_command().
+ * @param iiod - Instance returned by iio_init() or iio_instance_create().
+ * @return Value returned by tinyiiod_read_command(), or negative value if a
+ * binary frame failed.
+ */
+int32_t iio_read_command(struct tinyiiod *iiod)
+{
+	char c;
+	ssize_t ret;
+
+	iio_session = iiod;
+
+	ret = iio_server_comm.read(&c, 1);
+	if (ret < 0)
+		return ret;
+
+	if ((uint8_t)c == IIO_BIN_MAGIC)
+		return iio_bin_command();
+
+	iio_pending_byte = (uint8_t)c;
+
+	return tinyiiod_read_command(iiod);
 }
 
 /**
@@ -811,7 +1675,8 @@ ssize_t iio_init(struct tinyiiod **iiod, struct iio_server_ops *iio_server_ops)
 	ops->close = iio_close_dev;
 	ops->get_mask = iio_get_mask;
 
-	ops->read = iio_server_ops->read;
+	iio_server_comm = *iio_server_ops;
+	ops->read = iio_server_read;
 	ops->write = iio_server_ops->write;
 	ops->get_xml = iio_get_xml;
 
@@ -820,10 +1685,68 @@ ssize_t iio_init(struct tinyiiod **iiod, struct iio_server_ops *iio_server_ops)
 		free(ops);
 		return FAILURE;
 	} else {
+		iio_ops = ops;
 		return SUCCESS;
 	}
 }
 
+/**
+ * @brief Create an additional tinyiiod instance, with its own parser state,
+ * bound to the ops set by "iio_init()". Used by servers that handle several
+ * clients, one instance per client.
+ * @param iiod - Structure containing new tinyiiod instance.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_instance_create(struct tinyiiod **iiod)
+{
+	struct tinyiiod_ops *ops;
+
+	if (!iio_ops)
+		return FAILURE;
+
+	/* Each instance owns its ops, tinyiiod_destroy() releases them */
+	ops = (struct tinyiiod_ops *)calloc(1, sizeof(*ops));
+	if (!ops)
+		return -ENOMEM;
+	*ops = *iio_ops;
+
+	*iiod = tinyiiod_create(ops);
+	if (!(*iiod)) {
+		free(ops);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free an instance created by "iio_instance_create()" and close the
+ * devices it left open.
+ * @param iiod - Structure containing tinyiiod instance.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_instance_remove(struct tinyiiod *iiod)
+{
+	uint8_t i;
+
+	if (!iiod)
+		return FAILURE;
+
+	/* Close the devices the client left open */
+	for (i = 0; iio_interfaces && i < iio_interfaces->num_interfaces; i++) {
+		if (iio_interfaces->interfaces[i]->owner != iiod)
+			continue;
+		iio_interfaces->interfaces[i]->ch_mask = 0;
+		iio_interfaces->interfaces[i]->owner = NULL;
+	}
+	if (iio_session == iiod)
+		iio_session = NULL;
+
+	tinyiiod_destroy(iiod);
+
+	return SUCCESS;
+}
+
 /**
  * @brief Free the resources allocated by "iio_init()".
  * @param iiod: Structure containing tinyiiod instance.
@@ -833,11 +1756,48 @@ ssize_t iio_remove(struct tinyiiod *iiod)
 {
 	uint8_t i;
 
-	for (i = 0; i < iio_interfaces->num_interfaces; i++)
-		free(iio_interfaces->interfaces[i]);
+	if (iio_interfaces) {
+		for (i = 0; i < iio_interfaces->num_interfaces; i++) {
+			iio_attr_cache_free(iio_interfaces->interfaces[i]);
+			free(iio_interfaces->interfaces[i]);
+		}
 
-	free(iio_interfaces);
+		free(iio_interfaces->interfaces);
+		free(iio_interfaces);
+		iio_interfaces = NULL;
+	}
 	tinyiiod_destroy(iiod);
+	iio_ops = NULL;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the clock used to expire IIO_ATTR_CACHE_TTL values. Until a
+ * clock is set, TTL attributes are read on every access.
+ * @param get_ms - Function returning a free running millisecond count.
+ * @return None.
+ */
+void iio_attr_cache_set_clock(uint32_t (*get_ms)(void))
+{
+	iio_attr_cache_clock = get_ms;
+}
+
+/**
+ * @brief Drop the cached attribute values of a device. Needed when the
+ * application changes the device state without going through iio.
+ * @param device - String containing device name.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_attr_cache_invalidate(const char *device)
+{
+	struct iio_interface *iface;
+
+	iface = iio_get_interface(device, iio_interfaces);
+	if (!iface)
+		return -ENODEV;
+
+	iio_attr_cache_drop(iface);
 
 	return SUCCESS;
 }
@@ -47,10 +47,64 @@
 #include "tinyiiod.h"
 #include "iio_types.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * Binary batch attribute protocol. A frame starts, in place of a text command,
+ * with IIO_BIN_MAGIC, which no text command starts with. All fields are
+ * little endian.
+ *   request:  magic(u8) op(u8) count(u16) count * item
+ *             item = id(u32) for IIO_BIN_READ, id(u32) value(i64) for
+ *             IIO_BIN_WRITE
+ *   response: magic(u8) op(u8) count(u16) count * item
+ *             item = status(i32) value(i64) for IIO_BIN_READ, status(i32) for
+ *             IIO_BIN_WRITE, status being 0 or a negative error code
+ * The upper nibble of op is the request item size in 32 bit words. The items
+ * of an op the server does not know are skipped, and each is answered with a
+ * status(i32) of -EOPNOTSUPP.
+ */
+#define IIO_BIN_MAGIC		0xA5
+#define IIO_BIN_HDR_SIZE	4
+/* Request item size in bytes */
+#define IIO_BIN_ITEM_SIZE(op)	(((op) >> 4) * 4)
+/* Channel index of the device attributes */
+#define IIO_BIN_DEV_ATTR	0xFF
+/* Attribute id: indexes follow the order of the elements in the XML */
+#define IIO_BIN_ID(dev, ch, attr, fmt)	(((uint32_t)(dev) << 24) | \
+					 ((uint32_t)(ch) << 16) | \
+					 ((uint32_t)(attr) << 8) | (fmt))
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+struct iio_attr_cache;
+
+/**
+ * @enum iio_bin_op
+ * @brief Operations of the binary batch attribute protocol.
+ */
+enum iio_bin_op {
+	/** Read the attributes */
+	IIO_BIN_READ = 0x11,
+	/** Write the attributes */
+	IIO_BIN_WRITE = 0x32,
+};
+
+/**
+ * @enum iio_bin_fmt
+ * @brief Conversion between the text value of an attribute and the binary
+ * value of the protocol.
+ */
+enum iio_bin_fmt {
+	/** Integer */
+	IIO_BIN_INT = 0,
+	/** Decimal number, scaled by 1000000 */
+	IIO_BIN_MICRO = 1,
+};
+
 /**
  * @struct iio_interface
  * @brief Links a physical device instance "void *dev_instance"
@@ -79,6 +133,10 @@ struct iio_interface {
 	/** Write data to RAM. It should be called before "transfer_mem_to_dev" */
 	ssize_t (*write_data)(void *dev_instance, char *pbuf, size_t offset,
 			      size_t bytes_count, uint32_t ch_mask);
+	/** Pre-rendered attribute values, managed by iio.c */
+	struct iio_attr_cache *attr_cache;
+	/** Instance that opened the device, managed by iio.c */
+	struct tinyiiod *owner;
 };
 
 /******************************************************************************/
@@ -90,9 +148,36 @@ struct iio_interface {
 ssize_t iio_init(struct tinyiiod **iiod, struct iio_server_ops *comm_ops);
 /* Free the resources allocated by iio_init(). */
 ssize_t iio_remove(struct tinyiiod *iiod);
+/* Create another tinyiiod instance bound to the ops set by iio_init(). */
+ssize_t iio_instance_create(struct tinyiiod **iiod);
+/* Free the resources allocated by iio_instance_create(). */
+ssize_t iio_instance_remove(struct tinyiiod *iiod);
+/* Read and execute one text command or binary attribute frame. */
+int32_t iio_read_command(struct tinyiiod *iiod);
+/* Start a buffer read sent in chunks by the server itself. */
+ssize_t iio_buffer_read_start(struct tinyiiod *iiod, const char *device,
+			      size_t bytes_count, uint32_t *mask);
+/* Read the next chunk of a buffer started by iio_buffer_read_start(). */
+ssize_t iio_buffer_read(struct tinyiiod *iiod, const char *device, char *buf,
+			size_t offset, size_t bytes_count);
+/* Write the next chunk of a buffer received in chunks by the server. */
+ssize_t iio_buffer_write(struct tinyiiod *iiod, const char *device,
+			 const char *buf, size_t offset, size_t bytes_count);
+/* Send a buffer written with iio_buffer_write() to the device. */
+ssize_t iio_buffer_write_done(struct tinyiiod *iiod, const char *device,
+			      size_t bytes_count);
+/* Set the millisecond clock used to expire IIO_ATTR_CACHE_TTL values. */
+void iio_attr_cache_set_clock(uint32_t (*get_ms)(void));
+/* Drop the cached attribute values of a device written outside iio. */
+ssize_t iio_attr_cache_invalidate(const char *device);
 /* Register interface. */
 ssize_t iio_register(struct iio_interface *iio_interface);
 /* Unregister interface. */
 ssize_t iio_unregister(struct iio_interface *iio_interface);
+/* Generate the xml of a device from its channel and attribute lists. */
+ssize_t iio_device_get_scan_xml(char **xml, struct iio_device *iio_dev,
+				const char *scan_format);
+/* Same, for a device without buffer. Usable as iio_interface.get_xml. */
+ssize_t iio_device_get_xml(char **xml, struct iio_device *iio_dev);
 
 #endif /* IIO_H_ */
@@ -2167,6 +2167,7 @@ static struct iio_attribute iio_attr_rf_port_select = {
 	.name = "rf_port_select",
 	.show = get_rf_port_select,
 	.store = set_rf_port_select,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_hardwaregain = {
@@ -2185,72 +2186,84 @@ static struct iio_attribute iio_attr_hardwaregain_available = {
 	.name = "hardwaregain_available",
 	.show = get_hardwaregain_available,
 	.store = set_hardwaregain_available,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_sampling_frequency_available = {
 	.name = "sampling_frequency_available",
 	.show = get_sampling_frequency_available,
 	.store = set_sampling_frequency_available,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_rf_port_select_available = {
 	.name = "rf_port_select_available",
 	.show = get_rf_port_select_available,
 	.store = set_rf_port_select_available,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_filter_fir_en = {
 	.name = "filter_fir_en",
 	.show = get_filter_fir_en,
 	.store = set_filter_fir_en,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_sampling_frequency = {
 	.name = "sampling_frequency",
 	.show = get_sampling_frequency,
 	.store = set_sampling_frequency,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_rf_bandwidth_available = {
 	.name = "rf_bandwidth_available",
 	.show = get_rf_bandwidth_available,
 	.store = set_rf_bandwidth_available,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_rf_bandwidth = {
 	.name = "rf_bandwidth",
 	.show = get_rf_bandwidth,
 	.store = set_rf_bandwidth,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_gain_control_mode = {
 	.name = "gain_control_mode",
 	.show = get_gain_control_mode,
 	.store = set_gain_control_mode,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_rf_dc_offset_tracking_en = {
 	.name = "rf_dc_offset_tracking_en",
 	.show = get_rf_dc_offset_tracking_en,
 	.store = set_rf_dc_offset_tracking_en,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_quadrature_tracking_en = {
 	.name = "quadrature_tracking_en",
 	.show = get_quadrature_tracking_en,
 	.store = set_quadrature_tracking_en,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_gain_control_mode_available = {
 	.name = "gain_control_mode_available",
 	.show = get_gain_control_mode_available,
 	.store = set_gain_control_mode_available,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_bb_dc_offset_tracking_en = {
 	.name = "bb_dc_offset_tracking_en",
 	.show = get_bb_dc_offset_tracking_en,
 	.store = set_bb_dc_offset_tracking_en,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 struct iio_attribute *voltage_output_attributes[] = {
@@ -2290,6 +2303,7 @@ static struct iio_attribute iio_attr_frequency_available = {
 	.name = "frequency_available",
 	.show = get_frequency_available,
 	.store = set_frequency_available,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_fastlock_save = {
@@ -2302,6 +2316,7 @@ static struct iio_attribute iio_attr_powerdown = {
 	.name = "powerdown",
 	.show = get_powerdown,
 	.store = set_powerdown,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_fastlock_load = {
@@ -2320,12 +2335,14 @@ static struct iio_attribute iio_attr_frequency = {
 	.name = "frequency",
 	.show = get_frequency,
 	.store = set_frequency,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_external = {
 	.name = "external",
 	.show = get_external,
 	.store = set_external,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_fastlock_recall = {
@@ -2350,6 +2367,7 @@ static struct iio_attribute iio_attr_voltage_filter_fir_en = {
 	.name = "voltage_filter_fir_en",
 	.show = get_voltage_filter_fir_en,
 	.store = set_voltage_filter_fir_en,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 struct iio_attribute *out_attributes[] = {
@@ -2361,6 +2379,8 @@ static struct iio_attribute iio_attr_temp0_input = {
 	.name = "input",
 	.show = get_temp0_input,
 	.store = NULL,
+	.cache = IIO_ATTR_CACHE_TTL,
+	.ttl_ms = 1000,
 };
 
 struct iio_attribute *temp0_attributes[] = {
@@ -2372,30 +2392,35 @@ static struct iio_attribute iio_attr_dcxo_tune_coarse = {
 	.name = "dcxo_tune_coarse",
 	.show = get_dcxo_tune_coarse,
 	.store = set_dcxo_tune_coarse,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_rx_path_rates = {
 	.name = "rx_path_rates",
 	.show = get_rx_path_rates,
 	.store = NULL,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_trx_rate_governor = {
 	.name = "trx_rate_governor",
 	.show = get_trx_rate_governor,
 	.store = set_trx_rate_governor,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_calib_mode_available = {
 	.name = "calib_mode_available",
 	.show = get_calib_mode_available,
 	.store = NULL,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_xo_correction_available = {
 	.name = "xo_correction_available",
 	.show = get_xo_correction_available,
 	.store = NULL,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_gain_table_config = {
@@ -2408,18 +2433,21 @@ static struct iio_attribute iio_attr_dcxo_tune_fine = {
 	.name = "dcxo_tune_fine",
 	.show = get_dcxo_tune_fine,
 	.store = set_dcxo_tune_fine,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_dcxo_tune_fine_available = {
 	.name = "dcxo_tune_fine_available",
 	.show = get_dcxo_tune_fine_available,
 	.store = NULL,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_ensm_mode_available = {
 	.name = "ensm_mode_available",
 	.show = get_ensm_mode_available,
 	.store = NULL,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_multichip_sync = {
@@ -2438,42 +2466,50 @@ static struct iio_attribute iio_attr_dcxo_tune_coarse_available = {
 	.name = "dcxo_tune_coarse_available",
 	.show = get_dcxo_tune_coarse_available,
 	.store = NULL,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_tx_path_rates = {
 	.name = "tx_path_rates",
 	.show = get_tx_path_rates,
 	.store = NULL,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_trx_rate_governor_available = {
 	.name = "trx_rate_governor_available",
 	.show = get_trx_rate_governor_available,
 	.store = NULL,
+	.cache = IIO_ATTR_STATIC,
 };
 
 static struct iio_attribute iio_attr_xo_correction = {
 	.name = "xo_correction",
 	.show = get_xo_correction,
 	.store = NULL,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_ensm_mode = {
 	.name = "ensm_mode",
 	.show = get_ensm_mode,
 	.store = set_ensm_mode,
+	.cache = IIO_ATTR_CACHE_TTL,
+	.ttl_ms = 1000,
 };
 
 static struct iio_attribute iio_attr_filter_fir_config = {
 	.name = "filter_fir_config",
 	.show = get_filter_fir_config,
 	.store = set_filter_fir_config,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute iio_attr_calib_mode = {
 	.name = "calib_mode",
 	.show = get_calib_mode,
 	.store = set_calib_mode,
+	.cache = IIO_ATTR_CACHE_UNTIL_WRITE,
 };
 
 static struct iio_attribute *global_attributes[] = {
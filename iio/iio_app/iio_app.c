@@ -106,7 +106,7 @@ int32_t iio_app(struct iio_app_desc *desc)
 	int32_t status;
 
 	while(1) {
-		status = tinyiiod_read_command(desc->iiod);
+		status = iio_read_command(desc->iiod);
 		if(status < 0)
 			return status;
 	}
@@ -43,11 +43,21 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <errno.h>
 #include "error.h"
+#include "delay.h"
 #include "iio.h"
 #include "iio_axi_dac.h"
 #include "xml.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Time to wait for the DMA to release a slot */
+#define IIO_AXI_DAC_SLOT_TIMEOUT_US	1000000
+#define IIO_AXI_DAC_SLOT_POLL_US	10
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -65,6 +75,20 @@ struct iio_axi_dac {
 	uint32_t dac_ddr_base;
 	/** Function pointer to flush the data cache for the given address range */
 	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/** Number of buffers at dac_ddr_base, 1 to play the buffer being written */
+	uint8_t num_slots;
+	/** Distance between two slots, in bytes */
+	uint32_t slot_size;
+	/** Play every buffer once, in order, instead of repeating the last one */
+	bool streaming;
+	/** Slot written by the next buffer */
+	uint8_t slot;
+	/** The slot is queued or played by the DMA */
+	bool slot_busy[IIO_AXI_DAC_MAX_SLOTS];
+	/** DMA transfer id of the slot, valid if slot_busy */
+	uint32_t slot_id[IIO_AXI_DAC_MAX_SLOTS];
+	/** The DMA was started */
+	bool running;
 };
 
 /******************************************************************************/
@@ -531,6 +555,100 @@ static struct iio_attribute *iio_altvoltage_attributes[] = {
 	NULL,
 };
 
+/**
+ * @brief Wait until the DMA is done with a slot: the transfer was played, or
+ * in cyclic mode, the next waveform took over at the end of a period.
+ * @param iio_dac - Physical instance of a iio_axi_dac device.
+ * @param slot - Slot index.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static ssize_t iio_axi_dac_slot_wait(struct iio_axi_dac *iio_dac, uint8_t slot)
+{
+	uint32_t timeout = IIO_AXI_DAC_SLOT_TIMEOUT_US;
+	bool done = false;
+	ssize_t ret;
+
+	while (iio_dac->slot_busy[slot]) {
+		ret = axi_dmac_transfer_done(iio_dac->dmac, iio_dac->slot_id[slot],
+					     &done);
+		if (ret < 0)
+			return ret;
+		if (done) {
+			iio_dac->slot_busy[slot] = false;
+			break;
+		}
+		if (timeout < IIO_AXI_DAC_SLOT_POLL_US)
+			return -ETIMEDOUT;
+		udelay(IIO_AXI_DAC_SLOT_POLL_US);
+		timeout -= IIO_AXI_DAC_SLOT_POLL_US;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Play the opened channels from the DMA, the others from the DDS.
+ * @param iio_dac - Physical instance of a iio_axi_dac device.
+ * @param ch_mask - Opened channels mask.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static ssize_t iio_axi_dac_set_datasel(struct iio_axi_dac *iio_dac,
+				       uint32_t ch_mask)
+{
+	ssize_t ret;
+	uint8_t i;
+
+	for (i = 0; i < iio_dac->dac->num_channels; i++) {
+		ret = axi_dac_set_datasel(iio_dac->dac, i,
+					  (BIT(i) & ch_mask) ? AXI_DAC_DATA_SEL_DMA : AXI_DAC_DATA_SEL_DDS);
+		if(ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Queue the slot that was just written. In cyclic mode the DMA
+ * finishes the period of the waveform being played and then repeats the new
+ * one, so the output switches without a glitch. In streaming mode the slots
+ * are played once, back to back.
+ * @param iio_dac - Physical instance of a iio_axi_dac device.
+ * @param bytes_count - Number of bytes to transfer.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static ssize_t iio_axi_dac_slot_queue(struct iio_axi_dac *iio_dac,
+				      size_t bytes_count)
+{
+	uint8_t slot = iio_dac->slot;
+	uint32_t address = iio_dac->dac_ddr_base + slot * iio_dac->slot_size;
+	ssize_t ret;
+
+	if (iio_dac->dcache_flush_range)
+		iio_dac->dcache_flush_range(address, bytes_count);
+
+	if (!iio_dac->running) {
+		/* Drop whatever an earlier user left running */
+		axi_dmac_write(iio_dac->dmac, AXI_DMAC_REG_CTRL, 0x0);
+		memset(iio_dac->slot_busy, 0, sizeof(iio_dac->slot_busy));
+		iio_dac->dmac->flags = iio_dac->streaming ? 0 : DMA_CYCLIC;
+	} else {
+		iio_dac->dmac->flags = iio_dac->streaming ? 0 :
+				       DMA_CYCLIC | DMA_LAST;
+	}
+
+	ret = axi_dmac_transfer_start(iio_dac->dmac, address, bytes_count,
+				      &iio_dac->slot_id[slot]);
+	if (ret < 0)
+		return ret;
+
+	iio_dac->running = true;
+	iio_dac->slot_busy[slot] = true;
+	iio_dac->slot = (slot + 1) % iio_dac->num_slots;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Transfer data from RAM to device.
  * @param iio_inst - Physical instance of a iio_axi_dac device.
@@ -545,6 +663,19 @@ static ssize_t iio_axi_dac_transfer_mem_to_dev(void *iio_inst,
 	struct iio_axi_dac *iio_dac = iio_inst;
 	ssize_t ret;
 
+	/* Once per buffer, not per chunk, so the playing slot is not touched */
+	ret = iio_axi_dac_set_datasel(iio_dac, ch_mask);
+	if (ret < 0)
+		return ret;
+
+	if (iio_dac->num_slots > 1) {
+		ret = iio_axi_dac_slot_queue(iio_dac, bytes_count);
+		if (ret < 0)
+			return ret;
+
+		return bytes_count;
+	}
+
 	if(iio_dac->dcache_flush_range)
 		iio_dac->dcache_flush_range(iio_dac->dac_ddr_base, bytes_count);
 
@@ -561,7 +692,8 @@ static ssize_t iio_axi_dac_transfer_mem_to_dev(void *iio_inst,
  * @brief Write chunk of data into RAM.
  * This function is probably called multiple times by libtinyiiod before a
  * "iio_transfer_mem_to_dev" call, since we can only write "bytes_count" bytes
- * at a time.
+ * at a time. With several slots, the data goes to the next idle slot, never
+ * to the one being played.
  * @param iio_inst - Physical instance of a iio_axi_dac device.
  * @param buf - Values to write.
  * @param offset - Offset in memory after the nth chunk of data.
@@ -573,18 +705,23 @@ static ssize_t iio_axi_dac_write_dev(void *iio_inst, char *buf,
 				     size_t offset,  size_t bytes_count, uint32_t ch_mask)
 {
 	struct iio_axi_dac *iio_dac = iio_inst;
-	ssize_t ret, i;
+	uint32_t address = iio_dac->dac_ddr_base;
+	ssize_t ret;
 
-	for (i = 0; i < iio_dac->dac->num_channels; i++) {
-		ret = axi_dac_set_datasel(iio_dac->dac, i,
-					  (BIT(i) & ch_mask) ? AXI_DAC_DATA_SEL_DMA : AXI_DAC_DATA_SEL_DDS);
-		if(ret < 0)
+	if (iio_dac->num_slots > 1) {
+		if (offset + bytes_count > iio_dac->slot_size)
+			return -EINVAL;
+
+		ret = iio_axi_dac_slot_wait(iio_dac, iio_dac->slot);
+		if (ret < 0)
 			return ret;
+
+		address += iio_dac->slot * iio_dac->slot_size;
 	}
 
-	ret = axi_dac_set_buff(iio_dac->dac, iio_dac->dac_ddr_base + offset,
+	ret = axi_dac_set_buff(iio_dac->dac, address + offset,
 			       (uint16_t *)buf,
-			       bytes_count);
+			       bytes_count / sizeof(uint16_t));
 	if(ret < 0)
 		return ret;
 
@@ -870,6 +1007,11 @@ int32_t iio_axi_dac_init(struct iio_axi_dac_desc **desc,
 	if (!param->tx_dac || !param->tx_dmac)
 		return FAILURE;
 
+	if (param->num_slots > IIO_AXI_DAC_MAX_SLOTS ||
+	    (param->num_slots > 1 && !param->slot_size) ||
+	    (param->streaming && param->num_slots < 2))
+		return FAILURE;
+
 	iio_axi_dac_inst = (struct iio_axi_dac *)calloc(1, sizeof(struct iio_axi_dac));
 	if (!iio_axi_dac_inst)
 		return FAILURE;
@@ -878,6 +1020,9 @@ int32_t iio_axi_dac_init(struct iio_axi_dac_desc **desc,
 	iio_axi_dac_inst->dmac = param->tx_dmac;
 	iio_axi_dac_inst->dac_ddr_base = param->dac_ddr_base;
 	iio_axi_dac_inst->dcache_flush_range = param->dcache_flush_range;
+	iio_axi_dac_inst->num_slots = param->num_slots ? param->num_slots : 1;
+	iio_axi_dac_inst->slot_size = param->slot_size;
+	iio_axi_dac_inst->streaming = param->streaming;
 
 	iio_axi_dac_device = iio_axi_dac_create_device(iio_axi_dac_inst->dac->name,
 			     iio_axi_dac_inst->dac->num_channels);
@@ -44,9 +44,17 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdbool.h>
 #include "axi_dac_core.h"
 #include "axi_dmac.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Each queued slot holds a DMA transfer id */
+#define IIO_AXI_DAC_MAX_SLOTS	AXI_DMAC_MAX_TRANSFERS
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -73,6 +81,17 @@ struct iio_axi_dac_init_param {
 	uint32_t dac_ddr_base;
 	/** Function pointer to flush the data cache for the given address range */
 	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/**
+	 * Number of buffers at dac_ddr_base, at most IIO_AXI_DAC_MAX_SLOTS. With
+	 * 0 or 1 the buffer is written while it is played. With more, each new
+	 * buffer is written in an idle slot and the output switches to it at the
+	 * end of the current period.
+	 */
+	uint8_t num_slots;
+	/** Distance between two slots, in bytes: the maximum buffer size */
+	uint32_t slot_size;
+	/** Play each buffer once, back to back (needs at least 2 slots) */
+	bool streaming;
 };
 
 /******************************************************************************/
@@ -0,0 +1,339 @@
+/***************************************************************************//**
+ *   @file   iio_jesd204_rx_mon.c
+ *   @brief  Implementation of the iio JESD204 RX link monitor.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include "error.h"
+#include "iio.h"
+#include "iio_jesd204_rx_mon.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the status of the link, from the most recent snapshot.
+ * @param device - Physical instance of a jesd204_rx_mon device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_link_status(void *device, char *buf, size_t len,
+			       const struct iio_ch_info *channel)
+{
+	struct jesd204_rx_mon_snapshot snap;
+	ssize_t ret;
+
+	ret = jesd204_rx_mon_get_snapshot(device, 0, &snap);
+	if (ret < 0)
+		return -ENOENT;
+
+	return snprintf(buf, len, "%s", snap.link_disabled ? "disabled" :
+			(snap.link_status == 3) ? "up" : "down");
+}
+
+/**
+ * @brief Get the error counters of the lanes, from the most recent snapshot.
+ * @param device - Physical instance of a jesd204_rx_mon device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_lane_errors(void *device, char *buf, size_t len,
+			       const struct iio_ch_info *channel)
+{
+	struct jesd204_rx_mon *mon = device;
+	struct jesd204_rx_mon_snapshot snap;
+	size_t i, j = 0;
+	ssize_t ret;
+
+	ret = jesd204_rx_mon_get_snapshot(mon, 0, &snap);
+	if (ret < 0)
+		return -ENOENT;
+
+	buf[0] = '\0';
+	for (i = 0; (i < mon->num_lanes) && (j < len); i++)
+		j += snprintf(buf + j, len - j, "%s%"PRIu32"", i ? " " : "",
+			      snap.lane_errors[i]);
+
+	return min(j, len - 1);
+}
+
+/**
+ * @brief Get the number of link restarts done by the monitor.
+ * @param device - Physical instance of a jesd204_rx_mon device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_restarts(void *device, char *buf, size_t len,
+			    const struct iio_ch_info *channel)
+{
+	struct jesd204_rx_mon *mon = device;
+
+	return snprintf(buf, len, "%"PRIu32"", mon->restarts);
+}
+
+/**
+ * @brief Get the number of link drops seen by the monitor.
+ * @param device - Physical instance of a jesd204_rx_mon device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_link_drops(void *device, char *buf, size_t len,
+			      const struct iio_ch_info *channel)
+{
+	struct jesd204_rx_mon *mon = device;
+
+	return snprintf(buf, len, "%"PRIu32"", mon->link_drops);
+}
+
+/**
+ * @brief Get the lane error threshold that triggers a link restart.
+ * @param device - Physical instance of a jesd204_rx_mon device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_error_threshold(void *device, char *buf, size_t len,
+				   const struct iio_ch_info *channel)
+{
+	struct jesd204_rx_mon *mon = device;
+
+	return snprintf(buf, len, "%"PRIu32"", mon->error_threshold);
+}
+
+/**
+ * @brief Set the lane error threshold that triggers a link restart.
+ * @param device - Physical instance of a jesd204_rx_mon device.
+ * @param buf - Value to be written to attribute.
+ * @param len - Length of the data in "buf".
+ * @param channel - Channel properties.
+ * @return Number of bytes written to device, or negative value on failure.
+ */
+static ssize_t set_error_threshold(void *device, char *buf, size_t len,
+				   const struct iio_ch_info *channel)
+{
+	struct jesd204_rx_mon *mon = device;
+
+	mon->error_threshold = srt_to_uint32(buf);
+
+	return len;
+}
+
+/**
+ * @brief Dump the snapshot ring, most recent first, one snapshot per line:
+ * "seq flags link_status ilas_mismatch errors_lane0 ... errors_laneN".
+ * @param device - Physical instance of a jesd204_rx_mon device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_snapshots(void *device, char *buf, size_t len,
+			     const struct iio_ch_info *channel)
+{
+	struct jesd204_rx_mon *mon = device;
+	struct jesd204_rx_mon_snapshot snap;
+	char line[16 * (JESD204_RX_MON_MAX_LANES + 4)];
+	size_t j = 0, n;
+	uint32_t i, k;
+
+	buf[0] = '\0';
+	for (i = 0; jesd204_rx_mon_get_snapshot(mon, i, &snap) == SUCCESS; i++) {
+		n = snprintf(line, sizeof(line), "%"PRIu32" 0x%"PRIx32" %"PRIu32
+			     " 0x%"PRIx32"", snap.seq, snap.flags,
+			     snap.link_status, snap.ilas_mismatch);
+		for (k = 0; k < mon->num_lanes; k++)
+			n += snprintf(line + n, sizeof(line) - n, " %"PRIu32"",
+				      snap.lane_errors[k]);
+		n += snprintf(line + n, sizeof(line) - n, "\n");
+
+		/* Only whole lines */
+		if (j + n >= len)
+			break;
+		memcpy(buf + j, line, n + 1);
+		j += n;
+	}
+
+	return j;
+}
+
+static struct iio_attribute iio_attr_link_status = {
+	.name = "link_status",
+	.show = get_link_status,
+	.store = NULL,
+};
+
+static struct iio_attribute iio_attr_lane_errors = {
+	.name = "lane_errors",
+	.show = get_lane_errors,
+	.store = NULL,
+};
+
+static struct iio_attribute iio_attr_restarts = {
+	.name = "restarts",
+	.show = get_restarts,
+	.store = NULL,
+};
+
+static struct iio_attribute iio_attr_link_drops = {
+	.name = "link_drops",
+	.show = get_link_drops,
+	.store = NULL,
+};
+
+static struct iio_attribute iio_attr_error_threshold = {
+	.name = "error_threshold",
+	.show = get_error_threshold,
+	.store = set_error_threshold,
+};
+
+static struct iio_attribute iio_attr_snapshots = {
+	.name = "snapshots",
+	.show = get_snapshots,
+	.store = NULL,
+};
+
+/**
+ * List containing the device attributes.
+ */
+static struct iio_attribute *iio_jesd204_rx_mon_attributes[] = {
+	&iio_attr_link_status,
+	&iio_attr_lane_errors,
+	&iio_attr_restarts,
+	&iio_attr_link_drops,
+	&iio_attr_error_threshold,
+	&iio_attr_snapshots,
+	NULL,
+};
+
+/**
+ * @brief Registers the link monitor as an iio device.
+ * @param desc - Descriptor.
+ * @param init - Configuration structure.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_jesd204_rx_mon_init(struct iio_jesd204_rx_mon_desc **desc,
+				struct iio_jesd204_rx_mon_init_param *init)
+{
+	struct iio_interface *iio_interface;
+	struct iio_device *iio_device;
+	int32_t status;
+
+	if (!init || !init->mon || !init->name)
+		return FAILURE;
+
+	iio_device = (struct iio_device *)calloc(1, sizeof(*iio_device));
+	if (!iio_device)
+		return FAILURE;
+
+	iio_device->name = init->name;
+	iio_device->num_ch = 0;
+	iio_device->channels = NULL;
+	iio_device->attributes = iio_jesd204_rx_mon_attributes;
+
+	iio_interface = (struct iio_interface *)calloc(1, sizeof(*iio_interface));
+	if (!iio_interface)
+		goto error_free_device;
+
+	*iio_interface = (struct iio_interface) {
+		.name = init->name,
+		.dev_instance = init->mon,
+		.iio = iio_device,
+		.get_xml = iio_device_get_xml,
+		.transfer_dev_to_mem = NULL,
+		.transfer_mem_to_dev = NULL,
+		.read_data = NULL,
+		.write_data = NULL,
+	};
+
+	status = iio_register(iio_interface);
+	if (status < 0)
+		goto error_free_interface;
+
+	*desc = calloc(1, sizeof(struct iio_jesd204_rx_mon_desc));
+	if (!(*desc))
+		goto error_iio_unregister;
+
+	(*desc)->iio_interface = iio_interface;
+
+	return SUCCESS;
+
+error_iio_unregister:
+	iio_unregister(iio_interface);
+error_free_interface:
+	free(iio_interface);
+error_free_device:
+	free(iio_device);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_jesd204_rx_mon_remove(struct iio_jesd204_rx_mon_desc *desc)
+{
+	int32_t status;
+
+	if (!desc)
+		return FAILURE;
+
+	status = iio_unregister(desc->iio_interface);
+	if (status < 0)
+		return FAILURE;
+
+	free(desc->iio_interface->iio);
+	free(desc->iio_interface);
+	free(desc);
+
+	return SUCCESS;
+}
@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ *   @file   iio_jesd204_rx_mon.h
+ *   @brief  Header file of the iio JESD204 RX link monitor.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_JESD204_RX_MON_H_
+#define IIO_JESD204_RX_MON_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "axi_jesd204_rx_mon.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_jesd204_rx_mon_desc
+ * @brief iio descriptor.
+ */
+struct iio_jesd204_rx_mon_desc {
+	/** Structure containing physical device instance and device descriptor */
+	struct iio_interface *iio_interface;
+};
+
+/**
+ * @struct iio_jesd204_rx_mon_init_param
+ * @brief iio configuration.
+ */
+struct iio_jesd204_rx_mon_init_param {
+	/** iio device name */
+	const char *name;
+	/** Link monitor */
+	struct jesd204_rx_mon *mon;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Init iio. */
+int32_t iio_jesd204_rx_mon_init(struct iio_jesd204_rx_mon_desc **desc,
+				struct iio_jesd204_rx_mon_init_param *param);
+/* Free the resources allocated by iio_jesd204_rx_mon_init(). */
+int32_t iio_jesd204_rx_mon_remove(struct iio_jesd204_rx_mon_desc *desc);
+
+#endif // IIO_JESD204_RX_MON_H_
@@ -0,0 +1,238 @@
+/***************************************************************************//**
+ *   @file   iio_profile.c
+ *   @brief  Implementation of the iio profiling trace.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "iio.h"
+#include "iio_profile.h"
+#include "util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the trace ring, in the format of profile_dump_csv().
+ * @param device - Unused.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_trace(void *device, char *buf, size_t len,
+			 const struct iio_ch_info *channel)
+{
+	return profile_dump_csv(buf, len);
+}
+
+/**
+ * @brief Get the recording state.
+ * @param device - Unused.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_enable(void *device, char *buf, size_t len,
+			  const struct iio_ch_info *channel)
+{
+	return snprintf(buf, len, "%d", profile_is_enabled());
+}
+
+/**
+ * @brief Pause or resume recording.
+ * @param device - Unused.
+ * @param buf - Value to be written to attribute.
+ * @param len - Length of the data in "buf".
+ * @param channel - Channel properties.
+ * @return Number of bytes written to device, or negative value on failure.
+ */
+static ssize_t set_enable(void *device, char *buf, size_t len,
+			  const struct iio_ch_info *channel)
+{
+	profile_enable(srt_to_uint32(buf) != 0);
+
+	return len;
+}
+
+/**
+ * @brief Reading the reset attribute always returns 0.
+ * @param device - Unused.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_reset(void *device, char *buf, size_t len,
+			 const struct iio_ch_info *channel)
+{
+	return snprintf(buf, len, "0");
+}
+
+/**
+ * @brief Clear the trace ring, any written value is accepted.
+ * @param device - Unused.
+ * @param buf - Value to be written to attribute.
+ * @param len - Length of the data in "buf".
+ * @param channel - Channel properties.
+ * @return Number of bytes written to device, or negative value on failure.
+ */
+static ssize_t set_reset(void *device, char *buf, size_t len,
+			 const struct iio_ch_info *channel)
+{
+	profile_reset();
+
+	return len;
+}
+
+static struct iio_attribute iio_attr_trace = {
+	.name = "trace",
+	.show = get_trace,
+	.store = NULL,
+};
+
+static struct iio_attribute iio_attr_enable = {
+	.name = "enable",
+	.show = get_enable,
+	.store = set_enable,
+};
+
+static struct iio_attribute iio_attr_reset = {
+	.name = "reset",
+	.show = get_reset,
+	.store = set_reset,
+};
+
+/**
+ * List containing the device attributes.
+ */
+static struct iio_attribute *iio_profile_attributes[] = {
+	&iio_attr_trace,
+	&iio_attr_enable,
+	&iio_attr_reset,
+	NULL,
+};
+
+/**
+ * @brief Registers the profiling trace as an iio device.
+ * @param desc - Descriptor.
+ * @param init - Configuration structure.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_profile_init(struct iio_profile_desc **desc,
+			 struct iio_profile_init_param *init)
+{
+	struct iio_interface *iio_interface;
+	struct iio_device *iio_device;
+	int32_t status;
+
+	if (!init || !init->name)
+		return FAILURE;
+
+	iio_device = (struct iio_device *)calloc(1, sizeof(*iio_device));
+	if (!iio_device)
+		return FAILURE;
+
+	iio_device->name = init->name;
+	iio_device->num_ch = 0;
+	iio_device->channels = NULL;
+	iio_device->attributes = iio_profile_attributes;
+
+	iio_interface = (struct iio_interface *)calloc(1, sizeof(*iio_interface));
+	if (!iio_interface)
+		goto error_free_device;
+
+	*iio_interface = (struct iio_interface) {
+		.name = init->name,
+		.dev_instance = NULL,
+		.iio = iio_device,
+		.get_xml = iio_device_get_xml,
+		.transfer_dev_to_mem = NULL,
+		.transfer_mem_to_dev = NULL,
+		.read_data = NULL,
+		.write_data = NULL,
+	};
+
+	status = iio_register(iio_interface);
+	if (status < 0)
+		goto error_free_interface;
+
+	*desc = calloc(1, sizeof(struct iio_profile_desc));
+	if (!(*desc))
+		goto error_iio_unregister;
+
+	(*desc)->iio_interface = iio_interface;
+
+	return SUCCESS;
+
+error_iio_unregister:
+	iio_unregister(iio_interface);
+error_free_interface:
+	free(iio_interface);
+error_free_device:
+	free(iio_device);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_profile_remove(struct iio_profile_desc *desc)
+{
+	int32_t status;
+
+	if (!desc)
+		return FAILURE;
+
+	status = iio_unregister(desc->iio_interface);
+	if (status < 0)
+		return FAILURE;
+
+	free(desc->iio_interface->iio);
+	free(desc->iio_interface);
+	free(desc);
+
+	return SUCCESS;
+}
@@ -0,0 +1,431 @@
+/***************************************************************************//**
+ *   @file   iio_sample_source.c
+ *   @brief  Implementation of the iio sample source.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "iio.h"
+#include "iio_sample_source.h"
+#include "util.h"
+#include "wait.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define IIO_SAMPLE_SOURCE_TIMEOUT_US	1000000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct iio_sample_source {
+	/* First member, get_xml() only receives the iio_device */
+	struct iio_device iio_device;
+	struct iio_channel channels[SAMPLE_SOURCE_MAX_CHANNELS];
+	struct iio_channel *channel_list[SAMPLE_SOURCE_MAX_CHANNELS + 1];
+	char names[SAMPLE_SOURCE_MAX_CHANNELS][sizeof("voltage00")];
+	struct sample_source *src;
+	uint32_t timeout_us;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Print a value with 6 decimals.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param val - The value.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t print_micro(char *buf, size_t len, float val)
+{
+	int64_t micro = (int64_t)(val * 1000000.0f + (val < 0 ? -0.5f : 0.5f));
+
+	return snprintf(buf, len, "%s%"PRIi32".%.6"PRIi32"", micro < 0 ? "-" : "",
+			(int32_t)(llabs(micro) / 1000000),
+			(int32_t)(llabs(micro) % 1000000));
+}
+
+/**
+ * @brief Get one conversion of the channel. Not available while a buffer
+ * is captured.
+ * @param device - Physical instance of a iio_sample_source device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_raw(void *device, char *buf, size_t len,
+		       const struct iio_ch_info *channel)
+{
+	struct iio_sample_source *iio_src = (struct iio_sample_source *)device;
+	struct sample_source *src = iio_src->src;
+	uint16_t code;
+	int32_t ret;
+
+	if (src->running)
+		return FAILURE;
+
+	ret = src->read(src->dev, channel->ch_num, &code);
+	if (ret < 0)
+		return ret;
+
+	return snprintf(buf, len, "%"PRIu16"", code);
+}
+
+/**
+ * @brief Get the scale, in mV per LSB.
+ * @param device - Physical instance of a iio_sample_source device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_scale(void *device, char *buf, size_t len,
+			 const struct iio_ch_info *channel)
+{
+	struct iio_sample_source *iio_src = (struct iio_sample_source *)device;
+
+	return print_micro(buf, len, iio_src->src->scale * 1000);
+}
+
+/**
+ * @brief Get the code offset.
+ * @param device - Physical instance of a iio_sample_source device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_offset(void *device, char *buf, size_t len,
+			  const struct iio_ch_info *channel)
+{
+	struct iio_sample_source *iio_src = (struct iio_sample_source *)device;
+
+	return snprintf(buf, len, "%"PRIi32"", iio_src->src->offset);
+}
+
+/**
+ * @brief Get the frame rate set by the pacing timer.
+ * @param device - Physical instance of a iio_sample_source device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_sampling_frequency(void *device, char *buf, size_t len,
+				      const struct iio_ch_info *channel)
+{
+	struct iio_sample_source *iio_src = (struct iio_sample_source *)device;
+	uint32_t rate_hz;
+
+	if (sample_source_get_rate(iio_src->src, &rate_hz))
+		rate_hz = 0;
+
+	return snprintf(buf, len, "%"PRIu32"", rate_hz);
+}
+
+static struct iio_attribute iio_attr_raw = {
+	.name = "raw",
+	.show = get_raw,
+	.store = NULL,
+};
+
+static struct iio_attribute iio_attr_scale = {
+	.name = "scale",
+	.show = get_scale,
+	.store = NULL,
+	.cache = IIO_ATTR_STATIC,
+};
+
+static struct iio_attribute iio_attr_offset = {
+	.name = "offset",
+	.show = get_offset,
+	.store = NULL,
+	.cache = IIO_ATTR_STATIC,
+};
+
+static struct iio_attribute iio_attr_sampling_frequency = {
+	.name = "sampling_frequency",
+	.show = get_sampling_frequency,
+	.store = NULL,
+};
+
+/**
+ * List containing attributes, corresponding to "voltage" channels.
+ */
+static struct iio_attribute *iio_voltage_attributes[] = {
+	&iio_attr_raw,
+	&iio_attr_scale,
+	&iio_attr_offset,
+	&iio_attr_sampling_frequency,
+	NULL,
+};
+
+/**
+ * @brief Get xml corresponding to a sample source device.
+ * @param xml - Xml containing description of a device.
+ * @param iio_dev - Structure describing a device, channels and attributes.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+static ssize_t iio_sample_source_get_xml(char **xml, struct iio_device *iio_dev)
+{
+	struct sample_source *src;
+	char format[32];
+
+	if (!xml || !iio_dev)
+		return FAILURE;
+
+	src = ((struct iio_sample_source *)iio_dev)->src;
+	sprintf(format, "le:U%d/16&gt;&gt;0", src->bits ? src->bits : 16);
+
+	return iio_device_get_scan_xml(xml, iio_dev, format);
+}
+
+/**
+ * @brief Check if a frame can be read.
+ * @param ctx - The sample source.
+ * @param done - Set when a frame is available.
+ * @return SUCCESS.
+ */
+static int32_t iio_sample_source_ready(void *ctx, bool *done)
+{
+	*done = sample_source_available(ctx) != 0;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start the acquisition of the opened channels. A capture already
+ * running with the same channels continues, so consecutive buffers are
+ * contiguous.
+ * @param iio_inst - Physical instance of a iio_sample_source device.
+ * @param bytes_count - Number of bytes to transfer.
+ * @param ch_mask - Opened channels mask.
+ * @return bytes_count or negative value in case of error.
+ */
+static ssize_t iio_sample_source_transfer_dev_to_mem(void *iio_inst,
+		size_t bytes_count,
+		uint32_t ch_mask)
+{
+	struct iio_sample_source *iio_src;
+	int32_t ret;
+
+	if (!iio_inst)
+		return FAILURE;
+
+	iio_src = (struct iio_sample_source *)iio_inst;
+	if (!iio_src->src->running || iio_src->src->ch_mask != ch_mask) {
+		ret = sample_source_start(iio_src->src, ch_mask);
+		if (ret < 0)
+			return ret;
+	}
+
+	return bytes_count;
+}
+
+/**
+ * @brief Read chunk of data into pbuf, waiting for the frames that were not
+ * acquired yet. Without a pacing timer the frames are converted here.
+ * Call "iio_sample_source_transfer_dev_to_mem" first.
+ * @param iio_inst - Physical instance of a iio_sample_source device.
+ * @param pbuf - Buffer where value is stored.
+ * @param offset - Offset to the remaining data after reading n chunks.
+ * @param bytes_count - Number of bytes to read.
+ * @param ch_mask - Opened channels mask.
+ * @return Number of bytes of the whole frames read, a trailing partial frame
+ * is not filled, or negative value in case of error.
+ */
+static ssize_t iio_sample_source_read_dev(void *iio_inst, char *pbuf,
+		size_t offset, size_t bytes_count, uint32_t ch_mask)
+{
+	struct iio_sample_source *iio_src;
+	struct sample_source *src;
+	struct wait_param wait = {
+		.start_us = 10,
+		.max_step_us = 1000,
+	};
+	uint32_t frames, done = 0;
+	uint16_t *pbuf16;
+	int32_t ret;
+
+	if (!iio_inst || !pbuf)
+		return FAILURE;
+
+	iio_src = (struct iio_sample_source *)iio_inst;
+	src = iio_src->src;
+	if (!src->running || src->ch_mask != ch_mask)
+		return FAILURE;
+
+	wait.timeout_us = iio_src->timeout_us;
+	pbuf16 = (uint16_t *)pbuf;
+	frames = bytes_count / src->frame_size;
+	if (!frames)
+		return FAILURE;
+
+	while (done < frames) {
+		done += sample_source_read(src, &pbuf16[done * src->frame_size / 2],
+					   frames - done);
+		if (done == frames)
+			break;
+
+		if (!src->timer)
+			ret = sample_source_acquire(src);
+		else
+			ret = wait_for_condition(&wait, iio_sample_source_ready,
+						 src);
+		if (ret < 0)
+			return ret;
+	}
+
+	return frames * src->frame_size;
+}
+
+/**
+ * @brief Registers a sample source as an iio device with buffer support.
+ * @param desc - Descriptor.
+ * @param init - Configuration structure.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_sample_source_init(struct iio_sample_source_desc **desc,
+			       struct iio_sample_source_init_param *init)
+{
+	struct iio_sample_source *iio_src;
+	struct iio_interface *iio_interface;
+	int32_t status;
+	uint8_t i;
+
+	if (!desc || !init || !init->name || !init->src)
+		return FAILURE;
+
+	iio_src = (struct iio_sample_source *)calloc(1, sizeof(*iio_src));
+	if (!iio_src)
+		return FAILURE;
+
+	iio_src->src = init->src;
+	iio_src->timeout_us = init->timeout_us ? init->timeout_us :
+			      IIO_SAMPLE_SOURCE_TIMEOUT_US;
+
+	for (i = 0; i < init->src->num_channels; i++) {
+		sprintf(iio_src->names[i], "voltage%d", i);
+		iio_src->channels[i].name = iio_src->names[i];
+		iio_src->channels[i].attributes = iio_voltage_attributes;
+		iio_src->channels[i].ch_out = false;
+		iio_src->channel_list[i] = &iio_src->channels[i];
+	}
+	iio_src->channel_list[i] = NULL;
+
+	iio_src->iio_device.name = init->name;
+	iio_src->iio_device.num_ch = init->src->num_channels;
+	iio_src->iio_device.channels = iio_src->channel_list;
+	iio_src->iio_device.attributes = NULL; /* no device attribute */
+
+	iio_interface = (struct iio_interface *)calloc(1, sizeof(*iio_interface));
+	if (!iio_interface)
+		goto error_free_iio_src;
+
+	*iio_interface = (struct iio_interface) {
+		.name = init->name,
+		.dev_instance = iio_src,
+		.iio = &iio_src->iio_device,
+		.get_xml = iio_sample_source_get_xml,
+		.transfer_dev_to_mem = iio_sample_source_transfer_dev_to_mem,
+		.transfer_mem_to_dev = NULL,
+		.read_data = iio_sample_source_read_dev,
+		.write_data = NULL,
+	};
+
+	status = iio_register(iio_interface);
+	if (status < 0)
+		goto error_free_interface;
+
+	*desc = calloc(1, sizeof(struct iio_sample_source_desc));
+	if (!(*desc))
+		goto error_iio_unregister;
+
+	(*desc)->iio_interface = iio_interface;
+
+	return SUCCESS;
+
+error_iio_unregister:
+	iio_unregister(iio_interface);
+error_free_interface:
+	free(iio_interface);
+error_free_iio_src:
+	free(iio_src);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Release resources. The acquisition is stopped, the sample source
+ * itself is left to the caller.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_sample_source_remove(struct iio_sample_source_desc *desc)
+{
+	struct iio_sample_source *iio_src;
+	int32_t status;
+
+	if (!desc)
+		return FAILURE;
+
+	status = iio_unregister(desc->iio_interface);
+	if (status < 0)
+		return FAILURE;
+
+	iio_src = (struct iio_sample_source *)desc->iio_interface->dev_instance;
+	sample_source_stop(iio_src->src);
+
+	free(iio_src);
+	free(desc->iio_interface);
+	free(desc);
+
+	return SUCCESS;
+}
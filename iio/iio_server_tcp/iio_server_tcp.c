@@ -0,0 +1,825 @@
+/***************************************************************************//**
+ *   @file   iio_server_tcp.c
+ *   @brief  Multi-client iio server over TCP, for the Linux platform.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/*
+ * Every client gets its own tinyiiod instance. A command is handed to the
+ * parser only once it has been completely received, so a slow client never
+ * blocks the loop while it types, and the replies are queued and sent from the
+ * loop as the client drains them. Each turn of the loop runs one unit of work
+ * for every client whose previous replies are sent: a command, or one
+ * IIO_SERVER_TCP_CHUNK_SIZE chunk of a READBUF/WRITEBUF transfer. The server
+ * parses these two commands itself and keeps the transfer as per client state,
+ * so the commands of the other clients run between the chunks of a large
+ * buffer, and a client that stops reading only stalls itself.
+ *
+ * Only a command larger than the receive buffer, such as a long binary frame,
+ * still waits on its client socket to read the rest; a client stalling for
+ * IIO_SERVER_TCP_TIMEOUT_MS there is disconnected.
+ *
+ * The buffer of a device belongs to the client that opened it until it closes
+ * the device or disconnects, iio.c refuses other users with -EBUSY.
+ *
+ * The tinyiiod read/write ops carry no context, so there is one server per
+ * process.
+ */
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "error.h"
+#include "iio.h"
+#include "iio_server_tcp.h"
+#include "util.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct iio_server_tcp_desc *iio_server_tcp;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Register the socket of a client for the events it needs: EPOLLIN
+ * unless its receive buffer is full, EPOLLOUT while replies are queued.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @return None.
+ */
+static void iio_server_tcp_update(struct iio_server_tcp_desc *desc,
+				  struct iio_server_tcp_client *c)
+{
+	struct epoll_event ev = {
+		.data.ptr = c,
+	};
+
+	if (!c->rx_paused)
+		ev.events |= EPOLLIN;
+	if (c->tx_len)
+		ev.events |= EPOLLOUT;
+	if (ev.events == c->events)
+		return;
+
+	c->events = ev.events;
+	epoll_ctl(desc->epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+}
+
+/**
+ * @brief Enable or disable the receive events of a client.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @param enable - true to receive.
+ * @return None.
+ */
+static void iio_server_tcp_rx_enable(struct iio_server_tcp_desc *desc,
+				     struct iio_server_tcp_client *c,
+				     bool enable)
+{
+	c->rx_paused = !enable;
+	iio_server_tcp_update(desc, c);
+}
+
+/**
+ * @brief Drop the first bytes of the receive buffer of a client.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @param len - Number of bytes consumed.
+ * @return None.
+ */
+static void iio_server_tcp_consume(struct iio_server_tcp_desc *desc,
+				   struct iio_server_tcp_client *c,
+				   size_t len)
+{
+	memmove(c->rx, c->rx + len, c->rx_len - len);
+	c->rx_len -= len;
+
+	if (c->rx_paused)
+		iio_server_tcp_rx_enable(desc, c, true);
+}
+
+/**
+ * @brief Close a client connection.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @return None.
+ */
+static void iio_server_tcp_close(struct iio_server_tcp_desc *desc,
+				 struct iio_server_tcp_client *c)
+{
+	if (c->fd < 0)
+		return;
+
+	epoll_ctl(desc->epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+	close(c->fd);
+	iio_instance_remove(c->iiod);
+	free(c->tx);
+	c->fd = -1;
+	c->iiod = NULL;
+	c->busy = false;
+	c->rx_len = 0;
+	c->xfer.active = false;
+	c->tx = NULL;
+	c->tx_len = 0;
+	c->tx_done = 0;
+	c->tx_size = 0;
+}
+
+/**
+ * @brief Accept the pending connections.
+ * @param desc - Server descriptor.
+ * @return None.
+ */
+static void iio_server_tcp_accept(struct iio_server_tcp_desc *desc)
+{
+	struct iio_server_tcp_client *c;
+	struct epoll_event ev;
+	int fd, one = 1;
+	uint32_t i;
+
+	while (true) {
+		fd = accept(desc->listen_fd, NULL, NULL);
+		if (fd < 0)
+			return;
+
+		for (i = 0; i < desc->max_clients; i++)
+			if (desc->clients[i].fd < 0)
+				break;
+		if (i == desc->max_clients) {
+			close(fd);
+			continue;
+		}
+
+		c = &desc->clients[i];
+		memset(c, 0, sizeof(*c));
+		if (iio_instance_create(&c->iiod) != SUCCESS) {
+			close(fd);
+			c->fd = -1;
+			continue;
+		}
+
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		ev.events = EPOLLIN;
+		ev.data.ptr = c;
+		if (epoll_ctl(desc->epoll_fd, EPOLL_CTL_ADD, fd, &ev)) {
+			close(fd);
+			iio_instance_remove(c->iiod);
+			c->fd = -1;
+			continue;
+		}
+		c->fd = fd;
+		c->events = EPOLLIN;
+	}
+}
+
+/**
+ * @brief Get the number of value bytes following a text command line: the
+ * last field of a WRITE command, none for the other commands.
+ * @param line - Command line.
+ * @param eol - Newline ending the line.
+ * @return Number of bytes following the line.
+ */
+static size_t iio_server_tcp_payload(const char *line, const char *eol)
+{
+	const char *p = eol;
+
+	if (eol - line < 6 || strncmp(line, "WRITE ", 6))
+		return 0;
+
+	while (p > line && p[-1] != ' ')
+		p--;
+
+	return strtoul(p, NULL, 10);
+}
+
+/**
+ * @brief Check if a command can be started for a client: a complete text
+ * command, value included, or a complete binary frame. A full receive buffer
+ * that starts a command lets it run and read the rest from the socket.
+ * @param c - Client.
+ * @return true if a command is ready.
+ */
+static bool iio_server_tcp_has_command(struct iio_server_tcp_client *c)
+{
+	uint8_t *rx = (uint8_t *)c->rx;
+	size_t need;
+	char *eol;
+
+	if (!c->rx_len)
+		return false;
+
+	if (rx[0] == IIO_BIN_MAGIC) {
+		need = IIO_BIN_HDR_SIZE;
+		if (c->rx_len >= IIO_BIN_HDR_SIZE)
+			need += (size_t)(rx[2] | (rx[3] << 8)) *
+				IIO_BIN_ITEM_SIZE(rx[1]);
+	} else {
+		eol = memchr(c->rx, '\n', c->rx_len);
+		if (!eol)
+			return false;
+		need = eol - c->rx + 1 + iio_server_tcp_payload(c->rx, eol);
+	}
+
+	return c->rx_len >= need || c->rx_len == IIO_SERVER_TCP_RX_SIZE;
+}
+
+/**
+ * @brief Move the received data of a client into its buffer.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @return SUCCESS, or FAILURE if the peer closed the connection.
+ */
+static int32_t iio_server_tcp_receive(struct iio_server_tcp_desc *desc,
+				      struct iio_server_tcp_client *c)
+{
+	ssize_t n;
+
+	while (c->rx_len < IIO_SERVER_TCP_RX_SIZE) {
+		n = recv(c->fd, c->rx + c->rx_len,
+			 IIO_SERVER_TCP_RX_SIZE - c->rx_len, 0);
+		if (n > 0) {
+			c->rx_len += n;
+			continue;
+		}
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return SUCCESS;
+		if (n < 0 && errno == EINTR)
+			continue;
+
+		return FAILURE;
+	}
+
+	/* A full buffer without a command or buffer data will never be parsed */
+	if (!c->busy && !c->xfer.active && !iio_server_tcp_has_command(c))
+		return FAILURE;
+
+	iio_server_tcp_rx_enable(desc, c, false);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Send the queued replies of a client, as much as its socket takes.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @return SUCCESS, negative value if the client went away.
+ */
+static int32_t iio_server_tcp_flush(struct iio_server_tcp_desc *desc,
+				    struct iio_server_tcp_client *c)
+{
+	ssize_t n;
+
+	while (c->tx_done < c->tx_len) {
+		n = send(c->fd, c->tx + c->tx_done, c->tx_len - c->tx_done,
+			 MSG_NOSIGNAL);
+		if (n > 0) {
+			c->tx_done += n;
+			continue;
+		}
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+
+		return n < 0 ? -errno : -EPIPE;
+	}
+
+	if (c->tx_done == c->tx_len) {
+		c->tx_len = 0;
+		c->tx_done = 0;
+	}
+	iio_server_tcp_update(desc, c);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Queue a reply for a client and send what its socket takes.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @param buf - Reply.
+ * @param len - Reply size.
+ * @return SUCCESS, negative value in case of failure.
+ */
+static int32_t iio_server_tcp_queue(struct iio_server_tcp_desc *desc,
+				    struct iio_server_tcp_client *c,
+				    const char *buf, size_t len)
+{
+	uint32_t size;
+	char *tx;
+
+	if (c->tx_len + len > c->tx_size) {
+		size = c->tx_size ? c->tx_size : IIO_SERVER_TCP_CHUNK_SIZE;
+		while (size < c->tx_len + len)
+			size *= 2;
+		tx = realloc(c->tx, size);
+		if (!tx)
+			return -ENOMEM;
+		c->tx = tx;
+		c->tx_size = size;
+	}
+
+	memcpy(c->tx + c->tx_len, buf, len);
+	c->tx_len += len;
+
+	return iio_server_tcp_flush(desc, c);
+}
+
+/**
+ * @brief Queue a "%d\n" status line for a client.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @param value - Value to send.
+ * @return SUCCESS, negative value in case of failure.
+ */
+static int32_t iio_server_tcp_queue_value(struct iio_server_tcp_desc *desc,
+		struct iio_server_tcp_client *c,
+		ssize_t value)
+{
+	char buf[24];
+	int len;
+
+	len = snprintf(buf, sizeof(buf), "%zd\n", value);
+
+	return iio_server_tcp_queue(desc, c, buf, len);
+}
+
+/**
+ * @brief Start a buffer transfer if the next command line of a client is
+ * "READBUF <device> <bytes>" or "WRITEBUF <device> <bytes>", replying like
+ * "libtinyiiod" does.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @return 1 if the command was taken, 0 for any other command, negative value
+ * if the client went away.
+ */
+static int32_t iio_server_tcp_xfer_start(struct iio_server_tcp_desc *desc,
+		struct iio_server_tcp_client *c)
+{
+	struct iio_server_tcp_xfer *x = &c->xfer;
+	char line[IIO_SERVER_TCP_DEV_SIZE + 32];
+	size_t len, bytes;
+	ssize_t ret;
+	char *eol;
+
+	eol = memchr(c->rx, '\n', c->rx_len);
+	if (!eol)
+		return 0;
+	len = eol - c->rx + 1;
+	if (len >= sizeof(line))
+		return 0;
+	memcpy(line, c->rx, len);
+	line[len] = '\0';
+
+	if (strncmp(line, "READBUF ", 8) && strncmp(line, "WRITEBUF ", 9))
+		return 0;
+
+	x->write = line[0] == 'W';
+	if (sscanf(line + (x->write ? 9 : 8), "%63s %zu", x->device,
+		   &bytes) != 2)
+		return 0;
+
+	iio_server_tcp_consume(desc, c, len);
+	x->offset = 0;
+	x->remaining = bytes;
+	x->total = bytes;
+	x->mask_sent = false;
+
+	if (x->write) {
+		x->active = true;
+		ret = iio_server_tcp_queue_value(desc, c, bytes);
+	} else {
+		ret = iio_buffer_read_start(c->iiod, x->device, bytes,
+					    &x->mask);
+		if (ret < 0)
+			ret = iio_server_tcp_queue_value(desc, c, ret);
+		else
+			x->active = bytes != 0;
+	}
+
+	return ret < 0 ? ret : 1;
+}
+
+/**
+ * @brief Move the next chunk of the buffer transfer of a client.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @return SUCCESS, negative value if the client went away.
+ */
+static int32_t iio_server_tcp_xfer_step(struct iio_server_tcp_desc *desc,
+					struct iio_server_tcp_client *c)
+{
+	struct iio_server_tcp_xfer *x = &c->xfer;
+	char mask[10];
+	ssize_t ret, n;
+	size_t len;
+
+	if (x->write) {
+		len = min_t(size_t, x->remaining, c->rx_len);
+		len = min_t(size_t, len, IIO_SERVER_TCP_CHUNK_SIZE);
+		if (len) {
+			n = iio_buffer_write(c->iiod, x->device, c->rx,
+					     x->offset, len);
+			iio_server_tcp_consume(desc, c, len);
+			if (n < 0) {
+				x->active = false;
+				return n;
+			}
+			x->offset += len;
+			x->remaining -= len;
+		}
+		if (x->remaining)
+			return SUCCESS;
+
+		x->active = false;
+		n = iio_buffer_write_done(c->iiod, x->device, x->total);
+
+		return iio_server_tcp_queue_value(desc, c,
+						  n < 0 ? n : (ssize_t)x->total);
+	}
+
+	len = min_t(size_t, x->remaining, IIO_SERVER_TCP_CHUNK_SIZE);
+	n = iio_buffer_read(c->iiod, x->device, desc->chunk, x->offset, len);
+	ret = iio_server_tcp_queue_value(desc, c, n);
+	/* An empty chunk would never complete the transfer */
+	if (ret < 0 || n <= 0) {
+		x->active = false;
+		return ret;
+	}
+	n = min_t(size_t, n, len);
+
+	if (!x->mask_sent) {
+		snprintf(mask, sizeof(mask), "%08"PRIx32"\n", x->mask);
+		ret = iio_server_tcp_queue(desc, c, mask, 9);
+		if (ret < 0)
+			return ret;
+		x->mask_sent = true;
+	}
+
+	x->offset += n;
+	x->remaining -= n;
+	if (!x->remaining)
+		x->active = false;
+
+	return iio_server_tcp_queue(desc, c, desc->chunk, n);
+}
+
+/**
+ * @brief Check if a client has work to run: its replies are sent, and a
+ * buffer transfer can move or a command is complete.
+ * @param c - Client.
+ * @return true if the client is ready.
+ */
+static bool iio_server_tcp_ready(struct iio_server_tcp_client *c)
+{
+	if (c->fd < 0 || c->tx_len)
+		return false;
+
+	if (c->xfer.active)
+		return !c->xfer.write || c->rx_len || !c->xfer.remaining;
+
+	return iio_server_tcp_has_command(c);
+}
+
+/**
+ * @brief Check if a client has work waiting to be run.
+ * @param desc - Server descriptor.
+ * @return true if a client is ready.
+ */
+static bool iio_server_tcp_pending(struct iio_server_tcp_desc *desc)
+{
+	uint32_t i;
+
+	for (i = 0; i < desc->max_clients; i++)
+		if (iio_server_tcp_ready(&desc->clients[i]))
+			return true;
+
+	return false;
+}
+
+/**
+ * @brief Run one unit of work of a client: the next chunk of its buffer
+ * transfer, or its next complete command.
+ * @param desc - Server descriptor.
+ * @param c - Client.
+ * @return None.
+ */
+static void iio_server_tcp_dispatch(struct iio_server_tcp_desc *desc,
+				    struct iio_server_tcp_client *c)
+{
+	int32_t ret;
+
+	if (!iio_server_tcp_ready(c))
+		return;
+
+	if (c->xfer.active) {
+		ret = iio_server_tcp_xfer_step(desc, c);
+	} else {
+		ret = iio_server_tcp_xfer_start(desc, c);
+		if (!ret) {
+			c->busy = true;
+			desc->current = c;
+			ret = iio_read_command(c->iiod);
+			desc->current = NULL;
+			c->busy = false;
+		}
+	}
+
+	if (ret < 0)
+		iio_server_tcp_close(desc, c);
+}
+
+/**
+ * @brief Handle the pending events: accept connections, exchange data and run
+ * one unit of work of every client that has one.
+ * @param desc - Server descriptor.
+ * @param timeout_ms - Maximum time to wait for an event, -1 for ever.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_server_tcp_step(struct iio_server_tcp_desc *desc,
+			    int32_t timeout_ms)
+{
+	struct epoll_event events[IIO_SERVER_TCP_MAX_CLIENTS + 1];
+	struct iio_server_tcp_client *c;
+	int n, i;
+
+	if (!desc || desc->current)
+		return FAILURE;
+
+	/* Work left over from the previous turn must not wait for events */
+	if (iio_server_tcp_pending(desc))
+		timeout_ms = 0;
+
+	n = epoll_wait(desc->epoll_fd, events, ARRAY_SIZE(events), timeout_ms);
+	if (n < 0)
+		return errno == EINTR ? SUCCESS : FAILURE;
+
+	for (i = 0; i < n; i++) {
+		if (!events[i].data.ptr) {
+			iio_server_tcp_accept(desc);
+			continue;
+		}
+
+		c = events[i].data.ptr;
+		if (c->fd >= 0 && (events[i].events & EPOLLOUT) &&
+		    iio_server_tcp_flush(desc, c) < 0)
+			iio_server_tcp_close(desc, c);
+		if (c->fd >= 0 && (events[i].events & ~EPOLLOUT) &&
+		    iio_server_tcp_receive(desc, c) != SUCCESS)
+			iio_server_tcp_close(desc, c);
+	}
+
+	for (i = 0; i < (int)desc->max_clients; i++)
+		iio_server_tcp_dispatch(desc, &desc->clients[i]);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait until the socket of the client running a command is readable.
+ * @param fd - Socket.
+ * @return SUCCESS, -ETIMEDOUT if the client stalled, negative value otherwise.
+ */
+static int32_t iio_server_tcp_wait(int fd)
+{
+	struct pollfd pfd = {
+		.fd = fd,
+		.events = POLLIN,
+	};
+	int ret;
+
+	do {
+		ret = poll(&pfd, 1, IIO_SERVER_TCP_TIMEOUT_MS);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 0)
+		return -errno;
+	if (!ret)
+		return -ETIMEDOUT;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Server read op: take bytes from the buffer of the current client,
+ * waiting on its socket when the buffer is empty.
+ * @param buf - Destination.
+ * @param len - Number of bytes to read.
+ * @return len, or negative value if the client went away.
+ */
+static ssize_t iio_server_tcp_read(char *buf, size_t len)
+{
+	struct iio_server_tcp_desc *desc = iio_server_tcp;
+	struct iio_server_tcp_client *c = desc->current;
+	size_t done = 0, n;
+	int32_t ret;
+
+	while (done < len) {
+		if (!c->rx_len) {
+			ret = iio_server_tcp_wait(c->fd);
+			if (ret < 0)
+				return ret;
+			if (iio_server_tcp_receive(desc, c) != SUCCESS)
+				return -EPIPE;
+			continue;
+		}
+
+		n = min_t(size_t, len - done, c->rx_len);
+		memcpy(buf + done, c->rx, n);
+		iio_server_tcp_consume(desc, c, n);
+		done += n;
+	}
+
+	return len;
+}
+
+/**
+ * @brief Server write op: queue a reply for the current client, sent from the
+ * loop when its socket is full.
+ * @param buf - Source.
+ * @param len - Number of bytes to write.
+ * @return len, or negative value if the client went away.
+ */
+static ssize_t iio_server_tcp_write(const char *buf, size_t len)
+{
+	struct iio_server_tcp_desc *desc = iio_server_tcp;
+	int32_t ret;
+
+	ret = iio_server_tcp_queue(desc, desc->current, buf, len);
+	if (ret < 0)
+		return ret;
+
+	return len;
+}
+
+/**
+ * @brief Create the listening socket and register the server ops. Replaces
+ * iio_app_init() on Linux targets.
+ * @param desc - Server descriptor.
+ * @param param - Server configuration.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_server_tcp_init(struct iio_server_tcp_desc **desc,
+			    struct iio_server_tcp_init_param *param)
+{
+	static struct iio_server_ops server_ops = {
+		.read = iio_server_tcp_read,
+		.write = iio_server_tcp_write,
+	};
+	struct iio_server_tcp_desc *d;
+	struct sockaddr_in addr;
+	struct epoll_event ev;
+	uint32_t i;
+	int one = 1;
+
+	if (!desc || !param || iio_server_tcp)
+		return FAILURE;
+
+	d = calloc(1, sizeof(*d));
+	if (!d)
+		return FAILURE;
+
+	d->max_clients = param->max_clients ? param->max_clients :
+			 IIO_SERVER_TCP_MAX_CLIENTS;
+	if (d->max_clients > IIO_SERVER_TCP_MAX_CLIENTS)
+		goto error_free_desc;
+	d->clients = calloc(d->max_clients, sizeof(*d->clients));
+	if (!d->clients)
+		goto error_free_desc;
+	for (i = 0; i < d->max_clients; i++)
+		d->clients[i].fd = -1;
+
+	d->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (d->listen_fd < 0)
+		goto error_free_clients;
+	setsockopt(d->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(param->port ? param->port : IIO_SERVER_TCP_PORT);
+	if (bind(d->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    listen(d->listen_fd, d->max_clients))
+		goto error_close_listen;
+
+	d->epoll_fd = epoll_create1(0);
+	if (d->epoll_fd < 0)
+		goto error_close_listen;
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL;
+	if (epoll_ctl(d->epoll_fd, EPOLL_CTL_ADD, d->listen_fd, &ev))
+		goto error_close_epoll;
+
+	if (iio_init(&d->iiod, &server_ops) != SUCCESS)
+		goto error_close_epoll;
+
+	iio_server_tcp = d;
+	*desc = d;
+
+	return SUCCESS;
+
+error_close_epoll:
+	close(d->epoll_fd);
+error_close_listen:
+	close(d->listen_fd);
+error_free_clients:
+	free(d->clients);
+error_free_desc:
+	free(d);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Close all connections and release resources.
+ * @param desc - Server descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_server_tcp_remove(struct iio_server_tcp_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc)
+		return FAILURE;
+
+	for (i = 0; i < desc->max_clients; i++)
+		iio_server_tcp_close(desc, &desc->clients[i]);
+
+	close(desc->epoll_fd);
+	close(desc->listen_fd);
+	iio_remove(desc->iiod);
+	free(desc->clients);
+	free(desc);
+	iio_server_tcp = NULL;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Serve clients until an error occurs. Replaces iio_app() on Linux
+ * targets.
+ * @param desc - Server descriptor.
+ * @return FAILURE, only returns on error.
+ */
+int32_t iio_server_tcp_run(struct iio_server_tcp_desc *desc)
+{
+	int32_t status;
+
+	while (1) {
+		status = iio_server_tcp_step(desc, -1);
+		if (status < 0)
+			return status;
+	}
+}
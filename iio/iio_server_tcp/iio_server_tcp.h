@@ -0,0 +1,173 @@
+/***************************************************************************//**
+ *   @file   iio_server_tcp.h
+ *   @brief  Header file of the multi-client iio TCP server.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_SERVER_TCP_H_
+#define IIO_SERVER_TCP_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define IIO_SERVER_TCP_PORT		30431
+#define IIO_SERVER_TCP_MAX_CLIENTS	8
+/* Size of the per client command buffer */
+#define IIO_SERVER_TCP_RX_SIZE		4096
+/* Buffer bytes moved for a client before the other clients get a turn */
+#define IIO_SERVER_TCP_CHUNK_SIZE	4096
+/* Longest device name of a READBUF/WRITEBUF command */
+#define IIO_SERVER_TCP_DEV_SIZE		64
+/*
+ * A client stalling this long in the middle of a command larger than the
+ * command buffer is dropped
+ */
+#define IIO_SERVER_TCP_TIMEOUT_MS	5000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_server_tcp_xfer
+ * @brief READBUF/WRITEBUF command in progress, moved one chunk per turn.
+ */
+struct iio_server_tcp_xfer {
+	/** A transfer is in progress */
+	bool		active;
+	/** WRITEBUF, READBUF otherwise */
+	bool		write;
+	/** The channel mask was sent, with the first READBUF chunk */
+	bool		mask_sent;
+	/** Channel mask of the device */
+	uint32_t	mask;
+	/** Offset of the next chunk in the device buffer */
+	size_t		offset;
+	/** Bytes left to move */
+	size_t		remaining;
+	/** Size of the transfer */
+	size_t		total;
+	/** Device name */
+	char		device[IIO_SERVER_TCP_DEV_SIZE];
+};
+
+/**
+ * @struct iio_server_tcp_client
+ * @brief Connection state of one client.
+ */
+struct iio_server_tcp_client {
+	/** Socket, -1 if the slot is free */
+	int			fd;
+	/** Parser instance */
+	struct tinyiiod		*iiod;
+	/** A command of this client is being executed */
+	bool			busy;
+	/** Receive buffer full, EPOLLIN is disabled until the parser reads */
+	bool			rx_paused;
+	/** epoll events the socket is registered for */
+	uint32_t		events;
+	/** Buffer transfer in progress */
+	struct iio_server_tcp_xfer	xfer;
+	/** Replies not sent yet, nothing new is run until they are */
+	char			*tx;
+	/** Bytes in tx */
+	uint32_t		tx_len;
+	/** Bytes of tx already sent */
+	uint32_t		tx_done;
+	/** Size of the tx allocation */
+	uint32_t		tx_size;
+	/** Received bytes not consumed by the parser yet */
+	uint32_t		rx_len;
+	/** Receive buffer */
+	char			rx[IIO_SERVER_TCP_RX_SIZE];
+};
+
+/**
+ * @struct iio_server_tcp_desc
+ * @brief Server descriptor.
+ */
+struct iio_server_tcp_desc {
+	/** Listening socket */
+	int				listen_fd;
+	/** epoll instance */
+	int				epoll_fd;
+	/** Instance created by iio_init(), kept for iio_remove() */
+	struct tinyiiod			*iiod;
+	/** Client executing a command, target of the server read/write ops */
+	struct iio_server_tcp_client	*current;
+	/** Number of client slots */
+	uint32_t			max_clients;
+	/** Client slots */
+	struct iio_server_tcp_client	*clients;
+	/** Scratch buffer of the READBUF chunks */
+	char				chunk[IIO_SERVER_TCP_CHUNK_SIZE];
+};
+
+/**
+ * @struct iio_server_tcp_init_param
+ * @brief Server configuration.
+ */
+struct iio_server_tcp_init_param {
+	/** TCP port, 0 for IIO_SERVER_TCP_PORT */
+	uint16_t	port;
+	/** Maximum number of clients, 0 for IIO_SERVER_TCP_MAX_CLIENTS */
+	uint32_t	max_clients;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Create the server, replaces iio_app_init(). */
+int32_t iio_server_tcp_init(struct iio_server_tcp_desc **desc,
+			    struct iio_server_tcp_init_param *param);
+/* Free the resources allocated by iio_server_tcp_init(). */
+int32_t iio_server_tcp_remove(struct iio_server_tcp_desc *desc);
+/* Handle the pending events, waiting at most timeout_ms (-1 for ever). */
+int32_t iio_server_tcp_step(struct iio_server_tcp_desc *desc,
+			    int32_t timeout_ms);
+/* Serve clients until an error occurs, replaces iio_app(). */
+int32_t iio_server_tcp_run(struct iio_server_tcp_desc *desc);
+
+#endif // IIO_SERVER_TCP_H_
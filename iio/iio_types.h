@@ -61,6 +61,21 @@ struct iio_ch_info {
 	bool ch_out;
 };
 
+/**
+ * @enum iio_attr_cache_policy
+ * @brief How long the value returned by show() may be served from the cache.
+ */
+enum iio_attr_cache_policy {
+	/** Call show() on every read */
+	IIO_ATTR_VOLATILE,
+	/** The value never changes, show() is called once */
+	IIO_ATTR_STATIC,
+	/** The value only changes when the device is written through iio */
+	IIO_ATTR_CACHE_UNTIL_WRITE,
+	/** The value is read again once older than ttl_ms */
+	IIO_ATTR_CACHE_TTL,
+};
+
 /**
  * @struct iio_attribute
  * @brief Structure holding pointers to show and store functions.
@@ -74,6 +89,10 @@ struct iio_attribute {
 	/** Store function pointer */
 	ssize_t (*store)(void *device, char *buf, size_t len,
 			 const struct iio_ch_info *channel);
+	/** Read caching policy, volatile by default */
+	enum iio_attr_cache_policy cache;
+	/** Cache lifetime for IIO_ATTR_CACHE_TTL, in ms */
+	uint32_t ttl_ms;
 };
 
 /**
@@ -109,7 +128,11 @@ struct iio_device {
  * @brief iio interface for server read/write operations
  */
 struct iio_server_ops {
-	/** Read from from a peripheral device (UART, USB, NETWORK) */
+	/**
+	 * Read from from a peripheral device (UART, USB, NETWORK). Blocks until
+	 * len bytes are read, returns a non negative value (SUCCESS or len,
+	 * depending on the transport) or a negative error code.
+	 */
 	ssize_t (*read)(char *buf, size_t len);
 	/** Write to a peripheral device (UART, USB, NETWORK) */
 	ssize_t (*write)(const char *buf, size_t len);
@@ -56,4 +56,14 @@ int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data);
 /* AXI IO Write data */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data);
 
+/* AXI IO Write a block of 32-bit words to memory */
+int32_t axi_io_write_buf(uint32_t base, uint32_t offset, const uint32_t *data,
+			 uint32_t count);
+
+/* AXI IO Keep a range mapped across accesses, until axi_io_unmap() */
+int32_t axi_io_map(uint32_t base, uint32_t size);
+
+/* AXI IO Release the range kept by axi_io_map() */
+int32_t axi_io_unmap(uint32_t base);
+
 #endif // AXI_IO_H_
@@ -0,0 +1,146 @@
+/***************************************************************************//**
+ *   @file   bus_trace.h
+ *   @brief  SPI/I2C bus transaction tracer.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BUS_TRACE_H_
+#define BUS_TRACE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "timer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of (descriptor, region) pairs that can be tracked */
+#define BUS_TRACE_MAX_ENTRIES	64
+/* Histogram bins: bin n counts values in [2^(n-1), 2^n), bin 0 counts 0 */
+#define BUS_TRACE_HIST_BINS	8
+/* Region used for traffic outside any bus_trace_region_set() call */
+#define BUS_TRACE_NO_REGION	"none"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum bus_trace_type
+ * @brief Traced bus.
+ */
+enum bus_trace_type {
+	BUS_TRACE_SPI,
+	BUS_TRACE_I2C,
+};
+
+/**
+ * @struct bus_trace_entry
+ * @brief Traffic of one bus descriptor inside one region.
+ */
+struct bus_trace_entry {
+	/** SPI or I2C descriptor */
+	const void		*desc;
+	/** Bus type */
+	enum bus_trace_type	type;
+	/** Chip select (SPI) or slave address (I2C) */
+	uint8_t			address;
+	/** Region tag */
+	const char		*region;
+	/** Number of transactions */
+	uint32_t		xfers;
+	/** Number of transactions that returned an error */
+	uint32_t		errors;
+	/** Number of bytes transferred */
+	uint64_t		bytes;
+	/** Cumulative transaction time in ns */
+	uint64_t		time_ns;
+	/** Longest transaction in ns */
+	uint32_t		max_ns;
+	/** Transaction size histogram, in bytes */
+	uint32_t		size_hist[BUS_TRACE_HIST_BINS];
+	/** Transaction time histogram, in us */
+	uint32_t		time_hist[BUS_TRACE_HIST_BINS];
+};
+
+/**
+ * @struct bus_trace_init_param
+ * @brief Tracer configuration.
+ */
+struct bus_trace_init_param {
+	/** Started free running timer used for timestamps, NULL for counts only */
+	struct timer_desc	*timer;
+	/** The timer counts down */
+	bool			timer_count_down;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Configure the tracer and start recording. */
+int32_t bus_trace_init(struct bus_trace_init_param *param);
+/* Stop recording. */
+void bus_trace_remove(void);
+/* Pause or resume recording. */
+void bus_trace_enable(bool enable);
+/* Check whether recording is active. */
+bool bus_trace_is_enabled(void);
+/* Clear all statistics. */
+void bus_trace_reset(void);
+/* Attribute the following traffic to a region, returns the previous one. */
+const char *bus_trace_region_set(const char *region);
+/* Account one transaction, called by the bus shims. */
+void bus_trace_account(const void *desc, enum bus_trace_type type,
+		       uint8_t address, uint32_t bytes, uint32_t time_ns,
+		       int32_t status);
+/* Get the raw timer count. */
+uint32_t bus_trace_timestamp(void);
+/* Get the time elapsed since a bus_trace_timestamp() value, in ns. */
+uint32_t bus_trace_elapsed_ns(uint32_t start);
+/* Get a recorded entry. */
+const struct bus_trace_entry *bus_trace_get(uint32_t idx);
+/* Write the statistics as CSV, returns the number of characters written. */
+int32_t bus_trace_dump_csv(char *buf, uint32_t size);
+/* Print the statistics as CSV. */
+void bus_trace_print(void);
+
+#endif /* BUS_TRACE_H_ */
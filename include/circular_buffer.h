@@ -0,0 +1,101 @@
+/***************************************************************************//**
+ *   @file   circular_buffer.h
+ *   @brief  Lock-free single producer/single consumer byte ring buffer.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef CIRCULAR_BUFFER_H_
+#define CIRCULAR_BUFFER_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct circular_buffer
+ * @brief Byte ring buffer with one writer and one reader.
+ *
+ * The writer only moves the write index and the reader only moves the read
+ * index, so an interrupt handler can fill the buffer while the main loop
+ * drains it without masking interrupts. The indexes run freely and are
+ * reduced with a mask, which requires a power of two size.
+ */
+struct circular_buffer {
+	/** Storage */
+	uint8_t			*buff;
+	/** Size of the storage, power of two */
+	uint32_t		size;
+	/** Total number of bytes written */
+	volatile uint32_t	write_idx;
+	/** Total number of bytes read */
+	volatile uint32_t	read_idx;
+	/** Bytes dropped because the buffer was full */
+	volatile uint32_t	overflows;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a ring buffer of at least the requested size. */
+int32_t cb_init(struct circular_buffer **desc, uint32_t size);
+
+/* Free the resources allocated by cb_init(). */
+int32_t cb_remove(struct circular_buffer *desc);
+
+/* Number of bytes waiting to be read. */
+uint32_t cb_size(struct circular_buffer *desc);
+
+/* Number of bytes that can be written without dropping data. */
+uint32_t cb_free_space(struct circular_buffer *desc);
+
+/* Append data, returns the number of bytes stored. */
+uint32_t cb_write(struct circular_buffer *desc, const void *data,
+		  uint32_t len);
+
+/* Remove up to len bytes, returns the number of bytes copied. */
+uint32_t cb_read(struct circular_buffer *desc, void *data, uint32_t len);
+
+/* Discard the data waiting to be read. */
+int32_t cb_flush(struct circular_buffer *desc);
+
+#endif /* CIRCULAR_BUFFER_H_ */
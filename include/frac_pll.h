@@ -0,0 +1,159 @@
+/***************************************************************************//**
+ *   @file   frac_pll.h
+ *   @brief  Header file of the fractional-N PLL divider solver.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef FRAC_PLL_H_
+#define FRAC_PLL_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct frac_pll_cfg
+ * @brief Reference path and divider limits of a fractional-N PLL.
+ */
+struct frac_pll_cfg {
+	/** Reference input frequency (Hz) */
+	uint32_t	clkin;
+	/** Reference doubler enabled */
+	bool		ref_doubler_en;
+	/** Reference divide by 2 enabled */
+	bool		ref_div2_en;
+	/** R counter is searched starting from r_cnt_init + 1 */
+	uint16_t	r_cnt_init;
+	/** Largest R counter value */
+	uint16_t	max_r_cnt;
+	/** Largest PFD frequency (Hz) */
+	uint32_t	max_fpfd;
+	/** Largest modulus */
+	uint32_t	max_mod;
+	/** Fixed modulus, 0 if MOD is derived from the channel spacing */
+	uint32_t	fixed_mod;
+	/** Increase the channel spacing instead of failing when the R counter
+	 *  runs out of range */
+	bool		chspc_retry;
+	/** Round the divide ratio to the closest value, otherwise truncate */
+	bool		round_closest;
+};
+
+/**
+ * @struct frac_pll_pfd
+ * @brief State of the (R counter, modulus) search.
+ */
+struct frac_pll_pfd {
+	/** R counter */
+	uint16_t	r_cnt;
+	/** Channel spacing (Hz) */
+	uint32_t	chspc;
+	/** PFD frequency (Hz) */
+	uint32_t	fpfd;
+	/** Modulus */
+	uint32_t	mod;
+};
+
+/**
+ * @struct frac_pll_solver
+ * @brief Memoized first (R counter, modulus) pair of a reference setting.
+ */
+struct frac_pll_solver {
+	/** The cached pair is valid */
+	bool			valid;
+	/** Configuration the pair was found for */
+	struct frac_pll_cfg	cfg;
+	/** Requested channel spacing (Hz) */
+	uint32_t		req_chspc;
+	/** First valid pair */
+	struct frac_pll_pfd	first;
+};
+
+/**
+ * @struct frac_pll_result
+ * @brief Divider values of one frequency.
+ */
+struct frac_pll_result {
+	/** R counter */
+	uint16_t	r_cnt;
+	/** Channel spacing used by the search (Hz) */
+	uint32_t	chspc;
+	/** PFD frequency (Hz) */
+	uint32_t	fpfd;
+	/** Integer divide value */
+	uint32_t	int_val;
+	/** Fractional divide value */
+	uint32_t	fract;
+	/** Modulus, reduced with FRACT unless it is fixed */
+	uint32_t	mod;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Compute the PFD frequency for an R counter value. */
+uint32_t frac_pll_calc_fpfd(const struct frac_pll_cfg *cfg, uint16_t r_cnt);
+
+/* Advance the search to the next valid (R counter, modulus) pair. */
+int32_t frac_pll_pfd_next(const struct frac_pll_cfg *cfg,
+			  struct frac_pll_pfd *pfd);
+
+/* Get the first valid pair, memoized per reference setting. */
+int32_t frac_pll_pfd_first(struct frac_pll_solver *solver,
+			   const struct frac_pll_cfg *cfg, uint32_t chspc,
+			   struct frac_pll_pfd *pfd);
+
+/* Compute the dividers of a VCO frequency. */
+int32_t frac_pll_solve(struct frac_pll_solver *solver,
+		       const struct frac_pll_cfg *cfg, uint32_t chspc,
+		       uint64_t vco_freq, uint32_t int_min,
+		       struct frac_pll_result *res);
+
+/* Compute the VCO frequency produced by a set of dividers. */
+uint64_t frac_pll_vco_freq(const struct frac_pll_result *res);
+
+/* Invalidate the memoized search result. */
+void frac_pll_solver_reset(struct frac_pll_solver *solver);
+
+#endif // FRAC_PLL_H_
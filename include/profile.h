@@ -0,0 +1,140 @@
+/***************************************************************************//**
+ *   @file   profile.h
+ *   @brief  Hot path timing instrumentation.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of events kept in the trace ring, must be a power of two */
+#ifndef PROFILE_RING_SIZE
+#define PROFILE_RING_SIZE	256
+#endif
+
+/*
+ * Instrumentation macros. They compile to nothing unless PROFILE_ENABLE is
+ * defined, so instrumented code costs nothing in regular builds.
+ *
+ *	PROFILE_START(t);
+ *	axi_dmac_transfer(dmac, addr, size);
+ *	PROFILE_STOP(t, "dmac_transfer");
+ *
+ *	PROFILE_BLOCK("rx_cal") {
+ *		...
+ *	}
+ *
+ * Leaving a PROFILE_BLOCK with break, goto or return skips the record.
+ */
+#ifdef PROFILE_ENABLE
+#define PROFILE_START(var)	uint32_t var = profile_clock()
+#define PROFILE_STOP(var, name)	profile_record(name, var, profile_clock() - var)
+#define PROFILE_BLOCK(name)						\
+	for (uint32_t _profile_start = profile_clock(), _profile_once = 1; \
+	     _profile_once; _profile_once = 0,				\
+	     profile_record(name, _profile_start,			\
+			    profile_clock() - _profile_start))
+#else
+#define PROFILE_START(var)	do {} while (0)
+#define PROFILE_STOP(var, name)	do {} while (0)
+#define PROFILE_BLOCK(name)
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct profile_event
+ * @brief One timed section.
+ */
+struct profile_event {
+	/** Section name */
+	const char	*name;
+	/** Clock value when the section started */
+	uint32_t	start;
+	/** Section duration in clock ticks */
+	uint32_t	ticks;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Platform clock, implemented in drivers/platform/<platform>/profile.c */
+
+/* Start the platform clock. */
+int32_t profile_clock_init(void);
+/* Read the free running, monotonic platform clock. */
+uint32_t profile_clock(void);
+/* Get the platform clock frequency, 0 if the platform has no clock. */
+uint32_t profile_clock_hz(void);
+
+/* Trace ring, implemented in util/profile.c */
+
+/* Start the clock and clear the trace ring. */
+int32_t profile_init(void);
+/* Pause or resume recording. */
+void profile_enable(bool enable);
+/* Check whether recording is active. */
+bool profile_is_enabled(void);
+/* Clear the trace ring. */
+void profile_reset(void);
+/* Record one timed section. */
+void profile_record(const char *name, uint32_t start, uint32_t ticks);
+/* Convert clock ticks to ns. */
+uint32_t profile_ticks_to_ns(uint32_t ticks);
+/* Get an event, 0 is the oldest one still in the ring. */
+int32_t profile_get(uint32_t idx, struct profile_event *event);
+/* Get the number of events in the ring. */
+uint32_t profile_count(void);
+/* Write the trace as CSV, returns the number of characters written. */
+int32_t profile_dump_csv(char *buf, uint32_t size);
+/* Print the trace as CSV. */
+void profile_print(void);
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,163 @@
+/***************************************************************************//**
+ *   @file   sample_source.h
+ *   @brief  Timer paced acquisition from single sample ADC drivers.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef SAMPLE_SOURCE_H_
+#define SAMPLE_SOURCE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "circular_buffer.h"
+#include "irq.h"
+#include "timer.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SAMPLE_SOURCE_MAX_CHANNELS	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Single conversion callback of an ADC driver.
+ * @param dev - Driver descriptor.
+ * @param ch - Channel to convert.
+ * @param code - Conversion result, right aligned.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+typedef int32_t (*sample_read_t)(void *dev, uint8_t ch, uint16_t *code);
+
+/**
+ * @struct sample_source_init_param
+ * @brief Structure holding the parameters of a sample source.
+ */
+struct sample_source_init_param {
+	/** Driver descriptor passed to read */
+	void			*dev;
+	/** Driver single conversion */
+	sample_read_t		read;
+	/** Number of channels of the ADC */
+	uint8_t			num_channels;
+	/** Resolution (bits) */
+	uint8_t			bits;
+	/** volts = (code + offset) * scale */
+	int32_t			offset;
+	/** Volts per LSB */
+	float			scale;
+	/** Ring capacity, in frames of all the channels */
+	uint32_t		ring_frames;
+	/** Pacing timer, already set to the sample rate. NULL for polled
+	 *  acquisition with sample_source_acquire() */
+	struct timer_desc	*timer;
+	/** Interrupt controller of the timer */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Timer interrupt */
+	uint32_t		timer_irq_id;
+};
+
+/**
+ * @struct sample_source
+ * @brief Sample source descriptor.
+ */
+struct sample_source {
+	/** Driver descriptor */
+	void			*dev;
+	/** Driver single conversion */
+	sample_read_t		read;
+	/** Number of channels of the ADC */
+	uint8_t			num_channels;
+	/** Resolution (bits) */
+	uint8_t			bits;
+	/** volts = (code + offset) * scale */
+	int32_t			offset;
+	/** Volts per LSB */
+	float			scale;
+	/** Pacing timer */
+	struct timer_desc	*timer;
+	/** Interrupt controller of the timer */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Timer interrupt */
+	uint32_t		timer_irq_id;
+	/** Frames of the enabled channels, lowest channel first */
+	struct circular_buffer	*ring;
+	/** Enabled channels */
+	uint32_t		ch_mask;
+	/** Size of a frame (bytes) */
+	uint32_t		frame_size;
+	/** Acquisition running */
+	volatile bool		running;
+	/** Frames dropped because the ring was full */
+	volatile uint32_t	overruns;
+	/** Frames dropped because a conversion failed */
+	volatile uint32_t	read_errors;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Wrap a single sample ADC driver. */
+int32_t sample_source_init(struct sample_source **desc,
+			   struct sample_source_init_param *param);
+/* Free the resources allocated by sample_source_init(). */
+int32_t sample_source_remove(struct sample_source *desc);
+/* Start the acquisition of the selected channels. */
+int32_t sample_source_start(struct sample_source *desc, uint32_t ch_mask);
+/* Stop the acquisition. */
+int32_t sample_source_stop(struct sample_source *desc);
+/* Convert one frame of the enabled channels into the ring. */
+int32_t sample_source_acquire(struct sample_source *desc);
+/* Number of frames waiting to be read. */
+uint32_t sample_source_available(struct sample_source *desc);
+/* Read frames from the ring, returns the number of frames copied. */
+uint32_t sample_source_read(struct sample_source *desc, uint16_t *codes,
+			    uint32_t nb_frames);
+/* Convert codes to volts. */
+void sample_source_to_volts(struct sample_source *desc, const uint16_t *codes,
+			    float *volts, uint32_t nb_codes);
+/* Get the acquisition rate set by the pacing timer. */
+int32_t sample_source_get_rate(struct sample_source *desc, uint32_t *rate_hz);
+
+#endif /* SAMPLE_SOURCE_H_ */
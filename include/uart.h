@@ -82,6 +82,10 @@ struct uart_desc {
 /* Read data to UART. */
 int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number);
 
+/* Read the data already received, without waiting. */
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number);
+
 /* Write data to UART. */
 int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
 		   uint32_t bytes_number);
@@ -121,6 +121,8 @@ void rational_best_approximation(uint32_t given_numerator,
 				 uint32_t *best_denominator);
 /* Calculate the number of set bits. */
 uint32_t hweight8(uint32_t word);
+/* Calculate the number of set bits of a 32-bit word. */
+uint32_t hweight32(uint32_t word);
 /* Calculate the quotient and the remainder of an integer division. */
 uint64_t do_div(uint64_t* n,
 		uint64_t base);
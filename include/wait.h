@@ -0,0 +1,117 @@
+/***************************************************************************//**
+ *   @file   wait.h
+ *   @brief  Header file of the condition wait utility.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef WAIT_H_
+#define WAIT_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct wait_stats
+ * @brief Structure holding the statistics of the waits done on a condition.
+ */
+struct wait_stats {
+	/** Number of waits */
+	uint32_t	count;
+	/** Number of waits that timed out */
+	uint32_t	timeouts;
+	/** Duration of the last wait (us) */
+	uint32_t	last_us;
+	/** Shortest successful wait (us) */
+	uint32_t	min_us;
+	/** Longest successful wait (us) */
+	uint32_t	max_us;
+	/** Sum of the successful waits (us) */
+	uint64_t	total_us;
+};
+
+/**
+ * @struct wait_param
+ * @brief Structure holding the parameters of a condition wait.
+ */
+struct wait_param {
+	/** First polling interval (us) */
+	uint32_t		start_us;
+	/** Upper limit of the polling interval (us) */
+	uint32_t		max_step_us;
+	/** Time after which the wait is abandoned (us) */
+	uint32_t		timeout_us;
+	/** Optional status pin that mirrors the condition */
+	struct gpio_desc	*status_gpio;
+	/** Status pin level while the condition is met */
+	uint8_t			status_level;
+	/** Optional flag set from an interrupt handler (wait_event_handler) */
+	volatile bool		*event;
+	/** Optional statistics of the waits */
+	struct wait_stats	*stats;
+};
+
+/**
+ * @brief Condition callback.
+ * @param ctx - Caller context.
+ * @param done - Set to true when the condition is met.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+typedef int32_t (*wait_cond_t)(void *ctx, bool *done);
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Wait for a condition using an adaptive polling interval. */
+int32_t wait_for_condition(const struct wait_param *param,
+			   wait_cond_t cond, void *ctx);
+
+/* IRQ handler that sets the event flag of a wait. */
+void wait_event_handler(void *data);
+
+/* Clear the wait statistics. */
+void wait_stats_reset(struct wait_stats *stats);
+
+#endif // WAIT_H_
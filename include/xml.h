@@ -44,6 +44,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdint.h>
 #include "stdio.h"
 
 /******************************************************************************/
@@ -67,7 +67,7 @@ extern struct sd_desc	*sd_desc;
 DSTATUS SD_disk_status();
 DSTATUS SD_disk_initialize();
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count);
-DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count);
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count);
 
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
@@ -214,17 +214,22 @@ DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count)
 {
 	if (!sd_init_var)
 		return RES_NOTRDY;
-	if (SUCCESS != sd_read(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
+	/* A single sd_read() transfers all the sectors (CMD18) */
+	if (SUCCESS != sd_read(sd_desc, buff, (uint64_t)sector * DATA_BLOCK_LEN,
+			       (uint64_t)count * DATA_BLOCK_LEN))
 		return RES_ERROR;
 
 	return RES_OK;
 }
 
-DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count)
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count)
 {
 	if (!sd_init_var)
 		return RES_NOTRDY;
-	if (SUCCESS != sd_write(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
+	/* A single sd_write() transfers all the sectors (CMD25) */
+	if (SUCCESS != sd_write(sd_desc, (uint8_t *)buff,
+				(uint64_t)sector * DATA_BLOCK_LEN,
+				(uint64_t)count * DATA_BLOCK_LEN))
 		return RES_ERROR;
 
 	return RES_OK;
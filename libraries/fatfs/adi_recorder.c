@@ -0,0 +1,303 @@
+/***************************************************************************//**
+ *   @file   adi_recorder.c
+ *   @brief  Stream a sample source into a preallocated FatFs file.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <errno.h>
+#include "adi_recorder.h"
+#include "diskio.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#if FF_MAX_SS == FF_MIN_SS
+#define RECORDER_SS(fs)		FF_MAX_SS
+#else
+#define RECORDER_SS(fs)		((fs)->ssize)
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Create the file, preallocated and contiguous, so that the data can be
+ * written with multi-sector writes straight to the disk, without any FAT
+ * access while recording.
+ * @param desc - The recorder descriptor.
+ * @param param - The structure that contains the recorder parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t recorder_init(struct recorder_desc **desc,
+		      const struct recorder_init_param *param)
+{
+	struct recorder_desc *rec;
+	FATFS *fs;
+
+	if (!param->buffer_size || !param->source.submit || !param->source.wait)
+		return FAILURE;
+
+	rec = (struct recorder_desc *)calloc(1, sizeof(*rec));
+	if (!rec)
+		return FAILURE;
+
+	if (f_open(&rec->file, param->path, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
+		goto error_desc;
+
+	fs = rec->file.obj.fs;
+	if (param->buffer_size % RECORDER_SS(fs) ||
+	    param->file_size < RECORDER_SS(fs))
+		goto error_file;
+
+	/* Fails if there is no contiguous free area large enough */
+	if (f_expand(&rec->file, param->file_size, 1) != FR_OK)
+		goto error_file;
+
+	/* Record the allocation now, the data survives a power loss */
+	if (f_sync(&rec->file) != FR_OK)
+		goto error_file;
+
+	rec->sector = fs->database + (LBA_t)fs->csize *
+		      (rec->file.obj.sclust - 2);
+	rec->num_sectors = param->file_size / RECORDER_SS(fs);
+	rec->buffer_size = param->buffer_size;
+	rec->source = param->source;
+
+	if (param->buffer) {
+		rec->buf[0] = param->buffer;
+	} else {
+		rec->buf[0] = (uint8_t *)malloc(2 * param->buffer_size);
+		if (!rec->buf[0])
+			goto error_file;
+		rec->own_buffer = true;
+	}
+	rec->buf[1] = rec->buf[0] + param->buffer_size;
+
+	*desc = rec;
+
+	return SUCCESS;
+
+error_file:
+	f_close(&rec->file);
+error_desc:
+	free(rec);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Write the next filled buffer to the file and give it back to the
+ * source, while the source fills the other buffer.
+ * @param desc - The recorder descriptor.
+ * @return SUCCESS in case of success, -ENOSPC if the file is full, FAILURE
+ * otherwise.
+ */
+int32_t recorder_step(struct recorder_desc *desc)
+{
+	FATFS *fs = desc->file.obj.fs;
+	LBA_t sectors, count;
+	uint8_t *buf;
+	uint8_t i;
+
+	if (desc->written >= desc->num_sectors)
+		return -ENOSPC;
+
+	if (!desc->started) {
+		for (i = 0; i < 2; i++) {
+			if (desc->source.submit(desc->source.ctx, desc->buf[i],
+						desc->buffer_size) != SUCCESS)
+				return FAILURE;
+			desc->pending++;
+		}
+		desc->started = true;
+	}
+
+	buf = desc->buf[desc->next];
+	if (desc->source.wait(desc->source.ctx, buf,
+			      desc->buffer_size) != SUCCESS)
+		return FAILURE;
+	desc->pending--;
+
+	sectors = desc->buffer_size / RECORDER_SS(fs);
+	count = min_t(LBA_t, sectors, desc->num_sectors - desc->written);
+	if (disk_write(fs->pdrv, buf, desc->sector + desc->written,
+		       count) != RES_OK)
+		return FAILURE;
+	desc->written += count;
+	desc->next ^= 1;
+
+	/* Give the buffer back only if the file has room for its data */
+	if (desc->written + (LBA_t)desc->pending * sectors < desc->num_sectors) {
+		if (desc->source.submit(desc->source.ctx, buf,
+					desc->buffer_size) != SUCCESS)
+			return FAILURE;
+		desc->pending++;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Record until the file is full or at least len bytes are written.
+ * @param desc - The recorder descriptor.
+ * @param len - Number of bytes to record.
+ * @return SUCCESS in case of success, -ENOSPC if the file got full first,
+ * FAILURE otherwise.
+ */
+int32_t recorder_run(struct recorder_desc *desc, uint64_t len)
+{
+	uint64_t end = recorder_get_size(desc) + len;
+	int32_t ret;
+
+	while (recorder_get_size(desc) < end) {
+		ret = recorder_step(desc);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Number of bytes recorded.
+ * @param desc - The recorder descriptor.
+ * @return The size of the data written to the file.
+ */
+uint64_t recorder_get_size(struct recorder_desc *desc)
+{
+	return (uint64_t)desc->written * RECORDER_SS(desc->file.obj.fs);
+}
+
+/**
+ * @brief Wait for the buffers still owned by the source, trim the file to the
+ * recorded size, close it and free the recorder.
+ * @param desc - The recorder descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t recorder_remove(struct recorder_desc *desc)
+{
+	int32_t ret = SUCCESS;
+
+	if (!desc)
+		return FAILURE;
+
+	while (desc->pending) {
+		if (desc->source.wait(desc->source.ctx, desc->buf[desc->next],
+				      desc->buffer_size) != SUCCESS)
+			ret = FAILURE;
+		desc->next ^= 1;
+		desc->pending--;
+	}
+
+	if (f_lseek(&desc->file, (FSIZE_t)recorder_get_size(desc)) != FR_OK ||
+	    f_truncate(&desc->file) != FR_OK)
+		ret = FAILURE;
+
+	if (f_close(&desc->file) != FR_OK)
+		ret = FAILURE;
+
+	if (desc->own_buffer)
+		free(desc->buf[0]);
+	free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief AXI DMAC source: queue a capture into a buffer.
+ * @param ctx - struct recorder_dmac_source.
+ * @param buf - Buffer.
+ * @param len - Size of the buffer.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t recorder_dmac_submit(void *ctx, uint8_t *buf, uint32_t len)
+{
+	struct recorder_dmac_source *src = (struct recorder_dmac_source *)ctx;
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_SIZE(src->buf); i++) {
+		if (src->buf[i])
+			continue;
+
+		if (axi_dmac_transfer_start(src->dmac, (uint32_t)(uintptr_t)buf,
+					    len, &src->id[i]) != SUCCESS)
+			return FAILURE;
+		src->buf[i] = buf;
+
+		return SUCCESS;
+	}
+
+	return FAILURE;
+}
+
+/**
+ * @brief AXI DMAC source: wait until the capture into a buffer is completed.
+ * @param ctx - struct recorder_dmac_source.
+ * @param buf - Buffer.
+ * @param len - Size of the buffer.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t recorder_dmac_wait(void *ctx, uint8_t *buf, uint32_t len)
+{
+	struct recorder_dmac_source *src = (struct recorder_dmac_source *)ctx;
+	bool done = false;
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_SIZE(src->buf); i++)
+		if (src->buf[i] == buf)
+			break;
+	if (i == ARRAY_SIZE(src->buf))
+		return FAILURE;
+
+	while (!done)
+		if (axi_dmac_transfer_done(src->dmac, src->id[i], &done) != SUCCESS)
+			return FAILURE;
+
+	if (src->dcache_invalidate_range)
+		src->dcache_invalidate_range((uint32_t)(uintptr_t)buf, len);
+	src->buf[i] = NULL;
+
+	return SUCCESS;
+}
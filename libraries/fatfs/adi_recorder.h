@@ -0,0 +1,152 @@
+/***************************************************************************//**
+ *   @file   adi_recorder.h
+ *   @brief  Stream a sample source into a preallocated FatFs file.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef ADI_RECORDER_H_
+#define ADI_RECORDER_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ff.h"
+#include "axi_dmac.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct recorder_source
+ * @brief Producer of the recorded data. Buffers are queued with submit() and
+ * taken back with wait(), in the same order.
+ */
+struct recorder_source {
+	/** Source context, passed to the callbacks */
+	void *ctx;
+	/** Start filling a buffer, should return without waiting for the data */
+	int32_t (*submit)(void *ctx, uint8_t *buf, uint32_t len);
+	/** Wait until the oldest submitted buffer is filled */
+	int32_t (*wait)(void *ctx, uint8_t *buf, uint32_t len);
+};
+
+/**
+ * @struct recorder_dmac_source
+ * @brief Context of recorder_dmac_submit()/recorder_dmac_wait(), to record
+ * from an AXI DMAC.
+ */
+struct recorder_dmac_source {
+	/** DMAC, DMA_DEV_TO_MEM and not cyclic */
+	struct axi_dmac *dmac;
+	/** Invalidate the data cache range of a filled buffer, NULL if none */
+	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** Buffers in flight */
+	uint8_t *buf[2];
+	/** Transfer ids of the buffers in flight */
+	uint32_t id[2];
+};
+
+/**
+ * @struct recorder_init_param
+ * @brief Recorder configuration.
+ */
+struct recorder_init_param {
+	/** Path of the file, on a mounted volume. The file is overwritten */
+	const char *path;
+	/** Size to preallocate, the recording stops when it is full */
+	FSIZE_t file_size;
+	/** Size of one buffer, multiple of the sector size */
+	uint32_t buffer_size;
+	/** Two buffers of buffer_size bytes, allocated if NULL */
+	uint8_t *buffer;
+	/** Data source */
+	struct recorder_source source;
+};
+
+/**
+ * @struct recorder_desc
+ * @brief Recorder descriptor.
+ */
+struct recorder_desc {
+	/** File, contiguous */
+	FIL file;
+	/** First sector of the file */
+	LBA_t sector;
+	/** Sectors in the file */
+	LBA_t num_sectors;
+	/** Sectors written */
+	LBA_t written;
+	/** Size of one buffer */
+	uint32_t buffer_size;
+	/** The two buffers */
+	uint8_t *buf[2];
+	/** Buffer to be written next */
+	uint8_t next;
+	/** Buffers owned by the source */
+	uint8_t pending;
+	/** Buffer allocated by the recorder */
+	bool own_buffer;
+	/** Buffers have been submitted to the source */
+	bool started;
+	/** Data source */
+	struct recorder_source source;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Create the file, preallocated and contiguous. */
+int32_t recorder_init(struct recorder_desc **desc,
+		      const struct recorder_init_param *param);
+/* Write the next filled buffer to the file. */
+int32_t recorder_step(struct recorder_desc *desc);
+/* Record until the file is full or len bytes are written. */
+int32_t recorder_run(struct recorder_desc *desc, uint64_t len);
+/* Number of bytes recorded. */
+uint64_t recorder_get_size(struct recorder_desc *desc);
+/* Trim the file to the recorded size, close it and free the recorder. */
+int32_t recorder_remove(struct recorder_desc *desc);
+
+/* AXI DMAC source. */
+int32_t recorder_dmac_submit(void *ctx, uint8_t *buf, uint32_t len);
+int32_t recorder_dmac_wait(void *ctx, uint8_t *buf, uint32_t len);
+
+#endif /* ADI_RECORDER_H_ */
@@ -0,0 +1,213 @@
+/***************************************************************************//**
+ *   @file   main.c
+ *   @brief  Smoke test of the AD7124 driver against the simulated device.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ad7124.h"
+#include "ad7124_regs.h"
+#include "error.h"
+#include "sim.h"
+#include "sim_models.h"
+#include "spi_extra.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define TEST_NUM_SAMPLES	16
+/* Conversion result increment of the simulated device */
+#define TEST_RAMP_STEP		0x1000
+
+#define TEST_CHECK(cond, ...)			\
+	do {					\
+		test_checks++;			\
+		if (!(cond)) {			\
+			test_failures++;	\
+			printf("FAIL: ");	\
+			printf(__VA_ARGS__);	\
+			printf("\n");		\
+		}				\
+	} while (0)
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static uint32_t test_checks;
+static uint32_t test_failures;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Set up the driver on the model and check that the register map the
+ *        driver wrote is the one the device holds. Then change the ADC
+ *        control register and read a few conversions.
+ * @return None.
+ */
+static void test_ad7124(void)
+{
+	struct sim_spi_init_param sim_spi;
+	struct ad7124_init_param init;
+	struct ad7124_st_reg regs[AD7124_REG_NO];
+	struct ad7124_dev *dev;
+	struct sim_model *model;
+	int32_t ret, data, prev = 0;
+	uint32_t i;
+
+	ret = sim_ad7124_init(&model);
+	TEST_CHECK(ret == SUCCESS, "sim_ad7124_init returned %d", ret);
+	if (ret != SUCCESS)
+		return;
+
+	memcpy(regs, ad7124_regs, sizeof(regs));
+	/* Settings a board would change from the power-on values */
+	regs[AD7124_Channel_1].value = 0x8043;
+	regs[AD7124_Config_0].value = 0x09E0;
+	regs[AD7124_Filter_0].value = 0x060010;
+
+	sim_spi.model = model;
+	init.spi_init = (struct spi_init_param) {
+		.max_speed_hz = 1000000,
+		.chip_select = 0,
+		.mode = SPI_MODE_3,
+		.extra = &sim_spi,
+	};
+	init.regs = regs;
+	init.spi_rdy_poll_cnt = 25000;
+
+	ret = ad7124_setup(&dev, init);
+	TEST_CHECK(ret >= 0, "ad7124_setup returned %d", ret);
+	if (ret < 0)
+		goto out;
+
+	for (i = AD7124_ADC_Control; i < AD7124_Offset_0; i++) {
+		if (regs[i].rw != AD7124_RW)
+			continue;
+		TEST_CHECK(sim_reg_read(model, regs[i].addr) == regs[i].value,
+			   "register 0x%02x is 0x%06x, driver wrote 0x%06x",
+			   regs[i].addr, sim_reg_read(model, regs[i].addr),
+			   regs[i].value);
+	}
+
+	ret = ad7124_read_register(dev, &regs[AD7124_ID]);
+	TEST_CHECK(ret >= 0 && regs[AD7124_ID].value == 0x14,
+		   "ID read returned %d, value 0x%02x", ret,
+		   regs[AD7124_ID].value);
+
+	regs[AD7124_ADC_Control].value = AD7124_ADC_CTRL_REG_POWER_MODE(3) |
+					 AD7124_ADC_CTRL_REG_REF_EN;
+	ret = ad7124_write_register(dev, regs[AD7124_ADC_Control]);
+	TEST_CHECK(ret >= 0 && sim_reg_read(model, AD7124_ADC_CTRL_REG) ==
+		   regs[AD7124_ADC_Control].value,
+		   "ADC control write returned %d", ret);
+
+	for (i = 0; i < TEST_NUM_SAMPLES; i++) {
+		ret = ad7124_wait_for_conv_ready(dev, init.spi_rdy_poll_cnt);
+		TEST_CHECK(ret >= 0, "conversion %u not ready", i);
+		ret = ad7124_read_data(dev, &data);
+		TEST_CHECK(ret >= 0, "conversion %u read returned %d", i, ret);
+		if (i)
+			TEST_CHECK(((data - prev) & 0xFFFFFF) == TEST_RAMP_STEP,
+				   "conversion %u is 0x%06x after 0x%06x", i,
+				   data, prev);
+		prev = data;
+	}
+
+	ad7124_remove(dev);
+out:
+	sim_model_free(model);
+}
+
+/**
+ * @brief Memory map bookkeeping: regions that overlap a mapped one in any
+ *        way are refused.
+ * @return None.
+ */
+static void test_mmio_map(void)
+{
+	struct sim_model *a, *b;
+	int32_t ret;
+
+	ret = sim_axi_clkgen_init(&a, 0x44A10000, 0);
+	TEST_CHECK(ret == SUCCESS, "mapping the first region failed");
+	if (ret != SUCCESS)
+		return;
+
+	/* Both ends outside the mapped region */
+	ret = sim_axi_clkgen_init(&b, 0x44A08000, 0);
+	TEST_CHECK(ret != SUCCESS, "overlap at the start accepted");
+	ret = sim_axi_clkgen_init(&b, 0x44A18000, 0);
+	TEST_CHECK(ret != SUCCESS, "overlap at the end accepted");
+	ret = sim_axi_dmac_init(&b, 0x44A0F000);
+	TEST_CHECK(ret == SUCCESS && sim_mmio_find(0x44A0FFFF) == b &&
+		   sim_mmio_find(0x44A10000) == a, "adjacent region refused");
+	if (ret != SUCCESS)
+		goto out;
+
+	/* Move the second model around */
+	sim_mmio_unmap(b);
+	ret = sim_mmio_map(b, 0x44A00000, 0x40000);
+	TEST_CHECK(ret != SUCCESS, "enclosing region accepted");
+	ret = sim_mmio_map(b, 0xFFFFF000, 0x2000);
+	TEST_CHECK(ret != SUCCESS, "region wrapping around accepted");
+	ret = sim_mmio_map(b, 0xFFFFF000, 0x1000);
+	TEST_CHECK(ret == SUCCESS && sim_mmio_find(0xFFFFFFFF) == b,
+		   "region at the top of memory refused");
+
+	sim_model_free(b);
+out:
+	sim_model_free(a);
+}
+
+int main(void)
+{
+	test_ad7124();
+	test_mmio_map();
+
+	printf("%u checks, %u failures\n", test_checks, test_failures);
+
+	return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
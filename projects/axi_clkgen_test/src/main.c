@@ -0,0 +1,470 @@
+/***************************************************************************//**
+ *   @file   main.c
+ *   @brief  Host test and benchmark of the AXI clock generator driver.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "axi_io.h"
+#include "clk_axi_clkgen.h"
+#include "error.h"
+#include "sim_models.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define TEST_CLKGEN_BASE	0x44A00000
+
+#define REG_RESETN		0x40
+#define REG_DRP_CNTRL		0x70
+#define REG_DRP_STATUS		0x74
+#define DRP_CNTRL_SEL		BIT(29)
+#define DRP_CNTRL_READ		BIT(28)
+
+/* FPGA info register: technology, family, speed grade, package */
+#define FPGA_INFO(t, f, s)	(((t) << 24) | ((f) << 16) | ((s) << 8))
+
+/* Minimum run time of one measurement */
+#define BENCH_MIN_NS		200000000ull
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct test_fpga
+ * @brief FPGA info value and the PFD/VCO limits the driver must derive.
+ */
+struct test_fpga {
+	const char	*name;
+	uint32_t	info;
+	uint32_t	fpfd_min;
+	uint32_t	fpfd_max;
+	uint32_t	fvco_min;
+	uint32_t	fvco_max;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static const struct test_fpga test_fpgas[] = {
+	{ "unknown", FPGA_INFO(0, 0, 0), 10000, 300000, 600000, 1200000 },
+	{ "7series -2", FPGA_INFO(1, 2, 20), 10000, 500000, 600000, 1440000 },
+	{ "ultrascale+ -3", FPGA_INFO(3, 4, 30), 10000, 550000, 800000, 1600000 },
+};
+
+static const uint32_t test_parents[] = {
+	33333333, 100000000, 125000000, 200000000, 250000000
+};
+
+/* Rate dependent MMCM registers and the bits the rate settings own */
+static const uint32_t ref_regs[12] = {
+	0x08, 0x09, 0x0A, 0x0B, 0x16, 0x14, 0x15, 0x18, 0x19, 0x1a, 0x4e, 0x4f
+};
+
+static const uint32_t ref_masks[12] = {
+	0xefff, 0x03ff, 0xefff, 0x03ff, 0x3fff, 0xefff, 0x03ff, 0x03ff,
+	0x7fff, 0x7fff, 0x9900, 0x9900
+};
+
+/* Lookup tables of the original driver */
+static const uint32_t ref_filter_table[] = {
+	0x01001990, 0x01001190, 0x01009890, 0x01001890,
+	0x01008890, 0x01009090, 0x01009090, 0x01009090,
+	0x01009090, 0x01000890, 0x01000890, 0x01000890,
+	0x08009090, 0x01001090, 0x01001090, 0x01001090,
+	0x01001090, 0x01001090, 0x01001090, 0x01001090,
+	0x01001090, 0x01001090, 0x01001090, 0x01008090,
+	0x01008090, 0x01008090, 0x01008090, 0x01008090,
+	0x01008090, 0x01008090, 0x01008090, 0x01008090,
+	0x01008090, 0x01008090, 0x01008090, 0x01008090,
+	0x01008090, 0x08001090, 0x08001090, 0x08001090,
+	0x08001090, 0x08001090, 0x08001090, 0x08001090,
+	0x08001090, 0x08001090, 0x08001090
+};
+
+static const uint32_t ref_lock_table[] = {
+	0x060603e8, 0x060603e8, 0x080803e8, 0x0b0b03e8,
+	0x0e0e03e8, 0x111103e8, 0x131303e8, 0x161603e8,
+	0x191903e8, 0x1c1c03e8, 0x1f1f0384, 0x1f1f0339,
+	0x1f1f02ee, 0x1f1f02bc, 0x1f1f028a, 0x1f1f0271,
+	0x1f1f023f, 0x1f1f0226, 0x1f1f020d, 0x1f1f01f4,
+	0x1f1f01db, 0x1f1f01c2, 0x1f1f01a9, 0x1f1f0190,
+	0x1f1f0190, 0x1f1f0177, 0x1f1f015e, 0x1f1f015e,
+	0x1f1f0145, 0x1f1f0145, 0x1f1f012c, 0x1f1f012c,
+	0x1f1f012c, 0x1f1f0113, 0x1f1f0113, 0x1f1f0113
+};
+
+static uint64_t test_checks;
+static uint64_t test_failures;
+static int test_stdout = -1;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* The driver reports every lock on stdout, keep the report readable */
+static void test_quiet(bool quiet)
+{
+	int fd;
+
+	fflush(stdout);
+	if (quiet) {
+		test_stdout = dup(STDOUT_FILENO);
+		fd = open("/dev/null", O_WRONLY);
+		dup2(fd, STDOUT_FILENO);
+		close(fd);
+	} else if (test_stdout >= 0) {
+		dup2(test_stdout, STDOUT_FILENO);
+		close(test_stdout);
+		test_stdout = -1;
+	}
+}
+
+/**
+ * @brief Original axi_clkgen_calc_params() divider search.
+ */
+static void ref_calc_params(const struct test_fpga *fpga, uint32_t fin,
+			    uint32_t fout, uint32_t *best_d, uint32_t *best_m,
+			    uint32_t *best_dout)
+{
+	uint32_t d, d_min, d_max, _d_min, _d_max;
+	uint32_t m, m_min, m_max, dout, fvco;
+	int32_t f, best_f;
+
+	fin /= 1000;
+	fout /= 1000;
+
+	best_f = 0x7fffffff;
+	*best_d = 0;
+	*best_m = 0;
+	*best_dout = 0;
+
+	d_min = max(DIV_ROUND_UP(fin, fpga->fpfd_max), 1);
+	d_max = min(fin / fpga->fpfd_min, 80);
+
+	m_min = max(DIV_ROUND_UP(fpga->fvco_min, fin) * d_min, 1);
+	m_max = min(fpga->fvco_max * d_max / fin, 64);
+
+	for (m = m_min; m <= m_max; m++) {
+		_d_min = max(d_min, DIV_ROUND_UP(fin * m, fpga->fvco_max));
+		_d_max = min(d_max, fin * m / fpga->fvco_min);
+
+		for (d = _d_min; d <= _d_max; d++) {
+			fvco = fin * m / d;
+			dout = DIV_ROUND_CLOSEST(fvco, fout);
+			dout = clamp(dout, 1, 128);
+			f = fvco / dout;
+			if (abs(f - (int32_t)fout) < abs(best_f - (int32_t)fout)) {
+				best_f = f;
+				*best_d = d;
+				*best_m = m;
+				*best_dout = dout;
+				if (best_f == (int32_t)fout)
+					return;
+			}
+		}
+	}
+}
+
+static void ref_clk_params(uint32_t divider, uint32_t *low, uint32_t *high,
+			   uint32_t *edge, uint32_t *nocount)
+{
+	*nocount = (divider == 1);
+	*high = divider / 2;
+	*edge = divider % 2;
+	*low = divider - *high;
+}
+
+/**
+ * @brief Original axi_clkgen_set_rate() register values.
+ * @return false if no divider setting was found.
+ */
+static bool ref_rate_regs(const struct test_fpga *fpga, uint32_t parent,
+			  uint32_t rate, uint32_t *vals)
+{
+	uint32_t d, m, dout, low, high, edge, nocount, filter, lock;
+
+	ref_calc_params(fpga, parent, rate, &d, &m, &dout);
+	if (d == 0 || dout == 0 || m == 0)
+		return false;
+
+	filter = (m - 1 < 47) ? ref_filter_table[m - 1] : 0x08008090;
+	lock = (m - 1 < 36) ? ref_lock_table[m - 1] : 0x1f1f00fa;
+
+	ref_clk_params(dout, &low, &high, &edge, &nocount);
+	vals[0] = (high << 6) | low;
+	vals[1] = (edge << 7) | (nocount << 6);
+	ref_clk_params(dout * 4, &low, &high, &edge, &nocount);
+	vals[2] = (high << 6) | low;
+	vals[3] = (edge << 7) | (nocount << 6);
+	ref_clk_params(d, &low, &high, &edge, &nocount);
+	vals[4] = (edge << 13) | (nocount << 12) | (high << 6) | low;
+	ref_clk_params(m, &low, &high, &edge, &nocount);
+	vals[5] = (high << 6) | low;
+	vals[6] = (edge << 7) | (nocount << 6);
+	vals[7] = lock & 0x3ff;
+	vals[8] = (((lock >> 16) & 0x1f) << 10) | 0x1;
+	vals[9] = (((lock >> 24) & 0x1f) << 10) | 0x3e9;
+	vals[10] = filter >> 16;
+	vals[11] = filter;
+
+	return true;
+}
+
+/**
+ * @brief Original DRP read-modify-write sequence, through the bus.
+ */
+static void ref_drp_rmw(uint32_t reg, uint32_t val, uint32_t mask)
+{
+	uint32_t reg_val;
+
+	axi_io_read(TEST_CLKGEN_BASE, REG_DRP_STATUS, &reg_val);
+	axi_io_read(TEST_CLKGEN_BASE, REG_DRP_STATUS, &reg_val);
+	axi_io_write(TEST_CLKGEN_BASE, REG_DRP_CNTRL,
+		     DRP_CNTRL_SEL | DRP_CNTRL_READ | (reg << 16));
+	axi_io_read(TEST_CLKGEN_BASE, REG_DRP_STATUS, &reg_val);
+	reg_val = (reg_val & 0xffff & ~mask) | DRP_CNTRL_SEL | (reg << 16) |
+		  (val & mask);
+	axi_io_write(TEST_CLKGEN_BASE, REG_DRP_CNTRL, reg_val);
+}
+
+/**
+ * @brief Original axi_clkgen_set_rate(), used as the benchmark baseline.
+ */
+static void ref_set_rate(const struct test_fpga *fpga, uint32_t parent,
+			 uint32_t rate)
+{
+	uint32_t vals[12], reg_val, i;
+
+	/* The original code read the FPGA info on every search */
+	axi_io_read(TEST_CLKGEN_BASE, 0x0000, &reg_val);
+	axi_io_read(TEST_CLKGEN_BASE, 0x001C, &reg_val);
+	axi_io_read(TEST_CLKGEN_BASE, 0x0140, &reg_val);
+	if (!ref_rate_regs(fpga, parent, rate, vals))
+		return;
+
+	axi_io_write(TEST_CLKGEN_BASE, REG_RESETN, 0x1);
+	for (i = 0; i < 12; i++)
+		ref_drp_rmw(ref_regs[i], vals[i], ref_masks[i]);
+	axi_io_write(TEST_CLKGEN_BASE, REG_RESETN, 0x3);
+	axi_io_read(TEST_CLKGEN_BASE, 0x005C, &reg_val);
+}
+
+static void test_fail(const char *what, const struct test_fpga *fpga,
+		      uint32_t parent, uint32_t rate)
+{
+	if (test_failures++ < 20) {
+		test_quiet(false);
+		printf("FAIL %s: %s parent %"PRIu32" rate %"PRIu32"\n", what,
+		       fpga->name, parent, rate);
+		test_quiet(true);
+	}
+}
+
+/**
+ * @brief Set a rate with the driver and compare the MMCM registers with the
+ *        ones the original read-modify-write sequence leaves in the shadow.
+ */
+static void test_one(struct axi_clkgen *clkgen, struct sim_model *model,
+		     const struct test_fpga *fpga, uint32_t *shadow,
+		     uint32_t rate)
+{
+	uint32_t vals[12], i, drp, got, expected_rate, d, m, dout;
+
+	axi_clkgen_set_rate(clkgen, rate);
+	test_checks++;
+
+	if (ref_rate_regs(fpga, clkgen->parent_rate, rate, vals))
+		for (i = 0; i < 12; i++)
+			shadow[i] = (shadow[i] & ~ref_masks[i]) |
+				    (vals[i] & ref_masks[i]);
+
+	for (i = 0; i < 12; i++) {
+		drp = sim_reg_read(model, SIM_AXI_CLKGEN_DRP(ref_regs[i]));
+		if (drp != shadow[i]) {
+			test_fail("mmcm registers", fpga, clkgen->parent_rate,
+				  rate);
+			return;
+		}
+	}
+
+	/* axi_clkgen_get_rate() decodes the same registers */
+	dout = (shadow[0] & 0x3f) + ((shadow[0] >> 6) & 0x3f);
+	d = (shadow[4] & 0x3f) + ((shadow[4] >> 6) & 0x3f);
+	m = (shadow[5] & 0x3f) + ((shadow[5] >> 6) & 0x3f);
+	expected_rate = (d && dout) ?
+			(uint64_t)(clkgen->parent_rate / d) * m / dout : 0;
+	axi_clkgen_get_rate(clkgen, &got);
+	if (got != expected_rate)
+		test_fail("get_rate", fpga, clkgen->parent_rate, rate);
+}
+
+/**
+ * @brief Sweep the output rate for every FPGA type and parent rate. Each new
+ *        rate is followed by switches back and forth to the previous one,
+ *        which are served from the rate cache.
+ * @return None.
+ */
+static void test_sweep(void)
+{
+	struct axi_clkgen_init init = {
+		.name = "clkgen",
+		.base = TEST_CLKGEN_BASE,
+	};
+	struct axi_clkgen *clkgen;
+	struct sim_model *model;
+	uint32_t shadow[12], f, p, i, rate, prev;
+
+	srand(1);
+	for (f = 0; f < ARRAY_SIZE(test_fpgas); f++)
+		for (p = 0; p < ARRAY_SIZE(test_parents); p++) {
+			sim_axi_clkgen_init(&model, TEST_CLKGEN_BASE,
+					    test_fpgas[f].info);
+			/* Random bits outside the rate fields must survive */
+			for (i = 0; i < 12; i++) {
+				shadow[i] = rand() & 0xffff;
+				sim_reg_write(model,
+					      SIM_AXI_CLKGEN_DRP(ref_regs[i]),
+					      shadow[i]);
+			}
+
+			init.parent_rate = test_parents[p];
+			axi_clkgen_init(&clkgen, &init);
+
+			prev = 0;
+			for (rate = 5000000; rate <= 600000000;
+			     rate += 249989) {
+				test_one(clkgen, model, &test_fpgas[f], shadow,
+					 rate);
+				if (prev) {
+					test_one(clkgen, model, &test_fpgas[f],
+						 shadow, prev);
+					test_one(clkgen, model, &test_fpgas[f],
+						 shadow, rate);
+				}
+				prev = rate;
+			}
+
+			axi_clkgen_remove(clkgen);
+			sim_model_free(model);
+		}
+}
+
+/**
+ * @brief Measure switching between a few interface rates.
+ * @param name - Measurement name.
+ * @param use_ref - Use the original code instead of the driver.
+ * @return None.
+ */
+static void bench_switch(const char *name, bool use_ref)
+{
+	static const uint32_t rates[] = {
+		61440000, 122880000, 245760000, 30720000
+	};
+	struct axi_clkgen_init init = {
+		.name = "clkgen",
+		.base = TEST_CLKGEN_BASE,
+		.parent_rate = 100000000,
+	};
+	struct axi_clkgen *clkgen;
+	struct sim_model *model;
+	struct sim_stats *stats = sim_get_stats();
+	uint64_t start, ns, ops = 0, mmio;
+
+	sim_axi_clkgen_init(&model, TEST_CLKGEN_BASE, test_fpgas[1].info);
+	axi_clkgen_init(&clkgen, &init);
+	sim_stats_reset();
+
+	test_quiet(true);
+	start = bench_now_ns();
+	do {
+		if (use_ref)
+			ref_set_rate(&test_fpgas[1], init.parent_rate,
+				     rates[ops % ARRAY_SIZE(rates)]);
+		else
+			axi_clkgen_set_rate(clkgen,
+					    rates[ops % ARRAY_SIZE(rates)]);
+		ops++;
+		ns = bench_now_ns() - start;
+	} while (ns < BENCH_MIN_NS);
+	test_quiet(false);
+
+	mmio = (uint64_t)stats->mmio_reads + stats->mmio_writes;
+	printf("%-36s %12.1f ops/s %8.0f ns/op %6.1f mmio/op\n", name,
+	       ops * 1e9 / ns, (double)ns / ops, (double)mmio / ops);
+
+	axi_clkgen_remove(clkgen);
+	sim_model_free(model);
+}
+
+int main(void)
+{
+	test_quiet(true);
+	test_sweep();
+	test_quiet(false);
+
+	printf("%"PRIu64" rate switches checked, %"PRIu64" failures\n",
+	       test_checks, test_failures);
+
+	bench_switch("original set_rate", true);
+	bench_switch("axi_clkgen_set_rate", false);
+
+	return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
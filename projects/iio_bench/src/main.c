@@ -0,0 +1,463 @@
+/***************************************************************************//**
+ *   @file   main.c
+ *   @brief  Host benchmark of the IIO server ops.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include "axi_adc_core.h"
+#include "axi_dac_core.h"
+#include "axi_dmac.h"
+#include "error.h"
+#include "iio.h"
+#include "iio_axi_adc.h"
+#include "iio_axi_dac.h"
+#include "sim_models.h"
+#include "tinyiiod.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define BENCH_ADC_BASE		0x79020000
+#define BENCH_DAC_BASE		0x79040000
+#define BENCH_RX_DMA_BASE	0x7C400000
+#define BENCH_TX_DMA_BASE	0x7C420000
+#define BENCH_NUM_CH		4
+#define BENCH_DDR_SIZE		(4 * 1024 * 1024)
+#define BENCH_CHUNK		1024
+
+/* Minimum run time of one measurement */
+#define BENCH_MIN_NS		200000000ull
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bench_allocs
+ * @brief Heap operation counters, filled by the --wrap=malloc shims.
+ */
+struct bench_allocs {
+	uint64_t	mallocs;
+	/** realloc() calls that resize an existing block */
+	uint64_t	reallocs;
+	uint64_t	frees;
+	uint64_t	bytes;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct tinyiiod_ops *bench_ops;
+static struct bench_allocs bench_allocs;
+static char bench_buf[64 * 1024];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size)
+{
+	bench_allocs.mallocs++;
+	bench_allocs.bytes += size;
+
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+	bench_allocs.mallocs++;
+	bench_allocs.bytes += nmemb * size;
+
+	return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+	/* Only realloc(NULL, n) is a new allocation */
+	if (ptr)
+		bench_allocs.reallocs++;
+	else
+		bench_allocs.mallocs++;
+	bench_allocs.bytes += size;
+
+	return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+	if (ptr)
+		bench_allocs.frees++;
+
+	__real_free(ptr);
+}
+
+/*
+ * The benchmark calls the server ops directly, so libtinyiiod is replaced by
+ * a stub that only keeps the ops registered by iio_init().
+ */
+struct tinyiiod *tinyiiod_create(struct tinyiiod_ops *ops)
+{
+	bench_ops = ops;
+
+	return (struct tinyiiod *)ops;
+}
+
+void tinyiiod_destroy(struct tinyiiod *iiod)
+{
+	free(iiod);
+	bench_ops = NULL;
+}
+
+int32_t tinyiiod_read_command(struct tinyiiod *iiod)
+{
+	return FAILURE;
+}
+
+static ssize_t bench_server_read(char *buf, size_t len)
+{
+	return FAILURE;
+}
+
+static ssize_t bench_server_write(const char *buf, size_t len)
+{
+	return len;
+}
+
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Report one measurement.
+ * @param name - Measurement name.
+ * @param ops - Number of operations.
+ * @param bytes - Payload bytes moved, 0 if not a throughput test.
+ * @param ns - Elapsed time.
+ * @param start - Heap counters before the measurement.
+ * @return None.
+ */
+static void bench_report(const char *name, uint64_t ops, uint64_t bytes,
+			 uint64_t ns, const struct bench_allocs *start)
+{
+	double allocs = (double)(bench_allocs.mallocs - start->mallocs) / ops;
+	double frees = (double)(bench_allocs.frees - start->frees) / ops;
+
+	if (bytes)
+		printf("%-36s %12.1f ops/s %10.2f MB/s %8.2f allocs/op "
+		       "%8.2f frees/op\n", name, ops * 1e9 / ns,
+		       bytes * 1e3 / ns, allocs, frees);
+	else
+		printf("%-36s %12.1f ops/s %8.0f ns/op %10.2f allocs/op "
+		       "%8.2f frees/op\n", name, ops * 1e9 / ns,
+		       (double)ns / ops, allocs, frees);
+}
+
+/**
+ * @brief Measure channel attribute reads.
+ * @param dev - Device name.
+ * @param attr - Attribute name, "" reads all the attributes of the channel.
+ * @return None.
+ */
+static void bench_ch_attr(const char *dev, const char *attr)
+{
+	struct bench_allocs start = bench_allocs;
+	uint64_t t0, ns = 0, ops = 0;
+	char name[64];
+	ssize_t ret;
+
+	t0 = bench_now_ns();
+	do {
+		ret = bench_ops->ch_read_attr(dev, "voltage0", false, attr,
+					      bench_buf, sizeof(bench_buf));
+		if (ret < 0) {
+			printf("%s: ch_read_attr(%s) failed\n", dev, attr);
+			return;
+		}
+		ops++;
+		ns = bench_now_ns() - t0;
+	} while (ns < BENCH_MIN_NS);
+
+	snprintf(name, sizeof(name), "ch_read_attr %s", attr[0] ? attr : "*");
+	bench_report(name, ops, 0, ns, &start);
+}
+
+/**
+ * @brief Measure open/close of a device.
+ * @param dev - Device name.
+ * @return None.
+ */
+static void bench_open_close(const char *dev)
+{
+	struct bench_allocs start = bench_allocs;
+	uint64_t t0, ns = 0, ops = 0;
+
+	t0 = bench_now_ns();
+	do {
+		bench_ops->open(dev, 2, 0x1);
+		bench_ops->close(dev);
+		ops++;
+		ns = bench_now_ns() - t0;
+	} while (ns < BENCH_MIN_NS);
+
+	bench_report("open_dev + close_dev", ops, 0, ns, &start);
+}
+
+/**
+ * @brief Measure a capture: transfer_dev_to_mem() then read_dev() in
+ * BENCH_CHUNK pieces, as libtinyiiod does.
+ * @param dev - Device name.
+ * @param mask - Channel mask.
+ * @param bytes - Buffer size in bytes, for the enabled channels.
+ * @return None.
+ */
+static void bench_capture(const char *dev, uint32_t mask, uint32_t bytes)
+{
+	struct bench_allocs start = bench_allocs;
+	uint64_t t0, ns = 0, ops = 0;
+	uint32_t off, n;
+	char name[64];
+
+	if (bench_ops->open(dev, 2 * hweight8(mask), mask) < 0)
+		return;
+
+	t0 = bench_now_ns();
+	do {
+		if (bench_ops->transfer_dev_to_mem(dev, bytes) < 0) {
+			printf("%s: transfer_dev_to_mem failed\n", dev);
+			break;
+		}
+		for (off = 0; off < bytes; off += n) {
+			n = min_t(uint32_t, BENCH_CHUNK, bytes - off);
+			bench_ops->read_data(dev, bench_buf, off, n);
+		}
+		ops++;
+		ns = bench_now_ns() - t0;
+	} while (ns < BENCH_MIN_NS);
+
+	bench_ops->close(dev);
+
+	snprintf(name, sizeof(name), "capture mask 0x%"PRIx32" %"PRIu32" B",
+		 mask, bytes);
+	bench_report(name, ops, ops * bytes, ns, &start);
+}
+
+/**
+ * @brief Measure a playback: write_data() in BENCH_CHUNK pieces then
+ * transfer_mem_to_dev().
+ * @param dev - Device name.
+ * @param mask - Channel mask.
+ * @param bytes - Buffer size in bytes, for the enabled channels.
+ * @return None.
+ */
+static void bench_playback(const char *dev, uint32_t mask, uint32_t bytes)
+{
+	struct bench_allocs start = bench_allocs;
+	uint64_t t0, ns = 0, ops = 0;
+	uint32_t off, n;
+	char name[64];
+
+	if (bench_ops->open(dev, 2 * hweight8(mask), mask) < 0)
+		return;
+
+	t0 = bench_now_ns();
+	do {
+		for (off = 0; off < bytes; off += n) {
+			n = min_t(uint32_t, BENCH_CHUNK, bytes - off);
+			bench_ops->write_data(dev, bench_buf, off, n);
+		}
+		if (bench_ops->transfer_mem_to_dev(dev, bytes) < 0) {
+			printf("%s: transfer_mem_to_dev failed\n", dev);
+			break;
+		}
+		ops++;
+		ns = bench_now_ns() - t0;
+	} while (ns < BENCH_MIN_NS);
+
+	bench_ops->close(dev);
+
+	snprintf(name, sizeof(name), "playback mask 0x%"PRIx32" %"PRIu32" B",
+		 mask, bytes);
+	bench_report(name, ops, ops * bytes, ns, &start);
+}
+
+/**
+ * @brief Measure the context XML generation.
+ * @return None.
+ */
+static void bench_xml(void)
+{
+	struct bench_allocs start = bench_allocs;
+	uint64_t t0, ns = 0, ops = 0;
+	size_t len = 0;
+	char *xml;
+
+	t0 = bench_now_ns();
+	do {
+		if (bench_ops->get_xml(&xml) < 0) {
+			printf("get_xml failed\n");
+			return;
+		}
+		len = strlen(xml);
+		free(xml);
+		ops++;
+		ns = bench_now_ns() - t0;
+	} while (ns < BENCH_MIN_NS);
+
+	bench_report("get_xml", ops, 0, ns, &start);
+	printf("%-36s %12zu bytes\n", "get_xml size", len);
+}
+
+/**
+ * @brief Benchmark entry point. The AXI cores run on the simulated platform,
+ * the DMA buffers live in the low 4 GiB so that their addresses fit the 32 bit
+ * fields used by the drivers.
+ * @return 0 in case of success, 1 otherwise.
+ */
+int main(void)
+{
+	struct sim_model *adc_model, *dac_model, *rx_dma_model, *tx_dma_model;
+	struct axi_adc_init adc_init = {"bench-adc", BENCH_ADC_BASE,
+		       BENCH_NUM_CH
+	};
+	struct axi_dac_init dac_init = {"bench-dac", BENCH_DAC_BASE,
+		       BENCH_NUM_CH, NULL
+	};
+	struct axi_dmac_init rx_dma_init = {"rx_dmac", BENCH_RX_DMA_BASE,
+		       DMA_DEV_TO_MEM, 0
+	};
+	struct axi_dmac_init tx_dma_init = {"tx_dmac", BENCH_TX_DMA_BASE,
+		       DMA_MEM_TO_DEV, DMA_CYCLIC
+	};
+	struct iio_server_ops server_ops = {
+		.read = bench_server_read,
+		.write = bench_server_write,
+	};
+	struct iio_axi_adc_init_param iio_adc_init;
+	struct iio_axi_dac_init_param iio_dac_init;
+	struct iio_axi_adc_desc *iio_adc;
+	struct iio_axi_dac_desc *iio_dac;
+	struct axi_dmac *rx_dmac, *tx_dmac;
+	struct axi_adc *adc;
+	struct axi_dac *dac;
+	struct tinyiiod *iiod;
+	static const uint32_t masks[] = {0x1, 0x3, 0xF};
+	static const uint32_t sizes[] = {4096, 65536, 1048576};
+	uint32_t i, j;
+	void *ddr;
+
+	ddr = mmap(NULL, 2 * BENCH_DDR_SIZE, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (ddr == MAP_FAILED)
+		return 1;
+
+	/*
+	 * There is no AXI DAC model. axi_dac_init() only uses the common
+	 * register map (reset, clock and status), which is the same in both
+	 * cores, and the DDS/DMA registers are plain storage in the ADC model.
+	 */
+	if (sim_axi_adc_init(&adc_model, BENCH_ADC_BASE, BENCH_NUM_CH) ||
+	    sim_axi_adc_init(&dac_model, BENCH_DAC_BASE, BENCH_NUM_CH) ||
+	    sim_axi_dmac_init(&rx_dma_model, BENCH_RX_DMA_BASE) ||
+	    sim_axi_dmac_init(&tx_dma_model, BENCH_TX_DMA_BASE))
+		return 1;
+
+	if (axi_adc_init(&adc, &adc_init) || axi_dac_init(&dac, &dac_init) ||
+	    axi_dmac_init(&rx_dmac, &rx_dma_init) ||
+	    axi_dmac_init(&tx_dmac, &tx_dma_init))
+		return 1;
+
+	if (iio_init(&iiod, &server_ops))
+		return 1;
+
+	iio_adc_init = (struct iio_axi_adc_init_param) {
+		.rx_adc = adc,
+		.rx_dmac = rx_dmac,
+		.adc_ddr_base = (uint32_t)(uintptr_t)ddr,
+	};
+	iio_dac_init = (struct iio_axi_dac_init_param) {
+		.tx_dac = dac,
+		.tx_dmac = tx_dmac,
+		.dac_ddr_base = (uint32_t)(uintptr_t)ddr + BENCH_DDR_SIZE,
+	};
+	if (iio_axi_adc_init(&iio_adc, &iio_adc_init) ||
+	    iio_axi_dac_init(&iio_dac, &iio_dac_init))
+		return 1;
+
+	printf("\n");
+	bench_ch_attr(adc->name, "calibscale");
+	bench_ch_attr(adc->name, "sampling_frequency");
+	bench_ch_attr(adc->name, "");
+	bench_open_close(adc->name);
+	for (i = 0; i < ARRAY_SIZE(masks); i++)
+		for (j = 0; j < ARRAY_SIZE(sizes); j++)
+			bench_capture(adc->name, masks[i], sizes[j]);
+	for (i = 0; i < ARRAY_SIZE(masks); i++)
+		bench_playback(dac->name, masks[i], sizes[1]);
+	bench_xml();
+
+	iio_axi_adc_remove(iio_adc);
+	iio_axi_dac_remove(iio_dac);
+	iio_remove(iiod);
+
+	printf("%-36s %12"PRIu64" allocs %12"PRIu64" reallocs %12"PRIu64
+	       " frees\n", "total", bench_allocs.mallocs,
+	       bench_allocs.reallocs, bench_allocs.frees);
+
+	return 0;
+}
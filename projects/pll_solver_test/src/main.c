@@ -0,0 +1,537 @@
+/***************************************************************************//**
+ *   @file   main.c
+ *   @brief  Host test and benchmark of the fractional-N PLL solver.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "adf4350.h"
+#include "error.h"
+#include "frac_pll.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* ADF4156/ADF4157 limits, kept here to avoid linking their drivers */
+#define ADF415X_MAX_FREQ_PFD	32000000
+#define ADF4156_MAX_MODULUS	4095
+#define ADF415X_MAX_R_CNT	32
+#define ADF4157_FIXED_MODULUS	33554432
+
+/* ADF4153 limits, as set by adf4153_init() */
+#define ADF4153_PFD_MAX		32000000
+#define ADF4153_MOD_MAX		4095
+#define ADF4153_R_CNT_MAX	15
+
+/* Minimum run time of one measurement */
+#define BENCH_MIN_NS		200000000ull
+
+#define ARRAY_LEN(x)		(sizeof(x) / sizeof((x)[0]))
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct ref_result
+ * @brief Divider values computed by a reference implementation.
+ */
+struct ref_result {
+	uint32_t	r_cnt;
+	uint32_t	fpfd;
+	uint32_t	int_val;
+	uint32_t	fract;
+	uint32_t	mod;
+	uint64_t	actual;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static const uint32_t test_clkin[] = {
+	10000000, 19200000, 25000000, 30720000, 61440000, 100000000,
+	122880000, 250000000
+};
+
+static const uint32_t test_chspc[] = {
+	1, 1000, 10000, 12500, 100000, 200000, 1000000
+};
+
+static uint64_t test_checks;
+static uint64_t test_failures;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t ref_gcd(uint32_t x, uint32_t y)
+{
+	uint32_t tmp;
+
+	while (y != 0) {
+		tmp = x % y;
+		x = y;
+		y = tmp;
+	}
+
+	return x;
+}
+
+/**
+ * @brief Original adf4350_set_freq() divider search, without the SPI writes.
+ * @return 0 on success, -1 if the original code rejects the frequency, -2 if
+ *         it would divide by zero.
+ */
+static int32_t ref_adf4350(const struct adf4350_platform_data *pdata,
+			   uint32_t clkin, uint32_t chspc, uint64_t freq,
+			   struct ref_result *res)
+{
+	uint64_t tmp;
+	uint32_t div_gcd, fpfd, r1_mod, r0_fract, r0_int;
+	uint16_t mdiv, r_cnt = 0;
+	uint8_t rf_div_sel = 0;
+
+	if ((freq > ADF4350_MAX_OUT_FREQ) || (freq < ADF4350_MIN_OUT_FREQ))
+		return -1;
+
+	mdiv = (freq > ADF4350_MAX_FREQ_45_PRESC) ? 75 : 23;
+
+	while (freq < ADF4350_MIN_VCO_FREQ) {
+		freq <<= 1;
+		rf_div_sel++;
+	}
+
+	if (pdata->ref_div_factor)
+		r_cnt = pdata->ref_div_factor - 1;
+
+	do {
+		do {
+			do {
+				do {
+					r_cnt++;
+					fpfd = (clkin *
+						(pdata->ref_doubler_en ? 2 : 1)) /
+					       (r_cnt *
+						(pdata->ref_div2_en ? 2 : 1));
+				} while (fpfd > ADF4350_MAX_FREQ_PFD);
+				r1_mod = fpfd / chspc;
+				if (r_cnt > ADF4350_MAX_R_CNT) {
+					chspc++;
+					r_cnt = 0;
+				}
+			} while ((r1_mod > ADF4350_MAX_MODULUS) && r_cnt);
+		} while (r_cnt == 0);
+
+		if (!r1_mod)
+			return -2;
+
+		tmp = freq * (uint64_t)r1_mod + (fpfd > 1);
+		tmp = (tmp / fpfd);
+		r0_fract = tmp % r1_mod;
+		r0_int = tmp / r1_mod;
+	} while (mdiv > r0_int);
+
+	if (r0_fract && r1_mod) {
+		div_gcd = ref_gcd(r1_mod, r0_fract);
+		r1_mod /= div_gcd;
+		r0_fract /= div_gcd;
+	} else {
+		r0_fract = 0;
+		r1_mod = 1;
+	}
+
+	res->r_cnt = r_cnt;
+	res->fpfd = fpfd;
+	res->int_val = r0_int;
+	res->fract = r0_fract;
+	res->mod = r1_mod;
+	tmp = (uint64_t)((r0_int * r1_mod) + r0_fract) * (uint64_t)fpfd;
+	res->actual = tmp / ((uint64_t)r1_mod * ((uint64_t)1 << rf_div_sel));
+
+	return 0;
+}
+
+/**
+ * @brief Original adf4156_set_freq()/adf4157_set_freq() divider search.
+ * @param fixed_mod - 0 for the ADF4156, the fixed modulus for the ADF4157.
+ * @return 0 on success, -1 if the R counter runs out of range, -2 if the
+ *         original code would divide by zero.
+ */
+static int32_t ref_adf415x(uint32_t clkin, bool dbl, bool div2,
+			   uint32_t chspc, uint32_t fixed_mod, double freq,
+			   struct ref_result *res)
+{
+	uint64_t tmp;
+	uint32_t div_gcd, fpfd, mod, r0_fract, r0_int;
+	uint16_t mdiv, r_cnt = 0;
+
+	mdiv = (freq > 3000000000.0) ? 75 : 23;
+
+	do {
+		do {
+			do {
+				r_cnt++;
+				fpfd = (clkin * (dbl ? 2 : 1)) /
+				       (r_cnt * (div2 ? 2 : 1));
+			} while (fpfd > ADF415X_MAX_FREQ_PFD);
+			mod = fixed_mod ? fixed_mod : fpfd / chspc;
+			if (!fixed_mod && (r_cnt > ADF415X_MAX_R_CNT))
+				return -1;
+		} while (!fixed_mod && (mod > ADF4156_MAX_MODULUS) && r_cnt);
+		if (!mod)
+			return -2;
+		tmp = freq * (uint64_t)mod + (fpfd >> 1);
+		tmp = (uint64_t)(tmp / fpfd);
+		r0_fract = tmp % mod;
+		r0_int = tmp / mod;
+	} while (mdiv > r0_int);
+
+	if (!fixed_mod) {
+		if (r0_fract && mod) {
+			div_gcd = ref_gcd(mod, r0_fract);
+			mod /= div_gcd;
+			r0_fract /= div_gcd;
+		} else {
+			r0_fract = 0;
+			mod = 1;
+		}
+	}
+
+	res->r_cnt = r_cnt;
+	res->fpfd = fpfd;
+	res->int_val = r0_int;
+	res->fract = r0_fract;
+	res->mod = mod;
+
+	return 0;
+}
+
+static void test_fail(const char *what, uint32_t clkin, uint32_t chspc,
+		      uint64_t freq)
+{
+	if (test_failures++ < 20)
+		printf("FAIL %s: clkin %"PRIu32" chspc %"PRIu32" freq %"PRIu64"\n",
+		       what, clkin, chspc, freq);
+}
+
+/**
+ * @brief Compare the ADF4350 driver against the original search for every
+ *        reference setting and a sweep over the full output range.
+ * @return None.
+ */
+static void test_adf4350(void)
+{
+	static const uint16_t ref_div[] = {0, 1, 3, 10};
+	struct adf4350_platform_data pdata = {0};
+	adf4350_dev dev = {0};
+	struct adf4350_hop hop;
+	struct ref_result ref;
+	uint32_t c, s, d, opt;
+	uint64_t freq, step;
+	int32_t ret, ref_ret;
+
+	dev.pdata = &pdata;
+	frac_pll_solver_reset(&dev.solver);
+
+	for (c = 0; c < ARRAY_LEN(test_clkin); c++)
+		for (s = 0; s < ARRAY_LEN(test_chspc); s++)
+			for (d = 0; d < ARRAY_LEN(ref_div); d++)
+				for (opt = 0; opt < 4; opt++) {
+					dev.clkin = test_clkin[c];
+					dev.chspc = test_chspc[s];
+					pdata.ref_div_factor = ref_div[d];
+					pdata.ref_doubler_en = opt & 1;
+					pdata.ref_div2_en = !!(opt & 2);
+
+					/*
+					 * Tiny spacings make the original search
+					 * walk every R counter, so sweep coarser
+					 */
+					step = (dev.chspc < 100) ? 97137271 : 1713271;
+					for (freq = ADF4350_MIN_OUT_FREQ - 1;
+					     freq <= ADF4350_MAX_OUT_FREQ + 1;
+					     freq += step) {
+						ref_ret = ref_adf4350(&pdata,
+								      dev.clkin,
+								      dev.chspc,
+								      freq, &ref);
+						ret = adf4350_calc_freq(&dev,
+									freq,
+									&hop);
+						test_checks++;
+						if (ref_ret == -2) {
+							if (ret >= 0)
+								test_fail("adf4350 undefined",
+									  dev.clkin,
+									  dev.chspc,
+									  freq);
+							continue;
+						}
+						if ((ret < 0) != (ref_ret < 0)) {
+							test_fail("adf4350 status",
+								  dev.clkin,
+								  dev.chspc, freq);
+							continue;
+						}
+						if (ret < 0)
+							continue;
+						if (((hop.regs[ADF4350_REG2] >> 14) & 0x3FF) !=
+						    (ref.r_cnt & 0x3FF) ||
+						    (hop.fpfd != ref.fpfd) ||
+						    (hop.r0_int != ref.int_val) ||
+						    (hop.r0_fract != ref.fract) ||
+						    (hop.r1_mod != ref.mod) ||
+						    (hop.actual_freq != ref.actual))
+							test_fail("adf4350 dividers",
+								  dev.clkin,
+								  dev.chspc, freq);
+					}
+				}
+}
+
+/**
+ * @brief Compare the ADF4156/ADF4157 solver settings against the original
+ *        searches.
+ * @return None.
+ */
+static void test_adf415x(void)
+{
+	struct frac_pll_solver solver;
+	struct frac_pll_result res;
+	struct frac_pll_cfg cfg = {
+		.r_cnt_init = 0,
+		.max_r_cnt = ADF415X_MAX_R_CNT,
+		.max_fpfd = ADF415X_MAX_FREQ_PFD,
+		.chspc_retry = false,
+		.round_closest = true,
+	};
+	struct ref_result ref = {0};
+	uint32_t c, s, opt, fixed;
+	uint64_t freq, n, ref_n;
+	int32_t ret, ref_ret;
+
+	frac_pll_solver_reset(&solver);
+
+	for (fixed = 0; fixed < 2; fixed++)
+		for (c = 0; c < ARRAY_LEN(test_clkin); c++)
+			for (s = 0; s < ARRAY_LEN(test_chspc); s++)
+				for (opt = 0; opt < 4; opt++) {
+					cfg.clkin = test_clkin[c];
+					cfg.ref_doubler_en = opt & 1;
+					cfg.ref_div2_en = !!(opt & 2);
+					cfg.fixed_mod = fixed ?
+							ADF4157_FIXED_MODULUS : 0;
+					cfg.max_mod = fixed ?
+						      ADF4157_FIXED_MODULUS :
+						      ADF4156_MAX_MODULUS;
+					/* The ADF4157 ignores the spacing */
+					if (fixed && s)
+						break;
+
+					for (freq = 500000000; freq <= 6000000000ull;
+					     freq += 2718281) {
+						ref_ret = ref_adf415x(cfg.clkin,
+								      cfg.ref_doubler_en,
+								      cfg.ref_div2_en,
+								      test_chspc[s],
+								      cfg.fixed_mod,
+								      (double)freq, &ref);
+						ret = frac_pll_solve(&solver, &cfg,
+								     test_chspc[s], freq,
+								     (freq > 3000000000ull) ?
+								     75 : 23, &res);
+						test_checks++;
+						if ((ret < 0) != (ref_ret < 0)) {
+							test_fail(fixed ? "adf4157 status" :
+								  "adf4156 status",
+								  cfg.clkin,
+								  test_chspc[s], freq);
+							continue;
+						}
+						if (ret < 0)
+							continue;
+						/*
+						 * The original ADF4157 code computes
+						 * freq * 2^25 in double precision,
+						 * which may be off by one LSB.
+						 */
+						n = (uint64_t)res.int_val * res.mod +
+						    res.fract;
+						ref_n = (uint64_t)ref.int_val * ref.mod +
+							ref.fract;
+						if ((res.r_cnt != ref.r_cnt) ||
+						    (res.fpfd != ref.fpfd) ||
+						    (res.mod != ref.mod) ||
+						    (fixed ? (n + 1 < ref_n ||
+							      ref_n + 1 < n) :
+						     (n != ref_n)))
+							test_fail(fixed ? "adf4157 dividers" :
+								  "adf4156 dividers",
+								  cfg.clkin,
+								  test_chspc[s], freq);
+					}
+				}
+}
+
+/**
+ * @brief Check the ADF4153 settings. The original code computed the PFD
+ *        frequency and FRAC in single precision float, so the result is
+ *        checked against the divider equations instead.
+ * @return None.
+ */
+static void test_adf4153(void)
+{
+	struct frac_pll_solver solver;
+	struct frac_pll_result res;
+	struct frac_pll_cfg cfg = {
+		.r_cnt_init = 0,
+		.max_r_cnt = ADF4153_R_CNT_MAX,
+		.max_fpfd = ADF4153_PFD_MAX,
+		.max_mod = ADF4153_MOD_MAX,
+		.chspc_retry = false,
+		.round_closest = false,
+	};
+	uint32_t c, s, opt, mod, int_min;
+	uint64_t freq, actual;
+	int32_t ret;
+
+	frac_pll_solver_reset(&solver);
+
+	for (c = 0; c < ARRAY_LEN(test_clkin); c++)
+		for (s = 1; s < ARRAY_LEN(test_chspc); s++)
+			for (opt = 0; opt < 2; opt++) {
+				cfg.clkin = test_clkin[c];
+				cfg.ref_doubler_en = opt;
+				mod = (cfg.clkin + test_chspc[s] - 1) / test_chspc[s];
+				if (mod > ADF4153_MOD_MAX)
+					continue;
+				cfg.fixed_mod = mod;
+
+				for (freq = 500000000; freq <= 4000000000ull;
+				     freq += 3141592) {
+					int_min = (freq <= 2000000000) ? 31 : 91;
+					ret = frac_pll_solve(&solver, &cfg, 0, freq,
+							     int_min, &res);
+					test_checks++;
+					if (ret < 0)
+						continue;
+					actual = frac_pll_vco_freq(&res);
+					if ((res.fpfd > ADF4153_PFD_MAX) ||
+					    (res.r_cnt > ADF4153_R_CNT_MAX) ||
+					    (res.int_val < int_min) ||
+					    (res.fract >= res.mod) ||
+					    (actual > freq + 1) ||
+					    (freq - actual > res.fpfd / res.mod + 1))
+						test_fail("adf4153 dividers", cfg.clkin,
+							  test_chspc[s], freq);
+				}
+			}
+}
+
+/**
+ * @brief Measure the cost of one frequency computation.
+ * @param name - Measurement name.
+ * @param use_ref - Use the original search instead of the driver.
+ * @return None.
+ */
+static void bench_adf4350(const char *name, bool use_ref)
+{
+	struct adf4350_platform_data pdata = {0};
+	adf4350_dev dev = {0};
+	struct adf4350_hop hop;
+	struct ref_result ref;
+	uint64_t start, ns, ops = 0, freq = ADF4350_MIN_OUT_FREQ;
+	volatile uint32_t sink = 0;
+
+	dev.pdata = &pdata;
+	dev.clkin = 250000000;
+	dev.chspc = 1000;
+	frac_pll_solver_reset(&dev.solver);
+
+	start = bench_now_ns();
+	do {
+		if (use_ref) {
+			ref_adf4350(&pdata, dev.clkin, dev.chspc, freq, &ref);
+			sink += ref.fract;
+		} else {
+			adf4350_calc_freq(&dev, freq, &hop);
+			sink += hop.r0_fract;
+		}
+		freq += 1000003;
+		if (freq > ADF4350_MAX_OUT_FREQ)
+			freq = ADF4350_MIN_OUT_FREQ;
+		ops++;
+		ns = bench_now_ns() - start;
+	} while (ns < BENCH_MIN_NS);
+
+	printf("%-36s %12.1f ops/s %8.0f ns/op\n", name, ops * 1e9 / ns,
+	       (double)ns / ops);
+}
+
+int main(void)
+{
+	test_adf4350();
+	test_adf415x();
+	test_adf4153();
+
+	printf("%"PRIu64" settings checked, %"PRIu64" failures\n",
+	       test_checks, test_failures);
+
+	bench_adf4350("adf4350 original search", true);
+	bench_adf4350("adf4350_calc_freq", false);
+
+	return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
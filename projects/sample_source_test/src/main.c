@@ -0,0 +1,404 @@
+/***************************************************************************//**
+ *   @file   main.c
+ *   @brief  Host test of the sample source acquisition.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "circular_buffer.h"
+#include "error.h"
+#include "irq_extra.h"
+#include "sample_source.h"
+#include "timer.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define TEST_NUM_CHANNELS	16
+#define TEST_RING_FRAMES	8
+#define TEST_TIMER_IRQ		3
+/* Code of a conversion: channel in the high bits, sequence in the low ones */
+#define TEST_CODE(ch, seq)	(((ch) << 10) | ((seq) & 0x3FF))
+
+#define TEST_CHECK(cond, ...)			\
+	do {					\
+		test_checks++;			\
+		if (!(cond)) {			\
+			test_failures++;	\
+			printf("FAIL: ");	\
+			printf(__VA_ARGS__);	\
+			printf("\n");		\
+		}				\
+	} while (0)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct test_adc
+ * @brief Single conversion ADC standing in for a driver.
+ */
+struct test_adc {
+	/** Conversions done */
+	uint32_t	seq;
+	/** Channel whose conversion fails, -1 for none */
+	int32_t		fail_ch;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static uint32_t test_checks;
+static uint32_t test_failures;
+/* Source whose producer runs after the next ring size read */
+static struct sample_source *test_irq_src;
+/* Frames produced then */
+static uint32_t test_irq_frames;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+uint32_t __real_cb_size(struct circular_buffer *desc);
+
+/**
+ * @brief Ring size read by the code under test. When armed, the producer
+ * runs right after the read, as a timer interrupt could.
+ * @param desc - The ring buffer descriptor.
+ * @return Number of bytes waiting to be read, before the producer ran.
+ */
+uint32_t __wrap_cb_size(struct circular_buffer *desc)
+{
+	struct sample_source *src = test_irq_src;
+	uint32_t size = __real_cb_size(desc);
+
+	if (src && src->ring == desc) {
+		test_irq_src = NULL;
+		while (test_irq_frames--)
+			sample_source_acquire(src);
+	}
+
+	return size;
+}
+
+/**
+ * @brief sample_read_t of the test ADC.
+ * @param dev - The test ADC.
+ * @param ch - Channel to convert.
+ * @param code - Conversion result.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t test_adc_read(void *dev, uint8_t ch, uint16_t *code)
+{
+	struct test_adc *adc = dev;
+
+	if (adc->fail_ch == ch)
+		return FAILURE;
+
+	*code = TEST_CODE(ch, adc->seq);
+	adc->seq++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Check the codes of consecutive frames of the given channels.
+ * @param codes - Frames read.
+ * @param nb_frames - Number of frames.
+ * @param ch_mask - Channels of each frame.
+ * @param seq - Sequence number of the first code.
+ * @return true if all the codes are the expected ones.
+ */
+static bool test_frames_ok(const uint16_t *codes, uint32_t nb_frames,
+			   uint32_t ch_mask, uint32_t seq)
+{
+	uint32_t frame, n = 0;
+	uint8_t ch;
+
+	for (frame = 0; frame < nb_frames; frame++)
+		for (ch = 0; ch < TEST_NUM_CHANNELS; ch++)
+			if (ch_mask & BIT(ch))
+				if (codes[n++] != TEST_CODE(ch, seq++))
+					return false;
+
+	return true;
+}
+
+/**
+ * @brief Compare hweight32() with a bit by bit count.
+ * @return None.
+ */
+static void test_hweight32(void)
+{
+	uint32_t words[] = {0, 1, 0x80000000, 0x80000001, 0xFFFF0000,
+			    0xFFFFFFFF, 0x12345678, 0xDEADBEEF
+			   };
+	uint32_t i, bit, count, word = 0x2545F491;
+
+	for (i = 0; i < ARRAY_SIZE(words) + 1000; i++) {
+		if (i < ARRAY_SIZE(words)) {
+			word = words[i];
+		} else {
+			/* xorshift */
+			word ^= word << 13;
+			word ^= word >> 17;
+			word ^= word << 5;
+		}
+		for (bit = 0, count = 0; bit < 32; bit++)
+			count += (word >> bit) & 1;
+		TEST_CHECK(hweight32(word) == count,
+			   "hweight32(0x%08x) = %u, expected %u", word,
+			   hweight32(word), count);
+	}
+}
+
+/**
+ * @brief Discard the data of a ring, also when the indexes wrapped.
+ * @return None.
+ */
+static void test_cb_flush(void)
+{
+	struct circular_buffer *cb;
+	uint8_t data[24], out[24];
+	uint32_t i;
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = i;
+
+	if (cb_init(&cb, 32) != SUCCESS) {
+		TEST_CHECK(false, "cb_init failed");
+		return;
+	}
+
+	cb_write(cb, data, 24);
+	TEST_CHECK(cb_flush(cb) == SUCCESS && cb_size(cb) == 0 &&
+		   cb_free_space(cb) == 32, "flush left %u bytes", cb_size(cb));
+
+	/* The next data wraps around the end of the storage */
+	cb_write(cb, data, 24);
+	TEST_CHECK(cb_read(cb, out, 24) == 24 && !memcmp(out, data, 24),
+		   "data written after a flush corrupted");
+	TEST_CHECK(cb_flush(NULL) == FAILURE, "flush of NULL accepted");
+
+	cb_remove(cb);
+}
+
+/**
+ * @brief Acquire frames without a timer, with channels above the first 8.
+ * @return None.
+ */
+static void test_polled(void)
+{
+	struct sample_source_init_param param = {0};
+	struct test_adc adc = {.fail_ch = -1};
+	uint16_t codes[TEST_RING_FRAMES * TEST_NUM_CHANNELS];
+	struct sample_source *src;
+	uint32_t ch_mask = BIT(0) | BIT(8) | BIT(15);
+	float volts[3];
+	uint32_t i, n;
+	int32_t ret;
+
+	param.dev = &adc;
+	param.read = test_adc_read;
+	param.num_channels = TEST_NUM_CHANNELS;
+	param.bits = 16;
+	param.offset = -0x8000;
+	param.scale = 1.0f / 0x8000;
+	param.ring_frames = TEST_RING_FRAMES;
+
+	ret = sample_source_init(&src, &param);
+	TEST_CHECK(ret == SUCCESS, "sample_source_init returned %d", ret);
+	if (ret != SUCCESS)
+		return;
+
+	TEST_CHECK(sample_source_start(src, BIT(16)) != SUCCESS,
+		   "channel 16 of 16 accepted");
+	ret = sample_source_start(src, ch_mask);
+	TEST_CHECK(ret == SUCCESS && src->frame_size == 3 * sizeof(uint16_t),
+		   "frame size %u for 3 channels", src->frame_size);
+
+	for (i = 0; i < 5; i++)
+		sample_source_acquire(src);
+	TEST_CHECK(sample_source_available(src) == 5, "%u frames available",
+		   sample_source_available(src));
+	n = sample_source_read(src, codes, 8);
+	TEST_CHECK(n == 5 && test_frames_ok(codes, n, ch_mask, 0),
+		   "polled frames: %u read", n);
+
+	/* A failed conversion drops the frame */
+	adc.fail_ch = 8;
+	TEST_CHECK(sample_source_acquire(src) != SUCCESS &&
+		   src->read_errors == 1 && !sample_source_available(src),
+		   "failed conversion not dropped");
+	adc.fail_ch = -1;
+
+	/* Restarting discards what was not read */
+	sample_source_acquire(src);
+	ret = sample_source_start(src, ch_mask);
+	TEST_CHECK(ret == SUCCESS && !sample_source_available(src) &&
+		   !src->read_errors, "restart kept old frames");
+
+	/* All the channels */
+	adc.seq = 0;
+	ret = sample_source_start(src, 0xFFFF);
+	TEST_CHECK(ret == SUCCESS && src->frame_size == TEST_NUM_CHANNELS *
+		   sizeof(uint16_t), "frame size %u for 16 channels",
+		   src->frame_size);
+	for (i = 0; i < TEST_RING_FRAMES + 2; i++)
+		sample_source_acquire(src);
+	TEST_CHECK(src->overruns == 2, "%u overruns, expected 2",
+		   src->overruns);
+	n = sample_source_read(src, codes, TEST_RING_FRAMES);
+	TEST_CHECK(n == TEST_RING_FRAMES &&
+		   test_frames_ok(codes, n, 0xFFFF, 0), "full ring: %u read", n);
+
+	/* Frames arriving while the reader computes how many to copy */
+	adc.seq = 0;
+	sample_source_start(src, ch_mask);
+	sample_source_acquire(src);
+	memset(codes, 0xA5, sizeof(codes));
+	test_irq_src = src;
+	test_irq_frames = 4;
+	n = sample_source_read(src, codes, 2);
+	for (i = 2 * 3; i < ARRAY_SIZE(codes); i++)
+		if (codes[i] != 0xA5A5)
+			break;
+	TEST_CHECK(n == 1 && i == ARRAY_SIZE(codes) &&
+		   test_frames_ok(codes, n, ch_mask, 0),
+		   "read of 2 frames returned %u, wrote past them", n);
+	n = sample_source_read(src, codes, TEST_RING_FRAMES);
+	TEST_CHECK(n == 4 && test_frames_ok(codes, n, ch_mask, 3),
+		   "frames produced during the read: %u left", n);
+
+	codes[0] = 0;
+	codes[1] = 0x8000;
+	codes[2] = 0xC000;
+	sample_source_to_volts(src, codes, volts, 3);
+	TEST_CHECK(volts[0] == -1.0f && volts[1] == 0.0f && volts[2] == 0.5f,
+		   "to_volts: %f %f %f", volts[0], volts[1], volts[2]);
+
+	sample_source_remove(src);
+}
+
+/**
+ * @brief Acquire frames on the interrupts of a pacing timer.
+ * @return None.
+ */
+static void test_timer(void)
+{
+	struct sample_source_init_param param = {0};
+	struct timer_init_param timer_param = {
+		.id = 0,
+		.freq_hz = 1000000,
+		.load_value = 100,
+	};
+	struct irq_init_param irq_param = {0};
+	struct test_adc adc = {.fail_ch = -1};
+	uint16_t codes[TEST_RING_FRAMES * 2];
+	struct irq_ctrl_desc *irq_ctrl;
+	struct timer_desc *timer;
+	struct sample_source *src;
+	uint32_t ch_mask = BIT(3) | BIT(12);
+	uint32_t i, n, rate;
+	int32_t ret;
+
+	if (timer_init(&timer, &timer_param) != SUCCESS ||
+	    irq_ctrl_init(&irq_ctrl, &irq_param) != SUCCESS) {
+		TEST_CHECK(false, "timer or interrupt controller init failed");
+		return;
+	}
+	irq_global_enable(irq_ctrl);
+
+	param.dev = &adc;
+	param.read = test_adc_read;
+	param.num_channels = TEST_NUM_CHANNELS;
+	param.bits = 12;
+	param.scale = 1.0f;
+	param.ring_frames = TEST_RING_FRAMES;
+	param.timer = timer;
+	param.irq_ctrl = irq_ctrl;
+	param.timer_irq_id = TEST_TIMER_IRQ;
+
+	ret = sample_source_init(&src, &param);
+	TEST_CHECK(ret == SUCCESS, "sample_source_init returned %d", ret);
+	if (ret != SUCCESS)
+		goto out;
+
+	TEST_CHECK(sim_irq_trigger(irq_ctrl, TEST_TIMER_IRQ) != SUCCESS,
+		   "timer interrupt enabled before the start");
+	TEST_CHECK(sample_source_get_rate(src, &rate) == SUCCESS &&
+		   rate == 10000, "rate %u Hz, expected 10000", rate);
+
+	ret = sample_source_start(src, ch_mask);
+	TEST_CHECK(ret == SUCCESS, "sample_source_start returned %d", ret);
+	for (i = 0; i < 6; i++)
+		sim_irq_trigger(irq_ctrl, TEST_TIMER_IRQ);
+	n = sample_source_read(src, codes, TEST_RING_FRAMES);
+	TEST_CHECK(n == 6 && test_frames_ok(codes, n, ch_mask, 0),
+		   "timer frames: %u read", n);
+
+	sample_source_stop(src);
+	TEST_CHECK(sim_irq_trigger(irq_ctrl, TEST_TIMER_IRQ) != SUCCESS,
+		   "timer interrupt enabled after the stop");
+
+	sample_source_remove(src);
+out:
+	irq_ctrl_remove(irq_ctrl);
+	timer_remove(timer);
+}
+
+int main(void)
+{
+	test_hweight32();
+	test_cb_flush();
+	test_polled();
+	test_timer();
+
+	printf("%u checks, %u failures\n", test_checks, test_failures);
+
+	return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
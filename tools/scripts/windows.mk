@@ -113,6 +113,65 @@ CFLAGS = -Wall 								\
 LDFLAGS = -T $(LSCRIPT)							\
 	  -L $(LIBRARY_DIRS)
 
+#------------------------------------------------------------------------------
+#                               BUS TRACER
+#------------------------------------------------------------------------------
+# BUS_TRACE="spi i2c" wraps the selected bus calls with util/bus_trace.c
+ifneq (,$(strip $(BUS_TRACE)))
+SRCS += $(NO-OS)/util/bus_trace.c
+INCS += $(INCLUDE)/bus_trace.h						\
+	$(INCLUDE)/timer.h						\
+	$(INCLUDE)/i2c.h						\
+	$(INCLUDE)/spi.h
+ifneq (,$(findstring spi,$(BUS_TRACE)))
+CFLAGS += -D BUS_TRACE_WRAP_SPI
+LDFLAGS += -Wl,--wrap=spi_write_and_read
+endif
+ifneq (,$(findstring i2c,$(BUS_TRACE)))
+CFLAGS += -D BUS_TRACE_WRAP_I2C
+LDFLAGS += -Wl,--wrap=i2c_write						\
+	   -Wl,--wrap=i2c_read
+endif
+ifeq (y,$(strip $(TINYIIOD)))
+SRCS += $(NO-OS)/iio/iio_bus_trace/iio_bus_trace.c
+INCS += $(NO-OS)/iio/iio_bus_trace/iio_bus_trace.h
+endif
+endif
+
+#------------------------------------------------------------------------------
+#                                 PROFILING
+#------------------------------------------------------------------------------
+# PROFILE=y enables the PROFILE_* instrumentation macros and util/profile.c
+ifeq (y,$(strip $(PROFILE)))
+CFLAGS += -D PROFILE_ENABLE
+SRCS += $(NO-OS)/util/profile.c						\
+	$(PLATFORM_DRIVERS)/profile.c
+INCS += $(INCLUDE)/profile.h
+ifeq (y,$(strip $(TINYIIOD)))
+SRCS += $(NO-OS)/iio/iio_profile/iio_profile.c
+INCS += $(NO-OS)/iio/iio_profile/iio_profile.h
+endif
+endif
+
+#------------------------------------------------------------------------------
+#                               SAMPLE SOURCE
+#------------------------------------------------------------------------------
+# SAMPLE_SOURCE=y adds the paced acquisition of util/sample_source.c
+ifeq (y,$(strip $(SAMPLE_SOURCE)))
+SRCS += $(NO-OS)/util/sample_source.c					\
+	$(NO-OS)/util/circular_buffer.c
+INCS += $(INCLUDE)/sample_source.h					\
+	$(INCLUDE)/circular_buffer.h					\
+	$(INCLUDE)/irq.h						\
+	$(INCLUDE)/timer.h
+ifeq (y,$(strip $(TINYIIOD)))
+SRCS += $(NO-OS)/iio/iio_sample_source/iio_sample_source.c		\
+	$(NO-OS)/util/wait.c
+INCS += $(NO-OS)/iio/iio_sample_source/iio_sample_source.h		\
+	$(INCLUDE)/wait.h
+endif
+endif
+
 #------------------------------------------------------------------------------
 #                             PLATFORM HANDLING                                
 #------------------------------------------------------------------------------
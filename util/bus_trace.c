@@ -0,0 +1,485 @@
+/***************************************************************************//**
+ *   @file   bus_trace.c
+ *   @brief  SPI/I2C bus transaction tracer.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "bus_trace.h"
+#include "error.h"
+#include "i2c.h"
+#include "spi.h"
+#include "util.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct bus_trace_state
+ * @brief Tracer state. The tracer is not reentrant: bus accesses from
+ * interrupt context must not overlap with traced accesses from the main loop.
+ */
+struct bus_trace_state {
+	/** Timestamp source */
+	struct timer_desc	*timer;
+	/** The timer counts down */
+	bool			count_down;
+	/** Timer frequency */
+	uint32_t		freq_hz;
+	/** Recording active */
+	bool			enabled;
+	/** Current region */
+	const char		*region;
+	/** Last entry hit, checked first */
+	uint32_t		last;
+	/** Used entries */
+	uint32_t		num_entries;
+	/** Transactions lost because the entry table was full */
+	uint32_t		dropped;
+	/** Entry table */
+	struct bus_trace_entry	entries[BUS_TRACE_MAX_ENTRIES];
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct bus_trace_state bus_trace = {
+	.region = BUS_TRACE_NO_REGION,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Configure the tracer and start recording.
+ * @param param - Tracer configuration.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t bus_trace_init(struct bus_trace_init_param *param)
+{
+	if (!param)
+		return FAILURE;
+
+	bus_trace.timer = param->timer;
+	bus_trace.count_down = param->timer_count_down;
+	bus_trace.freq_hz = 0;
+	if (bus_trace.timer &&
+	    timer_count_clk_get(bus_trace.timer, &bus_trace.freq_hz) != SUCCESS)
+		return FAILURE;
+
+	bus_trace_reset();
+	bus_trace.region = BUS_TRACE_NO_REGION;
+	bus_trace.enabled = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop recording and release the timer. The statistics are kept.
+ * @return None.
+ */
+void bus_trace_remove(void)
+{
+	bus_trace.enabled = false;
+	bus_trace.timer = NULL;
+	bus_trace.freq_hz = 0;
+}
+
+/**
+ * @brief Pause or resume recording.
+ * @param enable - true to record.
+ * @return None.
+ */
+void bus_trace_enable(bool enable)
+{
+	bus_trace.enabled = enable;
+}
+
+/**
+ * @brief Check whether recording is active.
+ * @return true if recording.
+ */
+bool bus_trace_is_enabled(void)
+{
+	return bus_trace.enabled;
+}
+
+/**
+ * @brief Clear all statistics.
+ * @return None.
+ */
+void bus_trace_reset(void)
+{
+	memset(bus_trace.entries, 0, sizeof(bus_trace.entries));
+	bus_trace.num_entries = 0;
+	bus_trace.last = 0;
+	bus_trace.dropped = 0;
+}
+
+/**
+ * @brief Attribute the following traffic to a region. Regions nest by
+ * restoring the returned tag when the region ends:
+ *	prev = bus_trace_region_set("rx_cal");
+ *	...
+ *	bus_trace_region_set(prev);
+ * @param region - Region tag, must stay valid while the statistics are used.
+ * @return The previous region tag.
+ */
+const char *bus_trace_region_set(const char *region)
+{
+	const char *prev = bus_trace.region;
+
+	bus_trace.region = region ? region : BUS_TRACE_NO_REGION;
+
+	return prev;
+}
+
+/**
+ * @brief Get the raw timer count.
+ * @return The timer count, 0 if there is no timer.
+ */
+uint32_t bus_trace_timestamp(void)
+{
+	uint32_t count = 0;
+
+	if (bus_trace.timer)
+		timer_counter_get(bus_trace.timer, &count);
+
+	return count;
+}
+
+/**
+ * @brief Get the time elapsed since a bus_trace_timestamp() value.
+ * @param start - Start timestamp.
+ * @return Elapsed time in ns, saturated to UINT32_MAX.
+ */
+uint32_t bus_trace_elapsed_ns(uint32_t start)
+{
+	uint32_t now, ticks;
+	uint64_t ns;
+
+	if (!bus_trace.timer || !bus_trace.freq_hz)
+		return 0;
+
+	now = bus_trace_timestamp();
+	ticks = bus_trace.count_down ? start - now : now - start;
+	ns = div_u64((uint64_t)ticks * 1000000000ull, bus_trace.freq_hz);
+
+	return ns > UINT32_MAX ? UINT32_MAX : ns;
+}
+
+/**
+ * @brief Get the histogram bin of a value.
+ * @param val - Value.
+ * @return 0 for 0, otherwise 1 + log2(val), saturated to the last bin.
+ */
+static uint32_t bus_trace_bin(uint32_t val)
+{
+	uint32_t bin = 0;
+
+	while (val && bin < BUS_TRACE_HIST_BINS - 1) {
+		val >>= 1;
+		bin++;
+	}
+
+	return bin;
+}
+
+/**
+ * @brief Find or allocate the entry of a descriptor in the current region.
+ * @param desc - Bus descriptor.
+ * @param type - Bus type.
+ * @param address - Chip select or slave address.
+ * @return The entry, NULL if the table is full.
+ */
+static struct bus_trace_entry *bus_trace_find(const void *desc,
+		enum bus_trace_type type, uint8_t address)
+{
+	struct bus_trace_entry *e = &bus_trace.entries[bus_trace.last];
+	uint32_t i;
+
+	if (bus_trace.num_entries && e->desc == desc &&
+	    e->region == bus_trace.region)
+		return e;
+
+	for (i = 0; i < bus_trace.num_entries; i++) {
+		e = &bus_trace.entries[i];
+		if (e->desc == desc && (e->region == bus_trace.region ||
+					!strcmp(e->region, bus_trace.region))) {
+			bus_trace.last = i;
+			return e;
+		}
+	}
+
+	if (bus_trace.num_entries == BUS_TRACE_MAX_ENTRIES)
+		return NULL;
+
+	e = &bus_trace.entries[bus_trace.num_entries];
+	e->desc = desc;
+	e->type = type;
+	e->address = address;
+	e->region = bus_trace.region;
+	bus_trace.last = bus_trace.num_entries++;
+
+	return e;
+}
+
+/**
+ * @brief Account one transaction.
+ * @param desc - Bus descriptor.
+ * @param type - Bus type.
+ * @param address - Chip select or slave address.
+ * @param bytes - Transaction size.
+ * @param time_ns - Transaction time.
+ * @param status - Value returned by the platform driver.
+ * @return None.
+ */
+void bus_trace_account(const void *desc, enum bus_trace_type type,
+		       uint8_t address, uint32_t bytes, uint32_t time_ns,
+		       int32_t status)
+{
+	struct bus_trace_entry *e;
+
+	if (!bus_trace.enabled)
+		return;
+
+	e = bus_trace_find(desc, type, address);
+	if (!e) {
+		bus_trace.dropped++;
+		return;
+	}
+
+	e->xfers++;
+	if (status < 0)
+		e->errors++;
+	e->bytes += bytes;
+	e->time_ns += time_ns;
+	if (time_ns > e->max_ns)
+		e->max_ns = time_ns;
+	e->size_hist[bus_trace_bin(bytes)]++;
+	e->time_hist[bus_trace_bin(time_ns / 1000)]++;
+}
+
+/**
+ * @brief Get a recorded entry.
+ * @param idx - Entry index, in order of first use.
+ * @return The entry, NULL if idx is out of range.
+ */
+const struct bus_trace_entry *bus_trace_get(uint32_t idx)
+{
+	if (idx >= bus_trace.num_entries)
+		return NULL;
+
+	return &bus_trace.entries[idx];
+}
+
+/**
+ * @brief Format one CSV line.
+ * @param buf - Output buffer.
+ * @param size - Output buffer size.
+ * @param e - Entry, NULL for the header line.
+ * @return Number of characters the complete line needs.
+ */
+static int32_t bus_trace_csv_line(char *buf, uint32_t size,
+				  const struct bus_trace_entry *e)
+{
+	int32_t n;
+	uint32_t i;
+
+	if (!e)
+		return snprintf(buf, size, "bus,address,region,xfers,errors,"
+				"bytes,time_ns,max_ns,size_hist,time_hist_us\n");
+
+	n = snprintf(buf, size, "%s,0x%02x,%s,%"PRIu32",%"PRIu32",%"PRIu64
+		     ",%"PRIu64",%"PRIu32",",
+		     e->type == BUS_TRACE_SPI ? "spi" : "i2c", e->address,
+		     e->region, e->xfers, e->errors, e->bytes, e->time_ns,
+		     e->max_ns);
+	for (i = 0; i < BUS_TRACE_HIST_BINS; i++)
+		n += snprintf(buf + min((uint32_t)n, size),
+			      size - min((uint32_t)n, size), "%s%"PRIu32"",
+			      i ? " " : "", e->size_hist[i]);
+	n += snprintf(buf + min((uint32_t)n, size),
+		      size - min((uint32_t)n, size), ",");
+	for (i = 0; i < BUS_TRACE_HIST_BINS; i++)
+		n += snprintf(buf + min((uint32_t)n, size),
+			      size - min((uint32_t)n, size), "%s%"PRIu32"",
+			      i ? " " : "", e->time_hist[i]);
+	n += snprintf(buf + min((uint32_t)n, size),
+		      size - min((uint32_t)n, size), "\n");
+
+	return n;
+}
+
+/**
+ * @brief Write the statistics as CSV, one line per (descriptor, region) pair
+ * after a header line. Histogram fields hold BUS_TRACE_HIST_BINS space
+ * separated counters. Only whole lines are written.
+ * @param buf - Output buffer.
+ * @param size - Output buffer size.
+ * @return Number of characters written, excluding the terminator.
+ */
+int32_t bus_trace_dump_csv(char *buf, uint32_t size)
+{
+	char line[256];
+	uint32_t j = 0, i;
+	int32_t n;
+
+	if (!buf || !size)
+		return FAILURE;
+
+	buf[0] = '\0';
+	for (i = 0; i <= bus_trace.num_entries; i++) {
+		n = bus_trace_csv_line(line, sizeof(line),
+				       i ? &bus_trace.entries[i - 1] : NULL);
+		if (n < 0 || n >= (int32_t)sizeof(line) || j + n >= size)
+			break;
+		memcpy(buf + j, line, n + 1);
+		j += n;
+	}
+
+	return j;
+}
+
+/**
+ * @brief Print the statistics as CSV.
+ * @return None.
+ */
+void bus_trace_print(void)
+{
+	char line[256];
+	uint32_t i;
+
+	for (i = 0; i <= bus_trace.num_entries; i++) {
+		bus_trace_csv_line(line, sizeof(line),
+				   i ? &bus_trace.entries[i - 1] : NULL);
+		printf("%s", line);
+	}
+	if (bus_trace.dropped)
+		printf("# %"PRIu32" transactions dropped, entry table full\n",
+		       bus_trace.dropped);
+}
+
+#ifdef BUS_TRACE_WRAP_SPI
+/*
+ * Link time shim, enabled with -Wl,--wrap=spi_write_and_read. Every call to
+ * spi_write_and_read() lands here and __real_spi_write_and_read() resolves to
+ * the platform driver.
+ */
+int32_t __real_spi_write_and_read(struct spi_desc *desc, uint8_t *data,
+				  uint16_t bytes_number);
+
+/**
+ * @brief Traced spi_write_and_read().
+ * @param desc - The SPI descriptor.
+ * @param data - The buffer with the transmitted/received data.
+ * @param bytes_number - Number of bytes to write/read.
+ * @return Value returned by the platform driver.
+ */
+int32_t __wrap_spi_write_and_read(struct spi_desc *desc, uint8_t *data,
+				  uint16_t bytes_number)
+{
+	uint32_t start = bus_trace_timestamp();
+	int32_t ret;
+
+	ret = __real_spi_write_and_read(desc, data, bytes_number);
+	bus_trace_account(desc, BUS_TRACE_SPI, desc->chip_select, bytes_number,
+			  bus_trace_elapsed_ns(start), ret);
+
+	return ret;
+}
+#endif /* BUS_TRACE_WRAP_SPI */
+
+#ifdef BUS_TRACE_WRAP_I2C
+/*
+ * Link time shims, enabled with -Wl,--wrap=i2c_write -Wl,--wrap=i2c_read.
+ */
+int32_t __real_i2c_write(struct i2c_desc *desc, uint8_t *data,
+			 uint8_t bytes_number, uint8_t stop_bit);
+int32_t __real_i2c_read(struct i2c_desc *desc, uint8_t *data,
+			uint8_t bytes_number, uint8_t stop_bit);
+
+/**
+ * @brief Traced i2c_write().
+ * @param desc - The I2C descriptor.
+ * @param data - Buffer that stores the transmission data.
+ * @param bytes_number - Number of bytes to write.
+ * @param stop_bit - Stop condition control.
+ * @return Value returned by the platform driver.
+ */
+int32_t __wrap_i2c_write(struct i2c_desc *desc, uint8_t *data,
+			 uint8_t bytes_number, uint8_t stop_bit)
+{
+	uint32_t start = bus_trace_timestamp();
+	int32_t ret;
+
+	ret = __real_i2c_write(desc, data, bytes_number, stop_bit);
+	bus_trace_account(desc, BUS_TRACE_I2C, desc->slave_address,
+			  bytes_number, bus_trace_elapsed_ns(start), ret);
+
+	return ret;
+}
+
+/**
+ * @brief Traced i2c_read().
+ * @param desc - The I2C descriptor.
+ * @param data - Buffer that will store the received data.
+ * @param bytes_number - Number of bytes to read.
+ * @param stop_bit - Stop condition control.
+ * @return Value returned by the platform driver.
+ */
+int32_t __wrap_i2c_read(struct i2c_desc *desc, uint8_t *data,
+			uint8_t bytes_number, uint8_t stop_bit)
+{
+	uint32_t start = bus_trace_timestamp();
+	int32_t ret;
+
+	ret = __real_i2c_read(desc, data, bytes_number, stop_bit);
+	bus_trace_account(desc, BUS_TRACE_I2C, desc->slave_address,
+			  bytes_number, bus_trace_elapsed_ns(start), ret);
+
+	return ret;
+}
+#endif /* BUS_TRACE_WRAP_I2C */
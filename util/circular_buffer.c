@@ -0,0 +1,214 @@
+/***************************************************************************//**
+ *   @file   circular_buffer.c
+ *   @brief  Lock-free single producer/single consumer byte ring buffer.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include "circular_buffer.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Keep the compiler from moving the data copy past the index update */
+#if defined(__GNUC__)
+#define cb_barrier()	__asm__ __volatile__("" ::: "memory")
+#else
+#define cb_barrier()
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Allocate a ring buffer.
+ * @param desc - The ring buffer descriptor.
+ * @param size - Requested capacity in bytes, rounded up to a power of two.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t cb_init(struct circular_buffer **desc, uint32_t size)
+{
+	struct circular_buffer *cb;
+	uint32_t real_size = 1;
+
+	if (!desc || !size || size > 0x80000000)
+		return FAILURE;
+
+	while (real_size < size)
+		real_size <<= 1;
+
+	cb = calloc(1, sizeof(*cb));
+	if (!cb)
+		return FAILURE;
+
+	cb->buff = calloc(1, real_size);
+	if (!cb->buff) {
+		free(cb);
+		return FAILURE;
+	}
+	cb->size = real_size;
+
+	*desc = cb;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by cb_init().
+ * @param desc - The ring buffer descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t cb_remove(struct circular_buffer *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	free(desc->buff);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Number of bytes waiting to be read.
+ * @param desc - The ring buffer descriptor.
+ * @return Number of bytes.
+ */
+uint32_t cb_size(struct circular_buffer *desc)
+{
+	return desc->write_idx - desc->read_idx;
+}
+
+/**
+ * @brief Number of bytes that can be written without dropping data.
+ * @param desc - The ring buffer descriptor.
+ * @return Number of bytes.
+ */
+uint32_t cb_free_space(struct circular_buffer *desc)
+{
+	return desc->size - cb_size(desc);
+}
+
+/**
+ * @brief Append data to the ring buffer. Called by the producer only.
+ *
+ * The data is copied with at most two memcpy calls. What does not fit is
+ * dropped and counted in the overflows field.
+ * @param desc - The ring buffer descriptor.
+ * @param data - Data to store.
+ * @param len - Number of bytes.
+ * @return Number of bytes stored.
+ */
+uint32_t cb_write(struct circular_buffer *desc, const void *data,
+		  uint32_t len)
+{
+	const uint8_t *src = data;
+	uint32_t widx = desc->write_idx;
+	/* Single load: the reader may move its index meanwhile */
+	uint32_t ridx = desc->read_idx;
+	uint32_t off, span, n;
+
+	/* Reuse the space only after the index that released it */
+	cb_barrier();
+	n = min(len, desc->size - (widx - ridx));
+	if (n < len)
+		desc->overflows += len - n;
+
+	off = widx & (desc->size - 1);
+	span = min(n, desc->size - off);
+	memcpy(desc->buff + off, src, span);
+	memcpy(desc->buff, src + span, n - span);
+
+	/* Publish the data only after it was copied */
+	cb_barrier();
+	desc->write_idx = widx + n;
+
+	return n;
+}
+
+/**
+ * @brief Remove data from the ring buffer. Called by the consumer only.
+ * @param desc - The ring buffer descriptor.
+ * @param data - Destination buffer.
+ * @param len - Maximum number of bytes to read.
+ * @return Number of bytes copied, 0 if the buffer is empty.
+ */
+uint32_t cb_read(struct circular_buffer *desc, void *data, uint32_t len)
+{
+	uint8_t *dst = data;
+	uint32_t ridx = desc->read_idx;
+	/* Single load: the writer may move its index meanwhile */
+	uint32_t widx = desc->write_idx;
+	uint32_t off, span, n;
+
+	/* Read the data only after the index that published it */
+	cb_barrier();
+	n = min(len, widx - ridx);
+
+	off = ridx & (desc->size - 1);
+	span = min(n, desc->size - off);
+	memcpy(dst, desc->buff + off, span);
+	memcpy(dst + span, desc->buff, n - span);
+
+	cb_barrier();
+	desc->read_idx = ridx + n;
+
+	return n;
+}
+
+/**
+ * @brief Discard the data waiting to be read. Called by the consumer only.
+ * @param desc - The ring buffer descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t cb_flush(struct circular_buffer *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	desc->read_idx = desc->write_idx;
+
+	return SUCCESS;
+}
@@ -0,0 +1,268 @@
+/***************************************************************************//**
+ *   @file   frac_pll.c
+ *   @brief  Implementation of the fractional-N PLL divider solver.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stddef.h>
+#include "frac_pll.h"
+#include "error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Compute the greatest common divisor of two numbers.
+ * @param x - First number.
+ * @param y - Second number.
+ * @return The greatest common divisor.
+ */
+static uint32_t frac_pll_gcd(uint32_t x, uint32_t y)
+{
+	uint32_t tmp;
+
+	while (y != 0) {
+		tmp = x % y;
+		x = y;
+		y = tmp;
+	}
+
+	return x;
+}
+
+/**
+ * @brief Compute the PFD frequency for an R counter value.
+ * @param cfg - The PLL configuration.
+ * @param r_cnt - The R counter value.
+ * @return The PFD frequency (Hz).
+ */
+uint32_t frac_pll_calc_fpfd(const struct frac_pll_cfg *cfg, uint16_t r_cnt)
+{
+	return (cfg->clkin * (cfg->ref_doubler_en ? 2 : 1)) /
+	       (r_cnt * (cfg->ref_div2_en ? 2 : 1));
+}
+
+/**
+ * @brief Advance the search to the next valid (R counter, modulus) pair.
+ *
+ * The R counter is increased until the PFD frequency is in range and the
+ * modulus obtained for the channel spacing fits. When the R counter runs out
+ * of range the search either fails or restarts with a 1 Hz larger channel
+ * spacing, depending on cfg->chspc_retry.
+ * @param cfg - The PLL configuration.
+ * @param pfd - The search state, updated with the next valid pair.
+ * @return SUCCESS in case of success, FAILURE if no pair was found.
+ */
+int32_t frac_pll_pfd_next(const struct frac_pll_cfg *cfg,
+			  struct frac_pll_pfd *pfd)
+{
+	if (!cfg->clkin || (!cfg->fixed_mod && !pfd->chspc))
+		return FAILURE;
+
+	while (1) {
+		do {
+			pfd->r_cnt++;
+			pfd->fpfd = frac_pll_calc_fpfd(cfg, pfd->r_cnt);
+		} while ((pfd->fpfd > cfg->max_fpfd) &&
+			 (pfd->r_cnt <= cfg->max_r_cnt));
+
+		if (pfd->r_cnt > cfg->max_r_cnt) {
+			if (!cfg->chspc_retry)
+				return FAILURE;
+			/* try higher spacing values */
+			pfd->chspc++;
+			pfd->r_cnt = 0;
+			continue;
+		}
+
+		pfd->mod = cfg->fixed_mod ? cfg->fixed_mod :
+			   pfd->fpfd / pfd->chspc;
+		/* Channel spacing larger than the PFD frequency */
+		if (!pfd->mod)
+			return FAILURE;
+		if (pfd->mod <= cfg->max_mod)
+			return SUCCESS;
+	}
+}
+
+/**
+ * @brief Invalidate the memoized search result.
+ * @param solver - The solver.
+ * @return None.
+ */
+void frac_pll_solver_reset(struct frac_pll_solver *solver)
+{
+	solver->valid = false;
+}
+
+/**
+ * @brief Check if the memoized pair was found for a configuration.
+ * @param solver - The solver.
+ * @param cfg - The PLL configuration.
+ * @param chspc - The requested channel spacing.
+ * @return true if the memoized pair can be reused.
+ */
+static bool frac_pll_solver_match(const struct frac_pll_solver *solver,
+				  const struct frac_pll_cfg *cfg,
+				  uint32_t chspc)
+{
+	const struct frac_pll_cfg *c = &solver->cfg;
+
+	return solver->valid &&
+	       (solver->req_chspc == chspc) &&
+	       (c->clkin == cfg->clkin) &&
+	       (c->ref_doubler_en == cfg->ref_doubler_en) &&
+	       (c->ref_div2_en == cfg->ref_div2_en) &&
+	       (c->r_cnt_init == cfg->r_cnt_init) &&
+	       (c->max_r_cnt == cfg->max_r_cnt) &&
+	       (c->max_fpfd == cfg->max_fpfd) &&
+	       (c->max_mod == cfg->max_mod) &&
+	       (c->fixed_mod == cfg->fixed_mod) &&
+	       (c->chspc_retry == cfg->chspc_retry);
+}
+
+/**
+ * @brief Get the first valid (R counter, modulus) pair.
+ *
+ * The pair only depends on the reference path and on the channel spacing, so
+ * it is searched once and then reused until one of them changes.
+ * @param solver - The solver holding the memoized pair.
+ * @param cfg - The PLL configuration.
+ * @param chspc - The requested channel spacing (Hz).
+ * @param pfd - The first valid pair.
+ * @return SUCCESS in case of success, FAILURE if no pair was found.
+ */
+int32_t frac_pll_pfd_first(struct frac_pll_solver *solver,
+			   const struct frac_pll_cfg *cfg, uint32_t chspc,
+			   struct frac_pll_pfd *pfd)
+{
+	int32_t ret;
+
+	if (!frac_pll_solver_match(solver, cfg, chspc)) {
+		solver->valid = false;
+		solver->first.r_cnt = cfg->r_cnt_init;
+		solver->first.chspc = chspc;
+		ret = frac_pll_pfd_next(cfg, &solver->first);
+		if (ret != SUCCESS)
+			return ret;
+
+		solver->cfg = *cfg;
+		solver->req_chspc = chspc;
+		solver->valid = true;
+	}
+
+	*pfd = solver->first;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Compute the dividers of a VCO frequency.
+ *
+ * Starts from the memoized first pair and only continues the search when the
+ * integer divide value is below the prescaler minimum.
+ * @param solver - The solver holding the memoized pair.
+ * @param cfg - The PLL configuration.
+ * @param chspc - The requested channel spacing (Hz).
+ * @param vco_freq - The VCO frequency (Hz).
+ * @param int_min - The smallest integer divide value allowed.
+ * @param res - The divider values.
+ * @return SUCCESS in case of success, FAILURE if no divider set was found.
+ */
+int32_t frac_pll_solve(struct frac_pll_solver *solver,
+		       const struct frac_pll_cfg *cfg, uint32_t chspc,
+		       uint64_t vco_freq, uint32_t int_min,
+		       struct frac_pll_result *res)
+{
+	struct frac_pll_pfd pfd;
+	uint64_t tmp;
+	uint32_t div_gcd;
+	int32_t ret;
+
+	ret = frac_pll_pfd_first(solver, cfg, chspc, &pfd);
+	if (ret != SUCCESS)
+		return ret;
+
+	while (1) {
+		/* The +1 when truncating keeps the historical ADF4350 results */
+		tmp = vco_freq * (uint64_t)pfd.mod +
+		      (cfg->round_closest ? (pfd.fpfd >> 1) : (pfd.fpfd > 1));
+		tmp /= pfd.fpfd;
+
+		res->fract = tmp % pfd.mod;
+		res->int_val = tmp / pfd.mod;
+		if (res->int_val >= int_min)
+			break;
+
+		ret = frac_pll_pfd_next(cfg, &pfd);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	res->r_cnt = pfd.r_cnt;
+	res->chspc = pfd.chspc;
+	res->fpfd = pfd.fpfd;
+	res->mod = pfd.mod;
+
+	if (cfg->fixed_mod)
+		return SUCCESS;
+
+	if (res->fract) {
+		div_gcd = frac_pll_gcd(res->mod, res->fract);
+		res->mod /= div_gcd;
+		res->fract /= div_gcd;
+	} else {
+		res->mod = 1;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Compute the VCO frequency produced by a set of dividers.
+ * @param res - The divider values.
+ * @return The VCO frequency (Hz).
+ */
+uint64_t frac_pll_vco_freq(const struct frac_pll_result *res)
+{
+	return (uint64_t)res->int_val * res->fpfd +
+	       ((uint64_t)res->fract * res->fpfd) / res->mod;
+}
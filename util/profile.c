@@ -0,0 +1,259 @@
+/***************************************************************************//**
+ *   @file   profile.c
+ *   @brief  Hot path timing instrumentation.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "error.h"
+#include "profile.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#if (PROFILE_RING_SIZE & (PROFILE_RING_SIZE - 1)) != 0
+#error "PROFILE_RING_SIZE must be a power of two"
+#endif
+
+#define PROFILE_RING_MASK	(PROFILE_RING_SIZE - 1)
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/*
+ * Statically allocated trace ring. Recording is not reentrant: sections timed
+ * in interrupt handlers must not end while a main loop section is recorded.
+ */
+static struct profile_event profile_ring[PROFILE_RING_SIZE];
+/* Number of events ever recorded, the ring keeps the last PROFILE_RING_SIZE */
+static volatile uint32_t profile_head;
+static volatile bool profile_enabled;
+static uint32_t profile_hz;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start the platform clock, clear the trace ring and start recording.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t profile_init(void)
+{
+	int32_t ret;
+
+	ret = profile_clock_init();
+	if (ret != SUCCESS)
+		return ret;
+
+	profile_hz = profile_clock_hz();
+	profile_reset();
+	profile_enabled = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Pause or resume recording.
+ * @param enable - true to record.
+ * @return None.
+ */
+void profile_enable(bool enable)
+{
+	profile_enabled = enable;
+}
+
+/**
+ * @brief Check whether recording is active.
+ * @return true if recording.
+ */
+bool profile_is_enabled(void)
+{
+	return profile_enabled;
+}
+
+/**
+ * @brief Clear the trace ring.
+ * @return None.
+ */
+void profile_reset(void)
+{
+	profile_head = 0;
+}
+
+/**
+ * @brief Record one timed section, overwriting the oldest event when the ring
+ * is full.
+ * @param name - Section name, must stay valid while the trace is used.
+ * @param start - Clock value when the section started.
+ * @param ticks - Section duration in clock ticks.
+ * @return None.
+ */
+void profile_record(const char *name, uint32_t start, uint32_t ticks)
+{
+	struct profile_event *e;
+
+	if (!profile_enabled)
+		return;
+
+	e = &profile_ring[profile_head & PROFILE_RING_MASK];
+	e->name = name;
+	e->start = start;
+	e->ticks = ticks;
+	profile_head++;
+}
+
+/**
+ * @brief Convert clock ticks to ns.
+ * @param ticks - Clock ticks.
+ * @return Time in ns saturated to UINT32_MAX, 0 if there is no clock.
+ */
+uint32_t profile_ticks_to_ns(uint32_t ticks)
+{
+	uint64_t ns;
+
+	if (!profile_hz)
+		return 0;
+
+	ns = div_u64((uint64_t)ticks * 1000000000ull, profile_hz);
+
+	return ns > UINT32_MAX ? UINT32_MAX : ns;
+}
+
+/**
+ * @brief Get the number of events in the ring.
+ * @return Number of events.
+ */
+uint32_t profile_count(void)
+{
+	return min_t(uint32_t, profile_head, PROFILE_RING_SIZE);
+}
+
+/**
+ * @brief Get an event.
+ * @param idx - Event index, 0 is the oldest event still in the ring.
+ * @param event - The event.
+ * @return SUCCESS in case of success, FAILURE if idx is out of range.
+ */
+int32_t profile_get(uint32_t idx, struct profile_event *event)
+{
+	uint32_t head = profile_head;
+	uint32_t count = min_t(uint32_t, head, PROFILE_RING_SIZE);
+
+	if (idx >= count)
+		return FAILURE;
+
+	*event = profile_ring[(head - count + idx) & PROFILE_RING_MASK];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Format one CSV line.
+ * @param buf - Output buffer.
+ * @param size - Output buffer size.
+ * @param e - Event, NULL for the header line.
+ * @return Number of characters the complete line needs.
+ */
+static int32_t profile_csv_line(char *buf, uint32_t size,
+				const struct profile_event *e)
+{
+	if (!e)
+		return snprintf(buf, size, "name,start,ticks,ns\n");
+
+	return snprintf(buf, size, "%s,%"PRIu32",%"PRIu32",%"PRIu32"\n",
+			e->name, e->start, e->ticks,
+			profile_ticks_to_ns(e->ticks));
+}
+
+/**
+ * @brief Write the trace as CSV, oldest event first, after a header line.
+ * Only whole lines are written. Recording should be paused while dumping.
+ * @param buf - Output buffer.
+ * @param size - Output buffer size.
+ * @return Number of characters written, excluding the terminator.
+ */
+int32_t profile_dump_csv(char *buf, uint32_t size)
+{
+	struct profile_event e;
+	char line[96];
+	uint32_t j = 0, i;
+	int32_t n;
+
+	if (!buf || !size)
+		return FAILURE;
+
+	buf[0] = '\0';
+	n = profile_csv_line(line, sizeof(line), NULL);
+	for (i = 0; j + n < size; i++) {
+		memcpy(buf + j, line, n + 1);
+		j += n;
+		if (profile_get(i, &e) != SUCCESS)
+			break;
+		n = profile_csv_line(line, sizeof(line), &e);
+		if (n < 0 || n >= (int32_t)sizeof(line))
+			break;
+	}
+
+	return j;
+}
+
+/**
+ * @brief Print the trace as CSV, oldest event first.
+ * @return None.
+ */
+void profile_print(void)
+{
+	struct profile_event e;
+	char line[96];
+	uint32_t i;
+
+	profile_csv_line(line, sizeof(line), NULL);
+	printf("%s", line);
+	for (i = 0; profile_get(i, &e) == SUCCESS; i++) {
+		profile_csv_line(line, sizeof(line), &e);
+		printf("%s", line);
+	}
+}
@@ -0,0 +1,313 @@
+/***************************************************************************//**
+ *   @file   sample_source.c
+ *   @brief  Timer paced acquisition from single sample ADC drivers.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "error.h"
+#include "util.h"
+#include "sample_source.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Timer interrupt handler, converts one frame.
+ * @param data - The sample source descriptor.
+ */
+static void sample_source_irq_handler(void *data)
+{
+	sample_source_acquire(data);
+}
+
+/**
+ * @brief Wrap a single sample ADC driver into a paced acquisition.
+ * @param desc - The sample source descriptor.
+ * @param param - The sample source parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sample_source_init(struct sample_source **desc,
+			   struct sample_source_init_param *param)
+{
+	struct sample_source *src;
+	int32_t ret;
+
+	if (!desc || !param || !param->read || !param->num_channels ||
+	    param->num_channels > SAMPLE_SOURCE_MAX_CHANNELS ||
+	    !param->ring_frames || (param->timer && !param->irq_ctrl))
+		return FAILURE;
+
+	src = (struct sample_source *)calloc(1, sizeof(*src));
+	if (!src)
+		return FAILURE;
+
+	src->dev = param->dev;
+	src->read = param->read;
+	src->num_channels = param->num_channels;
+	src->bits = param->bits;
+	src->offset = param->offset;
+	src->scale = param->scale;
+	src->timer = param->timer;
+	src->irq_ctrl = param->irq_ctrl;
+	src->timer_irq_id = param->timer_irq_id;
+
+	ret = cb_init(&src->ring, param->ring_frames * param->num_channels *
+		      sizeof(uint16_t));
+	if (ret)
+		goto error_free;
+
+	if (src->timer) {
+		ret = irq_register(src->irq_ctrl, src->timer_irq_id,
+				   sample_source_irq_handler, src);
+		if (ret)
+			goto error_ring;
+	}
+
+	*desc = src;
+
+	return SUCCESS;
+
+error_ring:
+	cb_remove(src->ring);
+error_free:
+	free(src);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by sample_source_init().
+ * @param desc - The sample source descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sample_source_remove(struct sample_source *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	sample_source_stop(desc);
+	if (desc->timer)
+		irq_unregister(desc->irq_ctrl, desc->timer_irq_id);
+	cb_remove(desc->ring);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start the acquisition of the selected channels. The ring is
+ * emptied, each frame then holds one code per enabled channel, lowest
+ * channel first.
+ * @param desc - The sample source descriptor.
+ * @param ch_mask - Channels to acquire.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sample_source_start(struct sample_source *desc, uint32_t ch_mask)
+{
+	int32_t ret;
+
+	if (!desc || !ch_mask || ch_mask >> desc->num_channels)
+		return FAILURE;
+
+	ret = sample_source_stop(desc);
+	if (ret)
+		return ret;
+
+	desc->ch_mask = ch_mask;
+	desc->frame_size = hweight32(ch_mask) * sizeof(uint16_t);
+	/* The producer is stopped, the reader may drop what is left */
+	cb_flush(desc->ring);
+	desc->overruns = 0;
+	desc->read_errors = 0;
+	desc->running = true;
+
+	if (!desc->timer)
+		return SUCCESS;
+
+	ret = irq_source_enable(desc->irq_ctrl, desc->timer_irq_id);
+	if (ret)
+		goto error;
+	ret = timer_start(desc->timer);
+	if (ret) {
+		irq_source_disable(desc->irq_ctrl, desc->timer_irq_id);
+		goto error;
+	}
+
+	return SUCCESS;
+
+error:
+	desc->running = false;
+
+	return ret;
+}
+
+/**
+ * @brief Stop the acquisition. The frames in the ring can still be read.
+ * @param desc - The sample source descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sample_source_stop(struct sample_source *desc)
+{
+	int32_t ret = SUCCESS;
+
+	if (!desc)
+		return FAILURE;
+
+	if (!desc->running)
+		return SUCCESS;
+
+	if (desc->timer) {
+		ret = timer_stop(desc->timer);
+		ret |= irq_source_disable(desc->irq_ctrl, desc->timer_irq_id);
+	}
+	desc->running = false;
+
+	return ret;
+}
+
+/**
+ * @brief Convert one frame of the enabled channels into the ring. Called by
+ * the timer interrupt, or by the application in polled mode. The frame is
+ * dropped if the ring is full or a conversion fails.
+ * @param desc - The sample source descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sample_source_acquire(struct sample_source *desc)
+{
+	uint16_t frame[SAMPLE_SOURCE_MAX_CHANNELS];
+	uint32_t mask;
+	uint8_t n = 0;
+	uint8_t ch;
+	int32_t ret;
+
+	if (!desc->running)
+		return FAILURE;
+
+	if (cb_free_space(desc->ring) < desc->frame_size) {
+		desc->overruns++;
+		return FAILURE;
+	}
+
+	for (ch = 0, mask = desc->ch_mask; mask; ch++, mask >>= 1) {
+		if (!(mask & 1))
+			continue;
+		ret = desc->read(desc->dev, ch, &frame[n++]);
+		if (ret) {
+			desc->read_errors++;
+			return FAILURE;
+		}
+	}
+
+	cb_write(desc->ring, frame, desc->frame_size);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Number of frames waiting to be read.
+ * @param desc - The sample source descriptor.
+ * @return Number of frames.
+ */
+uint32_t sample_source_available(struct sample_source *desc)
+{
+	if (!desc->frame_size)
+		return 0;
+
+	return cb_size(desc->ring) / desc->frame_size;
+}
+
+/**
+ * @brief Read frames from the ring.
+ * @param desc - The sample source descriptor.
+ * @param codes - Destination, one code per enabled channel for each frame.
+ * @param nb_frames - Maximum number of frames to read.
+ * @return Number of frames copied.
+ */
+uint32_t sample_source_read(struct sample_source *desc, uint16_t *codes,
+			    uint32_t nb_frames)
+{
+	uint32_t available;
+	uint32_t n;
+
+	/* Single call: the timer interrupt may add frames meanwhile */
+	available = sample_source_available(desc);
+	n = min(nb_frames, available);
+	if (!n)
+		return 0;
+
+	return cb_read(desc->ring, codes, n * desc->frame_size) /
+	       desc->frame_size;
+}
+
+/**
+ * @brief Convert codes to volts.
+ * @param desc - The sample source descriptor.
+ * @param codes - Codes read with sample_source_read().
+ * @param volts - Destination, may be the same size as codes.
+ * @param nb_codes - Number of codes.
+ */
+void sample_source_to_volts(struct sample_source *desc, const uint16_t *codes,
+			    float *volts, uint32_t nb_codes)
+{
+	const float scale = desc->scale;
+	const int32_t offset = desc->offset;
+	uint32_t i;
+
+	for (i = 0; i < nb_codes; i++)
+		volts[i] = (float)((int32_t)codes[i] + offset) * scale;
+}
+
+/**
+ * @brief Get the acquisition rate set by the pacing timer.
+ * @param desc - The sample source descriptor.
+ * @param rate_hz - The frame rate.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sample_source_get_rate(struct sample_source *desc, uint32_t *rate_hz)
+{
+	if (!desc || !rate_hz || !desc->timer || !desc->timer->load_value)
+		return FAILURE;
+
+	*rate_hz = desc->timer->freq_hz / desc->timer->load_value;
+
+	return SUCCESS;
+}
@@ -147,6 +147,19 @@ uint32_t hweight8(uint32_t word)
 	return count;
 }
 
+/**
+ * Calculate the number of set bits of a 32-bit word, in parallel on bit
+ * fields of growing width.
+ */
+uint32_t hweight32(uint32_t word)
+{
+	word = word - ((word >> 1) & 0x55555555);
+	word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+	word = (word + (word >> 4)) & 0x0F0F0F0F;
+
+	return (word * 0x01010101) >> 24;
+}
+
 /**
  * Calculate the quotient and the remainder of an integer division.
  */
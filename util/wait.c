@@ -0,0 +1,195 @@
+/***************************************************************************//**
+ *   @file   wait.c
+ *   @brief  Implementation of the condition wait utility.
+ *   @author Analog Devices Inc.
+********************************************************************************
+ * Copyright 2020(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stddef.h>
+#include "wait.h"
+#include "delay.h"
+#include "util.h"
+#include "error.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Update the statistics at the end of a wait.
+ * @param stats - The statistics structure.
+ * @param elapsed_us - Duration of the wait.
+ * @param timed_out - True if the condition was not met.
+ * @return None.
+ */
+static void wait_stats_update(struct wait_stats *stats, uint32_t elapsed_us,
+			      bool timed_out)
+{
+	if (!stats)
+		return;
+
+	stats->count++;
+	stats->last_us = elapsed_us;
+	if (timed_out) {
+		stats->timeouts++;
+		return;
+	}
+
+	if (stats->count - stats->timeouts == 1 || elapsed_us < stats->min_us)
+		stats->min_us = elapsed_us;
+	if (elapsed_us > stats->max_us)
+		stats->max_us = elapsed_us;
+	stats->total_us += elapsed_us;
+}
+
+/**
+ * @brief Check if the condition signaled by the status pin or by the event
+ *        flag is asserted. The (slower) condition callback is only called
+ *        once this returns true.
+ * @param param - The wait parameters.
+ * @param asserted - Set to true if the hint is asserted.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t wait_hint_get(const struct wait_param *param, bool *asserted)
+{
+	uint8_t level;
+	int32_t ret;
+
+	*asserted = true;
+
+	if (param->event && !*param->event)
+		*asserted = false;
+
+	if (*asserted && param->status_gpio) {
+		ret = gpio_get_value(param->status_gpio, &level);
+		if (ret != SUCCESS)
+			return ret;
+		*asserted = (level == param->status_level);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for a condition.
+ *
+ * The condition is first checked immediately, then after an interval that
+ * starts at start_us and doubles on every check up to max_step_us. When a
+ * status pin or an event flag is provided, the condition callback is only
+ * called once the pin or the flag is asserted. The elapsed time is accounted
+ * from the delays issued by this function.
+ * @param param - The wait parameters.
+ * @param cond - The condition callback.
+ * @param ctx - Context passed to the condition callback.
+ * @return SUCCESS if the condition is met, FAILURE in case of timeout,
+ *         negative error code returned by the callback otherwise.
+ */
+int32_t wait_for_condition(const struct wait_param *param,
+			   wait_cond_t cond, void *ctx)
+{
+	uint32_t elapsed_us = 0;
+	uint32_t step_us;
+	bool asserted;
+	bool done = false;
+	int32_t ret;
+
+	if (!param || !cond)
+		return FAILURE;
+
+	step_us = param->start_us ? param->start_us : 1;
+
+	while (true) {
+		ret = wait_hint_get(param, &asserted);
+		if (ret != SUCCESS)
+			return ret;
+
+		if (asserted) {
+			ret = cond(ctx, &done);
+			if (ret != SUCCESS)
+				return ret;
+			if (done)
+				break;
+		}
+
+		if (elapsed_us >= param->timeout_us)
+			break;
+
+		step_us = min(step_us, param->timeout_us - elapsed_us);
+		udelay(step_us);
+		elapsed_us += step_us;
+
+		if (step_us < param->max_step_us)
+			step_us = min(step_us * 2, param->max_step_us);
+	}
+
+	wait_stats_update(param->stats, elapsed_us, !done);
+
+	return done ? SUCCESS : FAILURE;
+}
+
+/**
+ * @brief IRQ handler that sets the event flag of a wait. Register it with
+ *        irq_register() using the wait_param event flag as device instance.
+ * @param data - Pointer to the event flag.
+ * @return None.
+ */
+void wait_event_handler(void *data)
+{
+	volatile bool *event = data;
+
+	*event = true;
+}
+
+/**
+ * @brief Clear the wait statistics.
+ * @param stats - The statistics structure.
+ * @return None.
+ */
+void wait_stats_reset(struct wait_stats *stats)
+{
+	if (!stats)
+		return;
+
+	stats->count = 0;
+	stats->timeouts = 0;
+	stats->last_us = 0;
+	stats->min_us = 0;
+	stats->max_us = 0;
+	stats->total_us = 0;
+}